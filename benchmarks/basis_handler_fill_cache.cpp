@@ -0,0 +1,177 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the element cache fill of the reference bases:
+ *  BSplineHandler and NURBSHandler, for values, gradients and hessians
+ *  on all the active elements of the grid.
+ *  The batched fill of BSplineHandler (processing the elements row by row
+ *  along the direction 0) is measured on the same grids.
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/bspline_handler.h>
+#include <igatools/basis_functions/nurbs.h>
+#include <igatools/basis_functions/nurbs_element.h>
+#include <igatools/basis_functions/nurbs_handler.h>
+#include <igatools/functions/ig_grid_function.h>
+
+#include <cmath>
+
+
+template <int dim>
+std::function<void()>
+fill_cache_loop(const std::shared_ptr<const Basis<dim,0,1,1>> &basis, const int deg)
+{
+  using Flags = basis_element::Flags;
+
+  auto quad = QGauss<dim>::create(deg+1);
+  auto handler = std::shared_ptr<BasisHandler<dim,0,1,1>>(basis->create_cache_handler());
+  handler->set_element_flags(Flags::value | Flags::gradient | Flags::hessian);
+
+  auto elem = std::make_shared<typename Basis<dim,0,1,1>::ElementIterator>(basis->begin());
+  auto end = std::make_shared<typename Basis<dim,0,1,1>::ElementIterator>(basis->end());
+  handler->init_element_cache(*elem,quad);
+  const auto first_id = (*elem)->get_index();
+
+  return [handler,elem,end,first_id]()
+  {
+    (*elem)->move_to(first_id);
+    for (; *elem != *end ; ++(*elem))
+      handler->fill_element_cache(*elem);
+  };
+}
+
+
+
+template <int dim>
+void bspline_fill_cache(BenchmarkSuite &suite, const int deg, const int n_elems_dir)
+{
+  suite.run("BSplineHandler::fill_cache",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    auto grid = Grid<dim>::const_create(n_elems_dir+1);
+    std::shared_ptr<const Basis<dim,0,1,1>> basis =
+      BSpline<dim>::const_create(SplineSpace<dim>::const_create(deg,grid));
+    return fill_cache_loop<dim>(basis,deg);
+  });
+}
+
+
+
+template <int dim>
+void bspline_fill_cache_batch(BenchmarkSuite &suite, const int deg, const int n_elems_dir)
+{
+  suite.run("BSplineHandler::fill_cache_batch",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    using Flags = basis_element::Flags;
+
+    auto grid = Grid<dim>::const_create(n_elems_dir+1);
+    auto basis = BSpline<dim>::const_create(SplineSpace<dim>::const_create(deg,grid));
+    auto quad = QGauss<dim>::create(deg+1);
+    auto handler = std::make_shared<BSplineHandler<dim,1,1>>(basis);
+
+    // the elements of the grid, one batch for each row along the direction 0
+    auto rows = std::make_shared<SafeSTLVector<SafeSTLVector<TensorIndex<dim>>>>();
+    for (const auto &grid_elem : *grid)
+    {
+      const auto &t_id = grid_elem.get_index().get_tensor_index();
+      if (t_id[0] == 0)
+        rows->emplace_back();
+      rows->back().push_back(t_id);
+    }
+
+    auto batch = std::make_shared<typename BSplineHandler<dim,1,1>::CacheBatch>();
+    return [handler,rows,quad,batch]()
+    {
+      for (const auto &row : *rows)
+        handler->fill_cache_batch(row,quad,
+                                  Flags::value | Flags::gradient | Flags::hessian,
+                                  *batch);
+    };
+  });
+}
+
+
+
+#ifdef IGATOOLS_WITH_NURBS
+template <int dim>
+void nurbs_fill_cache(BenchmarkSuite &suite, const int deg, const int n_elems_dir)
+{
+  suite.run("NURBSHandler::fill_cache",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    auto grid = Grid<dim>::create(n_elems_dir+1);
+    auto space = SplineSpace<dim>::create(deg,grid);
+    auto bsp_basis = BSpline<dim>::create(space);
+
+    // non-uniform positive weights
+    const auto &dofs = space->get_dof_distribution()->get_global_dofs();
+    IgCoefficients weights(dofs);
+    for (const auto dof : dofs)
+      weights[dof] = 1.0 + 0.5 * ((dof % 3) / 2.0);
+    auto w_func = IgGridFunction<dim,1>::create(bsp_basis,weights);
+
+    std::shared_ptr<const Basis<dim,0,1,1>> basis = NURBS<dim>::create(bsp_basis,w_func);
+    return fill_cache_loop<dim>(basis,deg);
+  });
+}
+#endif // IGATOOLS_WITH_NURBS
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("basis_handler_fill_cache",argc,argv);
+
+  for (const int deg : {1,2,3,5})
+  {
+    bspline_fill_cache<1>(suite,deg,1024);
+    bspline_fill_cache<2>(suite,deg,32);
+    bspline_fill_cache<3>(suite,deg,8);
+  }
+
+  for (const int deg : {1,2,3,5})
+  {
+    bspline_fill_cache_batch<1>(suite,deg,1024);
+    bspline_fill_cache_batch<2>(suite,deg,32);
+    bspline_fill_cache_batch<3>(suite,deg,8);
+  }
+
+#ifdef IGATOOLS_WITH_NURBS
+  for (const int deg : {1,2,3,5})
+  {
+    nurbs_fill_cache<1>(suite,deg,1024);
+    nurbs_fill_cache<2>(suite,deg,32);
+    nurbs_fill_cache<3>(suite,deg,8);
+  }
+#endif // IGATOOLS_WITH_NURBS
+
+  return 0;
+}
@@ -0,0 +1,211 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Common header file for all benchmarks.
+ *
+ *  Each benchmark program defines a BenchmarkSuite and calls BenchmarkSuite::run()
+ *  for each case (identified by a name and by a list of integer parameters,
+ *  e.g. dim, degree and number of elements). The timings are printed on the
+ *  console and written (in the JSON format used by Google Benchmark) in the
+ *  file given with the --out option.
+ *
+ *  Command line options:
+ *  --out=<file>       JSON output file (default: <suite name>.json)
+ *  --filter=<string>  run only the cases whose name contains <string>
+ *  --min_time=<sec>   minimum time spent running each case (default: 0.5)
+ *
+ *  If the number of floating point operations performed by a case is given,
+ *  the achieved GFLOP/s are reported as well.
+ */
+
+#ifndef __BENCHMARK_H_
+#define __BENCHMARK_H_
+
+#include <igatools/base/config.h>
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+using namespace iga;
+
+class BenchmarkSuite
+{
+public:
+  /** Integer parameters of a benchmark case, as pairs (name,value). */
+  using Params = std::vector<std::pair<std::string,long>>;
+
+  BenchmarkSuite(const std::string &suite_name, int argc, char **argv)
+    :
+    suite_name_(suite_name),
+    out_file_(suite_name + ".json")
+  {
+    for (int i = 1 ; i < argc ; ++i)
+    {
+      const std::string arg(argv[i]);
+      if (arg.compare(0,6,"--out=") == 0)
+        out_file_ = arg.substr(6);
+      else if (arg.compare(0,9,"--filter=") == 0)
+        filter_ = arg.substr(9);
+      else if (arg.compare(0,11,"--min_time=") == 0)
+        min_time_ = std::stod(arg.substr(11));
+      else
+        std::cerr << "Unknown option: " << arg << std::endl;
+    }
+
+    std::cout << std::left << std::setw(70) << "Benchmark"
+              << std::right << std::setw(15) << "Time (ms)"
+              << std::setw(15) << "CPU (ms)"
+              << std::setw(12) << "Iterations"
+              << std::setw(12) << "GFLOP/s" << std::endl;
+    std::cout << std::string(124,'-') << std::endl;
+  }
+
+  ~BenchmarkSuite()
+  {
+    this->write_json();
+  }
+
+  /**
+   * Runs the case @p name with parameters @p params. The function @p setup
+   * is called once and must return the callable object that is timed
+   * (e.g. the loop over the elements with the cache fill).
+   * If @p n_flops (the number of floating point operations performed by
+   * one call of the timed object) is positive, the GFLOP/s are reported.
+   */
+  template <class Setup>
+  void run(const std::string &name, const Params &params, const Setup &setup,
+           const double n_flops = 0.0)
+  {
+    std::string full_name = name;
+    for (const auto &p : params)
+      full_name += "/" + p.first + ":" + std::to_string(p.second);
+
+    if (full_name.find(filter_) == std::string::npos)
+      return;
+
+    auto func = setup();
+
+    // warm up (it also initializes the caches built at the first call)
+    func();
+
+    using Clock = std::chrono::steady_clock;
+    long n_iterations = 0;
+    double real_time = 0.0;
+    const std::clock_t cpu_start = std::clock();
+    const auto start = Clock::now();
+    while (real_time < min_time_ || n_iterations == 0)
+    {
+      func();
+      ++n_iterations;
+      real_time = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    const double cpu_time = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    Result res;
+    res.name = full_name;
+    res.params = params;
+    res.n_iterations = n_iterations;
+    res.real_time = 1.0e3 * real_time / n_iterations;
+    res.cpu_time = 1.0e3 * cpu_time / n_iterations;
+    res.gflops = (n_flops > 0.0) ? 1.0e-6 * n_flops / res.real_time : 0.0;
+    results_.push_back(res);
+
+    std::cout << std::left << std::setw(70) << res.name
+              << std::right << std::setw(15) << std::setprecision(6) << res.real_time
+              << std::setw(15) << res.cpu_time
+              << std::setw(12) << res.n_iterations;
+    if (res.gflops > 0.0)
+      std::cout << std::setw(12) << std::setprecision(4) << res.gflops;
+    std::cout << std::endl;
+  }
+
+private:
+  struct Result
+  {
+    std::string name;
+    Params params;
+    long n_iterations;
+    double real_time;
+    double cpu_time;
+    double gflops;
+  };
+
+  void write_json() const
+  {
+    std::ofstream file(out_file_);
+
+    const std::time_t now = std::time(nullptr);
+    char date[64];
+    std::strftime(date,sizeof(date),"%Y-%m-%d %H:%M:%S",std::localtime(&now));
+
+    file << "{" << std::endl;
+    file << "  \"context\": {" << std::endl;
+    file << "    \"date\": \"" << date << "\"," << std::endl;
+    file << "    \"suite\": \"" << suite_name_ << "\"," << std::endl;
+    file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "," << std::endl;
+#ifdef NDEBUG
+    file << "    \"build_type\": \"release\"" << std::endl;
+#else
+    file << "    \"build_type\": \"debug\"" << std::endl;
+#endif
+    file << "  }," << std::endl;
+    file << "  \"benchmarks\": [" << std::endl;
+    for (std::size_t i = 0 ; i < results_.size() ; ++i)
+    {
+      const auto &res = results_[i];
+      file << "    {" << std::endl;
+      file << "      \"name\": \"" << res.name << "\"," << std::endl;
+      for (const auto &p : res.params)
+        file << "      \"" << p.first << "\": " << p.second << "," << std::endl;
+      file << "      \"iterations\": " << res.n_iterations << "," << std::endl;
+      file << "      \"real_time\": " << std::setprecision(10) << res.real_time << "," << std::endl;
+      file << "      \"cpu_time\": " << res.cpu_time << "," << std::endl;
+      if (res.gflops > 0.0)
+        file << "      \"GFLOPS\": " << res.gflops << "," << std::endl;
+      file << "      \"time_unit\": \"ms\"" << std::endl;
+      file << "    }" << (i+1 < results_.size() ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+  }
+
+  std::string suite_name_;
+
+  std::string out_file_;
+
+  std::string filter_;
+
+  double min_time_ = 0.5;
+
+  std::vector<Result> results_;
+};
+
+#endif // __BENCHMARK_H_
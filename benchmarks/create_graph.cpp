@@ -0,0 +1,117 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the construction of the sparsity pattern of the
+ *  matrix associated to a BSpline basis (create_sparsity_pattern(), using the
+ *  tensor-product and the element connectivity algorithms) and of the
+ *  corresponding Epetra graph (EpetraTools::create_graph()).
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/linear_algebra/sparsity_pattern.h>
+#ifdef IGATOOLS_USES_TRILINOS
+#include <igatools/linear_algebra/epetra_graph.h>
+#endif // IGATOOLS_USES_TRILINOS
+
+#include <cmath>
+
+
+enum class Algorithm {tensor_product, element, epetra_graph};
+
+
+template <int dim>
+void create_graph(BenchmarkSuite &suite,
+                  const Algorithm algorithm,
+                  const int deg, const int n_elems_dir, const int n_threads)
+{
+  std::string name;
+  switch (algorithm)
+  {
+    case Algorithm::tensor_product:
+      name = "create_tensor_product_pattern";
+      break;
+    case Algorithm::element:
+      name = "create_element_pattern";
+      break;
+    case Algorithm::epetra_graph:
+      name = "EpetraTools::create_graph";
+      break;
+  }
+
+  suite.run(name,
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)},{"n_threads",n_threads}},
+  [&]() -> std::function<void()>
+  {
+    auto grid = Grid<dim>::const_create(n_elems_dir+1);
+    auto basis = BSpline<dim>::const_create(SplineSpace<dim>::const_create(deg,grid));
+    const auto &prop = DofProperties::active;
+
+    if (algorithm == Algorithm::tensor_product)
+      return [basis,prop,n_threads]()
+    {
+      const auto &space = *basis->get_spline_space();
+      sparsity_pattern_tools::create_tensor_product_pattern(space,prop,space,prop,n_threads);
+    };
+    else if (algorithm == Algorithm::element)
+      return [basis,prop,n_threads]()
+    {
+      const auto &space = *basis->get_spline_space();
+      sparsity_pattern_tools::create_element_pattern(space,prop,space,prop,n_threads);
+    };
+#ifdef IGATOOLS_USES_TRILINOS
+    else
+      return [basis,prop,n_threads]()
+    {
+      Epetra_SerialComm comm;
+      EpetraTools::create_graph(*basis,prop,*basis,prop,comm,n_threads);
+    };
+#endif // IGATOOLS_USES_TRILINOS
+
+    return []() {};
+  });
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("create_graph",argc,argv);
+
+  std::vector<Algorithm> algorithms = {Algorithm::tensor_product, Algorithm::element};
+#ifdef IGATOOLS_USES_TRILINOS
+  algorithms.emplace_back(Algorithm::epetra_graph);
+#endif // IGATOOLS_USES_TRILINOS
+
+  for (const auto algorithm : algorithms)
+    for (const int n_threads : {1,4})
+      for (const int deg : {1,2,3})
+      {
+        create_graph<1>(suite,algorithm,deg,4096,n_threads);
+        create_graph<2>(suite,algorithm,deg,64,n_threads);
+        create_graph<3>(suite,algorithm,deg,16,n_threads);
+      }
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the element cache fill of a Domain (DomainHandler),
+ *  with a non-linear (analytical) geometry: points, weighted measures and inverse
+ *  jacobians on all the active elements of the grid.
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/functions/grid_function_lib.h>
+#include <igatools/geometry/domain.h>
+#include <igatools/geometry/domain_element.h>
+#include <igatools/geometry/domain_handler.h>
+
+#include <cmath>
+
+
+template <int dim>
+void domain_fill_cache(BenchmarkSuite &suite, const int deg, const int n_elems_dir)
+{
+  suite.run("DomainHandler::fill_cache",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    BBox<dim> box;
+    box[0] = {0.5, 1.};
+    for (int i = 1 ; i < dim ; ++i)
+      box[i] = {0., M_PI / 2.};
+
+    auto grid = Grid<dim>::const_create(box,n_elems_dir+1);
+    auto domain = Domain<dim,0>::const_create(
+                    grid_functions::BallGridFunction<dim>::const_create(grid));
+
+    using Flags = domain_element::Flags;
+    auto quad = QGauss<dim>::create(deg+1);
+    auto handler = std::shared_ptr<DomainHandler<dim,0>>(domain->create_cache_handler());
+    handler->set_element_flags(Flags::point | Flags::w_measure | Flags::inv_jacobian);
+
+    using ElementIterator = typename Domain<dim,0>::ElementIterator;
+    auto elem = std::make_shared<ElementIterator>(domain->begin());
+    auto end = std::make_shared<ElementIterator>(domain->end());
+    handler->init_element_cache(*elem,quad);
+    const auto first_id = (*elem)->get_index();
+
+    return [handler,elem,end,first_id]()
+    {
+      (*elem)->move_to(first_id);
+      for (; *elem != *end ; ++(*elem))
+        handler->fill_element_cache(*elem);
+    };
+  });
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("domain_handler_fill_cache",argc,argv);
+
+  // the number of quadrature points per direction is degree+1
+  for (const int deg : {1,2,3,5})
+  {
+    domain_fill_cache<1>(suite,deg,1024);
+    domain_fill_cache<2>(suite,deg,32);
+    domain_fill_cache<3>(suite,deg,8);
+  }
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the solution of the Poisson problem (homogeneous Dirichlet
+ *  conditions) with the CG method: ML preconditioner (default of
+ *  EpetraTools::create_solver()) vs. fast diagonalization preconditioner
+ *  (EpetraTools::FastDiagonalization), and setup of the latter.
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/basis_tools.h>
+#ifdef IGATOOLS_USES_TRILINOS
+#include <igatools/linear_algebra/epetra_solver.h>
+#include <igatools/linear_algebra/epetra_fast_diagonalization.h>
+#include <igatools/linear_algebra/dof_tools.h>
+#endif // IGATOOLS_USES_TRILINOS
+
+#ifdef IGATOOLS_USES_TRILINOS
+
+enum class Preconditioner {ml, fast_diagonalization};
+
+
+template <int dim>
+EpetraTools::MatrixPtr
+assemble_stiffness(const BSpline<dim> &basis, const int deg, const Epetra_SerialComm &comm)
+{
+  auto matrix = EpetraTools::create_matrix(basis,DofProperties::active,comm);
+
+  using Flags = basis_element::Flags;
+  auto handler = basis.create_cache_handler();
+  handler->set_element_flags(Flags::gradient | Flags::w_measure);
+
+  auto elem = basis.begin();
+  const auto end = basis.end();
+  handler->init_element_cache(elem,QGauss<dim>::create(deg+1));
+  for (; elem != end; ++elem)
+  {
+    handler->fill_element_cache(elem);
+    const auto &grad_phi = elem->get_element_gradients();
+    const auto w_meas = elem->get_element_w_measures();
+
+    const int n_basis = elem->get_num_basis();
+    const int n_pts = w_meas.size();
+    DenseMatrix loc_mat(n_basis,n_basis);
+    loc_mat = 0.0;
+    for (int i = 0 ; i < n_basis ; ++i)
+    {
+      const auto grad_phi_i = grad_phi.get_function_view(i);
+      for (int j = 0 ; j < n_basis ; ++j)
+      {
+        const auto grad_phi_j = grad_phi.get_function_view(j);
+        for (int q = 0 ; q < n_pts ; ++q)
+          loc_mat(i,j) += w_meas[q] * scalar_product(grad_phi_i[q],grad_phi_j[q]);
+      }
+    }
+
+    const auto loc_dofs = elem->get_local_to_global(DofProperties::active);
+    matrix->add_block(loc_dofs,loc_dofs,loc_mat);
+  }
+  matrix->FillComplete();
+
+  return matrix;
+}
+
+
+
+template <int dim>
+void solve(BenchmarkSuite &suite, const Preconditioner prec_type,
+           const int deg, const int n_elems_dir)
+{
+  suite.run(prec_type == Preconditioner::ml ? "CG + ML" :
+            "CG + FastDiagonalization",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    auto grid = Grid<dim>::create(n_elems_dir+1);
+    auto basis = BSpline<dim>::create(SplineSpace<dim>::create(deg,grid));
+
+    auto comm = std::make_shared<Epetra_SerialComm>();
+    auto matrix = assemble_stiffness(*basis,deg,*comm);
+    auto rhs = EpetraTools::create_vector(matrix->RangeMap());
+    auto sol = EpetraTools::create_vector(matrix->DomainMap());
+    rhs->PutScalar(1.0);
+
+    std::set<int> faces;
+    for (int s_id = 0 ; s_id < UnitElement<dim>::n_faces ; ++s_id)
+      faces.insert(s_id);
+    std::map<Index,Real> bndry_values;
+    for (const auto dof : basis_tools::get_boundary_dofs<BSpline<dim>>(basis,faces))
+      bndry_values[dof] = 0.0;
+    dof_tools::apply_boundary_values(bndry_values,*matrix,*rhs,*sol);
+
+    std::shared_ptr<EpetraTools::FastDiagonalization<dim>> prec;
+    if (prec_type == Preconditioner::fast_diagonalization)
+      prec = std::make_shared<EpetraTools::FastDiagonalization<dim>>(*basis,*comm,faces);
+
+    return [comm,matrix,rhs,sol,prec]()
+    {
+      sol->PutScalar(0.0);
+      auto solver = prec ?
+                    EpetraTools::create_solver(*matrix,*sol,*rhs,*prec,"CG",1.0e-8,1000) :
+                    EpetraTools::create_solver(*matrix,*sol,*rhs,"CG",1.0e-8,1000);
+      solver->solve();
+    };
+  });
+}
+
+
+
+template <int dim>
+void setup(BenchmarkSuite &suite, const int deg, const int n_elems_dir)
+{
+  suite.run("FastDiagonalization setup",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    auto grid = Grid<dim>::create(n_elems_dir+1);
+    auto basis = BSpline<dim>::create(SplineSpace<dim>::create(deg,grid));
+    auto comm = std::make_shared<Epetra_SerialComm>();
+
+    std::set<int> faces;
+    for (int s_id = 0 ; s_id < UnitElement<dim>::n_faces ; ++s_id)
+      faces.insert(s_id);
+
+    return [basis,comm,faces]()
+    {
+      EpetraTools::FastDiagonalization<dim> prec(*basis,*comm,faces);
+    };
+  });
+}
+
+#endif // IGATOOLS_USES_TRILINOS
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("fast_diagonalization",argc,argv);
+
+#ifdef IGATOOLS_USES_TRILINOS
+  for (const int deg : {1,2,3,5})
+  {
+    solve<2>(suite,Preconditioner::ml,deg,64);
+    solve<2>(suite,Preconditioner::fast_diagonalization,deg,64);
+    solve<3>(suite,Preconditioner::ml,deg,12);
+    solve<3>(suite,Preconditioner::fast_diagonalization,deg,12);
+
+    setup<2>(suite,deg,64);
+    setup<3>(suite,deg,12);
+  }
+#endif // IGATOOLS_USES_TRILINOS
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the computation of the local mass and stiffness matrices
+ *  of a BSpline basis, using the sum-factorization approach
+ *  (EllipticOperatorsSFIntegrationBSpline) and the standard quadrature loop
+ *  (BasisElement::integrate_u_v() and BasisElement::integrate_gradu_gradv()).
+ *  The timings include the element cache fill, that is the same for both approaches.
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/bspline_handler.h>
+
+#include <cmath>
+
+
+enum class Integration {standard, sum_factorization};
+
+enum class Operator {u_v, gradu_gradv};
+
+
+template <int dim>
+void local_matrix(BenchmarkSuite &suite,
+                  const Integration integration,
+                  const Operator op,
+                  const int deg, const int n_elems_dir)
+{
+  std::string name = (integration == Integration::standard) ?
+                     "StdIntegration" : "SFIntegrationBSpline";
+  name += (op == Operator::u_v) ? "::u_v" : "::gradu_gradv";
+
+  suite.run(name,
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    auto grid = Grid<dim>::const_create(n_elems_dir+1);
+    auto basis = BSpline<dim>::const_create(SplineSpace<dim>::const_create(deg,grid));
+
+    using Flags = basis_element::Flags;
+    auto quad = QGauss<dim>::create(deg+1);
+    auto handler = std::shared_ptr<BasisHandler<dim,0,1,1>>(basis->create_cache_handler());
+    handler->set_element_flags(Flags::value | Flags::gradient | Flags::w_measure);
+
+    using ElementIterator = typename BSpline<dim>::ElementIterator;
+    auto elem = std::make_shared<ElementIterator>(basis->begin());
+    auto end = std::make_shared<ElementIterator>(basis->end());
+    handler->init_element_cache(*elem,quad);
+    const auto first_id = (*elem)->get_index();
+
+    return [handler,elem,end,first_id,integration,op]()
+    {
+      (*elem)->move_to(first_id);
+      for (; *elem != *end ; ++(*elem))
+      {
+        handler->fill_element_cache(*elem);
+
+        auto &bsp_elem = **elem;
+        DenseMatrix loc_mat;
+        if (integration == Integration::standard)
+          loc_mat = (op == Operator::u_v) ?
+                    bsp_elem.template integrate_u_v<dim>(0) :
+                    bsp_elem.template integrate_gradu_gradv<dim>(0);
+        else
+          loc_mat = (op == Operator::u_v) ?
+                    bsp_elem.integrate_u_v_sum_factorization_impl(Topology<dim>(),0) :
+                    bsp_elem.integrate_gradu_gradv_sum_factorization_impl(Topology<dim>(),0);
+      }
+    };
+  });
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("local_matrix_integration",argc,argv);
+
+  for (const auto op : {Operator::u_v, Operator::gradu_gradv})
+    for (const auto integration : {Integration::standard, Integration::sum_factorization})
+      for (const int deg : {1,2,3,5})
+      {
+        local_matrix<1>(suite,integration,op,deg,256);
+        local_matrix<2>(suite,integration,op,deg,16);
+        local_matrix<3>(suite,integration,op,deg,4);
+      }
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the parsing of long whitespace separated lists of numbers,
+ *  as the IgCoefficients and the knot vectors of the XML files:
+ *  number_parser::parse_values() compared with the extraction from a
+ *  std::stringstream. The text is generated with the same format (and
+ *  precision) used by ObjectsContainerXMLWriter.
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/utils/number_parser.h>
+
+#include <cmath>
+
+
+/**
+ * Returns the text with the @p n_values values, written as
+ * ObjectsContainerXMLWriter does.
+ */
+template <class T>
+std::string generate_text(const Index n_values)
+{
+  std::ostringstream os;
+  os.precision(std::numeric_limits<Real>::digits10);
+  for (Index i = 0 ; i < n_values ; ++i)
+  {
+    if (std::is_integral<T>::value)
+      os << ((i * 7919) % n_values) << " ";
+    else
+      os << std::sin(0.37 * i) * std::pow(10.0, (i % 7) - 3) << " ";
+    if (i % 10 == 9)
+      os << std::endl;
+  }
+  return os.str();
+}
+
+
+
+template <class T>
+void parse_values(BenchmarkSuite &suite, const std::string &type_name, const Index n_values)
+{
+  const std::string text = generate_text<T>(n_values);
+
+  suite.run("std::stringstream<" + type_name + ">", {{"n_values",n_values}},
+            [&]()
+  {
+    return [&text]()
+    {
+      SafeSTLVector<T> data;
+      T v;
+      std::stringstream line_stream(text);
+      while (line_stream >> v)
+        data.push_back(v);
+    };
+  });
+
+  suite.run("number_parser::parse_values<" + type_name + ">", {{"n_values",n_values}},
+            [&]()
+  {
+    return [&text]()
+    {
+      number_parser::parse_values<T>(text.data(), text.size());
+    };
+  });
+
+  // The same text stored with 16 bits characters (as the XMLCh of Xerces-c).
+  const std::u16string text_16(text.cbegin(), text.cend());
+  suite.run("number_parser::parse_values<" + type_name + ",char16_t>", {{"n_values",n_values}},
+            [&]()
+  {
+    return [&text_16]()
+    {
+      number_parser::parse_values<T>(text_16.data(), text_16.size());
+    };
+  });
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("number_parser",argc,argv);
+
+  for (const Index n_values : {10000, 1000000, 5000000})
+  {
+    parse_values<Real>(suite,"Real",n_values);
+    parse_values<Index>(suite,"Index",n_values);
+  }
+
+  return 0;
+}
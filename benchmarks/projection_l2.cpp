@@ -0,0 +1,89 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the L2 projection of a grid function onto a BSpline basis:
+ *  assembled mass matrix solved with Belos + ML (projection_l2_grid_function)
+ *  vs. Kronecker-product univariate banded solves
+ *  (fast_projection_l2_grid_function).
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/functions/grid_function_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/basis_tools.h>
+
+#include <cmath>
+
+
+template <int dim>
+void projection_l2(BenchmarkSuite &suite, const bool fast, const int deg, const int n_elems_dir)
+{
+  suite.run(fast ? "basis_tools::fast_projection_l2_grid_function" :
+            "basis_tools::projection_l2_grid_function",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    auto grid = Grid<dim>::const_create(n_elems_dir+1);
+    auto basis = BSpline<dim>::const_create(SplineSpace<dim>::const_create(deg,grid));
+
+    typename grid_functions::LinearGridFunction<dim,1>::Gradient A;
+    typename grid_functions::LinearGridFunction<dim,1>::Value b;
+    for (int i = 0 ; i < dim ; ++i)
+      A[0][i] = i+1;
+    b[0] = 1.0;
+    auto f = grid_functions::LinearGridFunction<dim,1>::const_create(grid,A,b);
+    auto quad = QGauss<dim>::const_create(deg+1);
+
+    return [basis,f,quad,fast]()
+    {
+      IgCoefficients coeffs;
+      if (fast)
+        coeffs = basis_tools::fast_projection_l2_grid_function<dim,1>(*f,*basis,quad);
+#ifdef IGATOOLS_USES_TRILINOS
+      else
+        coeffs = basis_tools::projection_l2_grid_function<dim,1>(*f,*basis,quad);
+#endif // IGATOOLS_USES_TRILINOS
+    };
+  });
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("projection_l2",argc,argv);
+
+  for (const int deg : {1,2,3,5})
+  {
+#ifdef IGATOOLS_USES_TRILINOS
+    projection_l2<2>(suite,false,deg,64);
+    projection_l2<3>(suite,false,deg,12);
+#endif // IGATOOLS_USES_TRILINOS
+    projection_l2<2>(suite,true,deg,64);
+    projection_l2<3>(suite,true,deg,12);
+  }
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the cache fill on the elements and on the faces of the
+ *  grid (GridHandler) and of the BSpline basis (BSplineHandler).
+ *  The quadratures extended to the sub-elements are computed once in
+ *  init_cache(): the fill cost does not include their construction.
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/geometry/grid.h>
+#include <igatools/geometry/grid_element.h>
+#include <igatools/geometry/grid_handler.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/bspline_handler.h>
+
+
+template <int dim>
+void grid_fill_element_cache(BenchmarkSuite &suite, const int n_qp, const int n_elems_dir)
+{
+  suite.run("GridHandler::fill_element_cache",
+  {{"dim",dim},{"n_qp",n_qp},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    using Flags = grid_element::Flags;
+
+    auto grid = Grid<dim>::const_create(n_elems_dir+1);
+    auto handler = std::shared_ptr<GridHandler<dim>>(grid->create_cache_handler());
+    handler->set_element_flags(Flags::point | Flags::weight);
+
+    auto elem = std::make_shared<typename Grid<dim>::ElementIterator>(grid->begin());
+    auto end = std::make_shared<typename Grid<dim>::ElementIterator>(grid->end());
+    handler->init_element_cache(*elem,QGauss<dim>::create(n_qp));
+    const auto first_id = (*elem)->get_index();
+
+    return [grid,handler,elem,end,first_id]()
+    {
+      (*elem)->move_to(first_id);
+      for (; *elem != *end ; ++(*elem))
+        handler->fill_element_cache(*elem);
+    };
+  });
+}
+
+
+
+template <int dim>
+void grid_fill_face_cache(BenchmarkSuite &suite, const int n_qp, const int n_elems_dir)
+{
+  suite.run("GridHandler::fill_face_cache",
+  {{"dim",dim},{"n_qp",n_qp},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    using Flags = grid_element::Flags;
+
+    auto grid = Grid<dim>::const_create(n_elems_dir+1);
+    auto handler = std::shared_ptr<GridHandler<dim>>(grid->create_cache_handler());
+    handler->template set_flags<dim-1>(Flags::point | Flags::weight);
+
+    auto elem = std::make_shared<typename Grid<dim>::ElementIterator>(grid->begin());
+    auto end = std::make_shared<typename Grid<dim>::ElementIterator>(grid->end());
+    handler->init_face_cache(*elem,QGauss<dim-1>::create(n_qp));
+    const auto first_id = (*elem)->get_index();
+
+    return [grid,handler,elem,end,first_id]()
+    {
+      (*elem)->move_to(first_id);
+      for (; *elem != *end ; ++(*elem))
+        for (const int s_id : UnitElement<dim>::template elems_ids<dim-1>())
+          handler->fill_face_cache(*elem,s_id);
+    };
+  });
+}
+
+
+
+template <int dim>
+void bspline_fill_face_cache(BenchmarkSuite &suite, const int deg, const int n_elems_dir)
+{
+  suite.run("BSplineHandler::fill_face_cache",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    using Flags = basis_element::Flags;
+
+    auto grid = Grid<dim>::const_create(n_elems_dir+1);
+    std::shared_ptr<const Basis<dim,0,1,1>> basis =
+      BSpline<dim>::const_create(SplineSpace<dim>::const_create(deg,grid));
+    auto handler = std::shared_ptr<BasisHandler<dim,0,1,1>>(basis->create_cache_handler());
+    handler->template set_flags<dim-1>(Flags::value | Flags::gradient);
+
+    auto elem = std::make_shared<typename Basis<dim,0,1,1>::ElementIterator>(basis->begin());
+    auto end = std::make_shared<typename Basis<dim,0,1,1>::ElementIterator>(basis->end());
+    handler->init_face_cache(*elem,QGauss<dim-1>::create(deg+1));
+    const auto first_id = (*elem)->get_index();
+
+    return [basis,handler,elem,end,first_id]()
+    {
+      (*elem)->move_to(first_id);
+      for (; *elem != *end ; ++(*elem))
+        for (const int s_id : UnitElement<dim>::template elems_ids<dim-1>())
+          handler->fill_face_cache(*elem,s_id);
+    };
+  });
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("sub_elem_fill_cache",argc,argv);
+
+  for (const int n_qp : {2,4,6})
+  {
+    grid_fill_element_cache<2>(suite,n_qp,32);
+    grid_fill_element_cache<3>(suite,n_qp,8);
+    grid_fill_face_cache<2>(suite,n_qp,32);
+    grid_fill_face_cache<3>(suite,n_qp,8);
+  }
+
+  for (const int deg : {1,2,3,5})
+  {
+    bspline_fill_face_cache<2>(suite,deg,32);
+    bspline_fill_face_cache<3>(suite,deg,8);
+  }
+
+  return 0;
+}
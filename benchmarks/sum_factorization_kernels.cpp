@@ -0,0 +1,207 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the computation of a 3D local operator with the sum-factorization
+ *  technique (IntegratorSumFactorization<3>), for the degrees from 2 to 8.
+ *  The vectorized kernels (one case for each instruction set supported by the
+ *  processor) are compared with a scalar implementation of the loops used
+ *  before the introduction of the kernels (the "legacy" case).
+ *  The GFLOP/s are computed with the number of operations of the
+ *  three contractions (without the padding of the panels).
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/operators/integrator_sum_factorization.h>
+#include <igatools/operators/sum_factorization_kernels.h>
+
+#include <numeric>
+#include <random>
+
+using namespace sum_factorization_kernels;
+
+
+/**
+ * Scalar sum-factorization with the loop structure used before the
+ * introduction of the vectorized kernels: each entry of the partial contractions
+ * is computed as an inner product along the quadrature points.
+ */
+class LegacyIntegrator
+{
+public:
+  LegacyIntegrator(const TensorSize<3> &t_size_theta,
+                   const TensorSize<3> &t_size_alpha,
+                   const TensorSize<3> &t_size_beta)
+    :
+    T_(t_size_theta),
+    A_(t_size_alpha),
+    B_(t_size_beta),
+    C1_(T_[1] * T_[2] * A_[0] * B_[0]),
+    C2_(T_[2] * A_[0] * A_[1] * B_[0] * B_[1])
+  {}
+
+  void operator()(const SafeSTLArray<DynamicMultiArray<Real,3>,3> &J,
+                  const DynamicMultiArray<Real,3> &C,
+                  DenseMatrix &local_operator)
+  {
+    const Size T_12 = T_[1] * T_[2];
+
+    // C1(theta_1 theta_2,alpha_0,beta_0)
+    for (Index ab_0 = 0 ; ab_0 < A_[0] * B_[0] ; ++ab_0)
+    {
+      const Real *const J0 = &J[0][ab_0 * T_[0]];
+      for (Index t_12 = 0 ; t_12 < T_12 ; ++t_12)
+      {
+        const Real *const C_it = &C[t_12 * T_[0]];
+        C1_[ab_0 * T_12 + t_12] = std::inner_product(J0, J0 + T_[0], C_it, 0.0);
+      }
+    }
+
+    // C2(theta_2,alpha_0 alpha_1,beta_0 beta_1)
+    for (Index b_1 = 0 ; b_1 < B_[1] ; ++b_1)
+      for (Index b_0 = 0 ; b_0 < B_[0] ; ++b_0)
+        for (Index a_1 = 0 ; a_1 < A_[1] ; ++a_1)
+        {
+          const Real *const J1 = &J[1][(b_1 * A_[1] + a_1) * T_[1]];
+          for (Index a_0 = 0 ; a_0 < A_[0] ; ++a_0)
+          {
+            const Real *const C1_it = &C1_[(b_0 * A_[0] + a_0) * T_12];
+            const Index b_01 = b_1 * B_[0] + b_0;
+            const Index a_01 = a_1 * A_[0] + a_0;
+            Real *const C2_it = &C2_[(b_01 * A_[0] * A_[1] + a_01) * T_[2]];
+            for (Index t_2 = 0 ; t_2 < T_[2] ; ++t_2)
+              C2_it[t_2] = std::inner_product(J1, J1 + T_[1], C1_it + t_2 * T_[1], 0.0);
+          }
+        }
+
+    // local operator
+    const Size A_01 = A_[0] * A_[1];
+    const Size B_01 = B_[0] * B_[1];
+    for (Index b_2 = 0 ; b_2 < B_[2] ; ++b_2)
+      for (Index b_01 = 0 ; b_01 < B_01 ; ++b_01)
+        for (Index a_2 = 0 ; a_2 < A_[2] ; ++a_2)
+        {
+          const Real *const J2 = &J[2][(b_2 * A_[2] + a_2) * T_[2]];
+          for (Index a_01 = 0 ; a_01 < A_01 ; ++a_01)
+          {
+            const Real *const C2_it = &C2_[(b_01 * A_01 + a_01) * T_[2]];
+            local_operator(b_2 * B_01 + b_01, a_2 * A_01 + a_01) +=
+              std::inner_product(J2, J2 + T_[2], C2_it, 0.0);
+          }
+        }
+  }
+
+private:
+  TensorSize<3> T_;
+  TensorSize<3> A_;
+  TensorSize<3> B_;
+  std::vector<Real> C1_;
+  std::vector<Real> C2_;
+};
+
+
+
+void local_operator(BenchmarkSuite &suite, const int deg, const bool legacy,
+                    const InstructionSet instruction_set = InstructionSet::scalar)
+{
+  const int n_pts = deg + 1;
+  const int n_basis = deg + 1;
+
+  TensorSize<3> t_size_theta(n_pts);
+  TensorSize<3> t_size_alpha(n_basis);
+  TensorSize<3> t_size_beta(n_basis);
+
+  // number of floating point operations of the three contractions
+  const double n_flops =
+    2.0 * n_basis * n_basis * n_pts * n_pts * n_pts +
+    2.0 * std::pow(n_basis,4) * n_pts * n_pts +
+    2.0 * std::pow(n_basis,6) * n_pts;
+
+  const std::string name = legacy ?
+                           "SumFactorization::legacy" :
+                           "SumFactorization::" + get_name(instruction_set);
+
+  suite.run(name, {{"dim",3},{"degree",deg}},
+            [&]()
+  {
+    std::mt19937 gen(deg);
+    std::uniform_real_distribution<Real> dist(-1.0,1.0);
+
+    auto J = std::make_shared<SafeSTLArray<DynamicMultiArray<Real,3>,3>>();
+    TensorSize<3> t_size_J;
+    t_size_J[0] = n_pts;
+    t_size_J[1] = n_basis;
+    t_size_J[2] = n_basis;
+    for (auto &J_dir : *J)
+    {
+      J_dir.resize(t_size_J);
+      for (Index i = 0 ; i < J_dir.flat_size() ; ++i)
+        J_dir[i] = dist(gen);
+    }
+
+    auto C = std::make_shared<DynamicMultiArray<Real,3>>(t_size_theta);
+    for (Index i = 0 ; i < C->flat_size() ; ++i)
+      (*C)[i] = dist(gen);
+
+    const int n_rows = t_size_beta.flat_size();
+    const int n_cols = t_size_alpha.flat_size();
+    auto op = std::make_shared<DenseMatrix>(n_rows,n_cols);
+
+    auto legacy_integrator =
+      std::make_shared<LegacyIntegrator>(t_size_theta,t_size_alpha,t_size_beta);
+    auto workspace = std::make_shared<SumFactorizationWorkspace<3>>(n_basis,n_pts);
+
+    set_instruction_set(instruction_set);
+
+    return [=]()
+    {
+      *op = 0.0;
+      if (legacy)
+        (*legacy_integrator)(*J,*C,*op);
+      else
+        IntegratorSumFactorization<3>()(false,
+                                        t_size_theta,t_size_alpha,t_size_beta,
+                                        *J,*C,
+                                        0,n_rows-1,
+                                        0,n_cols-1,
+                                        *workspace,
+                                        *op);
+    };
+  },
+  n_flops);
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("sum_factorization_kernels",argc,argv);
+
+  for (int deg = 2 ; deg <= 8 ; ++deg)
+  {
+    local_operator(suite,deg,true);
+    for (int i = 0 ; i <= static_cast<int>(get_best_instruction_set()) ; ++i)
+      local_operator(suite,deg,false,static_cast<InstructionSet>(i));
+  }
+
+  return 0;
+}
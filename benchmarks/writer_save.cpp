@@ -0,0 +1,81 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for Writer::save(), in the "ascii" and "appended" formats,
+ *  for a Domain with a non-linear (analytical) geometry and a cell data field.
+ *
+ */
+
+#include "benchmark.h"
+
+#include <igatools/functions/grid_function_lib.h>
+#include <igatools/geometry/domain.h>
+#include <igatools/io/writer.h>
+
+
+template <int dim>
+void writer_save(BenchmarkSuite &suite, const std::string &format,
+                 const int n_plot_points, const int n_elems_dir)
+{
+  suite.run("Writer::save/" + format,
+  {{"dim",dim},{"n_plot_points",n_plot_points},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    BBox<dim> box;
+    box[0] = {0.5, 1.};
+    for (int i = 1 ; i < dim ; ++i)
+      box[i] = {0., M_PI / 2.};
+
+    auto grid = Grid<dim>::const_create(box,n_elems_dir+1);
+    auto domain = Domain<dim,0>::const_create(
+                    grid_functions::BallGridFunction<dim>::const_create(grid));
+
+    auto writer = std::make_shared<Writer<dim>>(domain,n_plot_points);
+
+    SafeSTLVector<double> elem_data(grid->get_num_all_elems());
+    for (int i = 0 ; i < elem_data.size() ; ++i)
+      elem_data[i] = i;
+    writer->add_element_data(elem_data,"element id");
+
+    const std::string filename = "writer_save_" + std::to_string(dim) + "d_" + format;
+    return [writer,filename,format]()
+    {
+      writer->save(filename,format);
+    };
+  });
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("writer_save",argc,argv);
+
+  for (const std::string format : {"ascii","appended"})
+    for (const int n_plot_points : {2,5})
+    {
+      writer_save<1>(suite,format,n_plot_points,1024);
+      writer_save<2>(suite,format,n_plot_points,32);
+      writer_save<3>(suite,format,n_plot_points,8);
+    }
+
+  return 0;
+}
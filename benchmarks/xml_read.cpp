@@ -0,0 +1,97 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Benchmark for the parsing of an XML file (ObjectsContainerXMLReader::parse())
+ *  containing a Domain defined by an IgGridFunction (with BSpline basis).
+ *  The input files are generated with ObjectsContainerXMLWriter, with the
+ *  numeric arrays written in the XML text or in a binary sidecar file.
+ *
+ */
+
+#include "benchmark.h"
+
+#ifdef IGATOOLS_WITH_XML_IO
+
+#include <igatools/base/objects_container.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/functions/ig_grid_function.h>
+#include <igatools/geometry/domain.h>
+#include <igatools/io/objects_container_xml_reader.h>
+#include <igatools/io/objects_container_xml_writer.h>
+
+
+template <int dim>
+void xml_read(BenchmarkSuite &suite, const int deg, const int n_elems_dir,
+              const bool binary_sidecar)
+{
+  suite.run(binary_sidecar ? "ObjectsContainerXMLReader::parse(sidecar)" :
+            "ObjectsContainerXMLReader::parse",
+  {{"dim",dim},{"degree",deg},{"n_elems",std::pow(n_elems_dir,dim)}},
+  [&]()
+  {
+    auto grid = Grid<dim>::create(n_elems_dir+1);
+    auto basis = BSpline<dim,dim>::create(SplineSpace<dim,dim>::create(deg,grid));
+
+    const auto &dofs = basis->get_spline_space()->get_dof_distribution()->get_global_dofs();
+    IgCoefficients coeffs(dofs);
+    for (const auto dof : dofs)
+      coeffs[dof] = 1.0 / (dof + 1);
+
+    auto domain = Domain<dim>::create(IgGridFunction<dim,dim>::create(basis,coeffs));
+    domain->set_name("domain");
+
+    const auto container = ObjectsContainer::create();
+    container->insert_object<Domain<dim>>(domain);
+
+    const std::string filename =
+      "xml_read_" + std::to_string(dim) + "d_" + std::to_string(deg) +
+      (binary_sidecar ? "_sidecar" : "") + ".xml";
+    ObjectsContainerXMLWriter::write(filename,container,binary_sidecar);
+
+    return [filename]()
+    {
+      ObjectsContainerXMLReader::parse(filename);
+    };
+  });
+}
+
+#endif // IGATOOLS_WITH_XML_IO
+
+
+
+int main(int argc, char **argv)
+{
+  BenchmarkSuite suite("xml_read",argc,argv);
+
+#ifdef IGATOOLS_WITH_XML_IO
+  for (const bool binary_sidecar : {false, true})
+    for (const int deg : {1,2,3})
+    {
+      xml_read<1>(suite,deg,1024,binary_sidecar);
+      xml_read<2>(suite,deg,32,binary_sidecar);
+      xml_read<3>(suite,deg,8,binary_sidecar);
+    }
+#else
+  std::cerr << "igatools is configured without XML I/O support: nothing to do." << std::endl;
+#endif // IGATOOLS_WITH_XML_IO
+
+  return 0;
+}
@@ -0,0 +1,27 @@
+#-+--------------------------------------------------------------------
+# Igatools a general purpose Isogeometric analysis library.
+# Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+#
+# This file is part of the igatools library.
+#
+# The igatools library is free software: you can use it, redistribute
+# it and/or modify it under the terms of the GNU General Public
+# License as published by the Free Software Foundation, either
+# version 3 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#-+--------------------------------------------------------------------
+
+#+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+# Find the threads library used by std::thread (Required)
+#-------------------------------------------------------------------------------
+macro(find_threads)
+  set(THREADS_PREFER_PTHREAD_FLAG ON)
+  find_package(Threads REQUIRED)
+endmacro(find_threads)
@@ -27,6 +27,7 @@
 #include <igatools/utils/safe_stl_set.h>
 #include <igatools/utils/safe_stl_vector.h>
 #include <igatools/utils/safe_stl_map.h>
+#include <igatools/utils/index_set.h>
 #include <igatools/utils/element_index.h>
 
 #include <map>
@@ -149,15 +150,31 @@ private:
 
 
 
+/**
+ * Container for the dofs properties.
+ *
+ * The dofs with a given property are stored in an IndexSet (i.e. a dense bitset),
+ * therefore the test of a dof for a property has constant complexity.
+ */
 class PropertiesDofs
-  : public PropertiesIdContainer<int,SafeSTLSet>
+  : public PropertiesIdContainer<int,IndexSet>
 {
-  using base_t = PropertiesIdContainer<int,SafeSTLSet>;
+  using base_t = PropertiesIdContainer<int,IndexSet>;
 
 public:
 
   using typename base_t::List;
 
+  /**
+   * Returns TRUE if the dof @p id has the given @p property.
+   */
+  bool test_id_for_property(const int id, const PropId &property) const;
+
+  /**
+   * Adds the @p offset value to the dofs ids of all the properties.
+   */
+  void add_offset(const int offset);
+
   /**
    * Sets the <tt>status</tt> of the given <tt>property</tt> for the given <tt>id</tt>.
    */
@@ -199,6 +216,38 @@ public:
                                    const List &ids,
                                    const bool status);
 
+  /**
+   * Returns the position of the element @p elem_id in the (sorted) list of elements
+   * having the given @p property, or -1 if the element has not the @p property.
+   *
+   * If the element has the @p property, its position is retrieved in constant time
+   * from an index (one for each property) mapping the element flat ids to the
+   * positions in the list. Otherwise (or if the index is not up to date, e.g. because
+   * the list has been modified directly through operator[]) the position is searched
+   * with a binary search in the list.
+   */
+  Index get_position(const PropId &property,
+                     const ElementIndex<dim> &elem_id) const;
+
+  /**
+   * Rebuilds the index used by get_position() for the given @p property.
+   *
+   * @note It must be called after the list of elements of the @p property is modified
+   * through operator[].
+   */
+  void update_positions(const PropId &property);
+
+  /**
+   * Rebuilds the index used by get_position() for all the properties.
+   */
+  void update_positions();
+
+private:
+  /**
+   * For each property, the position in the property list of the element with a given
+   * flat id (or -1 if the element has not the property).
+   */
+  std::map<PropId,SafeSTLVector<Index>> positions_;
 };
 
 
@@ -210,6 +259,10 @@ using MapStringSetIntAlias = iga::SafeSTLMap<std::string,iga::SafeSTLSet<int>>;
 CEREAL_SPECIALIZE_FOR_ARCHIVE(IArchive,MapStringSetIntAlias,cereal::specialization::member_serialize)
 CEREAL_SPECIALIZE_FOR_ARCHIVE(OArchive,MapStringSetIntAlias,cereal::specialization::member_serialize)
 
+using MapStringIndexSetIntAlias = iga::SafeSTLMap<std::string,iga::IndexSet<int>>;
+CEREAL_SPECIALIZE_FOR_ARCHIVE(IArchive,MapStringIndexSetIntAlias,cereal::specialization::member_serialize)
+CEREAL_SPECIALIZE_FOR_ARCHIVE(OArchive,MapStringIndexSetIntAlias,cereal::specialization::member_serialize)
+
 using MapStringVectorElemIDAlias0 = iga::SafeSTLMap<std::string,iga::SafeSTLVector<iga::ElementIndex<0>>>;
 CEREAL_SPECIALIZE_FOR_ARCHIVE(IArchive,MapStringVectorElemIDAlias0,cereal::specialization::member_serialize)
 CEREAL_SPECIALIZE_FOR_ARCHIVE(OArchive,MapStringVectorElemIDAlias0,cereal::specialization::member_serialize)
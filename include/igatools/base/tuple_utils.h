@@ -24,6 +24,8 @@
 #include <igatools/base/config.h>
 #include <igatools/geometry/unit_element.h>
 #include <igatools/base/quadrature.h>
+#include <igatools/utils/safe_stl_array.h>
+#include <igatools/utils/safe_stl_vector.h>
 
 #include <tuple>
 
@@ -118,6 +120,39 @@ public:
   {
     return boost::fusion::at_key<Topology<sdim>>(*this);
   }
+
+  /**
+   * Sets the quadrature for the <tt>sdim</tt>-dimensional sub-elements and
+   * computes (once) its extension to each of the sub-elements
+   * (see extend_sub_elem_quad()).
+   */
+  template<int sdim>
+  void set_quad(const QuadPtr<sdim> &quad)
+  {
+    Assert(quad != nullptr,ExcNullPtr());
+    this->template get_quad<sdim>() = quad;
+
+    auto &ext_quads = extended_quads_[sdim];
+    const int n_sub_elems = UnitElement<dim>::template num_elem<sdim>();
+    ext_quads.resize(n_sub_elems);
+    for (int s_id = 0 ; s_id < n_sub_elems ; ++s_id)
+      ext_quads[s_id] =
+        std::make_shared<const Quadrature<dim>>(extend_sub_elem_quad<sdim,dim>(*quad,s_id));
+  }
+
+  /**
+   * Returns the quadrature for the <tt>sdim</tt>-dimensional sub-elements
+   * extended to the <tt>s_id</tt>-th sub-element, as computed by set_quad().
+   */
+  template<int sdim>
+  const Quadrature<dim> &get_extended_quad(const int s_id) const
+  {
+    const auto &ext_quads = extended_quads_[sdim];
+    Assert(s_id >= 0 && s_id < Size(ext_quads.size()),
+           ExcIndexRange(s_id,0,ext_quads.size()));
+    Assert(ext_quads[s_id] != nullptr,ExcNullPtr());
+    return *ext_quads[s_id];
+  }
 #if 0
 private:
   /**
@@ -153,6 +188,13 @@ private:
   };
   ///@}
 #endif
+
+private:
+  /**
+   * Quadratures extended to the sub-elements: the entry <tt>[sdim][s_id]</tt>
+   * refers to the <tt>s_id</tt>-th sub-element of dimension <tt>sdim</tt>.
+   */
+  SafeSTLArray<SafeSTLVector<QuadPtr<dim>>,dim+1> extended_quads_;
 };
 
 IGA_NAMESPACE_CLOSE
@@ -29,6 +29,7 @@
 
 #include <igatools/utils/static_multi_array.h>
 #include <igatools/utils/cartesian_product_indexer.h>
+#include <igatools/utils/soa_value_table.h>
 
 #include <igatools/basis_functions/spline_space.h>
 
@@ -219,6 +220,36 @@ public:
   SafeSTLVector<Index>
   get_local_dofs(const std::string &dofs_property = DofProperties::active) const;
 
+  /**
+   * Type of the views on the dofs of the element returned by
+   * get_local_to_global_view(), get_local_to_patch_view() and get_local_dofs_view().
+   */
+  using DofsConstView = ConstContainerView<SafeSTLVector<Index>>;
+
+  /**
+   * \brief Returns a view on the global dofs of the local (non zero) basis functions
+   * on the element, stored in the element-to-dofs table of the SplineSpace
+   * (see SplineSpace::get_element_dofs_table()).
+   *
+   * Unlike get_local_to_global(), the dofs are not copied.
+   */
+  DofsConstView
+  get_local_to_global_view(const std::string &dofs_property = DofProperties::active) const;
+
+  /**
+   * \brief Returns a view on the patch dofs of the local (non zero) basis functions
+   * on the element (see get_local_to_global_view()).
+   */
+  DofsConstView
+  get_local_to_patch_view(const std::string &dofs_property = DofProperties::active) const;
+
+  /**
+   * \brief Returns a view on the element-local ids of the basis functions
+   * with the given @p dofs_property (see get_local_to_global_view()).
+   */
+  DofsConstView
+  get_local_dofs_view(const std::string &dofs_property = DofProperties::active) const;
+
 
   /**
    * \brief Returns the number of non zero basis functions with the given
@@ -267,18 +298,9 @@ public:
 
     //--------------------------------------------------------------------------------------
     // filtering the values that correspond to the dofs with the given property --- begin
-    SafeSTLVector<Index> dofs_global;
-    SafeSTLVector<Index> dofs_local_to_patch;
-    SafeSTLVector<Index> dofs_local_to_elem;
-
-    this->basis_->get_spline_space()->get_element_dofs(
-      this->get_index(),
-      dofs_global,
-      dofs_local_to_patch,
-      dofs_local_to_elem,
-      dofs_property);
-
-    const auto n_filtered_dofs = dofs_local_to_elem.size();
+    const auto dofs_local_to_elem = this->get_local_dofs_view(dofs_property);
+
+    const auto n_filtered_dofs = dofs_local_to_elem.get_num_entries();
     const auto n_pts = values_all_elem_dofs.get_num_points();
 
     using VType = typename std::remove_reference<decltype(values_all_elem_dofs)>::type;
@@ -570,6 +592,29 @@ protected:
   /** The local (element and sub-element(s)) cache. */
   CacheType all_sub_elems_cache_;
 
+private:
+  /**
+   * Scratch buffers used by integrate_u_v() and integrate_gradu_gradv().
+   * They are kept by the element (and resized only when needed) in order to
+   * avoid memory allocations in the loops over the elements.
+   */
+  struct ScalarProductsScratch
+  {
+    /** Filtered basis values, in SoA layout. */
+    SoAValueTable<Value> values;
+
+    /** Filtered basis gradients, in SoA layout. */
+    SoAValueTable<Derivative<1>> gradients;
+
+    /** Weighted values (all components, all points) of one basis function. */
+    AlignedVector w_u_i;
+
+    /** One row of the integrated matrix. */
+    AlignedVector M_i;
+  };
+
+  ScalarProductsScratch scalar_products_scratch_;
+
 public:
 
   /**
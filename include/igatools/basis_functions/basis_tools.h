@@ -27,8 +27,13 @@
 
 #include <igatools/basis_functions/physical_basis_element.h>
 #include <igatools/basis_functions/physical_basis_handler.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/parallel_assembler.h>
+#include <igatools/basis_functions/nurbs.h>
 
 #include <igatools/linear_algebra/epetra_solver.h>
+#include <igatools/operators/kronecker_mass.h>
+#include <igatools/utils/thread_tools.h>
 
 #include<set>
 
@@ -40,33 +45,30 @@ IGA_NAMESPACE_OPEN
  */
 namespace basis_tools
 {
-#ifdef IGATOOLS_USES_TRILINOS
 /**
- * Returns the coefficients of the (L2)-Projection of the Function @p function
- * onto the space generated by the @p basis.
- * The integrals in the computations are done using the Quadrature @p quad.
+ * Integrates, element by element with the Quadrature @p quad, the right hand side
+ * of the (L2)-Projection of the Function @p function onto the space generated by
+ * the @p basis.
+ *
+ * For each element, @p add_elem_rhs is called with the basis element (whose cache
+ * holds the values and the weighted measures) and with the local right hand side,
+ * relative to the element dofs with the property @p dofs_property.
+ *
+ * The grid of the @p basis must be the grid of the @p function or one of its refinements.
  */
-template<int dim,int codim,int range,int rank>
-IgCoefficients
-projection_l2_function(const Function<dim,codim,range,rank> &function,
-                       const PhysicalBasis<dim,range,rank,codim> &basis,
-                       const std::shared_ptr<const Quadrature<dim>> &quad,
-                       const std::string &dofs_property = DofProperties::active)
+template<int dim,int codim,int range,int rank,class AddElemRhs>
+void
+integrate_l2_projection_rhs(const Function<dim,codim,range,rank> &function,
+                            const PhysicalBasis<dim,range,rank,codim> &basis,
+                            const std::shared_ptr<const Quadrature<dim>> &quad,
+                            const std::string &dofs_property,
+                            const AddElemRhs &add_elem_rhs)
 {
-  Epetra_SerialComm comm;
-
-//    auto map = EpetraTools::create_map(*space, dofs_property, comm);
-  const auto graph = EpetraTools::create_graph(basis,dofs_property,basis,dofs_property,comm);
-
-
-  auto matrix = EpetraTools::create_matrix(*graph);
-  auto rhs = EpetraTools::create_vector(matrix->RangeMap());
-  auto sol = EpetraTools::create_vector(matrix->DomainMap());
+  Assert(quad != nullptr,ExcNullPtr());
 
   const auto space_grid = basis.get_grid();
   const auto func_grid = function.get_domain()->get_grid_function()->get_grid();
 
-
   Assert(space_grid->same_knots_or_refinement_of(*func_grid),
          ExcMessage("The space grid is not a refinement of the function grid."));
 
@@ -82,14 +84,10 @@ projection_l2_function(const Function<dim,codim,range,rank> &function,
 
   space_elem_handler->init_element_cache(*elem,quad);
 
-
-  using basis_element::_Value;
-
   using _D0 = function_element::template _D<0>;
   if (space_grid == func_grid)
   {
     auto func_elem_handler = function.create_cache_handler();
-
     func_elem_handler->set_element_flags(function_element::Flags::D0);
 
     func_elem_handler->init_cache(*f_elem,quad);
@@ -100,20 +98,11 @@ projection_l2_function(const Function<dim,codim,range,rank> &function,
       space_elem_handler->fill_element_cache(*elem);
 
       auto f_at_qp = f_elem->template get_values_from_cache<_D0,dim>(0);
-
-      const auto loc_mat = elem->template integrate_u_v<dim>(0,dofs_property);
-      const auto loc_rhs = elem->template integrate_u_func<dim>(f_at_qp,0,dofs_property);
-
-      const auto elem_dofs = elem->get_local_to_global(dofs_property);
-      matrix->add_block(elem_dofs,elem_dofs,loc_mat);
-      rhs->add_block(elem_dofs,loc_rhs);
+      add_elem_rhs(*elem,elem->template integrate_u_func<dim>(f_at_qp,0,dofs_property));
     }
-    matrix->FillComplete();
   }
   else
   {
-//    AssertThrow(false,ExcNotImplemented());
-
     auto map_elems_id_fine_coarse =
       grid_tools::build_map_elements_id_between_grids(*space_grid,*func_grid);
 
@@ -124,7 +113,6 @@ projection_l2_function(const Function<dim,codim,range,rank> &function,
 
       space_elem_handler->fill_element_cache(*elem);
 
-
       //---------------------------------------------------------------------------
       // the function is supposed to be defined on the same grid of the space or coarser
       const auto &elem_grid_accessor = elem->get_grid_element();
@@ -144,79 +132,44 @@ projection_l2_function(const Function<dim,codim,range,rank> &function,
       quad_in_func_elem->translate(f_elem_vertex);
       quad_in_func_elem->dilate(one_div_f_elem_size);
 
-
       auto f_at_qp =
         f_elem->template evaluate_at_points<_D0>(quad_in_func_elem);
       //---------------------------------------------------------------------------
 
-
-      const auto loc_mat = elem->template integrate_u_v<dim>(0,dofs_property);
-      const auto loc_rhs = elem->template integrate_u_func<dim>(f_at_qp,0,dofs_property);
-
-      const auto elem_dofs = elem->get_local_to_global(dofs_property);
-      matrix->add_block(elem_dofs,elem_dofs,loc_mat);
-      rhs->add_block(elem_dofs,loc_rhs);
+      add_elem_rhs(*elem,elem->template integrate_u_func<dim>(f_at_qp,0,dofs_property));
     }
-    matrix->FillComplete();
   }
-
-  auto solver = EpetraTools::create_solver(*matrix, *sol, *rhs);
-  auto result = solver->solve();
-  AssertThrow(result == Belos::ReturnType::Converged,
-              ExcMessage("No convergence."));
-
-  IgCoefficients ig_coeffs;
-
-  const auto &dof_distribution = *(basis.get_spline_space()->get_dof_distribution());
-  const auto &active_dofs = dof_distribution.get_global_dofs(dofs_property);
-
-  const auto &epetra_map = sol->Map();
-
-  for (const auto glob_dof : active_dofs)
-  {
-    auto loc_id = epetra_map.LID(glob_dof);
-    Assert(loc_id >= 0,
-           ExcMessage("Global dof " + std::to_string(glob_dof) + " not present in the input EpetraTools::Vector."));
-    ig_coeffs[glob_dof] = (*sol)[loc_id];
-  }
-
-  return ig_coeffs;
 }
 
 
 /**
- * Returns the coefficients of the (L2)-Projection of the GridFunction @p grid_function
- * onto the space generated by the @p basis.
- * The integrals in the computations are done using the Quadrature @p quad.
+ * Integrates, element by element with the Quadrature @p quad, the right hand side
+ * of the (L2)-Projection of the GridFunction @p grid_function onto the space generated by
+ * the @p ref_basis.
+ *
+ * For each element, @p add_elem_rhs is called with the basis element (whose cache
+ * holds the values and the weighted measures) and with the local right hand side,
+ * relative to the element dofs with the property @p dofs_property.
+ *
+ * The grid of the @p ref_basis must be the grid of the @p grid_function
+ * or one of its refinements.
  */
-template<int dim,int range>
-IgCoefficients
-projection_l2_grid_function(
-  const GridFunction<dim,range> &grid_function,
-  const ReferenceBasis<dim,range,1> &ref_basis,
-  const std::shared_ptr<const Quadrature<dim>> &quad,
-  const std::string &dofs_property = DofProperties::active)
+template<int dim,int range,class AddElemRhs>
+void
+integrate_l2_projection_rhs(const GridFunction<dim,range> &grid_function,
+                            const ReferenceBasis<dim,range,1> &ref_basis,
+                            const std::shared_ptr<const Quadrature<dim>> &quad,
+                            const std::string &dofs_property,
+                            const AddElemRhs &add_elem_rhs)
 {
   Assert(quad != nullptr,ExcNullPtr());
 
-  Epetra_SerialComm comm;
-
-  const auto graph =
-    EpetraTools::create_graph(ref_basis,dofs_property,ref_basis,dofs_property,comm);
-
-
-  auto matrix = EpetraTools::create_matrix(*graph);
-  auto rhs = EpetraTools::create_vector(matrix->RangeMap());
-  auto sol = EpetraTools::create_vector(matrix->DomainMap());
-
   const auto space_grid = ref_basis.get_grid();
   const auto func_grid = grid_function.get_grid();
 
-
   Assert(space_grid->same_knots_or_refinement_of(*func_grid),
          ExcMessage("The space grid is not a refinement of the function grid."));
 
-
   using BsFlags = basis_element::Flags;
   auto sp_flag = BsFlags::value |
                  BsFlags::w_measure;
@@ -243,15 +196,8 @@ projection_l2_grid_function(
       space_elem_handler->fill_element_cache(*elem);
 
       auto f_at_qp = f_elem->template get_values_from_cache<D0,dim>(0);
-
-      const auto loc_mat = elem->template integrate_u_v<dim>(0,dofs_property);
-      const auto loc_rhs = elem->template integrate_u_func<dim>(f_at_qp,0,dofs_property);
-
-      const auto elem_dofs = elem->get_local_to_global(dofs_property);
-      matrix->add_block(elem_dofs,elem_dofs,loc_mat);
-      rhs->add_block(elem_dofs,loc_rhs);
+      add_elem_rhs(*elem,elem->template integrate_u_func<dim>(f_at_qp,0,dofs_property));
     }
-    matrix->FillComplete();
   }
   else
   {
@@ -265,7 +211,6 @@ projection_l2_grid_function(
 
       space_elem_handler->fill_element_cache(*elem);
 
-
       //---------------------------------------------------------------------------
       // the function is supposed to be defined on a coarser grid of the space
       const auto &elem_grid_accessor = elem->get_grid_element();
@@ -284,46 +229,542 @@ projection_l2_grid_function(
       quad_in_func_elem->translate(f_elem_vertex);
       quad_in_func_elem->dilate(one_div_f_elem_size);
 
-
       auto f_at_qp =
         f_elem->template evaluate_at_points<D0>(quad_in_func_elem);
       //---------------------------------------------------------------------------
 
+      add_elem_rhs(*elem,elem->template integrate_u_func<dim>(f_at_qp,0,dofs_property));
+    }
+  }
+}
+
 
-      const auto loc_mat = elem->template integrate_u_v<dim>(0,dofs_property);
-      const auto loc_rhs = elem->template integrate_u_func<dim>(f_at_qp,0,dofs_property);
+#ifdef IGATOOLS_USES_TRILINOS
+/**
+ * Returns the coefficients of the (L2)-Projection of the Function @p function
+ * onto the space generated by the @p basis.
+ * The integrals in the computations are done using the Quadrature @p quad.
+ *
+ * If the @p function and the @p basis are defined on the same grid, the
+ * mass matrix and the right hand side are assembled by a ParallelAssembler
+ * using @p n_threads threads (the result does not depend on @p n_threads).
+ * Otherwise the element loop is serial.
+ */
+template<int dim,int codim,int range,int rank>
+IgCoefficients
+projection_l2_function(const Function<dim,codim,range,rank> &function,
+                       const PhysicalBasis<dim,range,rank,codim> &basis,
+                       const std::shared_ptr<const Quadrature<dim>> &quad,
+                       const std::string &dofs_property = DofProperties::active,
+                       const int n_threads = 1)
+{
+  Assert(quad != nullptr,ExcNullPtr());
+
+  Epetra_SerialComm comm;
+
+//    auto map = EpetraTools::create_map(*space, dofs_property, comm);
+  const auto graph = EpetraTools::create_graph(basis,dofs_property,basis,dofs_property,comm);
+
+
+  auto matrix = EpetraTools::create_matrix(*graph);
+  auto rhs = EpetraTools::create_vector(matrix->RangeMap());
+  auto sol = EpetraTools::create_vector(matrix->DomainMap());
+
+  if (basis.get_grid() == function.get_domain()->get_grid_function()->get_grid())
+  {
+    using Assembler = ParallelAssembler<dim,codim,range,rank>;
+    using ElementAccessor = typename Assembler::ElementAccessor;
+    using LocalContribution = typename Assembler::LocalContribution;
+
+    Assembler assembler(basis.shared_from_this(),quad,
+                        basis_element::Flags::value | basis_element::Flags::w_measure,
+                        n_threads,64,ElementProperties::active,dofs_property);
+
+    // each thread owns its own function element and cache handler
+    auto create_local_work = [&]()
+    {
+      using FuncElem = typename Function<dim,codim,range,rank>::ElementAccessor;
+      using FuncHandler = typename Function<dim,codim,range,rank>::Handler;
+      auto f_handler = std::shared_ptr<FuncHandler>(function.create_cache_handler());
+      f_handler->set_element_flags(function_element::Flags::D0);
+      auto f_elem = std::shared_ptr<FuncElem>(
+                      function.create_element_begin(ElementProperties::active));
+      f_handler->init_cache(*f_elem,quad);
+
+      return [f_handler,f_elem,&dofs_property](ElementAccessor &elem, LocalContribution &loc)
+      {
+        using _D0 = function_element::template _D<0>;
+        f_elem->move_to(elem.get_index());
+        f_handler->template fill_cache<dim>(*f_elem,0);
+
+        const auto &f_at_qp = f_elem->template get_values_from_cache<_D0,dim>(0);
+        loc.matrix = elem.template integrate_u_v<dim>(0,dofs_property);
+        loc.vector = elem.template integrate_u_func<dim>(f_at_qp,0,dofs_property);
+      };
+    };
+
+    assembler.assemble(create_local_work,*matrix,*rhs);
+  }
+  else
+  {
+    integrate_l2_projection_rhs(function,basis,quad,dofs_property,
+                                [&](auto &elem, const DenseVector &loc_rhs)
+    {
+      const auto loc_mat = elem.template integrate_u_v<dim>(0,dofs_property);
 
-      const auto elem_dofs = elem->get_local_to_global(dofs_property);
+      const auto elem_dofs = elem.get_local_to_global(dofs_property);
       matrix->add_block(elem_dofs,elem_dofs,loc_mat);
       rhs->add_block(elem_dofs,loc_rhs);
-    }
-    matrix->FillComplete();
+    });
   }
+  matrix->FillComplete();
 
   auto solver = EpetraTools::create_solver(*matrix, *sol, *rhs);
   auto result = solver->solve();
   AssertThrow(result == Belos::ReturnType::Converged,
               ExcMessage("No convergence."));
 
-  IgCoefficients ig_coeffs;
+  const auto &dof_distribution = *(basis.get_spline_space()->get_dof_distribution());
+  const auto &active_dofs = dof_distribution.get_global_dofs(dofs_property);
+
+  // the coefficients are a view on the solution (if its map matches the active dofs)
+  return IgCoefficients(active_dofs,std::shared_ptr<const EpetraTools::Vector>(sol));
+}
+
+
+/**
+ * Returns the coefficients of the (L2)-Projection of the GridFunction @p grid_function
+ * onto the space generated by the @p basis.
+ * The integrals in the computations are done using the Quadrature @p quad.
+ */
+template<int dim,int range>
+IgCoefficients
+projection_l2_grid_function(
+  const GridFunction<dim,range> &grid_function,
+  const ReferenceBasis<dim,range,1> &ref_basis,
+  const std::shared_ptr<const Quadrature<dim>> &quad,
+  const std::string &dofs_property = DofProperties::active)
+{
+  Assert(quad != nullptr,ExcNullPtr());
+
+  Epetra_SerialComm comm;
+
+  const auto graph =
+    EpetraTools::create_graph(ref_basis,dofs_property,ref_basis,dofs_property,comm);
+
+
+  auto matrix = EpetraTools::create_matrix(*graph);
+  auto rhs = EpetraTools::create_vector(matrix->RangeMap());
+  auto sol = EpetraTools::create_vector(matrix->DomainMap());
+
+  integrate_l2_projection_rhs(grid_function,ref_basis,quad,dofs_property,
+                              [&](auto &elem, const DenseVector &loc_rhs)
+  {
+    const auto loc_mat = elem.template integrate_u_v<dim>(0,dofs_property);
+
+    const auto elem_dofs = elem.get_local_to_global(dofs_property);
+    matrix->add_block(elem_dofs,elem_dofs,loc_mat);
+    rhs->add_block(elem_dofs,loc_rhs);
+  });
+  matrix->FillComplete();
+
+  auto solver = EpetraTools::create_solver(*matrix, *sol, *rhs);
+  auto result = solver->solve();
+  AssertThrow(result == Belos::ReturnType::Converged,
+              ExcMessage("No convergence."));
 
   const auto &dof_distribution = *(ref_basis.get_spline_space()->get_dof_distribution());
   const auto &active_dofs = dof_distribution.get_global_dofs(dofs_property);
 
-  const auto &epetra_map = sol->Map();
+  // the coefficients are a view on the solution (if its map matches the active dofs)
+  return IgCoefficients(active_dofs,std::shared_ptr<const EpetraTools::Vector>(sol));
+}
+
+#endif // IGATOOLS_USES_TRILINOS
+
 
-  for (const auto glob_dof : active_dofs)
+/**
+ * Returns the coefficients of the (L2)-Projection of the GridFunction @p grid_function
+ * onto the space generated by the @p ref_basis, without assembling the mass matrix.
+ *
+ * If @p ref_basis is a non periodic BSpline and all its dofs have the property
+ * @p dofs_property, the mass matrix is the Kronecker product of the univariate
+ * mass matrices (see KroneckerMass): only the right hand side is computed with
+ * the quadrature @p quad and the system is solved with a sequence of banded
+ * univariate solves, with a cost of \f$ O(N p) \f$ (being \f$ N \f$ the number
+ * of dofs and \f$ p \f$ the degree).
+ *
+ * Otherwise, the projection is computed by projection_l2_grid_function().
+ */
+template<int dim,int range>
+IgCoefficients
+fast_projection_l2_grid_function(
+  const GridFunction<dim,range> &grid_function,
+  const ReferenceBasis<dim,range,1> &ref_basis,
+  const std::shared_ptr<const Quadrature<dim>> &quad,
+  const std::string &dofs_property = DofProperties::active)
+{
+  Assert(quad != nullptr,ExcNullPtr());
+
+  using Bs = BSpline<dim,range,1>;
+  const Bs *bsp = ref_basis.is_bspline() ? dynamic_cast<const Bs *>(&ref_basis) : nullptr;
+  if (bsp == nullptr || !KroneckerMass<dim,range>::is_supported(*bsp,dofs_property))
   {
-    auto loc_id = epetra_map.LID(glob_dof);
-    Assert(loc_id >= 0,
-           ExcMessage("Global dof " + std::to_string(glob_dof) + " not present in the input EpetraTools::Vector."));
-    ig_coeffs[glob_dof] = (*sol)[loc_id];
+#ifdef IGATOOLS_USES_TRILINOS
+    return projection_l2_grid_function(grid_function,ref_basis,quad,dofs_property);
+#else
+    AssertThrow(false,ExcMessage("The basis has not the Kronecker-product structure."));
+    return IgCoefficients();
+#endif // IGATOOLS_USES_TRILINOS
   }
 
+  const KroneckerMass<dim,range> mass(*bsp);
+
+  const auto &dofs = mass.get_dofs();
+  if (dofs.empty())
+    return IgCoefficients();
+
+  SafeSTLVector<Index> dof_position(dofs.back()+1,-1);
+  for (Index pos = 0 ; pos < Index(dofs.size()) ; ++pos)
+    dof_position[dofs[pos]] = pos;
+
+  SafeSTLVector<Real> sol(dofs.size(),0.0);
+
+  integrate_l2_projection_rhs(grid_function,ref_basis,quad,dofs_property,
+                              [&](auto &elem, const DenseVector &loc_rhs)
+  {
+    const auto elem_dofs = elem.get_local_to_global(dofs_property);
+    const int n_loc_dofs = elem_dofs.size();
+    for (int i = 0 ; i < n_loc_dofs ; ++i)
+      sol[dof_position[elem_dofs[i]]] += loc_rhs(i);
+  });
+
+  mass.solve(sol);
+
+  IgCoefficients ig_coeffs;
+  for (Index pos = 0 ; pos < Index(dofs.size()) ; ++pos)
+    ig_coeffs.insert(dofs[pos],sol[pos]);
+
   return ig_coeffs;
 }
 
+
+/**
+ * Returns the coefficients of the (L2)-Projection of the Function @p function
+ * onto the space generated by the @p basis, without assembling the mass matrix.
+ *
+ * If the reference basis of @p basis is a non periodic BSpline (with all its dofs
+ * having the property @p dofs_property), the basis has rank 1 and the
+ * Transformation::h_grad push-forward, the mass matrix is
+ * \f[
+ * (M_c)_{ij} = \int_{\hat{\Omega}} |\det D F| \hat{B}_i \hat{B}_j \; d\hat{x}.
+ * \f]
+ * It is never assembled: the system is solved by the conjugate gradient method,
+ * with the matrix-free (sum-factorized) application of \f$ M_c \f$ and
+ * preconditioned by the Kronecker-product parametric mass matrix
+ * (see KroneckerMass::solve_weighted()). On a Cartesian domain the preconditioner
+ * is the inverse of \f$ M_c \f$ and the method converges in one iteration.
+ *
+ * Otherwise, the projection is computed by projection_l2_function().
+ *
+ * @note The Quadrature @p quad must have the tensor-product structure.
+ */
+template<int dim,int codim,int range,int rank>
+IgCoefficients
+fast_projection_l2_function(const Function<dim,codim,range,rank> &function,
+                            const PhysicalBasis<dim,range,rank,codim> &basis,
+                            const std::shared_ptr<const Quadrature<dim>> &quad,
+                            const std::string &dofs_property = DofProperties::active)
+{
+  Assert(quad != nullptr,ExcNullPtr());
+
+  using Bs = BSpline<dim,range,1>;
+  const auto ref_basis = basis.get_reference_basis();
+  const Bs *bsp = ref_basis->is_bspline() ?
+                  dynamic_cast<const Bs *>(ref_basis.get()) : nullptr;
+  if (bsp == nullptr ||
+      basis.get_transformation_type() != Transformation::h_grad ||
+      !quad->is_tensor_product() ||
+      !KroneckerMass<dim,range>::is_supported(*bsp,dofs_property))
+  {
+#ifdef IGATOOLS_USES_TRILINOS
+    return projection_l2_function(function,basis,quad,dofs_property);
+#else
+    AssertThrow(false,ExcMessage("The basis has not the Kronecker-product structure."));
+    return IgCoefficients();
 #endif // IGATOOLS_USES_TRILINOS
+  }
+
+  KroneckerMass<dim,range> mass(*bsp);
+
+  const auto &dofs = mass.get_dofs();
+  if (dofs.empty())
+    return IgCoefficients();
+
+  SafeSTLVector<Index> dof_position(dofs.back()+1,-1);
+  for (Index pos = 0 ; pos < Index(dofs.size()) ; ++pos)
+    dof_position[dofs[pos]] = pos;
+
+  SafeSTLVector<Real> sol(dofs.size(),0.0);
+
+  // integration weights (with the measure of the mapped elements) for the
+  // matrix-free application of the mass matrix
+  const Size n_elems = basis.get_grid()->get_num_elements(ElementProperties::active);
+  SafeSTLVector<TensorIndex<dim>> elem_intervals;
+  SafeSTLVector<Real> weights;
+  elem_intervals.reserve(n_elems);
+  weights.reserve(n_elems * quad->get_num_points());
+
+  integrate_l2_projection_rhs(function,basis,quad,dofs_property,
+                              [&](auto &elem, const DenseVector &loc_rhs)
+  {
+    const auto elem_dofs = elem.get_local_to_global(dofs_property);
+    const int n_loc_dofs = elem_dofs.size();
+    for (int i = 0 ; i < n_loc_dofs ; ++i)
+      sol[dof_position[elem_dofs[i]]] += loc_rhs(i);
+
+    elem_intervals.push_back(elem.get_grid_element().get_index().get_tensor_index());
+    for (const auto &w : elem.get_element_w_measures())
+      weights.push_back(w);
+  });
+
+  mass.set_weights(*quad,elem_intervals,weights);
+  const int n_iters = mass.solve_weighted(sol);
+  AssertThrow(n_iters >= 0, ExcMessage("No convergence."));
+
+  IgCoefficients ig_coeffs;
+  for (Index pos = 0 ; pos < Index(dofs.size()) ; ++pos)
+    ig_coeffs.insert(dofs[pos],sol[pos]);
+
+  return ig_coeffs;
+}
+
+
+/**
+ * Computes the matrix of the knot insertion (Oslo algorithm) between the
+ * univariate B-splines of degree @p degree defined on the knot vector
+ * (with repetitions) @p old_knots and the ones defined on @p new_knots, i.e.
+ * the coefficients \f$ \alpha_{j,i} \f$ such that
+ * \f$ \hat{B}_i = \sum_j \alpha_{j,i} B_j \f$, being \f$ \hat{B}_i \f$
+ * the old basis functions and \f$ B_j \f$ the new ones.
+ *
+ * Each new basis function has at most <tt>degree+1</tt> non-zero
+ * coefficients, relative to consecutive old basis functions: the
+ * coefficients of the <tt>j</tt>-th new basis function are stored in
+ * @p alpha starting at position <tt>j*(degree+1)</tt> and are relative to the
+ * old basis functions starting from <tt>first_old_basis[j]</tt>.
+ *
+ * It returns false (and the output arguments are not meaningful)
+ * if @p new_knots is not a refinement of @p old_knots.
+ */
+bool
+compute_knot_insertion_matrix_1D(
+  const SafeSTLVector<Real> &old_knots,
+  const SafeSTLVector<Real> &new_knots,
+  const int degree,
+  SafeSTLVector<Index> &first_old_basis,
+  SafeSTLVector<Real> &alpha);
+
+
+/**
+ * Computes with the knot insertion algorithm the coefficients
+ * @p new_coeffs with respect to the basis @p new_basis of the function
+ * having coefficients @p old_coeffs with respect to the basis @p old_basis,
+ * being @p new_basis a refinement (by knot insertion) of @p old_basis.
+ *
+ * The result is exact (up to round-off) and no linear system is solved:
+ * for each component the univariate knot insertion matrices are
+ * applied direction by direction to the tensor-product array of the
+ * coefficients, with a cost of
+ * <tt>O(n_dofs * (degree+1))</tt> for each direction.
+ *
+ * For NURBS bases the knot insertion is applied to the homogeneous
+ * coefficients (i.e. the coefficients multiplied by the weights) and to the
+ * weights, and the new coefficients are recovered by dividing the first ones
+ * by the second ones.
+ *
+ * It returns false (and @p new_coeffs is not modified) if the knot insertion
+ * cannot be used, i.e. if:
+ * - the two bases are not of the same type, or have different degrees;
+ * - the basis is periodic along some direction;
+ * - the knots of @p new_basis are not a refinement of the ones of
+ *   @p old_basis;
+ * - @p old_coeffs has not an entry for each dof of @p old_basis.
+ */
+template<int dim,int range,int rank>
+bool
+knot_insertion_coefficients(const ReferenceBasis<dim,range,rank> &old_basis,
+                            const ReferenceBasis<dim,range,rank> &new_basis,
+                            const IgCoefficients &old_coeffs,
+                            IgCoefficients &new_coeffs)
+{
+  using BSp = BSpline<dim,range,rank>;
+
+  if (old_basis.is_bspline() != new_basis.is_bspline())
+    return false;
+
+  const BSp *old_bsp = nullptr;
+  const BSp *new_bsp = nullptr;
+
+  // weights of the NURBS basis (only the ones of the old basis are needed)
+  const IgCoefficients *weights = nullptr;
+  const DynamicMultiArray<Index,dim> *weights_index_table = nullptr;
+
+  if (old_basis.is_bspline())
+  {
+    old_bsp = dynamic_cast<const BSp *>(&old_basis);
+    new_bsp = dynamic_cast<const BSp *>(&new_basis);
+  }
+  else
+  {
+#ifdef IGATOOLS_WITH_NURBS
+    using Nrb = NURBS<dim,range,rank>;
+    const auto old_nrb = dynamic_cast<const Nrb *>(&old_basis);
+    const auto new_nrb = dynamic_cast<const Nrb *>(&new_basis);
+    if (old_nrb == nullptr || new_nrb == nullptr)
+      return false;
+    old_bsp = old_nrb->get_bspline_basis().get();
+    new_bsp = new_nrb->get_bspline_basis().get();
+
+    const auto &w_func = *old_nrb->get_weight_func();
+    const auto w_basis =
+      std::dynamic_pointer_cast<const BSpline<dim,1,1>>(w_func.get_basis());
+    if (w_basis == nullptr)
+      return false;
+    weights = &w_func.get_coefficients();
+    weights_index_table =
+      &w_basis->get_spline_space()->get_dof_distribution()->get_index_table()[0];
+#else
+    return false;
+#endif
+  }
+  if (old_bsp == nullptr || new_bsp == nullptr)
+    return false;
+
+  const auto &old_space = *old_bsp->get_spline_space();
+  const auto &new_space = *new_bsp->get_spline_space();
+  const auto &old_knots = old_bsp->get_knots_with_repetitions_table();
+  const auto &new_knots = new_bsp->get_knots_with_repetitions_table();
+  const auto &old_index_table = old_space.get_dof_distribution()->get_index_table();
+  const auto &new_index_table = new_space.get_dof_distribution()->get_index_table();
+
+  IgCoefficients coeffs;
+  for (int comp = 0 ; comp < BSp::n_components ; ++comp)
+  {
+    const auto &old_comp_table = old_index_table[comp];
+    const auto &new_comp_table = new_index_table[comp];
+    const auto old_size = old_comp_table.tensor_size();
+    const auto new_size = new_comp_table.tensor_size();
+
+    // univariate knot insertion matrices
+    SafeSTLArray<SafeSTLVector<Index>,dim> first_old_basis;
+    SafeSTLArray<SafeSTLVector<Real>,dim> alpha;
+    for (int dir = 0 ; dir < dim ; ++dir)
+    {
+      const int deg = old_space.get_degree_table()[comp][dir];
+      if (deg != new_space.get_degree_table()[comp][dir] ||
+          old_space.get_periodic_table()[comp][dir] ||
+          new_space.get_periodic_table()[comp][dir])
+        return false;
+
+      if (!compute_knot_insertion_matrix_1D(
+            old_knots[comp][dir], new_knots[comp][dir], deg,
+            first_old_basis[dir], alpha[dir]))
+        return false;
+
+      if (Size(first_old_basis[dir].size()) != new_size[dir])
+        return false;
+    }
+
+    if (weights_index_table != nullptr &&
+        weights_index_table->tensor_size() != old_size)
+      return false;
+
+    // tensor-product array (first direction running fastest) of the
+    // old (homogeneous, for NURBS) coefficients and of the weights
+    const int n_arrays = (weights != nullptr) ? 2 : 1;
+    SafeSTLArray<SafeSTLVector<Real>,2> values;
+    for (int k = 0 ; k < n_arrays ; ++k)
+      values[k].resize(old_comp_table.flat_size());
+
+    for (Index f = 0 ; f < old_comp_table.flat_size() ; ++f)
+    {
+      const auto tensor_id = old_comp_table.flat_to_tensor(f);
+      Index pos = 0;
+      for (int dir = dim-1 ; dir >= 0 ; --dir)
+        pos = pos * old_size[dir] + tensor_id[dir];
+
+      const Index dof = old_comp_table[f];
+      if (old_coeffs.count(dof) == 0)
+        return false;
+      values[0][pos] = old_coeffs[dof];
+      if (weights != nullptr)
+      {
+        const Real w = (*weights)[(*weights_index_table)(tensor_id)];
+        values[0][pos] *= w;
+        values[1][pos] = w;
+      }
+    }
+
+    // the knot insertion is applied direction by direction
+    auto size = old_size;
+    SafeSTLVector<Real> refined;
+    for (int dir = 0 ; dir < dim ; ++dir)
+    {
+      Size n_before = 1;
+      for (int d = 0 ; d < dir ; ++d)
+        n_before *= size[d];
+      Size n_after = 1;
+      for (int d = dir+1 ; d < dim ; ++d)
+        n_after *= size[d];
+
+      const Size n_in = size[dir];
+      const Size n_out = new_size[dir];
+      const int n_alpha = alpha[dir].size() / n_out;
+
+      for (int k = 0 ; k < n_arrays ; ++k)
+      {
+        const auto &in = values[k];
+        refined.assign(n_before * n_out * n_after, 0.0);
+        for (Index i_after = 0 ; i_after < n_after ; ++i_after)
+        {
+          for (Index j = 0 ; j < n_out ; ++j)
+          {
+            const Real *alpha_j = alpha[dir].data() + j * n_alpha;
+            Real *out_j = refined.data() + (i_after * n_out + j) * n_before;
+            const Index first = first_old_basis[dir][j];
+            for (int r = 0 ; r < n_alpha ; ++r)
+            {
+              if (alpha_j[r] == 0.0)
+                continue;
+              const Real *in_i = in.data() + (i_after * n_in + first + r) * n_before;
+              for (Index i_before = 0 ; i_before < n_before ; ++i_before)
+                out_j[i_before] += alpha_j[r] * in_i[i_before];
+            }
+          }
+        }
+        std::swap(values[k], refined);
+      }
+      size[dir] = n_out;
+    }
+
+    for (Index f = 0 ; f < new_comp_table.flat_size() ; ++f)
+    {
+      const auto tensor_id = new_comp_table.flat_to_tensor(f);
+      Index pos = 0;
+      for (int dir = dim-1 ; dir >= 0 ; --dir)
+        pos = pos * new_size[dir] + tensor_id[dir];
+
+      Real value = values[0][pos];
+      if (weights != nullptr)
+        value /= values[1][pos];
+      coeffs.insert(new_comp_table[f],value);
+    }
+  }
+
+  new_coeffs = std::move(coeffs);
+  return true;
+}
 
 
 /**
@@ -336,6 +777,9 @@ projection_l2_grid_function(
  * indices of degrees of freedom at the boundary and the computed coefficient value
  * for this degree of freedom.
  *
+ * If @p fast_projection is true, the projections on the faces are computed
+ * without assembling the mass matrices (see fast_projection_l2_function() and
+ * fast_projection_l2_grid_function()).
  */
 template<int dim,int codim, int range, int rank>
 void
@@ -343,7 +787,8 @@ project_boundary_values(
   std::map<int, std::shared_ptr<const Function<dim-1,codim+1,range,rank>>> &bndry_funcs,
   const PhysicalBasis<dim,range,rank,codim> &basis,
   const std::shared_ptr<const Quadrature<(dim > 1)?dim-1:0>> &quad,
-  std::map<Index, Real>  &boundary_values)
+  std::map<Index, Real>  &boundary_values,
+  const bool fast_projection = false)
 {
   static_assert(dim >= 1,"The dimension must be > 0");
 
@@ -377,7 +822,10 @@ project_boundary_values(
     InterBasisMap  dof_map;
     const auto sub_basis = basis.template get_sub_basis<sdim>(s_id, dof_map,sub_grid,elem_map);
 
-    const auto coeffs = projection_l2_function(
+    const auto coeffs = fast_projection ?
+                        fast_projection_l2_function(
+                          bndry_func,*sub_basis,quad,DofProperties::active) :
+                        projection_l2_function(
                           bndry_func,*sub_basis,quad,DofProperties::active);
 
     const int face_n_dofs = dof_map.size();
@@ -395,7 +843,8 @@ project_boundary_values(
   std::map<int, std::shared_ptr<const SubGridFunction<dim-1,dim,range>>> &bndry_funcs,
   const ReferenceBasis<dim,range,1> &ref_basis,
   const std::shared_ptr<const Quadrature<(dim > 1)?dim-1:0>> &quad,
-  std::map<Index, Real>  &boundary_values)
+  std::map<Index, Real>  &boundary_values,
+  const bool fast_projection = false)
 {
   static_assert(dim >= 1,"The dimension must be >= 1");
 
@@ -428,7 +877,10 @@ project_boundary_values(
     InterBasisMap  dof_map;
     const auto sub_basis = ref_basis.template get_ref_sub_basis<sdim>(s_id, dof_map,sub_grid);
 
-    const auto coeffs = projection_l2_grid_function(
+    const auto coeffs = fast_projection ?
+                        fast_projection_l2_grid_function(
+                          bndry_func,*sub_basis,quad,DofProperties::active) :
+                        projection_l2_grid_function(
                           bndry_func,*sub_basis,quad,DofProperties::active);
 
     const int face_n_dofs = dof_map.size();
@@ -587,12 +1039,103 @@ project_function_on_boundary(
 }
 
 
+/**
+ * Returns the sum of the first @p n entries of @p values, computed with the
+ * pairwise (cascade) summation: the rounding error grows as \f$ O(\log n) \f$
+ * instead of \f$ O(n) \f$ and the result depends only on the order of the values.
+ *
+ * The recursion stops on blocks of 8 entries, that are summed sequentially.
+ */
+template<class T>
+T
+pairwise_sum(const T *values, const Size n)
+{
+  const Size block_size = 8;
+  if (n <= block_size)
+  {
+    T sum;
+    sum = 0.0;
+    for (Index i = 0 ; i < n ; ++i)
+      sum += values[i];
+    return sum;
+  }
+
+  const Size half = n / 2;
+  T sum = pairwise_sum(values,half);
+  sum += pairwise_sum(values + half,n - half);
+  return sum;
+}
+
+/**
+ * Returns the sum of the element contributions stored in @p element_values.
+ *
+ * The values are summed with pairwise_sum() following the order of the
+ * element indices in the map, i.e. independently of the order in which
+ * they have been computed (and therefore of the number of threads used to
+ * compute them).
+ */
+template<int dim,class T>
+T
+sum_element_values(const SafeSTLMap<ElementIndex<dim>,T> &element_values)
+{
+  std::vector<T> values;
+  values.reserve(element_values.size());
+  for (const auto &elem_value : element_values)
+    values.emplace_back(elem_value.second);
+  return pairwise_sum(values.data(),values.size());
+}
+
+/**
+ * Performs in parallel a loop over @p n_elems elements, split in (at most)
+ * @p n_threads contiguous chunks (see thread_tools::split_range()).
+ *
+ * For each chunk, the calling thread creates (before spawning the threads)
+ * a work object <tt>work = create_work()</tt>, holding the cache handlers and the
+ * element iterators used by the thread. Then each thread calls
+ * <tt>work(first,last)</tt>, that must process the elements at positions
+ * <tt>[first,last)</tt> in the list of the active elements of the grid
+ * (i.e. the list returned by
+ * <tt>grid->get_elements_with_property(ElementProperties::active)</tt>,
+ * that is the iteration order of the elements).
+ * The work object is expected to place its iterators on the first element
+ * of the chunk with <tt>move_to()</tt>, that has constant complexity.
+ */
+template<class WorkFactory>
+void
+parallel_element_loop(const Size n_elems, const int n_threads,
+                      const WorkFactory &create_work)
+{
+  Assert(n_threads > 0, ExcLowerRange(n_threads,1));
+
+  const auto chunks = thread_tools::split_range(n_elems,n_threads);
+  const int n_chunks = chunks.size() - 1;
+
+  using Work = decltype(create_work());
+  std::vector<Work> works;
+  works.reserve(n_chunks);
+  for (int t = 0 ; t < n_chunks ; ++t)
+    works.emplace_back(create_work());
+
+  thread_tools::run_in_parallel(n_chunks,[&](const int t)
+  {
+    works[t](chunks[t],chunks[t+1]);
+  });
+}
+
+
 /**
  * Numerically computes the local element contribution
  * to the integral  \f$\int_\Omega D^kf\f$.
  * This contributions are written to the vector
  * @p element_error and the integral value is returned.
  *
+ * The elements are split among @p n_threads threads (each one with its own
+ * cache handler) and the integral is the pairwise sum of the element
+ * contributions (see sum_element_values()), therefore the result does not
+ * depend on the number of threads.
+ * The default is a serial evaluation: use <tt>n_threads > 1</tt> only if
+ * @p f can be evaluated concurrently by different cache handlers.
+ *
  * @note It is generally not used directly, but usually called from other
  * functions
  */
@@ -607,7 +1150,8 @@ integrate(const Function<dim, codim, range, rank> &f,
           Conditional<order==0,
           typename Function<dim, codim, range, rank>::Value,
           typename Function<dim, codim, range, rank>::template Derivative<order>>
-          > &element_error)
+          > &element_error,
+          const int n_threads = 1)
 {
   Assert(quad != nullptr,ExcNullPtr());
 
@@ -617,36 +1161,49 @@ integrate(const Function<dim, codim, range, rank> &f,
 
   using _Val = typename function_element::template _D<order>;
 
-  auto f_handler = f.create_cache_handler();
-
   const auto flag = function_element::Flags::D0 |
                     function_element::Flags::w_measure;
-  f_handler->set_element_flags(flag);
 
-  auto elem_f = f.begin();
-  const auto end = f.end();
+  const auto grid = f.get_domain()->get_grid_function()->get_grid();
+  const auto &active_elems = grid->get_elements_with_property(ElementProperties::active);
+  const Size n_elems = active_elems.size();
+  std::vector<Value> elems_val(n_elems);
 
   const int n_points = quad->get_num_points();
-  f_handler->init_cache(elem_f, quad);
-  Value val;
-  for (; elem_f != end; ++elem_f)
+  parallel_element_loop(n_elems,n_threads,[&]()
   {
-    f_handler->fill_element_cache(elem_f);
+    auto f_handler = f.create_cache_handler();
+    f_handler->set_element_flags(flag);
 
-    auto f_val = elem_f->template get_values_from_cache<_Val,dim>(0);
-    auto w_meas = elem_f->get_domain_element().get_element_w_measures();
+    auto elem_f = f.begin();
+    f_handler->init_cache(elem_f, quad);
 
-    val = 0.0;
-    for (int pt = 0; pt < n_points; ++pt)
-      val += f_val[pt] * w_meas[pt];
+    return [&,f_handler = std::move(f_handler),elem_f = std::move(elem_f)]
+           (const Index first, const Index last) mutable
+    {
+      if (first == last)
+        return;
+      elem_f->move_to(active_elems[first]);
 
-    element_error[ elem_f->get_index() ] = val;
-  }
+      for (Index pos = first ; pos < last ; ++pos, ++elem_f)
+      {
+        f_handler->fill_element_cache(elem_f);
 
-  val = 0.0;
-  for (const auto &el_val : element_error)
-    val += el_val.second;
-  return val;
+        auto f_val = elem_f->template get_values_from_cache<_Val,dim>(0);
+        auto w_meas = elem_f->get_domain_element().get_element_w_measures();
+
+        Value &val = elems_val[pos];
+        val = 0.0;
+        for (int pt = 0; pt < n_points; ++pt)
+          val += f_val[pt] * w_meas[pt];
+      }
+    };
+  });
+
+  for (Index pos = 0 ; pos < n_elems ; ++pos)
+    element_error[ active_elems[pos] ] = elems_val[pos];
+
+  return sum_element_values(element_error);
 }
 
 /**
@@ -655,6 +1212,12 @@ integrate(const Function<dim, codim, range, rank> &f,
  * This contributions are added to the map
  * @p element_error.
  *
+ * The elements are split among @p n_threads threads, each one with its own
+ * cache handlers. The element contributions do not depend on the
+ * number of threads.
+ * The default is a serial evaluation: use <tt>n_threads > 1</tt> only if
+ * @p f and @p g can be evaluated concurrently by different cache handlers.
+ *
  * @note It is generally not used directly, but usually called from other
  * functions
  */
@@ -663,7 +1226,8 @@ void norm_difference_functions(const Function<dim, codim, range, rank> &f,
                                const Function<dim, codim, range, rank> &g,
                                const std::shared_ptr<const Quadrature<dim>> &quad,
                                const Real p,
-                               SafeSTLMap<ElementIndex<dim>,Real> &element_error)
+                               SafeSTLMap<ElementIndex<dim>,Real> &element_error,
+                               const int n_threads = 1)
 {
   Assert(f.get_domain() == g.get_domain(),
          ExcMessage("Functions defined on different domains."));
@@ -683,56 +1247,73 @@ void norm_difference_functions(const Function<dim, codim, range, rank> &f,
   else
     Assert(false,ExcNotImplemented());
 
-
-  auto f_handler = f.create_cache_handler();
-  auto g_handler = g.create_cache_handler();
-
-  f_handler->set_element_flags(flag);
-  g_handler->set_element_flags(flag);
-
-
-  auto elem_f = f.begin();
-  auto elem_g = g.begin();
-  auto end = f.end();
-
-  f_handler->init_cache(elem_f,quad);
-  g_handler->init_cache(elem_g,quad);
-
+  const auto grid = f.get_domain()->get_grid_function()->get_grid();
+  const auto &active_elems = grid->get_elements_with_property(ElementProperties::active);
+  const Size n_elems = active_elems.size();
+  SafeSTLVector<Real> elems_diff_pow_p(n_elems);
 
   const int n_points = quad->get_num_points();
-  for (; elem_f != end; ++elem_f, ++elem_g)
+  parallel_element_loop(n_elems,n_threads,[&]()
   {
-    f_handler->fill_element_cache(elem_f);
-    g_handler->fill_element_cache(elem_g);
+    auto f_handler = f.create_cache_handler();
+    auto g_handler = g.create_cache_handler();
 
-    const auto &elem_id = elem_f->get_index();
+    f_handler->set_element_flags(flag);
+    g_handler->set_element_flags(flag);
 
-    auto f_val = elem_f->template get_values_from_cache<_Val,dim>(0);
-    auto g_val = elem_g->template get_values_from_cache<_Val,dim>(0);
-    auto w_meas = elem_f->get_domain_element().get_element_w_measures();
+    auto elem_f = f.begin();
+    auto elem_g = g.begin();
 
-    Real elem_diff_pow_p = 0.0;
-    Real val;
-    if (is_inf)
-    {
-      for (int pt = 0; pt < n_points; ++pt)
-      {
-        const auto err = f_val[pt] - g_val[pt];
-        val = err.norm_square();
-        elem_diff_pow_p = std::max(elem_diff_pow_p, fabs(sqrt(val)));
-      } // end loop pt
-    } // end if (is_inf)
-    else
+    f_handler->init_cache(elem_f,quad);
+    g_handler->init_cache(elem_g,quad);
+
+    return [&,
+            f_handler = std::move(f_handler),g_handler = std::move(g_handler),
+            elem_f = std::move(elem_f),elem_g = std::move(elem_g)]
+           (const Index first, const Index last) mutable
     {
-      for (int pt = 0; pt < n_points; ++pt)
+      if (first == last)
+        return;
+      elem_f->move_to(active_elems[first]);
+      elem_g->move_to(active_elems[first]);
+
+      for (Index pos = first ; pos < last ; ++pos, ++elem_f, ++elem_g)
       {
-        const auto err = f_val[pt] - g_val[pt];
-        val = err.norm_square();
-        elem_diff_pow_p += std::pow(val,p/2.) * w_meas[pt];
-      } // end loop pt
-    } // end if (!is_inf)
-    element_error[ elem_id ] += elem_diff_pow_p;
-  }
+        f_handler->fill_element_cache(elem_f);
+        g_handler->fill_element_cache(elem_g);
+
+        auto f_val = elem_f->template get_values_from_cache<_Val,dim>(0);
+        auto g_val = elem_g->template get_values_from_cache<_Val,dim>(0);
+        auto w_meas = elem_f->get_domain_element().get_element_w_measures();
+
+        Real elem_diff_pow_p = 0.0;
+        Real val;
+        if (is_inf)
+        {
+          for (int pt = 0; pt < n_points; ++pt)
+          {
+            const auto err = f_val[pt] - g_val[pt];
+            val = err.norm_square();
+            elem_diff_pow_p = std::max(elem_diff_pow_p, fabs(sqrt(val)));
+          } // end loop pt
+        } // end if (is_inf)
+        else
+        {
+          for (int pt = 0; pt < n_points; ++pt)
+          {
+            const auto err = f_val[pt] - g_val[pt];
+            val = err.norm_square();
+            elem_diff_pow_p += std::pow(val,p/2.) * w_meas[pt];
+          } // end loop pt
+        } // end if (!is_inf)
+
+        elems_diff_pow_p[pos] = elem_diff_pow_p;
+      }
+    };
+  });
+
+  for (Index pos = 0 ; pos < n_elems ; ++pos)
+    element_error[ active_elems[pos] ] += elems_diff_pow_p[pos];
 }
 
 
@@ -742,7 +1323,8 @@ void norm_difference_grid_functions(
   const GridFunction<dim,range> &g,
   const std::shared_ptr<const Quadrature<dim>> &quad,
   const Real p,
-  SafeSTLMap<ElementIndex<dim>,Real> &element_error)
+  SafeSTLMap<ElementIndex<dim>,Real> &element_error,
+  const int n_threads = 1)
 {
   Assert(f.get_grid() == g.get_grid(),
          ExcMessage("Functions defined on different grids."));
@@ -765,57 +1347,73 @@ void norm_difference_grid_functions(
 
   using _Val = typename grid_function_element::template _D<order>;
 
-  auto f_handler = f.create_cache_handler();
-  auto g_handler = g.create_cache_handler();
-
-  f_handler->set_element_flags(flag);
-  g_handler->set_element_flags(flag);
-
-
-
-  auto elem_f = f.begin();
-  auto elem_g = g.begin();
-  auto end = f.end();
-
-
-  f_handler->init_cache(elem_f,quad);
-  g_handler->init_cache(elem_g,quad);
-
+  const auto grid = f.get_grid();
+  const auto &active_elems = grid->get_elements_with_property(ElementProperties::active);
+  const Size n_elems = active_elems.size();
+  SafeSTLVector<Real> elems_diff_pow_p(n_elems);
 
   const int n_points = quad->get_num_points();
-  for (; elem_f != end; ++elem_f, ++elem_g)
+  parallel_element_loop(n_elems,n_threads,[&]()
   {
-    f_handler->fill_element_cache(elem_f);
-    g_handler->fill_element_cache(elem_g);
+    auto f_handler = f.create_cache_handler();
+    auto g_handler = g.create_cache_handler();
 
-    const auto &elem_id = elem_f->get_index();
+    f_handler->set_element_flags(flag);
+    g_handler->set_element_flags(flag);
 
-    const auto &f_val = elem_f->template get_values_from_cache<_Val,dim>(0);
-    const auto &g_val = elem_g->template get_values_from_cache<_Val,dim>(0);
-    const auto &w_meas = elem_f->get_element_weights();
+    auto elem_f = f.begin();
+    auto elem_g = g.begin();
 
-    Real elem_diff_pow_p = 0.0;
-    Real val;
-    if (is_inf)
-    {
-      for (int pt = 0; pt < n_points; ++pt)
-      {
-        const auto err = f_val[pt] - g_val[pt];
-        val = err.norm_square();
-        elem_diff_pow_p = std::max(elem_diff_pow_p, fabs(sqrt(val)));
-      } // end loop pt
-    } // end if (is_inf)
-    else
+    f_handler->init_cache(elem_f,quad);
+    g_handler->init_cache(elem_g,quad);
+
+    return [&,
+            f_handler = std::move(f_handler),g_handler = std::move(g_handler),
+            elem_f = std::move(elem_f),elem_g = std::move(elem_g)]
+           (const Index first, const Index last) mutable
     {
-      for (int pt = 0; pt < n_points; ++pt)
+      if (first == last)
+        return;
+      elem_f->move_to(active_elems[first]);
+      elem_g->move_to(active_elems[first]);
+
+      for (Index pos = first ; pos < last ; ++pos, ++elem_f, ++elem_g)
       {
-        const auto err = f_val[pt] - g_val[pt];
-        val = err.norm_square();
-        elem_diff_pow_p += std::pow(val,p/2.) * w_meas[pt];
-      } // end loop pt
-    } // end if (!is_inf)
-    element_error[ elem_id ] += elem_diff_pow_p;
-  }
+        f_handler->fill_element_cache(elem_f);
+        g_handler->fill_element_cache(elem_g);
+
+        const auto &f_val = elem_f->template get_values_from_cache<_Val,dim>(0);
+        const auto &g_val = elem_g->template get_values_from_cache<_Val,dim>(0);
+        const auto &w_meas = elem_f->get_element_weights();
+
+        Real elem_diff_pow_p = 0.0;
+        Real val;
+        if (is_inf)
+        {
+          for (int pt = 0; pt < n_points; ++pt)
+          {
+            const auto err = f_val[pt] - g_val[pt];
+            val = err.norm_square();
+            elem_diff_pow_p = std::max(elem_diff_pow_p, fabs(sqrt(val)));
+          } // end loop pt
+        } // end if (is_inf)
+        else
+        {
+          for (int pt = 0; pt < n_points; ++pt)
+          {
+            const auto err = f_val[pt] - g_val[pt];
+            val = err.norm_square();
+            elem_diff_pow_p += std::pow(val,p/2.) * w_meas[pt];
+          } // end loop pt
+        } // end if (!is_inf)
+
+        elems_diff_pow_p[pos] = elem_diff_pow_p;
+      }
+    };
+  });
+
+  for (Index pos = 0 ; pos < n_elems ; ++pos)
+    element_error[ active_elems[pos] ] += elems_diff_pow_p[pos];
 }
 
 
@@ -823,19 +1421,19 @@ template<int dim, int codim = 0, int range = 1, int rank = 1>
 Real l2_norm_difference(const Function<dim, codim, range, rank> &f,
                         const Function<dim, codim, range, rank> &g,
                         const std::shared_ptr<const Quadrature<dim>> &quad,
-                        SafeSTLMap<ElementIndex<dim>,Real> &elems_error)
+                        SafeSTLMap<ElementIndex<dim>,Real> &elems_error,
+                        const int n_threads = 1)
 {
   const Real p=2.;
   const Real one_p = 1./p;
   const int order=0;
 
-  norm_difference_functions<order,dim, codim, range, rank>(f,g,quad,p,elems_error);
+  norm_difference_functions<order,dim, codim, range, rank>(f,g,quad,p,elems_error,n_threads);
 
-  Real err = 0.0;
+  const Real err = sum_element_values(elems_error);
   for (auto &elem_err : elems_error)
   {
     auto &loc_err = elem_err.second;
-    err += loc_err;
     loc_err = std::pow(loc_err,one_p);
   }
 
@@ -847,19 +1445,19 @@ template<int dim,int range>
 Real l2_norm_difference(const GridFunction<dim,range> &f,
                         const GridFunction<dim,range> &g,
                         const std::shared_ptr<const Quadrature<dim>> &quad,
-                        SafeSTLMap<ElementIndex<dim>,Real> &elems_error)
+                        SafeSTLMap<ElementIndex<dim>,Real> &elems_error,
+                        const int n_threads = 1)
 {
   const Real p=2.;
   const Real one_p = 1./p;
   const int order=0;
 
-  norm_difference_grid_functions<order,dim,range>(f,g,quad,p,elems_error);
+  norm_difference_grid_functions<order,dim,range>(f,g,quad,p,elems_error,n_threads);
 
-  Real err = 0;
+  const Real err = sum_element_values(elems_error);
   for (auto &elem_err : elems_error)
   {
     auto &loc_err = elem_err.second;
-    err += loc_err;
     loc_err = std::pow(loc_err,one_p);
   }
 
@@ -872,19 +1470,19 @@ template<int dim,int codim,int range,int rank>
 Real h1_norm_difference(const Function<dim,codim,range,rank> &f,
                         const Function<dim,codim,range,rank> &g,
                         const std::shared_ptr<const Quadrature<dim>> &quad,
-                        SafeSTLMap<ElementIndex<dim>,Real> &elems_error)
+                        SafeSTLMap<ElementIndex<dim>,Real> &elems_error,
+                        const int n_threads = 1)
 {
   const Real p=2.;
   const Real one_p = 1./p;
 
-  norm_difference_functions<0,dim,codim,range,rank>(f,g,quad,p,elems_error);
-  norm_difference_functions<1,dim,codim,range,rank>(f,g,quad,p,elems_error);
+  norm_difference_functions<0,dim,codim,range,rank>(f,g,quad,p,elems_error,n_threads);
+  norm_difference_functions<1,dim,codim,range,rank>(f,g,quad,p,elems_error,n_threads);
 
-  Real err = 0;
+  const Real err = sum_element_values(elems_error);
   for (auto &elem_err : elems_error)
   {
     auto &loc_err = elem_err.second;
-    err += loc_err;
     loc_err = std::pow(loc_err,one_p);
   }
 
@@ -895,19 +1493,19 @@ template<int dim,int range>
 Real h1_norm_difference(const GridFunction<dim,range> &f,
                         const GridFunction<dim,range> &g,
                         const std::shared_ptr<const Quadrature<dim>> &quad,
-                        SafeSTLMap<ElementIndex<dim>,Real> &elems_error)
+                        SafeSTLMap<ElementIndex<dim>,Real> &elems_error,
+                        const int n_threads = 1)
 {
   const Real p=2.;
   const Real one_p = 1./p;
 
-  norm_difference_grid_functions<0,dim,range>(f,g,quad,p,elems_error);
-  norm_difference_grid_functions<1,dim,range>(f,g,quad,p,elems_error);
+  norm_difference_grid_functions<0,dim,range>(f,g,quad,p,elems_error,n_threads);
+  norm_difference_grid_functions<1,dim,range>(f,g,quad,p,elems_error,n_threads);
 
-  Real err = 0;
+  const Real err = sum_element_values(elems_error);
   for (auto &elem_err : elems_error)
   {
     auto &loc_err = elem_err.second;
-    err += loc_err;
     loc_err = std::pow(loc_err,one_p);
   }
 
@@ -920,10 +1518,11 @@ template<int dim, int codim = 0, int range = 1, int rank = 1>
 Real inf_norm_difference(const Function<dim,codim,range,rank> &f,
                          const Function<dim,codim,range,rank> &g,
                          const std::shared_ptr<const Quadrature<dim>> &quad,
-                         SafeSTLMap<ElementIndex<dim>,Real> &elems_error)
+                         SafeSTLMap<ElementIndex<dim>,Real> &elems_error,
+                         const int n_threads = 1)
 {
   const Real p=std::numeric_limits<Real>::infinity();
-  norm_difference_functions<0,dim,codim,range,rank>(f,g,quad,p,elems_error);
+  norm_difference_functions<0,dim,codim,range,rank>(f,g,quad,p,elems_error,n_threads);
   Real err = 0;
   for (const auto &elem_err : elems_error)
   {
@@ -938,10 +1537,11 @@ template<int dim,int range>
 Real inf_norm_difference(const GridFunction<dim,range> &f,
                          const GridFunction<dim,range> &g,
                          const std::shared_ptr<const Quadrature<dim>> &quad,
-                         SafeSTLMap<ElementIndex<dim>,Real> &elems_error)
+                         SafeSTLMap<ElementIndex<dim>,Real> &elems_error,
+                         const int n_threads = 1)
 {
   const Real p=std::numeric_limits<Real>::infinity();
-  norm_difference_grid_functions<0,dim,range>(f,g,quad,p,elems_error);
+  norm_difference_grid_functions<0,dim,range>(f,g,quad,p,elems_error,n_threads);
   Real err = 0;
   for (const auto &elem_err : elems_error)
   {
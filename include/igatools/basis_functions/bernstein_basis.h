@@ -107,6 +107,49 @@ DenseMatrix
 derivative(int k, const int p, const SafeSTLVector<Real> &x) ;
 
 
+/**
+ * @name Allocation-free kernels
+ */
+///@{
+/**
+ * Returns the minimum size of the buffer @p work needed by evaluate_derivatives()
+ * for the Bernstein's basis of degree @p p evaluated at @p n_points points.
+ */
+Size
+get_work_size(const int p, const int n_points);
+
+/**
+ * Computes, in a single pass, the values and the derivatives of order
+ * 1,...,<tt>n_orders-1</tt> of all the p+1 Bernstein's basis
+ * of degree @p p at the @p n_points points @p x.
+ *
+ * The results are written in the caller-provided buffer @p D_B
+ * (of size at least <tt>n_orders*(p+1)*n_points</tt>), where
+ * \f$ \frac{d^k B^p_i(x_j)}{dx^k} \f$ is stored at the position
+ * <tt>(k*(p+1)+i)*n_points+j</tt>, i.e. the point index runs faster
+ * than the basis index, that runs faster than the derivative order.
+ * The caller-provided buffer @p work
+ * (of size at least get_work_size(p,n_points))
+ * is used to store the intermediate results.
+ *
+ * No memory is allocated by this function. The degrees from 1 to 6 are
+ * handled by specialized versions, with loop bounds known at compile time.
+ *
+ * The computed values are identical to the ones returned by
+ * evaluate() and derivative().
+ *
+ * @warning The points \f$ x \f$ must belong to the unit interval [0,1], otherwise an
+ * assertion will be raised in Debug mode.
+ */
+void
+evaluate_derivatives(const int p,
+                     const int n_orders,
+                     const Real *x,
+                     const int n_points,
+                     Real *D_B,
+                     Real *work);
+///@}
+
 }
 
 
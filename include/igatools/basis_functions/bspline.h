@@ -26,6 +26,7 @@
 
 #include <igatools/basis_functions/reference_basis.h>
 #include <igatools/basis_functions/bernstein_extraction.h>
+#include <igatools/basis_functions/values1d_const_view.h>
 //#include <igatools/geometry/domain.h>
 #include <igatools/basis_functions/physical_basis.h>
 
@@ -272,6 +273,20 @@ public:
    */
   virtual const EndBehaviourTable &get_end_behaviour_table() const override final;
 
+  /**
+   * Computes (with the Bezier extraction) the values and the derivatives up to the
+   * order MAX_NUM_DERIVATIVES-1 of the one-dimensional B-splines of the component
+   * @p comp along the direction @p dir that are not zero on the interval
+   * @p interval_id, at the points @p pt_coords (defined on the unit interval).
+   *
+   * The derivatives are taken with respect to the coordinate of the Grid.
+   */
+  void evaluate_splines_1D(const int comp,
+                           const int dir,
+                           const Index interval_id,
+                           const SafeSTLVector<Real> &pt_coords,
+                           BasisValues1d &splines_1D) const;
+
   /**
    * Prints internal information about the basis.
    * @note Mostly used for debugging and testing.
@@ -143,6 +143,8 @@ private:
     SafeSTLArray<typename basis_element::Flags, dim+1> &flags_;
   };
 
+  class GlobalCache;
+
 public:
   using BaseElem = BasisElement<dim_,0,range_,rank_>;
   using BSplineElem = BSplineElement<dim_,range_,rank_>;
@@ -155,6 +157,7 @@ private:
   {
     InitCacheDispatcher(const GridHandler<dim_> &grid_handler,
                         const SafeSTLArray<typename basis_element::Flags, dim+1> &flags,
+                        SafeSTLArray<std::shared_ptr<const GlobalCache>,dim+1> *global_cache,
                         BSplineElem &elem);
 
 
@@ -164,6 +167,10 @@ private:
   private:
     const GridHandler<dim_> &grid_handler_;
     const SafeSTLArray<typename basis_element::Flags, dim+1> &flags_;
+
+    /** Global caches to be (re)built. It is nullptr if the global cache is not used. */
+    SafeSTLArray<std::shared_ptr<const GlobalCache>,dim+1> *global_cache_;
+
     BSplineElem &bsp_elem_;
 
     template<int sdim>
@@ -179,16 +186,35 @@ public:
                                const int s_id) const override final;
 
 private:
+  /**
+   * Evaluators of the tensor-product B-splines (one for each active component).
+   */
+  using BlockEvaluators = ComponentContainer<std::unique_ptr<TensorProductBlockEvaluator<dim>>>;
+
+  /**
+   * Evaluators used by the element cache fill, indexed as [sdim][s_id].
+   *
+   * They are constructed at the first fill of each sub-element (and
+   * reconstructed only if the quadrature or the derivatives to be computed
+   * change), then for each element only their one-dimensional factors are
+   * updated.
+   *
+   * @note Because of these evaluators, the same handler cannot be used
+   * to fill the cache of different elements concurrently.
+   */
+  mutable SafeSTLArray<SafeSTLVector<BlockEvaluators>,dim+1> block_evaluators_;
+
   struct FillCacheDispatcherNoGlobalCache : boost::static_visitor<void>
   {
     FillCacheDispatcherNoGlobalCache(const int s_id,
                                      const GridHandler<dim_> &grid_handler,
+                                     SafeSTLArray<SafeSTLVector<BlockEvaluators>,dim+1> &block_evaluators,
                                      BSplineElem &elem);
 
     template<int sdim>
     void operator()(const Topology<sdim> &topology);
 
-  private:
+  protected:
 
     template<int sdim>
     void fill_cache_1D(const Quadrature<dim> &extended_sub_elem_quad);
@@ -207,7 +233,7 @@ private:
      * an exception will be raised.
      */
     void evaluate_bspline_values(
-      const ComponentContainer<std::unique_ptr<const TensorProductFunctionEvaluator<dim>>> &elem_values,
+      const BlockEvaluators &elem_values,
       ValueTable<Value> &D_phi) const;
 
     /**
@@ -220,7 +246,7 @@ private:
      */
     template <int order>
     void evaluate_bspline_derivatives(
-      const ComponentContainer<std::unique_ptr<const TensorProductFunctionEvaluator<dim>>> &elem_values,
+      const BlockEvaluators &elem_values,
       ValueTable<Derivative<order>> &D_phi) const;
 
 
@@ -238,80 +264,214 @@ private:
 
     const int s_id_;
     const GridHandler<dim_> &grid_handler_;
+    SafeSTLArray<SafeSTLVector<BlockEvaluators>,dim+1> &block_evaluators_;
     BSplineElem &bsp_elem_;
   };
 
 
 
-#if 0
   /**
-   * One-dimensional B-splines values and derivatives at quadrature points.
-   * The values are stored with the following index ordering:
+   * Fills the element cache copying the one-dimensional B-splines values
+   * (and derivatives) from the GlobalCache, instead of computing them.
+   */
+  struct FillCacheDispatcherGlobalCache : FillCacheDispatcherNoGlobalCache
+  {
+    FillCacheDispatcherGlobalCache(const int s_id,
+                                   const GridHandler<dim_> &grid_handler,
+                                   const SafeSTLArray<std::shared_ptr<const GlobalCache>,dim+1> &global_cache,
+                                   SafeSTLArray<SafeSTLVector<BlockEvaluators>,dim+1> &block_evaluators,
+                                   BSplineElem &elem);
+
+    template<int sdim>
+    void operator()(const Topology<sdim> &topology);
+
+  private:
+    const SafeSTLArray<std::shared_ptr<const GlobalCache>,dim+1> &global_cache_;
+  };
+
+
+  /**
+   * One-dimensional B-splines values and derivatives at the quadrature points
+   * (of a given topological dimension), for all the intervals of the grid.
    *
-   * splines1d_[comp][dir][interval][order][function][point]
+   * The values are accessed with the following index ordering:
    *
-   * @ingroup serializable
+   * splines_1D[s_id][comp][dir][interval]
+   *
+   * Only one table is stored for consecutive interior intervals having the same
+   * length and the same Bezier extraction operator (i.e. the uniform interior intervals),
+   * therefore the memory used is (almost) independent of the number of intervals on
+   * uniform grids.
    */
   class GlobalCache
   {
-  private:
+  public:
+    /**
+     * Constructor. Computes the one-dimensional values for all the intervals
+     * and for all the <tt>sdim</tt>-dimensional sub-elements, using the
+     * quadrature @p quad.
+     */
+    template<int sdim>
+    GlobalCache(const Basis &basis, const std::shared_ptr<const Quadrature<sdim>> &quad);
 
+    /**
+     * Returns true if the cache has been built using the quadrature @p quad
+     * and the current grid of the @p basis.
+     */
+    template<int sdim>
+    bool is_built_for(const Basis &basis, const std::shared_ptr<const Quadrature<sdim>> &quad) const;
 
     /**
-     * Quadrature points used for the 1D basis evaluation.
+     * Returns the one-dimensional values of the component @p comp along
+     * the direction @p dir, on the interval @p interval_id, for the sub-element @p s_id.
      */
-    std::shared_ptr<const Quadrature<dim>> quad_;
+    const BasisValues1d &get_splines_1D(const int s_id,
+                                        const int comp,
+                                        const int dir,
+                                        const Index interval_id) const;
 
+    /**
+     * Returns the number of (distinct) one-dimensional tables stored in the cache.
+     */
+    Size get_num_tables() const;
 
-    using BasisValues1dTable = ComponentContainer<SafeSTLArray<std::map<Index,BasisValues1d>,dim>>;
+    void print_info(LogStream &out) const;
 
+  private:
     /**
-     * Values (and derivatives) of 1D basis precomputed in the initalized
-     * interval of a given direction.
-     *
-     * @note The map's key is the interval id. In Debug mode, it will be
-     * raised an assertion if
-     * the requested values are not initialized for the interval.
-     *
+     * Values of one component along one direction, for all the intervals.
      */
-    BasisValues1dTable basis_values_1d_table_;
+    struct IntervalsTable
+    {
+      /** For each interval, the position of its values in #splines_1D. */
+      SafeSTLVector<Index> interval_to_table;
 
+      /** Distinct one-dimensional values. */
+      SafeSTLVector<BasisValues1d> splines_1D;
+    };
 
-  public:
-    using ComponentMap = typename BasisValues1dTable::ComponentMap;
+    /**
+     * Quadrature used to build the cache.
+     */
+    std::shared_ptr<const void> quad_;
+
+    /**
+     * Number of intervals of the grid used to build the cache.
+     */
+    TensorSize<dim> n_intervals_;
 
-    GlobalCache() = default;
+    /**
+     * Tables indexed as [s_id][comp][dir] (only the active components are
+     * filled).
+     */
+    std::vector<SafeSTLArray<SafeSTLArray<IntervalsTable,dim>,n_components>> tables_;
+  };
 
-    GlobalCache(const std::shared_ptr<const Quadrature<dim>> &quad, const ComponentMap &component_map);
+  /**
+   * Global caches (one for each topological dimension).
+   * They are built by init_cache_impl(), if the global cache is enabled.
+   */
+  mutable SafeSTLArray<std::shared_ptr<const GlobalCache>,dim+1> global_cache_;
 
+  /**
+   * TRUE if the global cache is used.
+   */
+  bool use_global_cache_ = false;
 
-    ComponentContainer<std::unique_ptr<const TensorProductFunctionEvaluator<dim>> >
-        get_element_values(const TensorIndex<dim> &elem_tensor_id) const;
+public:
+  /**
+   * @name Global cache
+   */
+  ///@{
+  /**
+   * Enables (or disables) the global cache.
+   *
+   * When the global cache is enabled, the one-dimensional B-splines values
+   * (and derivatives) are computed once for all the intervals of the grid when the
+   * element cache is initialized, and then they are reused by all
+   * the subsequent cache fills (of any element, in any loop),
+   * instead of being recomputed for each element.
+   *
+   * The global cache is disabled by default.
+   *
+   * @note The global cache must be enabled before the initialization of the
+   * element cache. It is rebuilt at initialization if the quadrature or
+   * the grid are changed.
+   */
+  void enable_global_cache(const bool use_global_cache = true);
 
-    BasisValues1d &entry(const int comp, const int dir, const Index interval_id);
+  /**
+   * Returns TRUE if the global cache is enabled.
+   */
+  bool is_global_cache_enabled() const;
 
-    void print_info(LogStream &out) const;
+  /**
+   * Returns the number of (distinct) one-dimensional tables stored in the global cache
+   * for the sub-elements of dimension @p sdim
+   * (or 0 if the global cache for @p sdim has not been built).
+   */
+  Size get_num_global_cache_tables(const int sdim) const;
+  ///@}
 
-  private:
-#ifdef IGATOOLS_WITH_SERIALIZATION
-    /**
-     * @name Functions needed for boost::serialization
-     * @see <a href="http://www.boost.org/doc/libs/release/libs/serialization/">boost::serialization</a>
-     */
-    ///@{
-    friend class boost::serialization::access;
 
-    template<class Archive>
-    void
-    serialize(Archive &ar, const unsigned int version)
-    {
-      ar &boost::serialization::make_nvp("quad_",quad_);
-      ar &boost::serialization::make_nvp("basis_values_1d_table_",basis_values_1d_table_);
-    }
-    ///@}
-#endif // IGATOOLS_WITH_SERIALIZATION
+  /**
+   * @name Batched cache fill
+   */
+  ///@{
+  /**
+   * Values, gradients and hessians of the basis functions on the elements of a batch.
+   *
+   * The data of the <tt>i</tt>-th element of the batch are stored in the
+   * <tt>i</tt>-th entry of the vectors, with the same ordering of the basis
+   * functions used by the element cache.
+   */
+  struct CacheBatch
+  {
+    /** Values (filled if basis_element::Flags::value is used). */
+    std::vector<ValueTable<Value>> values;
+
+    /** Gradients (filled if basis_element::Flags::gradient is used). */
+    std::vector<ValueTable<Derivative<1>>> gradients;
+
+    /** Hessians (filled if basis_element::Flags::hessian is used). */
+    std::vector<ValueTable<Derivative<2>>> hessians;
   };
-#endif
+
+  /**
+   * Computes the basis functions data selected by @p flags
+   * (basis_element::Flags::value, basis_element::Flags::gradient and/or
+   * basis_element::Flags::hessian) at the points of the quadrature @p quad,
+   * for all the elements having the tensor indices @p elems_tensor_id
+   * (the <em>batch</em>).
+   *
+   * The one-dimensional B-splines along the directions 1,...,dim-1 and their
+   * tensor product are computed only when an element differs from the
+   * previous one of the batch along these directions. Therefore, for a row of
+   * elements along the direction 0, they are computed once for the whole row
+   * and only the one-dimensional B-splines along the direction 0 are computed
+   * for each element.
+   *
+   * @code{.cpp}
+     // all the elements in the row j of a 2D grid
+     SafeSTLVector<TensorIndex<2>> row;
+     for (int i = 0 ; i < n_intervals[0] ; ++i)
+       row.emplace_back(TensorIndex<2>({i,j}));
+
+     typename BSplineHandler<2,1,1>::CacheBatch batch;
+     handler.fill_cache_batch(row,quad,basis_element::Flags::gradient,batch);
+     @endcode
+   *
+   * @note The element caches are not used, i.e. the handler does not need
+   * to be initialized. The products of the one-dimensional factors are
+   * associated differently than in the element cache fill, therefore the
+   * results may differ from the ones in the element cache by round-off.
+   */
+  void fill_cache_batch(const SafeSTLVector<TensorIndex<dim_>> &elems_tensor_id,
+                        const std::shared_ptr<const Quadrature<dim_>> &quad,
+                        const typename basis_element::Flags &flags,
+                        CacheBatch &batch) const;
+  ///@}
+
 
 
 
@@ -24,6 +24,8 @@
 #include <igatools/base/config.h>
 #include <igatools/basis_functions/spline_space.h>
 #include <igatools/utils/concatenated_iterator.h>
+#include <igatools/utils/index_set.h>
+#include <igatools/utils/unique_id_generator.h>
 
 
 
@@ -330,6 +332,11 @@ public:
    */
   bool is_property_defined(const std::string &property) const;
 
+  /**
+   * Returns the names of the properties defined for the dofs.
+   */
+  SafeSTLVector<std::string> get_dofs_properties() const;
+
 
   /**
    * Returns true if the dof with id @p dof_id has the asked @p property.
@@ -347,12 +354,12 @@ public:
   /**
    * Returns the id of the dofs having a certain @p property (non-const version).
    */
-  std::set<Index> &get_global_dofs(const std::string &property = DofProperties::active);
+  IndexSet<Index> &get_global_dofs(const std::string &property = DofProperties::active);
 
   /**
    * Returns the id of the dofs having a certain @p property (const version).
    */
-  const std::set<Index> &get_global_dofs(const std::string &property = DofProperties::active) const;
+  const IndexSet<Index> &get_global_dofs(const std::string &property = DofProperties::active) const;
 
 
   /**
@@ -370,6 +377,25 @@ public:
   void set_all_dofs_property_status(const std::string &property, const bool status);
   ///@}
 
+  /**
+   * Returns an identifier of the current state of the DofDistribution.
+   *
+   * A new (unique) identifier is assigned each time the dof ids or the dof properties
+   * are modified by a member function (e.g. add_dofs_offset() or set_dof_property_status()),
+   * therefore it can be used to test if the data computed from the DofDistribution
+   * (e.g. the element-to-dofs table in SplineSpace) are still valid.
+   *
+   * @note The modifications done through the references (or views) returned by
+   * the non-const versions of get_dofs_view() and get_global_dofs() are not tracked.
+   */
+  Index get_state_id() const;
+
+private:
+  /**
+   * Assigns a new (unique) identifier to the current state of the DofDistribution.
+   */
+  void update_state_id();
+
 private:
 
   /**
@@ -405,6 +431,13 @@ private:
    */
   PropertiesDofs properties_dofs_;
 
+  /**
+   * Identifier of the current state of the DofDistribution.
+   *
+   * @see get_state_id()
+   */
+  Index state_id_ = UniqueIdGenerator::get_unique_id();
+
 #ifdef IGATOOLS_WITH_SERIALIZATION
   /**
    * @name Functions needed for serialization.
@@ -0,0 +1,334 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __PARALLEL_ASSEMBLER_H_
+#define __PARALLEL_ASSEMBLER_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/quadrature.h>
+#include <igatools/basis_functions/basis.h>
+#include <igatools/basis_functions/basis_element.h>
+#include <igatools/basis_functions/basis_handler.h>
+#include <igatools/linear_algebra/dense_matrix.h>
+#include <igatools/linear_algebra/dense_vector.h>
+#include <igatools/linear_algebra/epetra_matrix.h>
+#include <igatools/linear_algebra/epetra_vector.h>
+#include <igatools/utils/thread_tools.h>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Multithreaded driver for the loops over the elements of a Basis.
+ *
+ * The elements of the basis (having a given property) are processed in
+ * <em>batches</em>: each batch is made of <tt>n_threads</tt> consecutive
+ * blocks of <tt>block_size</tt> elements, and each block is processed by one thread.
+ * Each thread owns its own element accessor and its own cache handler (both
+ * created and initialized only once, at the beginning of assemble()),
+ * therefore the threads never share any cache.
+ *
+ * For each element, the thread fills the element cache and calls the user-provided
+ * <em>local work</em>, that computes the local contribution (local matrix and
+ * local vector) of the element.
+ * The local contributions are stored in a per-thread buffer and, when all the blocks of
+ * a batch are done, they are scattered (by the calling thread) into the global
+ * objects <b>in the same order of the serial element loop</b>.
+ * This means that the result of the assembly is bitwise identical to the one
+ * obtained with the serial loop, for any number of threads and any block size.
+ * The memory used by the buffers is bounded by <tt>n_threads * block_size</tt>
+ * local contributions.
+ *
+ * The local work is created, one for each thread, by a user-provided
+ * <em>factory</em>: this allows each thread to own the data needed for the
+ * computation of the local contributions (e.g. the element accessor and the cache
+ * handler of a Function used for the right hand side).
+ * @code{.cpp}
+   ParallelAssembler<dim,0,1,1> assembler(basis,quad,
+                                          Flags::value | Flags::gradient | Flags::w_measure);
+
+   auto create_local_work = [&]()
+   {
+     auto f_handler = std::shared_ptr<FuncHandler>(f->create_cache_handler());
+     f_handler->set_element_flags(function_element::Flags::D0);
+     auto f_elem = std::shared_ptr<FuncElem>(f->create_element_begin(ElementProperties::active));
+     f_handler->init_cache(*f_elem,quad);
+
+     return [f_handler,f_elem](BasisElem &elem, LocalContribution &loc)
+     {
+       f_elem->move_to(elem.get_index());
+       f_handler->fill_element_cache(*f_elem);
+
+       loc.matrix = elem.template integrate_gradu_gradv<dim>(0);
+       loc.vector = elem.template integrate_u_func<dim>(f_elem->get_element_values_D0(),0);
+     };
+   };
+
+   assembler.assemble(create_local_work,*matrix,*rhs);
+   @endcode
+ *
+ * @note The factory is called by the calling thread (once for each thread, before the
+ * threads are spawned), while the local works are called concurrently:
+ * a local work must modify only data owned by itself or by the element it receives.
+ *
+ * @ingroup linear_algebra
+ */
+template<int dim,int codim,int range,int rank>
+class ParallelAssembler
+{
+public:
+  using Bs = Basis<dim,codim,range,rank>;
+  using ElementAccessor = typename Bs::ElementAccessor;
+  using ElementIterator = typename Bs::ElementIterator;
+  using ElementHandler = BasisHandler<dim,codim,range,rank>;
+
+  using Flags = basis_element::Flags;
+
+  /**
+   * Contribution of a single element to the global objects.
+   */
+  struct LocalContribution
+  {
+    /** Global ids of the element's basis functions with the dofs property. */
+    SafeSTLVector<Index> dofs;
+
+    /** Local matrix. */
+    DenseMatrix matrix;
+
+    /** Local vector. */
+    DenseVector vector;
+  };
+
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. Not allowed to be used.
+   */
+  ParallelAssembler() = delete;
+
+  /**
+   * Constructor.
+   *
+   * @param[in] basis Basis over which the element loop is performed.
+   * @param[in] quad Quadrature scheme used to initialize the element caches.
+   * @param[in] flags Quantities that are computed in the element caches
+   * before the call of the local work.
+   * @param[in] n_threads Number of threads used in the loop.
+   * @param[in] block_size Number of consecutive elements processed by a thread
+   * in each batch.
+   * @param[in] elems_property Property of the elements on which the loop is performed.
+   * @param[in] dofs_property Property of the dofs used to define
+   * LocalContribution::dofs.
+   */
+  ParallelAssembler(const std::shared_ptr<const Bs> &basis,
+                    const std::shared_ptr<const Quadrature<dim>> &quad,
+                    const Flags &flags,
+                    const int n_threads = thread_tools::get_default_num_threads(),
+                    const Size block_size = 64,
+                    const PropId &elems_property = ElementProperties::active,
+                    const PropId &dofs_property = DofProperties::active)
+    :
+    basis_(basis),
+    quad_(quad),
+    flags_(flags),
+    n_threads_(n_threads),
+    block_size_(block_size),
+    elems_property_(elems_property),
+    dofs_property_(dofs_property)
+  {
+    Assert(basis_ != nullptr, ExcNullPtr());
+    Assert(quad_ != nullptr, ExcNullPtr());
+    Assert(n_threads_ > 0, ExcLowerRange(n_threads_,1));
+    Assert(block_size_ > 0, ExcLowerRange(block_size_,1));
+  }
+
+  /**
+   * Copy constructor. Not allowed to be used.
+   */
+  ParallelAssembler(const ParallelAssembler &assembler) = delete;
+
+  /**
+   * Move constructor. Not allowed to be used.
+   */
+  ParallelAssembler(ParallelAssembler &&assembler) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~ParallelAssembler() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /**
+   * Copy assignment operator. Not allowed to be used.
+   */
+  ParallelAssembler &operator=(const ParallelAssembler &assembler) = delete;
+
+  /**
+   * Move assignment operator. Not allowed to be used.
+   */
+  ParallelAssembler &operator=(ParallelAssembler &&assembler) = delete;
+  ///@}
+
+  /**
+   * Performs the element loop.
+   *
+   * @param[in] create_local_work Callable object with signature
+   * <tt>LocalWork()</tt>, returning the local work used by a thread.
+   * The LocalWork must be a callable object with signature
+   * <tt>void(ElementAccessor &elem, LocalContribution &loc)</tt>.
+   * When it is called, the cache of <tt>elem</tt> is filled and
+   * <tt>loc.dofs</tt> is already set.
+   * @param[in] scatter Callable object with signature
+   * <tt>void(const LocalContribution &loc)</tt>, called (by the calling thread)
+   * for each element, following the order of the elements in the Grid.
+   */
+  template <class LocalWorkFactory, class Scatter>
+  void assemble(const LocalWorkFactory &create_local_work,
+                const Scatter &scatter) const
+  {
+    using LocalWork = decltype(create_local_work());
+
+    struct ThreadData
+    {
+      ThreadData(const Bs &basis, const PropId &elems_property,
+                 LocalWork &&work, const Size block_size)
+        :
+        handler(basis.create_cache_handler()),
+        elem(basis.begin(elems_property)),
+        local_work(std::move(work)),
+        buffer(block_size)
+      {}
+
+      std::unique_ptr<ElementHandler> handler;
+      ElementIterator elem;
+      LocalWork local_work;
+
+      /** Position of elem in the list of elements with the given property. */
+      Index elem_pos = 0;
+
+      std::vector<LocalContribution> buffer;
+      Size n_filled = 0;
+    };
+
+    const Size n_elems =
+      basis_->get_grid()->get_num_elements(elems_property_);
+    if (n_elems == 0)
+      return;
+
+    // the threads' data are created by the calling thread
+    const int n_threads =
+      std::min(n_threads_, (n_elems + block_size_ - 1) / block_size_);
+    std::vector<ThreadData> threads_data;
+    threads_data.reserve(n_threads);
+    for (int t = 0 ; t < n_threads ; ++t)
+    {
+      threads_data.emplace_back(*basis_,elems_property_,create_local_work(),block_size_);
+      auto &data = threads_data.back();
+      data.handler->set_element_flags(flags_);
+      data.handler->init_element_cache(data.elem,quad_);
+    }
+
+    const Size batch_size = n_threads * block_size_;
+    for (Index batch_first = 0 ; batch_first < n_elems ; batch_first += batch_size)
+    {
+      thread_tools::run_in_parallel(n_threads,[&](const int t)
+      {
+        auto &data = threads_data[t];
+        data.n_filled = 0;
+
+        const Index first = batch_first + t * block_size_;
+        const Index last = std::min(first + block_size_, n_elems);
+
+        for (Index pos = first ; pos < last ; ++pos)
+        {
+          for (; data.elem_pos < pos ; ++data.elem_pos)
+            ++data.elem;
+
+          auto &elem = *data.elem;
+          data.handler->fill_element_cache(elem);
+
+          auto &loc = data.buffer[data.n_filled++];
+          loc.dofs = elem.get_local_to_global(dofs_property_);
+          loc.matrix.resize(0,0,false);
+          loc.vector.resize(0,false);
+          data.local_work(elem,loc);
+        }
+      });
+
+      for (const auto &data : threads_data)
+        for (Index i = 0 ; i < data.n_filled ; ++i)
+          scatter(data.buffer[i]);
+    }
+  }
+
+#ifdef IGATOOLS_USES_TRILINOS
+  /**
+   * Performs the element loop, adding the local contributions
+   * to the global @p matrix and to the global vector @p rhs.
+   *
+   * @note If the local work leaves the local matrix (or the local vector) empty,
+   * nothing is added to the @p matrix (or to @p rhs).
+   *
+   * @note The function FillComplete() is not called on @p matrix.
+   */
+  template <class LocalWorkFactory>
+  void assemble(const LocalWorkFactory &create_local_work,
+                EpetraTools::Matrix &matrix,
+                EpetraTools::Vector &rhs) const
+  {
+    this->assemble(create_local_work,
+                   [&matrix,&rhs](const LocalContribution &loc)
+    {
+      if (loc.matrix.size1() > 0)
+        matrix.add_block(loc.dofs,loc.dofs,loc.matrix);
+      if (loc.vector.size() > 0)
+        rhs.add_block(loc.dofs,loc.vector);
+    });
+  }
+#endif // IGATOOLS_USES_TRILINOS
+
+  /**
+   * Returns the number of threads used in the element loop.
+   */
+  int get_num_threads() const
+  {
+    return n_threads_;
+  }
+
+private:
+  std::shared_ptr<const Bs> basis_;
+
+  std::shared_ptr<const Quadrature<dim>> quad_;
+
+  Flags flags_;
+
+  int n_threads_;
+
+  Size block_size_;
+
+  PropId elems_property_;
+
+  PropId dofs_property_;
+};
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __PARALLEL_ASSEMBLER_H_
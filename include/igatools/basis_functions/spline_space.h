@@ -27,8 +27,13 @@
 #include <igatools/utils/static_multi_array.h>
 #include <igatools/utils/dynamic_multi_array.h>
 #include <igatools/utils/shared_ptr_constness_handler.h>
+#include <igatools/utils/container_view.h>
 #include <igatools/geometry/grid.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 
 IGA_NAMESPACE_OPEN
 
@@ -329,6 +334,96 @@ public:
 
   SafeSTLVector<Index> get_active_components_id() const;
 
+  /**
+   * @brief Element-to-dofs connectivity table for the dofs with a given property.
+   *
+   * The table is stored in compressed (CSR-like) format: for each element (identified
+   * by its flat id in the Grid) the global dof ids, the patch-local dof ids and
+   * the element-local dof ids of the basis functions with the property are stored
+   * contiguously, and the functions of this class return views on them.
+   *
+   * @see SplineSpace::get_element_dofs_table()
+   */
+  class ElementDofsTable
+  {
+  public:
+    using DofsConstView = ConstContainerView<SafeSTLVector<Index>>;
+
+    /**
+     * Returns the global ids of the dofs of the element with flat id @p elem_flat_id.
+     */
+    DofsConstView get_global_dofs(const Index elem_flat_id) const
+    {
+      return this->get_view(dofs_global_,elem_flat_id);
+    }
+
+    /**
+     * Returns the patch-local ids of the dofs of the element with flat id @p elem_flat_id.
+     */
+    DofsConstView get_local_to_patch(const Index elem_flat_id) const
+    {
+      return this->get_view(dofs_local_to_patch_,elem_flat_id);
+    }
+
+    /**
+     * Returns the element-local ids of the dofs of the element with flat id @p elem_flat_id.
+     */
+    DofsConstView get_local_to_elem(const Index elem_flat_id) const
+    {
+      return this->get_view(dofs_local_to_elem_,elem_flat_id);
+    }
+
+    /**
+     * Returns the number of dofs of the element with flat id @p elem_flat_id.
+     */
+    Size get_num_dofs(const Index elem_flat_id) const
+    {
+      Assert(elem_flat_id >= 0 && elem_flat_id < Index(offsets_.size())-1,
+             ExcIndexRange(elem_flat_id,0,Index(offsets_.size())-1));
+      return offsets_[elem_flat_id+1] - offsets_[elem_flat_id];
+    }
+
+  private:
+    DofsConstView get_view(const SafeSTLVector<Index> &dofs, const Index elem_flat_id) const
+    {
+      Assert(elem_flat_id >= 0 && elem_flat_id < Index(offsets_.size())-1,
+             ExcIndexRange(elem_flat_id,0,Index(offsets_.size())-1));
+      return DofsConstView(dofs.cbegin() + offsets_[elem_flat_id],
+                           dofs.cbegin() + offsets_[elem_flat_id+1]);
+    }
+
+    /**
+     * The dofs of the element with flat id <tt>i</tt> are in the range
+     * <tt>[offsets_[i],offsets_[i+1])</tt> of the vectors below.
+     */
+    SafeSTLVector<Index> offsets_;
+
+    SafeSTLVector<Index> dofs_global_;
+
+    SafeSTLVector<Index> dofs_local_to_patch_;
+
+    SafeSTLVector<Index> dofs_local_to_elem_;
+
+    friend class SplineSpace<dim_,range_,rank_>;
+  };
+
+  /**
+   * Returns the element-to-dofs table for the dofs with the given @p dofs_property.
+   *
+   * The table is built the first time it is requested (for a given property) and
+   * then stored in the SplineSpace. It is built again if the DofDistribution
+   * has been modified (e.g. because the dofs properties have been changed, or
+   * after a refinement).
+   *
+   * @note This function can be called concurrently by different threads: the lookup
+   * of the table is done under a mutex, while different tables can be built concurrently.
+   * The tables built for a previous state of the DofDistribution are never destroyed before
+   * the SplineSpace, therefore the returned reference (and the views obtained from it)
+   * stays valid, but it refers to the dofs at the time the table was built.
+   */
+  const ElementDofsTable &
+  get_element_dofs_table(const std::string &dofs_property) const;
+
   void get_element_dofs(
     const typename GridType::IndexType &elem_id,
     SafeSTLVector<Index> &dofs_global,
@@ -471,6 +566,53 @@ private:
    */
   std::shared_ptr<DofDistribution<dim_,range_,rank_> > dof_distribution_;
 
+  /**
+   * Element-to-dofs table of a dofs property, built only once (on its first request).
+   */
+  struct ElementDofsTableSlot
+  {
+    std::once_flag is_built;
+
+    ElementDofsTable table;
+  };
+
+  /**
+   * Element-to-dofs tables (one slot for each dofs property of the DofDistribution).
+   */
+  using ElementDofsTables = std::map<std::string,std::unique_ptr<ElementDofsTableSlot>>;
+
+  /**
+   * Element-to-dofs tables for the current state of the DofDistribution,
+   * built on demand by get_element_dofs_table().
+   */
+  mutable std::shared_ptr<ElementDofsTables> element_dofs_tables_;
+
+  /**
+   * Element-to-dofs tables built for the previous states of the DofDistribution.
+   * They are kept alive because the views returned by get_element_dofs_table()
+   * may still refer to them.
+   */
+  mutable SafeSTLVector<std::shared_ptr<const ElementDofsTables>> old_element_dofs_tables_;
+
+  /**
+   * State of the DofDistribution for which element_dofs_tables_ have been created.
+   *
+   * @see DofDistribution::get_state_id()
+   */
+  mutable Index element_dofs_tables_state_id_;
+
+  /**
+   * Mutex guarding element_dofs_tables_, old_element_dofs_tables_ and
+   * element_dofs_tables_state_id_.
+   */
+  mutable std::mutex element_dofs_tables_mutex_;
+
+  /**
+   * Fills the element-to-dofs @p table for the dofs with the given @p dofs_property.
+   */
+  void build_element_dofs_table(const std::string &dofs_property,
+                                ElementDofsTable &table) const;
+
   /**
    * Unique identifier associated to each object instance.
    */
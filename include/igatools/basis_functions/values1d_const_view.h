@@ -30,6 +30,9 @@
 #include <igatools/utils/tensor_sized_container.h>
 #include <igatools/base/quadrature.h>
 
+#include <algorithm>
+#include <vector>
+
 IGA_NAMESPACE_OPEN
 
 /**
@@ -208,6 +211,431 @@ private:
 
 
 
+/**
+ * @brief Evaluator of the partial derivatives of tensor-product functions
+ * by blocks of points.
+ *
+ * The partial derivative of order \f$ \mathbf{o} = (o_0,\dots,o_{d-1}) \f$
+ * of the function
+ * \f$ \phi_{\mathbf{i}}(\mathbf{x}) = \prod_{k=0}^{d-1} B^k_{i_k}(x_k) \f$
+ * is written as
+ * \f[
+ * \partial^{\mathbf{o}} \phi_{\mathbf{i}}(\mathbf{x}) =
+ * \partial^{o_0} B^0_{i_0}(x_0) \,
+ * R^{(o_1,\dots,o_{d-1})}_{i_1,\dots,i_{d-1}}(x_1,\dots,x_{d-1})
+ * \f]
+ * where the partial products
+ * \f$ R^{(o_1,\dots,o_{d-1})} = \prod_{k=1}^{d-1} \partial^{o_k} B^k \f$
+ * are computed by update_partial_products() once for each distinct order
+ * \f$ (o_1,\dots,o_{d-1}) \f$ among the requested ones, for all the
+ * functions and all the points.
+ * Then evaluate_block() writes the values of one function at all the points
+ * using a single multiplication for each value, instead of the \f$ d-1 \f$
+ * multiplications (and the tensor-index translations) of
+ * TensorProductFunctionEvaluator::evaluate().
+ *
+ * The partial products do not depend on the one-dimensional values along
+ * the direction 0, therefore they can be reused on the elements having the
+ * same position along the directions \f$ 1,\dots,d-1 \f$, calling only
+ * update_first_direction() (see BSplineHandler::fill_cache_batch()).
+ * Moreover, an evaluator can be reused on different elements (calling update())
+ * as long as is_set_up_for() returns true.
+ *
+ * If igatools is compiled with <tt>TIME_PROFILING</tt> defined,
+ * the number of multiplications performed are counted and reported by
+ * get_operation_counts().
+ */
+template <int dim>
+class TensorProductBlockEvaluator
+{
+public:
+#ifdef TIME_PROFILING
+  /**
+   * Number of multiplications performed by the evaluator.
+   */
+  struct OperationCounts
+  {
+    /** Multiplications used to compute the partial products. */
+    Size partial_products = 0;
+
+    /** Multiplications used to compute the blocks of values. */
+    Size block_products = 0;
+  };
+#endif // #ifdef TIME_PROFILING
+
+  /** @name Constructors */
+  ///@{
+  /**
+   * Constructor. Sets up the evaluation of the derivatives of orders
+   * @p orders for the tensor-product functions having @p n_funcs
+   * one-dimensional functions along each direction, at the points of
+   * @p quad.
+   */
+  TensorProductBlockEvaluator(const TensorSize<dim> &n_funcs,
+                              const Quadrature<dim> &quad,
+                              const SafeSTLVector<TensorIndex<dim>> &orders)
+    :
+    orders_(orders),
+    n_funcs_(n_funcs),
+    pts_t_id_(quad.get_map_point_id_to_coords_id()),
+    n_pts_(quad.get_num_points())
+  {
+    const auto n_coords = quad.get_num_coords_direction();
+
+    TensorSize<dim> n_funcs_rest = n_funcs;
+    TensorSize<dim> n_coords_rest = n_coords;
+    if (dim > 0)
+    {
+      n_funcs_0_ = n_funcs[0];
+      n_pts_0_ = n_coords[0];
+      n_funcs_rest[0] = 1;
+      n_coords_rest[0] = 1;
+    }
+    n_funcs_rest_ = n_funcs_rest.flat_size();
+    n_pts_rest_ = n_coords_rest.flat_size();
+
+    // the indices of the partial products have the direction 1 running faster
+    const auto rest_flat_id = [](const TensorIndex<dim> &t_id, const TensorSize<dim> &size)
+    {
+      int id = 0;
+      for (int dir = dim-1 ; dir > 0 ; --dir)
+        id = id * size[dir] + t_id[dir];
+      return id;
+    };
+
+    const TensorSizedContainer<dim> f_size(n_funcs);
+    const int n_funcs_total = n_funcs.flat_size();
+    func_id_0_.resize(n_funcs_total,0);
+    func_id_rest_.resize(n_funcs_total);
+    rest_func_t_id_.resize(n_funcs_rest_);
+    for (int fn = 0 ; fn < n_funcs_total ; ++fn)
+    {
+      const auto f_t_id = f_size.flat_to_tensor(fn);
+      if (dim > 0)
+        func_id_0_[fn] = f_t_id[0];
+      func_id_rest_[fn] = rest_flat_id(f_t_id,n_funcs);
+      rest_func_t_id_[func_id_rest_[fn]] = f_t_id;
+    }
+
+    const auto &pts_t_id = quad.get_map_point_id_to_coords_id();
+    pt_id_0_.resize(n_pts_,0);
+    pt_id_rest_.resize(n_pts_);
+    rest_pt_t_id_.resize(n_pts_rest_);
+    for (int pt = 0 ; pt < n_pts_ ; ++pt)
+    {
+      const auto &p_t_id = pts_t_id[pt];
+      if (dim > 0)
+        pt_id_0_[pt] = p_t_id[0];
+      pt_id_rest_[pt] = rest_flat_id(p_t_id,n_coords);
+      rest_pt_t_id_[pt_id_rest_[pt]] = p_t_id;
+    }
+
+    // distinct orders along the direction 0 and along the other directions
+    const int n_orders = orders_.size();
+    first_order_id_.resize(n_orders);
+    rest_order_id_.resize(n_orders);
+    for (int k = 0 ; k < n_orders ; ++k)
+    {
+      const int order_0 = (dim > 0) ? orders_[k][0] : 0;
+      auto it_0 = std::find(first_orders_.begin(), first_orders_.end(), order_0);
+      first_order_id_[k] = std::distance(first_orders_.begin(), it_0);
+      if (it_0 == first_orders_.end())
+        first_orders_.push_back(order_0);
+
+      TensorIndex<dim> order_rest = orders_[k];
+      if (dim > 0)
+        order_rest[0] = 0;
+      auto it_rest = std::find(rest_orders_.begin(), rest_orders_.end(), order_rest);
+      rest_order_id_[k] = std::distance(rest_orders_.begin(), it_rest);
+      if (it_rest == rest_orders_.end())
+        rest_orders_.push_back(order_rest);
+    }
+
+    first_dir_.resize(first_orders_.size());
+    for (auto &f : first_dir_)
+      f.assign(n_funcs_0_ * n_pts_0_, 1.0);
+
+    rest_.resize(rest_orders_.size());
+    for (auto &r : rest_)
+      r.assign(n_funcs_rest_ * n_pts_rest_, 1.0);
+  }
+
+  /** Copy constructor. */
+  TensorProductBlockEvaluator(const TensorProductBlockEvaluator<dim> &in) = default;
+
+  /** Move constructor. */
+  TensorProductBlockEvaluator(TensorProductBlockEvaluator<dim> &&in) = default;
+
+  /** Destructor. */
+  ~TensorProductBlockEvaluator() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /** Copy assignment operator. */
+  TensorProductBlockEvaluator<dim> &operator=(const TensorProductBlockEvaluator<dim> &in) = default;
+
+  /** Move assignment operator. */
+  TensorProductBlockEvaluator<dim> &operator=(TensorProductBlockEvaluator<dim> &&in) = default;
+  ///@}
+
+  /** @name Updating the one-dimensional factors */
+  ///@{
+  /**
+   * Computes the partial products along the directions 1,...,dim-1
+   * from the one-dimensional values @p values_1D.
+   */
+  void update_partial_products(const ElemFuncValues<dim> &values_1D)
+  {
+    const int n_rest_orders = rest_orders_.size();
+    for (int r = 0 ; r < n_rest_orders ; ++r)
+    {
+      auto &rest_r = rest_[r];
+      for (int dir = 1 ; dir < dim ; ++dir)
+      {
+        const auto &splines = values_1D[dir].get_derivative(rest_orders_[r][dir]);
+        auto rest_it = rest_r.begin();
+        for (int fn = 0 ; fn < n_funcs_rest_ ; ++fn)
+        {
+          const int f_dir = rest_func_t_id_[fn][dir];
+          if (dir == 1)
+            for (int pt = 0 ; pt < n_pts_rest_ ; ++pt, ++rest_it)
+              *rest_it = splines(f_dir,rest_pt_t_id_[pt][dir]);
+          else
+            for (int pt = 0 ; pt < n_pts_rest_ ; ++pt, ++rest_it)
+              *rest_it *= splines(f_dir,rest_pt_t_id_[pt][dir]);
+        } // end loop fn
+      } // end loop dir
+    } // end loop r
+
+#ifdef TIME_PROFILING
+    if (dim > 2)
+      op_counts_.partial_products += n_rest_orders * n_funcs_rest_ * n_pts_rest_ * (dim-2);
+#endif // #ifdef TIME_PROFILING
+  }
+
+  /**
+   * Copies the one-dimensional values along the direction 0
+   * from @p values_1D.
+   */
+  void update_first_direction(const ElemFuncValues<dim> &values_1D)
+  {
+    if (dim == 0)
+      return;
+
+    const int n_first_orders = first_orders_.size();
+    for (int f = 0 ; f < n_first_orders ; ++f)
+    {
+      const auto &splines = values_1D[0].get_derivative(first_orders_[f]);
+      auto first_it = first_dir_[f].begin();
+      for (int fn = 0 ; fn < n_funcs_0_ ; ++fn)
+        for (int pt = 0 ; pt < n_pts_0_ ; ++pt, ++first_it)
+          *first_it = splines(fn,pt);
+    }
+  }
+
+  /**
+   * Updates the partial products and the values along the direction 0
+   * from @p values_1D.
+   */
+  void update(const ElemFuncValues<dim> &values_1D)
+  {
+    update_partial_products(values_1D);
+    update_first_direction(values_1D);
+  }
+  ///@}
+
+  /** @name Evaluation */
+  ///@{
+  /**
+   * Returns true if the evaluator has been set up for the tensor-product
+   * functions having @p n_funcs one-dimensional functions along each direction,
+   * for the points of @p quad and for the derivative orders @p orders,
+   * i.e. if it can be reused (calling update()) instead of constructing a new one.
+   */
+  bool is_set_up_for(const TensorSize<dim> &n_funcs,
+                     const Quadrature<dim> &quad,
+                     const SafeSTLVector<TensorIndex<dim>> &orders) const
+  {
+    return n_funcs == n_funcs_ &&
+           orders == orders_ &&
+           quad.get_map_point_id_to_coords_id() == pts_t_id_;
+  }
+
+  /**
+   * Returns the orders of the derivatives that can be evaluated.
+   */
+  const SafeSTLVector<TensorIndex<dim>> &get_orders() const
+  {
+    return orders_;
+  }
+
+  /**
+   * Returns the position of the derivative order @p order in the vector
+   * returned by get_orders().
+   */
+  int get_order_id(const TensorIndex<dim> &order) const
+  {
+    const auto it = std::find(orders_.begin(), orders_.end(), order);
+    Assert(it != orders_.end(), ExcMessage("Derivative order not set up in the evaluator."));
+    return std::distance(orders_.begin(), it);
+  }
+
+  /**
+   * Returns the number of evaluation points.
+   */
+  int get_num_points() const
+  {
+    return n_pts_;
+  }
+
+  /**
+   * Writes in @p block the derivative of order <tt>get_orders()[order_id]</tt>
+   * of the function @p func_id at all the points.
+   *
+   * @warning @p block must have room for get_num_points() values.
+   */
+  void evaluate_block(const int order_id, const int func_id, Real *block) const
+  {
+    Assert(order_id >= 0 && order_id < orders_.size(),
+           ExcIndexRange(order_id,0,orders_.size()));
+    Assert(block != nullptr, ExcNullPtr());
+
+    const Real *first = first_dir_[first_order_id_[order_id]].data() +
+                        func_id_0_[func_id] * n_pts_0_;
+    if (dim > 1)
+    {
+      const Real *rest = rest_[rest_order_id_[order_id]].data() +
+                         func_id_rest_[func_id] * n_pts_rest_;
+      for (int pt = 0 ; pt < n_pts_ ; ++pt)
+        block[pt] = first[pt_id_0_[pt]] * rest[pt_id_rest_[pt]];
+
+#ifdef TIME_PROFILING
+      op_counts_.block_products += n_pts_;
+#endif // #ifdef TIME_PROFILING
+    }
+    else
+    {
+      for (int pt = 0 ; pt < n_pts_ ; ++pt)
+        block[pt] = first[pt_id_0_[pt]];
+    }
+  }
+
+  /**
+   * Returns the derivative of order <tt>get_orders()[order_id]</tt>
+   * of the function @p func_id at the point @p pt.
+   */
+  Real evaluate(const int order_id, const int func_id, const int pt) const
+  {
+    const Real first = first_dir_[first_order_id_[order_id]][func_id_0_[func_id] * n_pts_0_ + pt_id_0_[pt]];
+    if (dim > 1)
+    {
+#ifdef TIME_PROFILING
+      ++op_counts_.block_products;
+#endif // #ifdef TIME_PROFILING
+      return first * rest_[rest_order_id_[order_id]][func_id_rest_[func_id] * n_pts_rest_ + pt_id_rest_[pt]];
+    }
+    else
+      return first;
+  }
+  ///@}
+
+  /** @name Operation counts */
+  ///@{
+#ifdef TIME_PROFILING
+  /**
+   * Returns the number of multiplications performed since the construction
+   * (or since the last call to reset_operation_counts()).
+   */
+  const OperationCounts &get_operation_counts() const
+  {
+    return op_counts_;
+  }
+
+  /**
+   * Sets to zero the operation counts.
+   */
+  void reset_operation_counts()
+  {
+    op_counts_ = OperationCounts();
+  }
+#endif // #ifdef TIME_PROFILING
+
+  /**
+   * Returns the number of multiplications used by the direct evaluation
+   * (i.e. as product of <tt>dim</tt> one-dimensional factors, as in
+   * TensorProductFunctionEvaluator::evaluate()) of all the derivatives
+   * of all the functions at all the points.
+   */
+  Size get_num_products_direct() const
+  {
+    return (dim > 1) ? orders_.size() * func_id_0_.size() * n_pts_ * (dim-1) : 0;
+  }
+  ///@}
+
+  void print_info(LogStream &out) const
+  {
+    out.begin_item("Derivative orders:");
+    orders_.print_info(out);
+    out.end_item();
+
+    out << "Distinct orders along the direction 0: " << first_orders_.size() << std::endl;
+    out << "Distinct partial products: " << rest_orders_.size() << std::endl;
+  }
+
+private:
+  SafeSTLVector<TensorIndex<dim>> orders_;
+
+  /** Number of one-dimensional functions along each direction. */
+  TensorSize<dim> n_funcs_;
+
+  /** Coordinate indices of each point. */
+  SafeSTLVector<TensorIndex<dim>> pts_t_id_;
+
+  int n_pts_;
+
+  int n_funcs_0_ = 1;
+  int n_pts_0_ = 1;
+  int n_funcs_rest_;
+  int n_pts_rest_;
+
+  /** Tensor index along the direction 0 of each function. */
+  std::vector<int> func_id_0_;
+
+  /** Flat index along the directions 1,...,dim-1 of each function. */
+  std::vector<int> func_id_rest_;
+
+  /** Coordinate index along the direction 0 of each point. */
+  std::vector<int> pt_id_0_;
+
+  /** Flat coordinate index along the directions 1,...,dim-1 of each point. */
+  std::vector<int> pt_id_rest_;
+
+  std::vector<TensorIndex<dim>> rest_func_t_id_;
+  std::vector<TensorIndex<dim>> rest_pt_t_id_;
+
+  /** Distinct derivative orders along the direction 0. */
+  std::vector<int> first_orders_;
+
+  /** Distinct derivative orders along the directions 1,...,dim-1. */
+  std::vector<TensorIndex<dim>> rest_orders_;
+
+  std::vector<int> first_order_id_;
+  std::vector<int> rest_order_id_;
+
+  /** One-dimensional values along the direction 0, for each distinct order. */
+  std::vector<std::vector<Real>> first_dir_;
+
+  /** Partial products, for each distinct order. */
+  std::vector<std::vector<Real>> rest_;
+
+#ifdef TIME_PROFILING
+  mutable OperationCounts op_counts_;
+#endif // #ifdef TIME_PROFILING
+};
+
+
+
 
 /**
  * @brief Const view to one-dimensional BSpline function over an interval.
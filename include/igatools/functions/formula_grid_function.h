@@ -80,7 +80,7 @@ public:
         IgCoefficients sub_coeffs;
         const int n_sub_dofs = dof_map.size();
         for (int sub_dof = 0 ; sub_dof < n_sub_dofs ; ++ sub_dof)
-          sub_coeffs[sub_dof] = coeffs_[dof_map[sub_dof]];
+          sub_coeffs.insert(sub_dof,coeffs_[dof_map[sub_dof]]);
 
         auto sub_func = IgGridFunction<sdim,range>::const_create(sub_ref_basis,sub_coeffs);
 
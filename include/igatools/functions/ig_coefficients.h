@@ -24,9 +24,18 @@
 
 #include <igatools/base/config.h>
 #include <igatools/base/logstream.h>
+#include <igatools/base/types.h>
+#include <igatools/utils/safe_stl_vector.h>
+#include <igatools/utils/index_set.h>
+
+#ifdef IGATOOLS_USES_TRILINOS
+#include <igatools/linear_algebra/epetra_vector.h>
+#endif // IGATOOLS_USES_TRILINOS
 
 #include <map>
 #include <set>
+#include <memory>
+#include <iterator>
 
 
 IGA_NAMESPACE_OPEN
@@ -34,20 +43,54 @@ IGA_NAMESPACE_OPEN
 /**
  * @brief Coefficients for the IgFunction and IgGridFunction classes.
  *
- * Basically it is a <tt>std::map<Index,Real></tt> in which its <tt>key</tt> is the global dof
- * and the associated <tt>value</tt> is the coefficient associated to the dof.
+ * It is a container that associates a coefficient (the <tt>value</tt>)
+ * to a global dof (the <tt>key</tt>), with an interface similar to the one of
+ * <tt>std::map<Index,Real></tt>: the iteration is done in increasing order of the global dofs,
+ * and the dereferenced iterators have the members <tt>first</tt> (the global dof)
+ * and <tt>second</tt> (the coefficient).
+ *
+ * Internally, the coefficients are stored in one of the following ways:
+ * - <b>dense storage</b>: if the global dofs form a contiguous range
+ * <tt>[first_dof,first_dof+size)</tt>, the coefficients are stored in a contiguous vector
+ * and the access to a coefficient is a simple indexed load.
+ * This is the case for the coefficients inserted
+ * in increasing (and contiguous) order of the global dofs, as it is usually done;
+ * - <b>sparse storage</b>: if a global dof that breaks the contiguity is inserted,
+ * the coefficients are moved into a <tt>std::map<Index,Real></tt>.
+ *
+ * The dense storage can also be a read-only view on the values of an
+ * EpetraTools::Vector (see IgCoefficients(const std::shared_ptr<const EpetraTools::Vector> &)).
+ * In this case no copy is performed until a coefficient is modified.
  *
- * @note We do not use the EpetraTools::Vector because we want the IgCoefficient class to be
+ * Differently from <tt>std::map</tt>, the coefficients can be added only with insert()
+ * (or with the constructors): the access operators never insert new coefficients,
+ * therefore they never invalidate the references previously returned.
+ *
+ * @note We do not use the EpetraTools::Vector as only storage because we want the
+ * IgCoefficient class to be
  * <em>serializable</em> and to make EpetraTools::Vector serializable is not an easy task
  * (it requires to make serializable all the attributes of EpetraTools::Vector).
  *
  * @ingroup serializable
  */
 class IgCoefficients
-  : public std::map<Index,Real>
 {
+private:
+  template <bool is_const>
+  class Iterator;
+
 public:
+  /** Type of the iterator (non-const version). */
+  using iterator = Iterator<false>;
+
+  /** Type of the iterator (const version). */
+  using const_iterator = Iterator<true>;
 
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. It builds an empty container.
+   */
   IgCoefficients() = default;
 
   /**
@@ -56,6 +99,67 @@ public:
    */
   IgCoefficients(const std::set<Index> &global_dofs);
 
+  /**
+   * /brief Initialize to zero the coefficients associated with the <tt>global_dofs</tt>
+   * used in the input argument.
+   */
+  IgCoefficients(const IndexSet<Index> &global_dofs);
+
+  /**
+   * Builds the container from the pairs <tt>(global_dof,coefficient)</tt> in @p dofs_values.
+   */
+  explicit IgCoefficients(const std::map<Index,Real> &dofs_values);
+
+#ifdef IGATOOLS_USES_TRILINOS
+  /**
+   * Builds the coefficients as a (read-only) view on the values of the vector @p vec,
+   * i.e. without copying them. The global dofs are the global ids of the vector's map.
+   *
+   * The vector is kept alive by the container (and by its copies) and it must not be
+   * modified while the view is in use. If a coefficient is modified through the container,
+   * the values are copied into an internal storage (and the view is released).
+   *
+   * @note If the global ids of the vector's map are not contiguous, the values are copied.
+   */
+  explicit IgCoefficients(const std::shared_ptr<const EpetraTools::Vector> &vec);
+
+  /**
+   * Builds the coefficients associated to the @p global_dofs, copying their values
+   * from the vector @p vec.
+   */
+  IgCoefficients(const IndexSet<Index> &global_dofs, const EpetraTools::Vector &vec);
+
+  /**
+   * Builds the coefficients associated to the @p global_dofs, taking their values
+   * from the vector @p vec.
+   *
+   * If the global ids of the vector's map are exactly the @p global_dofs
+   * (in a contiguous range), the container is a view on the values of @p vec
+   * (see IgCoefficients(const std::shared_ptr<const EpetraTools::Vector> &)),
+   * otherwise the values are copied.
+   */
+  IgCoefficients(const IndexSet<Index> &global_dofs,
+                 const std::shared_ptr<const EpetraTools::Vector> &vec);
+#endif // IGATOOLS_USES_TRILINOS
+
+  /** Copy constructor. */
+  IgCoefficients(const IgCoefficients &coeffs) = default;
+
+  /** Move constructor. */
+  IgCoefficients(IgCoefficients &&coeffs) = default;
+
+  /** Destructor. */
+  ~IgCoefficients() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /** Copy assignment operator. */
+  IgCoefficients &operator=(const IgCoefficients &coeffs) = default;
+
+  /** Move assignment operator. */
+  IgCoefficients &operator=(IgCoefficients &&coeffs) = default;
+  ///@}
 
   /**
    * Access operator.
@@ -67,18 +171,254 @@ public:
 
   /**
    * Access operator.
-   * If @p global_dof matches the key of an element in the container, the function returns a reference to its mapped value.
+   * Returns a reference to the mapped value of the element identified with key @p global_dof.
    * If @p global_dof does not match the key of any element in the container,
-   * the function inserts a new element with that key and returns a reference to its mapped value.
+   * the function throws an <tt>out_of_range</tt> exception.
+   *
+   * @note Differently from <tt>std::map</tt>, no element is inserted: use insert() instead.
    */
   Real &operator[](const Index global_dof);
 
+  /**
+   * Inserts the coefficient @p value associated to the global dof @p global_dof,
+   * if @p global_dof does not match the key of any element in the container
+   * (otherwise the container is not modified).
+   * Returns true if the coefficient has been inserted.
+   *
+   * @warning The insertion can move the coefficients in memory, therefore
+   * it invalidates the references and the iterators previously obtained from the container.
+   */
+  bool insert(const Index global_dof, const Real value);
+
+  /**
+   * Returns a reference to the mapped value of the element identified with key @p global_dof.
+   * If @p global_dof does not match the key of any element in the container,
+   * the function throws an <tt>out_of_range</tt> exception.
+   */
+  const Real &at(const Index global_dof) const;
+
+  /**
+   * Returns a reference to the mapped value of the element identified with key @p global_dof.
+   * If @p global_dof does not match the key of any element in the container,
+   * the function throws an <tt>out_of_range</tt> exception.
+   */
+  Real &at(const Index global_dof);
+
+  /**
+   * Returns the number of coefficients associated to the global dof @p global_dof (i.e. 0 or 1).
+   */
+  Size count(const Index global_dof) const;
+
   /** Return the number of coefficients stored in the container. */
   Index size() const;
 
+  /** Returns true if the container is empty. */
+  bool empty() const;
+
+  /** Removes all the coefficients from the container. */
+  void clear();
+
+  /**
+   * Gathers the coefficients associated to the global dofs @p global_dofs
+   * into @p local_coeffs (that is resized to the size of @p global_dofs).
+   *
+   * With the dense storage this is a plain indexed load, without any search.
+   */
+  void get_local_coeffs(const SafeSTLVector<Index> &global_dofs,
+                        SafeSTLVector<Real> &local_coeffs) const;
+
+  /**
+   * Returns the coefficients associated to the global dofs @p global_dofs.
+   */
+  SafeSTLVector<Real> get_local_coeffs(const SafeSTLVector<Index> &global_dofs) const;
+
+  /**
+   * Returns true if the coefficients are stored in a contiguous (dense) storage.
+   */
+  bool is_dense() const;
+
+  /**
+   * Returns true if the coefficients are a view on the values of an external vector.
+   */
+  bool is_view() const;
+
+  /** @name Iterators */
+  ///@{
+  iterator begin();
+
+  iterator end();
+
+  const_iterator begin() const;
+
+  const_iterator end() const;
+
+  const_iterator cbegin() const;
+
+  const_iterator cend() const;
+  ///@}
+
   void print_info(LogStream &out) const;
 
 private:
+  /**
+   * TRUE if the coefficients are in the dense storage.
+   */
+  bool is_dense_ = true;
+
+  /**
+   * Global dof associated to the first coefficient in the dense storage.
+   */
+  Index first_dof_ = 0;
+
+  /**
+   * Dense storage: the <tt>i</tt>-th entry is the coefficient associated to the global dof
+   * <tt>first_dof_+i</tt>.
+   */
+  SafeSTLVector<Real> dense_values_;
+
+  /**
+   * Sparse storage.
+   */
+  std::map<Index,Real> sparse_values_;
+
+  /**
+   * Object owning the external values of the (read-only) view.
+   * It is nullptr if the container is not a view.
+   */
+  std::shared_ptr<const void> view_owner_;
+
+  /**
+   * External values of the (read-only) view.
+   */
+  const Real *view_values_ = nullptr;
+
+  /**
+   * Number of external values of the (read-only) view.
+   */
+  Size view_size_ = 0;
+
+  /**
+   * Returns the number of coefficients in the dense storage (or in the view).
+   */
+  Size get_num_dense_values() const;
+
+  /**
+   * Returns the pointer to the first coefficient in the dense storage (or in the view).
+   */
+  const Real *get_dense_values() const;
+
+  /**
+   * Copies the values of the view into the dense storage and releases the view.
+   * It does nothing if the container is not a view.
+   */
+  void detach_view();
+
+  /**
+   * Moves the coefficients from the dense storage to the sparse storage.
+   */
+  void switch_to_sparse();
+
+  /**
+   * @brief Iterator over the pairs <tt>(global_dof,coefficient)</tt>.
+   *
+   * The dereferenced iterator is a <tt>std::pair<Index,Real &></tt>
+   * (or <tt>std::pair<Index,const Real &></tt> for the const version)
+   * returned by value.
+   */
+  template <bool is_const>
+  class Iterator
+  {
+  public:
+    using Container = Conditional<is_const,const IgCoefficients,IgCoefficients>;
+    using RealRef = Conditional<is_const,const Real &,Real &>;
+    using MapIterator = Conditional<is_const,
+          std::map<Index,Real>::const_iterator,
+          std::map<Index,Real>::iterator>;
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<Index,RealRef>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = value_type;
+
+    /** Helper used to return a pointer from operator->(). */
+    struct Arrow
+    {
+      value_type pair;
+      const value_type *operator->() const
+      {
+        return &pair;
+      }
+    };
+
+    Iterator() = default;
+
+    Iterator(Container &coeffs, const Index pos, const MapIterator &map_it)
+      :
+      coeffs_(&coeffs),
+      pos_(pos),
+      map_it_(map_it)
+    {}
+
+    /** Conversion from the non-const to the const iterator. */
+    template <bool is_const_in, class = EnableIf<is_const && !is_const_in>>
+    Iterator(const Iterator<is_const_in> &it)
+      :
+      coeffs_(it.coeffs_),
+      pos_(it.pos_),
+      map_it_(it.map_it_)
+    {}
+
+    value_type operator*() const
+    {
+      if (coeffs_->is_dense_)
+        return value_type(coeffs_->first_dof_ + pos_, get_dense_value());
+      else
+        return value_type(map_it_->first, map_it_->second);
+    }
+
+    Arrow operator->() const
+    {
+      return Arrow {**this};
+    }
+
+    Iterator &operator++()
+    {
+      if (coeffs_->is_dense_)
+        ++pos_;
+      else
+        ++map_it_;
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      auto it = *this;
+      ++(*this);
+      return it;
+    }
+
+    bool operator==(const Iterator &it) const
+    {
+      return coeffs_ == it.coeffs_ && pos_ == it.pos_ && map_it_ == it.map_it_;
+    }
+
+    bool operator!=(const Iterator &it) const
+    {
+      return !(*this == it);
+    }
+
+  private:
+    template <bool> friend class Iterator;
+
+    RealRef get_dense_value() const;
+
+    Container *coeffs_ = nullptr;
+
+    Index pos_ = 0;
+
+    MapIterator map_it_;
+  };
 
 
 #ifdef IGATOOLS_WITH_SERIALIZATION
@@ -96,6 +436,27 @@ private:
 };
 
 
+
+template <>
+inline
+auto
+IgCoefficients::Iterator<true>::
+get_dense_value() const -> RealRef
+{
+  return coeffs_->get_dense_values()[pos_];
+}
+
+template <>
+inline
+auto
+IgCoefficients::Iterator<false>::
+get_dense_value() const -> RealRef
+{
+  // the non-const iterators are created only after the view (if any) is detached
+  return coeffs_->dense_values_[pos_];
+}
+
+
 IGA_NAMESPACE_CLOSE
 
 
@@ -106,4 +467,3 @@ CEREAL_SPECIALIZE_FOR_ARCHIVE(OArchive,iga::IgCoefficients,cereal::specializatio
 
 
 #endif // __IG_COEFFICIENTS_H
-
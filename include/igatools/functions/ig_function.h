@@ -140,6 +140,26 @@ public:
   create(const std::shared_ptr<PhysBasis> &basis,
          const EpetraTools::Vector &coeff,
          const std::string &dofs_property = DofProperties::active);
+
+  /**
+   * Creates the function without copying the values of @p coeff, if the global ids
+   * of its map are the dofs with the property @p dofs_property (the coefficients
+   * are a view on @p coeff, see IgCoefficients).
+   */
+  static std::shared_ptr<const self_t>
+  const_create(const std::shared_ptr<const PhysBasis> &basis,
+               const std::shared_ptr<const EpetraTools::Vector> &coeff,
+               const std::string &dofs_property = DofProperties::active);
+
+  /**
+   * Creates the function without copying the values of @p coeff, if the global ids
+   * of its map are the dofs with the property @p dofs_property (the coefficients
+   * are a view on @p coeff, see IgCoefficients).
+   */
+  static std::shared_ptr<self_t>
+  create(const std::shared_ptr<PhysBasis> &basis,
+         const std::shared_ptr<const EpetraTools::Vector> &coeff,
+         const std::string &dofs_property = DofProperties::active);
 #endif // IGATOOLS_USES_TRILINOS
 
   static std::shared_ptr<const self_t>
@@ -197,7 +217,7 @@ public:
     IgCoefficients sub_coeffs;
     const int n_sub_dofs = dof_map.size();
     for (int sub_dof = 0 ; sub_dof < n_sub_dofs ; ++ sub_dof)
-      sub_coeffs[sub_dof] = coeffs_[dof_map[sub_dof]];
+      sub_coeffs.insert(sub_dof,coeffs_[dof_map[sub_dof]]);
 
     auto sub_func = IgFunction<sdim,codim+(dim-sdim),range,rank>::const_create(sub_basis,sub_coeffs);
 
@@ -97,6 +97,26 @@ public:
   create(const std::shared_ptr<RefBasis> &ref_basis,
          const EpetraTools::Vector &coeffs,
          const std::string &dofs_property = DofProperties::active);
+
+  /**
+   * Creates the function without copying the values of @p coeffs, if the global ids
+   * of its map are the dofs with the property @p dofs_property (the coefficients
+   * are a view on @p coeffs, see IgCoefficients).
+   */
+  static std::shared_ptr<const self_t>
+  const_create(const std::shared_ptr<const RefBasis> &ref_basis,
+               const std::shared_ptr<const EpetraTools::Vector> &coeffs,
+               const std::string &dofs_property = DofProperties::active);
+
+  /**
+   * Creates the function without copying the values of @p coeffs, if the global ids
+   * of its map are the dofs with the property @p dofs_property (the coefficients
+   * are a view on @p coeffs, see IgCoefficients).
+   */
+  static std::shared_ptr<self_t>
+  create(const std::shared_ptr<RefBasis> &ref_basis,
+         const std::shared_ptr<const EpetraTools::Vector> &coeffs,
+         const std::string &dofs_property = DofProperties::active);
 #endif // IGATOOLS_USES_TRILINOS
 
   virtual void print_info(LogStream &out) const override final;
@@ -116,7 +136,7 @@ public:
     IgCoefficients sub_coeffs;
     const int n_sub_dofs = dof_map.size();
     for (int sub_dof = 0 ; sub_dof < n_sub_dofs ; ++ sub_dof)
-      sub_coeffs[sub_dof] = coeffs_[dof_map[sub_dof]];
+      sub_coeffs.insert(sub_dof,coeffs_[dof_map[sub_dof]]);
 
     auto sub_func = IgGridFunction<sdim,range>::const_create(sub_ref_basis,sub_coeffs);
 
@@ -157,6 +177,11 @@ private:
   /**
    * Rebuild the internal state of the object after an insert_knots() function is invoked.
    *
+   * The coefficients with respect to the refined basis are computed exactly with
+   * basis_tools::knot_insertion_coefficients(). The L2 projection onto the refined
+   * basis is used only when the knot insertion cannot be applied
+   * (e.g. for periodic bases).
+   *
    * @pre Before invoking this function, must be invoked the function grid_->insert_knots().
    * @note This function is connected to the Grid's signal for the refinement, and
    * it is necessary in order to avoid infinite loops in the insert_knots() function calls.
@@ -24,6 +24,7 @@
 #include <igatools/functions/grid_function_handler.h>
 #include <igatools/functions/ig_grid_function.h>
 #include <igatools/basis_functions/basis_handler.h>
+#include <igatools/basis_functions/basis_element.h>
 
 
 IGA_NAMESPACE_OPEN
@@ -31,6 +32,20 @@ IGA_NAMESPACE_OPEN
 
 
 /**
+ * @brief Cache handler for the IgGridFunction.
+ *
+ * The values (and derivatives) of the IgGridFunction are computed as linear
+ * combination of the basis functions over the element. The handler owns
+ * a persistent element of the basis (with its cache), that follows the element
+ * of the IgGridFunction passed to fill_cache(): the cache of the basis element
+ * is initialized only when the quadrature changes, so that the cost of
+ * fill_cache() is only the cost of filling the basis element and of computing
+ * the linear combination.
+ * The basis element is created again when the basis is modified (e.g. after a refinement).
+ *
+ * @note As the basis element is owned by the handler, the same handler must not be used
+ * concurrently by different threads.
+ *
  * @ingroup handlers
  */
 template<int dim, int range>
@@ -95,6 +110,35 @@ private:
   using IgBasisHandler = BasisHandler<dim,0,range,1>;
   std::unique_ptr<IgBasisHandler> ig_basis_handler_;
 
+  using IgBasisElement = BasisElement<dim,0,range,1>;
+
+  /**
+   * Element of the basis used to evaluate the IgGridFunction.
+   *
+   * It is created in the constructor and, at each call of fill_cache(),
+   * it is moved to the element of the IgGridFunction that is being filled.
+   * It is created again (and its cache initialized again) if the basis has been
+   * modified since its creation.
+   */
+  mutable std::unique_ptr<IgBasisElement> ig_basis_elem_;
+
+  /**
+   * State of the DofDistribution of the basis when ig_basis_elem_ has been created.
+   * A refinement of the basis (or of its grid) builds a new DofDistribution,
+   * and therefore changes this state.
+   *
+   * @see DofDistribution::get_state_id()
+   */
+  mutable Index ig_basis_elem_state_id_;
+
+  /**
+   * Quadratures used (for each sub-element dimension) to initialize the cache
+   * of ig_basis_elem_. The cache of ig_basis_elem_ is initialized again only if
+   * the quadrature of the IgGridFunction element changes or if the flags are
+   * modified by set_flags().
+   */
+  mutable SafeSTLArray<std::shared_ptr<const void>,dim+1> ig_basis_elem_quads_;
+
   std::shared_ptr<GridFunctionType> ig_grid_function_;
 
 };
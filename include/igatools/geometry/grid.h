@@ -742,6 +742,9 @@ public:
 
   /**
    * Returns a reference to the list of element ids with the property specified by @p prop.
+   *
+   * @note The list must be kept sorted. If it is modified, the lookup of the elements
+   * in the list (e.g. by GridElement::move_to()) falls back to a binary search.
    */
   List &get_elements_with_property(const PropId &prop);
 
@@ -760,6 +763,15 @@ public:
   bool element_has_property(const IndexType &elem_id,
                             const PropId &prop) const;
 
+  /**
+   * Returns the position of the element identified by <tt>elem_id</tt> in the list of
+   * elements with the property <tt>prop</tt>, or -1 if the element has not the property.
+   *
+   * @note The complexity is constant.
+   */
+  Index get_element_position(const IndexType &elem_id,
+                             const PropId &prop) const;
+
 #if 0
   /**
    * Sets the @p status of the given @p property for the entire set of elements in the grid.
@@ -134,6 +134,11 @@ public:
    * if the GridElement specified by <tt>elem_id</tt> has not the same property of the
    * calling GridElement.
    *
+   * The complexity is constant (the position of <tt>elem_id</tt> in the list of elements
+   * with the same property is retrieved by Grid::get_element_position()), therefore
+   * this function can be used to visit an arbitrary subset of elements
+   * (e.g. the ones returned by Grid::find_elements_id_of_points()).
+   *
    * @warning Use this function only if you know what you are doing
    */
   void move_to(const IndexType &elem_id);
@@ -170,6 +175,11 @@ public:
 
   const ListIt &get_index_iterator() const;
 
+  /**
+   * Returns the position of the element in the list of elements with the same property.
+   */
+  Index get_position() const;
+
 
   /** Return the Grid from which the element belongs.*/
   std::shared_ptr<const Grid<dim>> get_grid() const;
@@ -267,6 +277,17 @@ public:
   template <int sdim>
   std::shared_ptr<const Quadrature<sdim>> get_quad() const;
 
+  /**
+   * Returns the unitary quadrature scheme corresponding to the <tt>sdim</tt>-dimensional
+   * sub-elements, extended to the s_id-th sub-element (i.e. with the points
+   * expressed in the coordinates of the element).
+   *
+   * @note It is computed once, when the quadrature is set by the init_cache()
+   * function of the GridHandler.
+   */
+  template <int sdim>
+  const Quadrature<dim> &get_extended_quad(const int s_id) const;
+
 
   void print_cache_info(LogStream &out) const;
 
@@ -0,0 +1,262 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __BINARY_SIDECAR_H_
+#define __BINARY_SIDECAR_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/exceptions.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+IGA_NAMESPACE_OPEN
+
+template <class T> class SafeSTLVector;
+
+/**
+ * @brief Binary file storing large numeric arrays (blocks) next to a
+ * document that references them by their block id.
+ *
+ * It is used by @ref ObjectsContainerXMLWriter and
+ * @ref ObjectsContainerXMLReader for storing the knot vectors and the
+ * @ref IgCoefficients outside the XML file: the XML document keeps the
+ * structure of the objects and every array is replaced by the id of its
+ * block in the sidecar file.
+ *
+ * The file layout (all the integers are stored with the native byte order,
+ * that is checked at load time) is:
+ * - a header of 64 bytes: the magic string <tt>IGABSIDE</tt>, the format
+ *   version (@p uint32), a byte order mark (@p uint32), the number of blocks,
+ *   the offset of the block table and the total size of the file
+ *   (@p uint64 each);
+ * - the block table: for each block, the type of the entries, the size in
+ *   bytes of an entry (@p uint32 each), the number of entries and the offset
+ *   of the block data (@p uint64 each);
+ * - the data of the blocks, each one starting at an offset multiple
+ *   of 64 bytes.
+ *
+ * A sidecar can be created for writing (@ref create), filled with
+ * @ref add_block and written with @ref write_to_file.
+ *
+ * A sidecar file is loaded with @ref open, that maps the file read-only
+ * into memory (with <tt>mmap</tt>): the loading time does not depend on the
+ * size of the file, the data are read from the page cache only when they
+ * are accessed and the pages are shared by all the processes mapping the
+ * same file. The blocks are accessed without copies with @ref get_block_data,
+ * or copied into a vector with @ref get_block.
+ *
+ * @note The entries of a block are of type @ref Real or @ref Index.
+ */
+class BinarySidecar
+{
+private:
+  /** @name Types and static values */
+  ///@{
+
+  /** Type for the current class. */
+  typedef BinarySidecar Self_;
+
+  /** Type for a shared pointer of the current class. */
+  typedef std::shared_ptr<Self_> SelfPtr_;
+
+  /** Information stored in the block table for each block. */
+  struct BlockInfo
+  {
+    /** Type of the block entries. */
+    std::uint32_t type;
+
+    /** Size in bytes of each entry. */
+    std::uint32_t type_size;
+
+    /** Number of entries. */
+    std::uint64_t n_entries;
+
+    /**
+     * Offset (in bytes) of the block data with respect to the begin of
+     * get_file_data().
+     */
+    std::uint64_t offset;
+  };
+
+  /** Size in bytes of the header. */
+  static const std::uint64_t header_size_;
+
+  /** Alignment in bytes of the data of each block. */
+  static const std::uint64_t alignment_;
+
+  ///@}
+
+public:
+  /** Current version of the sidecar file format. */
+  static const std::uint32_t FORMAT_VERSION;
+
+  /** @name Constructors, destructor, assignment operators and creators */
+  ///@{
+
+  /**
+   * @brief Default constructor. It creates an empty sidecar for writing.
+   */
+  BinarySidecar();
+
+  /**
+   * @brief Constructs the sidecar by mapping the file @p file_path.
+   */
+  BinarySidecar(const std::string &file_path);
+
+  /**
+   * @brief Copy constructor.
+   * @note Deleted, not allowed to be used.
+   */
+  BinarySidecar(const BinarySidecar &) = delete;
+
+  /**
+   * @brief Move constructor.
+   * @note Deleted, not allowed to be used.
+   */
+  BinarySidecar(BinarySidecar &&) = delete;
+
+  /**
+   * @brief Copy assignment operator.
+   * @note Deleted, not allowed to be used.
+   */
+  BinarySidecar &operator= (const BinarySidecar &) = delete;
+
+  /**
+   * @brief Move assignment operator.
+   * @note Deleted, not allowed to be used.
+   */
+  BinarySidecar &operator= (BinarySidecar &&) = delete;
+
+  /**
+   * @brief Destructor. It unmaps the file (if any).
+   */
+  ~BinarySidecar();
+
+  /**
+   * @brief Creates an empty sidecar for writing.
+   * @return A shared pointer with a new instance of the class.
+   */
+  static SelfPtr_ create();
+
+  /**
+   * @brief Maps read-only the sidecar file @p file_path and checks its
+   * header and block table.
+   *
+   * @param[in] file_path Path of the file to be mapped.
+   * @return A shared pointer with a new instance of the class.
+   * @warning It throws an exception if the file can not be mapped or if it
+   * is not a valid sidecar file.
+   */
+  static SelfPtr_ open(const std::string &file_path);
+
+  ///@}
+
+  /**
+   * @brief Returns the number of blocks.
+   */
+  Size get_num_blocks() const;
+
+  /**
+   * @brief Returns true if the data of the sidecar is mapped from a file.
+   */
+  bool is_mapped() const;
+
+  /**
+   * @brief Appends a new block containing the entries of @p vector and
+   * returns its id.
+   *
+   * @tparam T Type of the entries of the vector (@ref Real or @ref Index).
+   * @note The data is copied and kept in memory until the sidecar is
+   * written with @ref write_to_file.
+   */
+  template <class T>
+  Index add_block(const SafeSTLVector<T> &vector);
+
+  /**
+   * @brief Returns a pointer to the data of the block @p block_id.
+   *
+   * @tparam T Type of the entries of the block.
+   * @param[in] block_id Id of the block.
+   * @param[out] n_entries Number of entries of the block.
+   * @warning It throws an exception if the entries of the block are not
+   * of type @p T, if the number of entries can not be represented by
+   * @ref Size or if the block data exceeds the end of the file.
+   */
+  template <class T>
+  const T *get_block_data(const Index block_id, Size &n_entries) const;
+
+  /**
+   * @brief Returns a vector with a copy of the entries of the block
+   * @p block_id.
+   *
+   * @tparam T Type of the entries of the block.
+   */
+  template <class T>
+  SafeSTLVector<T> get_block(const Index block_id) const;
+
+  /**
+   * @brief Writes the sidecar to the file @p file_path.
+   */
+  void write_to_file(const std::string &file_path) const;
+
+private:
+  /**
+   * @brief Returns the type identifier of the entries of the type @p T.
+   */
+  template <class T>
+  static std::uint32_t get_type_id();
+
+  /**
+   * @brief Returns a pointer to the begin of the mapped file or, if the
+   * sidecar is not mapped, to the data of the blocks to be written.
+   */
+  const char *get_file_data() const;
+
+  /** Blocks table. */
+  std::vector<BlockInfo> blocks_;
+
+  /**
+   * Data of the blocks to be written (the header and the block table
+   * are added by @ref write_to_file).
+   */
+  std::vector<char> data_;
+
+  /** Pointer to the mapped file (nullptr if the sidecar is not mapped). */
+  const char *mapped_data_;
+
+  /** Size in bytes of the mapped file. */
+  std::uint64_t mapped_size_;
+
+  DeclException2(ExcBlockTooLarge, Index, std::uint64_t,
+                 << "Block " << arg1 << " of the binary sidecar has " << arg2
+                 << " entries, that exceed the maximum value of Size.");
+
+  DeclException4(ExcBlockOutOfRange, Index, std::uint64_t, std::uint64_t, std::uint64_t,
+                 << "Block " << arg1 << " of the binary sidecar (offset " << arg2
+                 << ", " << arg3 << " entries) exceeds the size of the data ("
+                 << arg4 << " bytes).");
+};
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __BINARY_SIDECAR_H_
@@ -121,6 +121,36 @@ const std::string ObjectsContainerXMLReader::XML_SCHEMA_ =
   "    </xs:simpleContent>\n"
   "  </xs:complexType>\n"
   "\n"
+  "  <!-- Vector of non negative integers that may be stored in a binary sidecar block -->\n"
+  "  <xs:complexType name=\"NonNegativeIntegerBinaryListType\">\n"
+  "    <xs:simpleContent>\n"
+  "      <xs:extension base=\"NonNegativeIntegerListType\">\n"
+  "        <xs:attribute name=\"BinaryBlock\" type=\"IdType\" use=\"optional\"/>\n"
+  "      </xs:extension>\n"
+  "    </xs:simpleContent>\n"
+  "  </xs:complexType>\n"
+  "\n"
+  "  <!-- Vector of doubles that may be stored in a binary sidecar block -->\n"
+  "  <xs:complexType name=\"DoubleBinaryListType\">\n"
+  "    <xs:simpleContent>\n"
+  "      <xs:extension base=\"DoubleListType\">\n"
+  "        <xs:attribute name=\"BinaryBlock\" type=\"IdType\" use=\"optional\"/>\n"
+  "      </xs:extension>\n"
+  "    </xs:simpleContent>\n"
+  "  </xs:complexType>\n"
+  "\n"
+  "  <!-- Vector of double with Size and Direction attributes that may be stored -->\n"
+  "  <!-- in a binary sidecar block (the minimum size is checked by the reader) -->\n"
+  "  <xs:complexType name=\"DoubleSizeDirectionBinaryListType\">\n"
+  "    <xs:simpleContent>\n"
+  "      <xs:extension base=\"DoubleListType\">\n"
+  "        <xs:attribute name=\"Size\" type=\"SizeType\" use=\"required\"/>\n"
+  "        <xs:attribute name=\"Direction\" type=\"DirectionType\" use=\"required\"/>\n"
+  "        <xs:attribute name=\"BinaryBlock\" type=\"IdType\" use=\"optional\"/>\n"
+  "      </xs:extension>\n"
+  "    </xs:simpleContent>\n"
+  "  </xs:complexType>\n"
+  "\n"
   "  <!-- ########################################################## -->\n"
   "  <!-- Some base igatools types definitions ##################### -->\n"
   "  <!-- ########################################################## -->\n"
@@ -303,7 +333,7 @@ const std::string ObjectsContainerXMLReader::XML_SCHEMA_ =
   "          <xs:element name=\"Knots\" minOccurs=\"1\" maxOccurs=\"1\">\n"
   "            <xs:complexType>\n"
   "              <xs:sequence>\n"
-  "                <xs:element name=\"Knots\" minOccurs=\"0\" maxOccurs=\"3\" type=\"DoubleSizeDirectionListMin2Type\"/>\n"
+  "                <xs:element name=\"Knots\" minOccurs=\"0\" maxOccurs=\"3\" type=\"DoubleSizeDirectionBinaryListType\"/>\n"
   "              </xs:sequence>\n"
   "            </xs:complexType>\n"
   "          </xs:element>\n"
@@ -432,8 +462,8 @@ const std::string ObjectsContainerXMLReader::XML_SCHEMA_ =
   "  <!-- IgCoefficients type -->\n"
   "  <xs:complexType name=\"IgCoefficientsType\">\n"
   "    <xs:all>\n"
-  "      <xs:element name=\"Indices\" type=\"NonNegativeIntegerListType\"/>\n"
-  "      <xs:element name=\"Values\"  type=\"DoubleListType\"/>\n"
+  "      <xs:element name=\"Indices\" type=\"NonNegativeIntegerBinaryListType\"/>\n"
+  "      <xs:element name=\"Values\"  type=\"DoubleBinaryListType\"/>\n"
   "    </xs:all>\n"
   "    <xs:attribute name=\"Size\" type=\"SizeType\" use=\"required\"/>\n"
   "  </xs:complexType>\n"
@@ -553,6 +583,8 @@ const std::string ObjectsContainerXMLReader::XML_SCHEMA_ =
   "      </xs:sequence>\n"
   "      <xs:attribute name=\"FormatVersion\" type=\"xs:float\" fixed=\"" +
   IGATOOLS_FILE_FORMAT_VERSION + "\" use=\"required\"/>\n"
+  "      <!-- Note that this attribute is optional -->\n"
+  "      <xs:attribute name=\"BinarySidecar\" type=\"xs:string\" use=\"optional\"/>\n"
   "    </xs:complexType>\n"
   "  </xs:element>\n"
   "\n"
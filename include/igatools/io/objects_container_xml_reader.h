@@ -31,12 +31,14 @@
 IGA_NAMESPACE_OPEN
 
 class XMLElement;
+class XMLDocument;
 class ObjectsContainer;
 template <int dim> class Grid;
 template <class T> class SafeSTLVector;
 class IgCoefficients;
 class LogStream;
 template <class T1, class T2> class SafeSTLMap;
+template <class T> class IndexSet;
 template <int dim, int range, int rank> class ReferenceBasis;
 template <int dim, int range> class GridFunction;
 template <int dim, int codim, int range, int rank> class Function;
@@ -199,6 +201,19 @@ public:
 
 private:
 
+  /**
+   * @brief Maps the binary sidecar referenced by the document @p xml_doc
+   * (if any) and attaches it to the document.
+   *
+   * The path of the sidecar (attribute @p BinarySidecar of the main XML
+   * element) is relative to the directory of @p file_path.
+   *
+   * @param[in] file_path Path of the parsed XML file.
+   * @param[in] xml_doc Parsed XML document.
+   */
+  static void open_binary_sidecar(const std::string &file_path,
+                                  const std::shared_ptr<XMLDocument> xml_doc);
+
 
   /** @name Methods for parsing all the objects. */
   ///@{
@@ -811,7 +826,7 @@ private:
   static std::shared_ptr<IgCoefficients>
   parse_ig_coefficients(const std::shared_ptr<XMLElement> xml_elem,
                         const std::string &parsing_msg,
-                        const std::set<Index> &space_global_dofs);
+                        const IndexSet<Index> &space_global_dofs);
 
 };
 
@@ -143,11 +143,21 @@ public:
   /**
    * @brief Writes the @p container to a @p file_path with XML format.
    *
+   * If @p binary_sidecar is true, the knot vectors and the
+   * @ref IgCoefficients are not written in the XML file, but in the
+   * @ref BinarySidecar file <tt>file_path + ".bin"</tt>, that is referenced
+   * by the attribute @p BinarySidecar of the main XML element. The sidecar
+   * is mapped into memory by @ref ObjectsContainerXMLReader when the file
+   * is parsed, avoiding the parsing of the (possibly huge) numeric arrays.
+   *
    * @param[in] file_path Path of the file to be written.
    * @param[in] container Objects container to be written.
+   * @param[in] binary_sidecar Flag indicating if the numeric arrays
+   * must be written into a binary sidecar file.
    */
   static void write(const std::string &file_path,
-                    const ContPtr_ container);
+                    const ContPtr_ container,
+                    const bool binary_sidecar = false);
 
 private:
 
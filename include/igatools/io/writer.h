@@ -30,8 +30,11 @@
 #include <igatools/functions/function_element.h>
 
 #include <igatools/utils/safe_stl_array.h>
+#include <igatools/utils/thread_tools.h>
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 IGA_NAMESPACE_OPEN
 
@@ -92,12 +95,63 @@ public:
   /**
    * Save the data on a .vtu file.
    * \param[in] filename - Output file name.
-   * \param[in] format - Output format. It can be "ascii" or "appended".
+   * \param[in] format - Output format. It can be "ascii", "appended" or
+   * "compressed".
+   *
+   * With the "appended" and "compressed" formats the data are written
+   * as binary appended data (respectively raw and compressed with zlib).
+   * The file is written incrementally, evaluating the points of
+   * blocks of IGA elements in parallel (see set_num_threads()), therefore
+   * the points and the connectivity are never stored for the whole domain.
+   * If igatools is built without zlib support, the "compressed" format
+   * falls back to "appended".
+   *
    * \note The .vtu extension should NOT part of the file name.
    */
   void save(const std::string &filename,
             const std::string &format = "ascii") const;
 
+  /**
+   * Save the data split in @p n_pieces .vtu files (named <tt>filename_0.vtu</tt>,
+   * <tt>filename_1.vtu</tt>, ...) and a .pvtu file referencing them.
+   *
+   * The pieces are made by contiguous layers of IGA elements along the
+   * last coordinate direction (therefore the number of pieces is at most the
+   * number of intervals of the grid in that direction), and they are
+   * written concurrently, each one by its own thread.
+   * The point and cell data are partitioned as the IGA elements.
+   *
+   * \param[in] filename - Output file name (without extension).
+   * \param[in] n_pieces - Number of pieces.
+   * \param[in] format - Output format of the pieces. It can be "appended"
+   * or "compressed" (see save()).
+   */
+  void save_pieces(const std::string &filename,
+                   const int n_pieces,
+                   const std::string &format = "appended") const;
+
+  /**
+   * Sets the number of threads used by add_field() for evaluating the fields
+   * and by save() for evaluating the points and compressing the data of the binary formats.
+   * The default is thread_tools::get_default_num_threads().
+   */
+  void set_num_threads(const int n_threads);
+
+  /**
+   * If @p merge is true, the binary formats write only once the points
+   * shared by adjacent VTK elements. The point data of a shared point are
+   * taken from one of the IGA elements sharing it.
+   *
+   * Requires the evaluation points to include the vertices of the IGA
+   * elements, i.e. the first and last coordinate of the plot quadrature
+   * must be 0 and 1 in each direction (as for QUniform).
+   *
+   * \warning If the geometry or the point data are discontinuous across
+   * the IGA elements, the merged output is not correct.
+   * The default is false.
+   */
+  void set_merge_shared_points(const bool merge);
+
 
   /**
    * Writes the vtu into a LogStream, filtering it for uniform
@@ -140,6 +194,10 @@ public:
 
   /**
    * \brief Add a field (of type Function) to the output file.
+   *
+   * The field is evaluated here, at the plot points of all the IGA elements
+   * (concurrently, with the threads set by set_num_threads()), and only its values
+   * are stored: the Writer does not keep any reference to @p func.
    */
   template<int range, int rank>
   void add_field(const Function<dim,codim,range,rank> &func,
@@ -147,6 +205,8 @@ public:
 
   /**
    * \brief Add a field (of type GridFunction) to the output file.
+   *
+   * As for the Function fields, the values are computed here.
    */
   template<int range>
   void add_field(const GridFunction<dim,range> &func,
@@ -212,9 +272,9 @@ private:
   const int n_points_per_iga_element_;
 
   /**
-   * Number of VTK elements handled by the Writer.
+   * Number of VTK points handled by the Writer.
    */
-  const int n_vtk_points_;
+  const std::int64_t n_vtk_points_;
 
   unsigned char vtk_element_type_;
 
@@ -228,11 +288,17 @@ private:
   const int sizeof_uchar_  = 0;
   std::string string_uchar_;
 
-  std::stringstream appended_data_;
+  int precision_;
 
-  int offset_;
+  /**
+   * Number of threads used by the binary output.
+   */
+  int n_threads_;
 
-  int precision_;
+  /**
+   * True if the binary output merges the points shared by adjacent VTK elements.
+   */
+  bool merge_shared_points_;
 
   static const int n_vertices_per_vtk_element_ = UnitElement<dim>::template num_elem<0>();
 
@@ -248,7 +314,6 @@ private:
 
   struct PointData
   {
-
     PointData(
       const std::string &name,
       const std::string &type,
@@ -276,11 +341,27 @@ private:
     Size num_components_;
 
 
+    /**
+     * Values at the plot points of all the IGA elements
+     * (in the ordering of the active elements).
+     */
     std::shared_ptr< const SafeSTLVector<T> > values_;
   };
 
   SafeSTLVector< PointData > fields_;
 
+  /**
+   * Evaluates the function @p func (a Function or a GridFunction) at the plot points
+   * of all the active IGA elements, with n_threads_ threads (each one with its own element
+   * accessor and cache handler).
+   * The @p n_values_per_pt values of the points of an element are written by
+   * <tt>copy_values(elem,data)</tt>, with the cache of <tt>elem</tt> filled with @p flag.
+   */
+  template<class Func, class Flags, class CopyValues>
+  std::shared_ptr<const SafeSTLVector<T>>
+  evaluate_field(const Func &func, const Flags flag, const int n_values_per_pt,
+                 const CopyValues &copy_values) const;
+
 
   SafeSTLVector<std::string> names_point_data_scalar_;
   SafeSTLVector<std::string> names_point_data_vector_;
@@ -338,10 +419,30 @@ private:
                   &vtk_elements_connectivity) const;
 
 
-  void save_appended(const std::string &filename,
-                     const SafeSTLVector<SafeSTLVector<SafeSTLArray<T,3> > > &points_in_iga_elements,
-                     const SafeSTLVector<SafeSTLVector<SafeSTLArray< int,n_vertices_per_vtk_element_> > >
-                     &vtk_elements_connectivity) const;
+  /**
+   * The IGA elements in lexicographic order (with the first direction
+   * running faster): for each of them, its index and its position in
+   * the list of active elements (i.e. in the ordering of the point and
+   * cell data).
+   */
+  struct LexicographicElements
+  {
+    std::vector<const ElementIndex<dim> *> index;
+
+    std::vector<Index> position;
+  };
+
+  LexicographicElements get_lexicographic_elements() const;
+
+  /**
+   * Writes the .vtu file with binary appended data for the IGA elements
+   * in the layers <tt>[first_layer,last_layer)</tt> along the last direction,
+   * processing them in blocks of layers with @p n_threads threads.
+   */
+  void save_binary(const std::string &filename, const bool compress,
+                   const LexicographicElements &elems,
+                   const Index first_layer, const Index last_layer,
+                   const int n_threads) const;
 
 
 
@@ -351,6 +452,54 @@ private:
 using std::string;
 using std::shared_ptr;
 
+template<int dim, int codim, class T>
+template<class Func, class Flags, class CopyValues>
+inline
+auto
+Writer<dim, codim, T>::
+evaluate_field(const Func &func, const Flags flag, const int n_values_per_pt,
+               const CopyValues &copy_values) const
+-> std::shared_ptr<const SafeSTLVector<T>>
+{
+  const auto grid = domain_->get_grid_function()->get_grid();
+  std::vector<const ElementIndex<dim> *> elems_index;
+  for (const auto &elem_id : grid->get_elements_with_property(ElementProperties::active))
+    elems_index.emplace_back(&elem_id);
+  const Size n_elems = elems_index.size();
+
+  const std::int64_t n_values_elem = std::int64_t(n_points_per_iga_element_) * n_values_per_pt;
+  auto values = std::make_shared<SafeSTLVector<T>>(n_elems * n_values_elem);
+
+  // each thread owns its element accessor and cache handler
+  const auto chunks = thread_tools::split_range(n_elems,n_threads_);
+  const int n_eval_threads = chunks.size() - 1;
+  std::vector<std::unique_ptr<typename Func::Handler>> handlers;
+  std::vector<std::unique_ptr<typename Func::ElementAccessor>> elems;
+  for (int t = 0 ; t < n_eval_threads ; ++t)
+  {
+    handlers.emplace_back(func.create_cache_handler());
+    handlers.back()->template set_flags<dim>(flag);
+    elems.emplace_back(func.create_element_begin(ElementProperties::active));
+    handlers.back()->init_cache(*elems.back(),quad_plot_);
+  }
+
+  thread_tools::run_in_parallel(n_eval_threads,[&](const int t)
+  {
+    auto &elem = *elems[t];
+    auto &handler = *handlers[t];
+    for (Index i = chunks[t] ; i < chunks[t+1] ; ++i)
+    {
+      elem.move_to(*elems_index[i]);
+      handler.template fill_cache<dim>(elem,0);
+      copy_values(elem,values->data() + i * n_values_elem);
+    }
+  });
+
+  return values;
+}
+
+
+
 template<int dim, int codim, class T>
 template<int range, int rank>
 inline
@@ -368,94 +517,46 @@ add_field(const Function<dim,codim,range,rank> &func,
 
 
   //--------------------------------------------------------------------------
-  // get the fields to write and assign them to the vtkUnstructuredGrid object
+  // get the values of the field at the plot points
+  using ElementAccessor = typename Function<dim,codim,range,rank>::ElementAccessor;
   using function_element::Flags;
   using _D0 = function_element::template _D<0>;
 
-  auto func_cache_handler = func.create_cache_handler();
-  func_cache_handler->template set_flags<dim>(Flags::D0);
-
-  auto f_elem = func.cbegin();
-  const auto f_end  = func.cend();
-
-
-
-  func_cache_handler->init_cache(*f_elem,quad_plot_);
-
-
   const auto n_elements = domain_->get_grid_function()->get_grid()->get_num_all_elems();
-  const auto n_pts_per_elem = quad_plot_->get_num_points();
-
+  const int n_pts_per_elem = quad_plot_->get_num_points();
   const int n_values_per_pt = (range == 1 ? 1 : std::pow(range, rank)) ;
-  auto data_ptr = std::make_shared<SafeSTLVector<T>>(n_elements * n_pts_per_elem * n_values_per_pt);
-  auto &data = *data_ptr;
-  if (rank == 0 || (rank == 1 && range == 1))
+
+  const auto data_ptr = this->evaluate_field(func,Flags::D0,n_values_per_pt,
+                                             [n_pts_per_elem,n_values_per_pt](const ElementAccessor &f_elem, T *data)
   {
-    int pos = 0;
-    for (; f_elem != f_end; ++f_elem)
+    const auto &field_values = f_elem.template get_values_from_cache<_D0,dim>(0);
+    for (int iPt = 0; iPt < n_pts_per_elem; ++iPt)
     {
-      func_cache_handler->template fill_cache<dim>(*f_elem,0);
-
-      const auto &field_values = f_elem->template get_values_from_cache<_D0,dim>(0);
-
-      for (int iPt = 0; iPt < n_pts_per_elem; ++iPt)
-        data[pos++] = field_values[iPt][0];
+      const auto field_value_ipt = field_values[iPt].get_flat_values();
+      for (int i = 0; i < n_values_per_pt; ++i)
+        *data++ = field_value_ipt[i];
     }
+  });
 
-    fields_.emplace_back(PointData(name,"scalar",n_elements,n_pts_per_elem, n_values_per_pt, data_ptr));
+  string type;
+  if (rank == 0 || (rank == 1 && range == 1))
+  {
+    type = "scalar";
     names_point_data_scalar_.emplace_back(name);
   }
   else if (rank == 1 && range > 1)
   {
-    int pos = 0;
-    for (; f_elem != f_end; ++f_elem)
-    {
-      func_cache_handler->template fill_cache<dim>(*f_elem,0);
-
-      const auto &field_values = f_elem->template get_values_from_cache<_D0,dim>(0);
-
-      for (int iPt = 0; iPt < n_pts_per_elem; ++iPt)
-      {
-        const auto &field_value_ipt = field_values[iPt];
-        for (int i = 0; i < range; ++i)
-          data[pos++] = field_value_ipt[i];
-      }
-    }
-
-    fields_.emplace_back(PointData(name,"vector",n_elements,n_pts_per_elem, n_values_per_pt, data_ptr));
+    type = "vector";
     names_point_data_vector_.emplace_back(name);
   }
   else if (rank == 2)
   {
     Assert(false,ExcNotImplemented());
-    int pos = 0;
-    for (; f_elem != f_end; ++f_elem)
-    {
-      // TODO (pauletti, Sep 12, 2014): fix next line
-      Assert(true, ExcMessage(" fix next line "));
-      func_cache_handler->template fill_cache<dim>(*f_elem,0);
-
-      const auto &field_values = f_elem->template get_values_from_cache<_D0,dim>(0);
-
-      for (int iPt = 0; iPt < n_pts_per_elem; ++iPt)
-      {
-        const auto &field_value_ipt = field_values[ iPt ];
-        for (int i = 0; i < range; ++i)
-        {
-          const auto &field_value_ipt_i = field_value_ipt[i];
-
-          for (int j = 0; j < range; ++j)
-            data[pos++] = field_value_ipt_i[j];
-        }
-      }
-    }
-
-    fields_.emplace_back(PointData(name,"tensor",n_elements,n_pts_per_elem,n_values_per_pt,data_ptr));
+    type = "tensor";
     names_point_data_tensor_.emplace_back(name);
   }
-
+  fields_.emplace_back(PointData(name,type,n_elements,n_pts_per_elem,n_values_per_pt,data_ptr));
   //--------------------------------------------------------------------------
-//#endif
 }
 
 
@@ -479,65 +580,34 @@ add_field(const GridFunction<dim,range> &func,
   //--------------------------------------------------------------------------
 
   //--------------------------------------------------------------------------
-  // get the fields to write and assign them to the vtkUnstructuredGrid object
+  // get the values of the field at the plot points
+  using ElementAccessor = typename GridFunction<dim,range>::ElementAccessor;
   using grid_function_element::Flags;
   using _D0 = grid_function_element::_D<0>;
 
-  auto func_cache_handler = func.create_cache_handler();
-  func_cache_handler->template set_flags<dim>(Flags::D0);
-
-  auto f_elem = func.cbegin();
-  const auto f_end  = func.cend();
-
-
-
-  func_cache_handler->init_cache(*f_elem,quad_plot_);
-
-
   const auto n_elements = grid->get_num_all_elems();
-  const auto n_pts_per_elem = quad_plot_->get_num_points();
-
+  const int n_pts_per_elem = quad_plot_->get_num_points();
   const int n_values_per_pt = range;
-  auto data_ptr = std::make_shared<SafeSTLVector<T>>(n_elements * n_pts_per_elem * n_values_per_pt);
-  auto &data = *data_ptr;
-  if (range == 1)
-  {
-    int pos = 0;
-    for (; f_elem != f_end; ++f_elem)
-    {
-      func_cache_handler->template fill_cache<dim>(*f_elem,0);
 
-      const auto &field_values = f_elem->template get_values_from_cache<_D0,dim>(0);
-
-      for (int iPt = 0; iPt < n_pts_per_elem; ++iPt)
-        data[pos++] = field_values[iPt][0];
-    }
-
-    fields_.emplace_back(PointData(name,"scalar",n_elements,n_pts_per_elem, n_values_per_pt, data_ptr));
-    names_point_data_scalar_.emplace_back(name);
-  }
-  else if (range > 1)
+  const auto data_ptr = this->evaluate_field(func,Flags::D0,n_values_per_pt,
+                                             [n_pts_per_elem,n_values_per_pt](const ElementAccessor &f_elem, T *data)
   {
-    int pos = 0;
-    for (; f_elem != f_end; ++f_elem)
+    const auto &field_values = f_elem.template get_values_from_cache<_D0,dim>(0);
+    for (int iPt = 0; iPt < n_pts_per_elem; ++iPt)
     {
-      func_cache_handler->template fill_cache<dim>(*f_elem,0);
-
-      const auto &field_values = f_elem->template get_values_from_cache<_D0,dim>(0);
-
-      for (int iPt = 0; iPt < n_pts_per_elem; ++iPt)
-      {
-        const auto &field_value_ipt = field_values[iPt];
-        for (int i = 0; i < range; ++i)
-          data[pos++] = field_value_ipt[i];
-      }
+      const auto &field_value_ipt = field_values[iPt];
+      for (int i = 0; i < n_values_per_pt; ++i)
+        *data++ = field_value_ipt[i];
     }
+  });
 
-    fields_.emplace_back(PointData(name,"vector",n_elements,n_pts_per_elem, n_values_per_pt, data_ptr));
+  const string type = (range == 1) ? "scalar" : "vector";
+  if (range == 1)
+    names_point_data_scalar_.emplace_back(name);
+  else
     names_point_data_vector_.emplace_back(name);
-  }
+  fields_.emplace_back(PointData(name,type,n_elements,n_pts_per_elem,n_values_per_pt,data_ptr));
   //--------------------------------------------------------------------------
-//#endif
 }
 
 
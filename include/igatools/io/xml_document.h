@@ -41,6 +41,7 @@ IGA_NAMESPACE_OPEN
 template <class T> class SafeSTLVector;
 class LogStream;
 class XMLElement;
+class BinarySidecar;
 
 
 /**
@@ -65,6 +66,11 @@ class XMLElement;
  * XML documents can be written to a file by calling the method
  * @ref write_fo_file.
  *
+ * A @ref BinarySidecar can be attached to the document (see
+ * @ref set_binary_sidecar): the vectors created with
+ * @ref create_data_vector_element are then stored in the sidecar, and the
+ * elements of the document read their values from it.
+ *
  *
  * @note This class uses @p Xerces-c library.
  * @note The class is not in charge of freeing the @p DOMDocument pointer.
@@ -268,6 +274,37 @@ public:
                                     const int &precision = default_precision_,
                                     const bool scientific_format = true) const;
 
+  /**
+   * @brief Creates a new @ref XMLElement with the given @p name and
+   * containing a (possibly large) @p vector of numerical data.
+   *
+   * If a binary sidecar is attached to the document, the @p vector is
+   * added as a new block of the sidecar and the element only contains the
+   * attribute @p BinaryBlock with the block id. Otherwise, it is
+   * equivalent to @ref create_vector_element.
+   *
+   * @tparam T Type of the entries of the vector (@ref Real or @ref Index).
+   * @param[in] name Name of the new element created.
+   * @param[in] vector Vector of values to be added.
+   * @return XML element.
+   */
+  template <class T>
+  XMLElemPtr_ create_data_vector_element(const std::string &name,
+                                         const SafeSTLVector<T> &vector) const;
+
+  /**
+   * @brief Attaches the binary @p sidecar to the document.
+   *
+   * It must be called before retrieving the elements of the document.
+   */
+  void set_binary_sidecar(const std::shared_ptr<BinarySidecar> sidecar);
+
+  /**
+   * @brief Returns the binary sidecar attached to the document
+   * (nullptr if none).
+   */
+  std::shared_ptr<BinarySidecar> get_binary_sidecar() const;
+
   /**
    * @brief Prints the XML document content.
    *
@@ -303,6 +340,9 @@ private:
   /// @p Xerces-c DOM implementation pointer.
   xercesc::DOMImplementation *dom_impl_;
 
+  /// Binary sidecar attached to the document (if any).
+  std::shared_ptr<BinarySidecar> sidecar_;
+
   /**
    * @brief Method for initializing all the @p Xerces-c processes.
    *
@@ -40,6 +40,7 @@ IGA_NAMESPACE_OPEN
 template <class T> class SafeSTLVector;
 class LogStream;
 class XMLDocument;
+class BinarySidecar;
 
 /**
  * @brief Class for managing XML DOM elements of @p Xerces-c.
@@ -96,8 +97,10 @@ private:
    * to a <tt>Xerces-c DOMElement</tt>.
    *
    * @param[in] dom_elem @p Xerces-c XML element object.
+   * @param[in] sidecar Binary sidecar of the document (if any).
    */
-  XMLElement(const DOMElemPtr_ dom_elem);
+  XMLElement(const DOMElemPtr_ dom_elem,
+             const std::shared_ptr<const BinarySidecar> sidecar);
 
   /**
    * @brief Default constructor.
@@ -136,9 +139,11 @@ private:
    * It uses the above defined constructor.
    *
    * @param[in] dom_elem @p Xerces-c XML element object.
+   * @param[in] sidecar Binary sidecar of the document (if any).
    * @return A shared pointer with a new instance of the class.
    */
-  static SelfPtr_ create(const DOMElemPtr_ dom_elem);
+  static SelfPtr_ create(const DOMElemPtr_ dom_elem,
+                         const std::shared_ptr<const BinarySidecar> sidecar = nullptr);
 
   ///@}
 
@@ -216,6 +221,10 @@ public:
    * @brief Returns a vector of values with type @p T that are contained
    * in the element.
    *
+   * If the element has the attribute @p BinaryBlock, the values are
+   * read from the corresponding block of the binary sidecar of the
+   * document (see @ref BinarySidecar) instead of from the text.
+   *
    * @tparam T Type of value returned in the vector.
    * @return Vector containing the extracted numerical values.
    *
@@ -329,6 +338,9 @@ private:
   /// @p Xerces-c DOM element pointer being wrapped.
   const DOMElemPtr_ root_elem_;
 
+  /// Binary sidecar of the document the element belongs to (if any).
+  const std::shared_ptr<const BinarySidecar> sidecar_;
+
 };
 
 
@@ -0,0 +1,150 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+
+#ifndef __BANDED_MATRIX_H_
+#define __BANDED_MATRIX_H_
+
+#include <igatools/base/config.h>
+#include <igatools/utils/safe_stl_vector.h>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Symmetric banded matrix with real entries.
+ *
+ * Only the entries \f$ a_{ij} \f$ with \f$ 0 \leq i-j \leq b \f$ (being \f$ b \f$
+ * the bandwidth) are stored, row by row. The entries above the diagonal are
+ * accessed through the symmetry.
+ *
+ * A typical use of it is the matrix of the univariate mass (or stiffness) bilinear
+ * form of a spline space: with degree \f$ p \f$ its bandwidth is \f$ p \f$.
+ *
+ * The matrix can be replaced by its Cholesky factor (see factorize()) and then
+ * used for solving linear systems in \f$ O(n b) \f$ operations (see solve()).
+ * The vectors used by vmult() and solve() are accessed with a @p stride, so
+ * the univariate matrices can be applied to a fiber of a tensor-product array
+ * without copies.
+ *
+ * @ingroup linear_algebra
+ */
+class BandedMatrix
+{
+public:
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. It builds an empty matrix.
+   */
+  BandedMatrix() = default;
+
+  /**
+   * Constructor. It builds a <tt>n_rows x n_rows</tt> matrix with bandwidth
+   * @p bandwidth and all the entries set to zero.
+   */
+  BandedMatrix(const Size n_rows, const Size bandwidth);
+
+  /** Copy constructor. */
+  BandedMatrix(const BandedMatrix &matrix) = default;
+
+  /** Move constructor. */
+  BandedMatrix(BandedMatrix &&matrix) = default;
+
+  /** Destructor. */
+  ~BandedMatrix() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /** Copy assignment operator. */
+  BandedMatrix &operator=(const BandedMatrix &matrix) = default;
+
+  /** Move assignment operator. */
+  BandedMatrix &operator=(BandedMatrix &&matrix) = default;
+  ///@}
+
+  /** Returns the number of rows (and columns). */
+  Size get_num_rows() const;
+
+  /** Returns the bandwidth. */
+  Size get_bandwidth() const;
+
+  /**
+   * Returns a reference to the entry \f$ a_{ij} \f$ (or to \f$ a_{ji} \f$ if
+   * <tt>j > i</tt>).
+   * @note The entry must be inside the band.
+   */
+  Real &operator()(const Index i, const Index j);
+
+  /**
+   * Returns the entry \f$ a_{ij} \f$ (zero if it is outside the band).
+   */
+  Real operator()(const Index i, const Index j) const;
+
+  /**
+   * Computes \f$ y = A x \f$, being @p x and @p y two (non-overlapping)
+   * arrays whose consecutive entries are <tt>stride</tt> positions apart.
+   *
+   * @note The matrix must not be factorized.
+   */
+  void vmult(const Real *x, Real *y, const Size stride = 1) const;
+
+  /**
+   * Replaces the matrix with its Cholesky factor \f$ L \f$, i.e. the lower
+   * triangular matrix (with the same bandwidth) such that \f$ A = L L^T \f$.
+   *
+   * @warning It throws an exception if the matrix is not positive definite.
+   */
+  void factorize();
+
+  /**
+   * Returns true if the matrix has been replaced by its Cholesky factor.
+   */
+  bool is_factorized() const;
+
+  /**
+   * Solves in place the linear system \f$ A x = b \f$, being @p x an array
+   * (containing \f$ b \f$ on input) whose consecutive entries are
+   * <tt>stride</tt> positions apart.
+   *
+   * @note The matrix must be factorized (see factorize()).
+   */
+  void solve(Real *x, const Size stride = 1) const;
+
+private:
+  /** Number of rows. */
+  Size n_rows_ = 0;
+
+  /** Bandwidth. */
+  Size bandwidth_ = 0;
+
+  /**
+   * Entries of the lower band, row by row: the entry \f$ a_{ij} \f$
+   * is at position <tt>i*(bandwidth_+1) + bandwidth_ + j - i</tt>.
+   */
+  SafeSTLVector<Real> entries_;
+
+  /** True if the entries are the ones of the Cholesky factor. */
+  bool factorized_ = false;
+};
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __BANDED_MATRIX_H_
@@ -223,6 +223,22 @@ void eig_dense_matrix_symm(const DenseMatrix &A,
                            SafeSTLVector<Real> &eigenvalues,
                            DenseMatrix &eigenvectors);
 
+/**
+ * Computes the eigenvalues (and the associated eigenvectors) of the generalized
+ * eigenproblem \f$ A u = \lambda B u \f$, being @p A symmetric and @p B symmetric
+ * and positive definite.
+ *
+ * The @p eigenvalues are sorted in ascending order and for the i-th eigenvalue, the associated eigenvector is
+ * the i-th column of the matrix @p eigenvectors. The eigenvectors are normalized
+ * with respect to @p B, i.e. \f$ U^T B U = I \f$.
+ *
+ * @relates DenseMatrix
+ */
+void eig_dense_matrix_symm_generalized(const DenseMatrix &A,
+                                       const DenseMatrix &B,
+                                       SafeSTLVector<Real> &eigenvalues,
+                                       DenseMatrix &eigenvectors);
+
 
 IGA_NAMESPACE_CLOSE
 
@@ -163,9 +163,10 @@ MapPtr create_map(const BasisPtr basis,
                   Comm &comm)
 {
   const auto dof_dist = basis->get_ptr_const_dof_distribution();
-  const auto dofs = dof_dist->get_global_dofs(property);
-  //TODO (pauletti, Mar 28, 2015): this is double copy of data
-  const SafeSTLVector<Index> dofs_vec(dofs.begin(), dofs.end());
+  const auto &dofs = dof_dist->get_global_dofs(property);
+  SafeSTLVector<Index> dofs_vec;
+  dofs_vec.reserve(dofs.size());
+  dofs_vec.insert(dofs_vec.end(), dofs.begin(), dofs.end());
   auto map = std::make_shared<Map>(-1, dofs_vec.size(), dofs_vec.data(), 0, comm);
   return map;
 }
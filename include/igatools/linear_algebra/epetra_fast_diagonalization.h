@@ -0,0 +1,563 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __EPETRA_FAST_DIAGONALIZATION_H_
+#define __EPETRA_FAST_DIAGONALIZATION_H_
+
+#include <igatools/base/config.h>
+#include <igatools/linear_algebra/epetra_map.h>
+#include <igatools/linear_algebra/dense_matrix.h>
+#include <igatools/operators/kronecker_mass.h>
+#include <igatools/geometry/unit_element.h>
+
+#ifdef IGATOOLS_USES_TRILINOS
+#include <Epetra_Operator.h>
+#include <Epetra_MultiVector.h>
+#endif // IGATOOLS_USES_TRILINOS
+
+#include <set>
+
+IGA_NAMESPACE_OPEN
+
+#ifdef IGATOOLS_USES_TRILINOS
+
+namespace EpetraTools
+{
+
+/**
+ * @brief Fast diagonalization preconditioner for Poisson-type problems
+ * discretized with a (non periodic) BSpline basis.
+ *
+ * On the parametric domain, each component of the operator
+ * \f$ -c_1 \Delta u + c_0 u \f$ has the Kronecker-product structure
+ * \f[
+ * A = c_1 \sum_{d=0}^{dim-1} M_{dim-1} \otimes \dots \otimes K_d \otimes \dots \otimes M_0
+ * + c_0 M_{dim-1} \otimes \dots \otimes M_0,
+ * \f]
+ * where \f$ M_d \f$ and \f$ K_d \f$ are the univariate mass and stiffness matrices
+ * along the direction \f$ d \f$ (see univariate_matrices::compute_mass_stiffness()).
+ * Solving the univariate generalized eigenproblems
+ * \f$ K_d U_d = M_d U_d \Lambda_d \f$ (with \f$ U_d^T M_d U_d = I \f$,
+ * see eig_dense_matrix_symm_generalized()), the inverse of \f$ A \f$ is
+ * \f[
+ * A^{-1} = (U_{dim-1} \otimes \dots \otimes U_0)
+ * \bigl( c_1 \sum_d I \otimes \dots \otimes \Lambda_d \otimes \dots \otimes I + c_0 I \bigr)^{-1}
+ * (U_{dim-1} \otimes \dots \otimes U_0)^T
+ * \f]
+ * and it is applied (see ApplyInverse()) with <tt>2 dim</tt> dense univariate
+ * products per component, i.e. with \f$ O(N^{1+1/dim}) \f$ operations, being \f$ N \f$ the
+ * number of dofs. The setup (the univariate eigenproblems) costs \f$ O(N^{3/dim}) \f$.
+ *
+ * Used as preconditioner (see create_solver()) for the (assembled or matrix-free)
+ * stiffness matrix of a problem on a domain that is a smooth deformation of the
+ * parametric one, the number of iterations of the Krylov solver is robust with respect
+ * to the mesh size and to the degree. For vector-valued bases (e.g. linear elasticity)
+ * the preconditioner is block-diagonal, each block being the operator above for
+ * one component.
+ *
+ * The dofs on the faces in the constructor argument @p dirichlet_faces are removed
+ * from the univariate problems: they are expected to be the Dirichlet dofs
+ * of the system (see dof_tools::apply_boundary_values()) and they are preconditioned
+ * with the diagonal of \f$ A \f$. If no face is Dirichlet and \f$ c_0 = 0 \f$ the
+ * operator \f$ A \f$ is singular and its pseudo-inverse is applied.
+ *
+ * The domain and range maps are the same and they are built from the active dofs
+ * of the basis, so the Epetra vectors created with create_map() for the same basis and
+ * the DofProperties::active property can be used with Apply() and ApplyInverse().
+ *
+ * @note All the dofs must be owned by the calling process (i.e. the operator is meant
+ * to be used with an Epetra_SerialComm).
+ *
+ * @ingroup linear_algebra
+ */
+template <int dim, int range = 1>
+class FastDiagonalization : public Epetra_Operator
+{
+public:
+  using Bs = BSpline<dim,range,1>;
+
+  static const int n_components = Bs::n_components;
+
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. Not allowed to be used.
+   */
+  FastDiagonalization() = delete;
+
+  /**
+   * Constructor. It computes the univariate matrices of the @p basis and
+   * solves the univariate generalized eigenproblems.
+   *
+   * @param[in] basis The basis (it must satisfy the requirements checked by
+   * KroneckerMass::is_supported() for the DofProperties::active property).
+   * @param[in] comm The communicator used to build the map.
+   * @param[in] dirichlet_faces The ids of the faces whose dofs are Dirichlet dofs.
+   * @param[in] stiffness_coeff The coefficient \f$ c_1 \f$.
+   * @param[in] mass_coeff The coefficient \f$ c_0 \f$.
+   */
+  FastDiagonalization(const Bs &basis,
+                      const Epetra_Comm &comm,
+                      const std::set<int> &dirichlet_faces = std::set<int>(),
+                      const Real stiffness_coeff = 1.0,
+                      const Real mass_coeff = 0.0)
+    :
+    stiffness_coeff_(stiffness_coeff),
+    mass_coeff_(mass_coeff)
+  {
+    AssertThrow((KroneckerMass<dim,range>::is_supported(basis,DofProperties::active)),
+                ExcMessage("The basis has not the Kronecker-product structure."));
+    Assert(stiffness_coeff_ >= 0.0 && mass_coeff_ >= 0.0,
+           ExcMessage("The coefficients must be non negative."));
+
+    const auto &space = *basis.get_spline_space();
+    const auto &dof_distribution = *space.get_dof_distribution();
+    const auto &index_table = dof_distribution.get_index_table();
+
+    //--------------------------------------------------------------------------
+    // dofs numbering
+    const auto &global_dofs = dof_distribution.get_global_dofs(DofProperties::active);
+    dofs_.assign(global_dofs.begin(),global_dofs.end());
+
+    const Index max_dof = dofs_.empty() ? -1 : dofs_.back();
+    SafeSTLVector<Index> dof_position(max_dof+1,-1);
+    for (Index pos = 0 ; pos < Index(dofs_.size()) ; ++pos)
+      dof_position[dofs_[pos]] = pos;
+
+    map_ = std::make_shared<Map>(-1, dofs_.size(), dofs_.data(), 0, comm);
+    Assert(map_->NumMyElements() == map_->NumGlobalElements(),
+           ExcMessage("All the dofs must be owned by the calling process."));
+    //--------------------------------------------------------------------------
+
+    //--------------------------------------------------------------------------
+    // the Dirichlet faces remove the first or the last univariate basis function
+    SafeSTLArray<SafeSTLArray<bool,2>,dim> remove_end(SafeSTLArray<bool,2>(false));
+    for (const int s_id : dirichlet_faces)
+    {
+      Assert(s_id >= 0 && s_id < UnitElement<dim>::template num_elem<dim-1>(),
+             ExcIndexRange(s_id,0,UnitElement<dim>::template num_elem<dim-1>()));
+      const auto &face = UnitElement<dim>::template get_elem<dim-1>(s_id);
+      remove_end[face.constant_directions[0]][face.constant_values[0]] = true;
+    }
+    //--------------------------------------------------------------------------
+
+    Real max_eig = 0.0;
+    for (int comp = 0 ; comp < n_components ; ++comp)
+    {
+      //--------------------------------------------------------------------------
+      // univariate problems
+      SafeSTLArray<BandedMatrix,dim> mass;
+      SafeSTLArray<BandedMatrix,dim> stiffness;
+      SafeSTLArray<Index,dim> first;
+      for (int dir = 0 ; dir < dim ; ++dir)
+      {
+        univariate_matrices::compute_mass_stiffness(
+          basis,comp,dir,mass[dir],&stiffness[dir]);
+
+        const Size n = mass[dir].get_num_rows();
+        first[dir] = remove_end[dir][0] ? 1 : 0;
+        const Size n_int = std::max(n - first[dir] - (remove_end[dir][1] ? 1 : 0),0);
+        n_interior_[comp][dir] = n_int;
+
+        auto &mass_int = mass_int_[comp][dir];
+        auto &stiffness_int = stiffness_int_[comp][dir];
+        mass_int.resize(n_int,n_int);
+        stiffness_int.resize(n_int,n_int);
+        const BandedMatrix &m = mass[dir];
+        const BandedMatrix &k = stiffness[dir];
+        for (Index i = 0 ; i < n_int ; ++i)
+          for (Index j = 0 ; j < n_int ; ++j)
+          {
+            mass_int(i,j) = m(first[dir]+i,first[dir]+j);
+            stiffness_int(i,j) = k(first[dir]+i,first[dir]+j);
+          }
+
+        if (n_int > 0)
+          eig_dense_matrix_symm_generalized(stiffness_int,mass_int,
+                                            eigenvalues_[comp][dir],eigenvectors_[comp][dir]);
+      }
+      //--------------------------------------------------------------------------
+
+      //--------------------------------------------------------------------------
+      // positions of the dofs, with the first direction running faster
+      const auto &comp_table = index_table[comp];
+      Size n_int_comp = 1;
+      for (int dir = 0 ; dir < dim ; ++dir)
+        n_int_comp *= n_interior_[comp][dir];
+      interior_pos_[comp].resize(n_int_comp);
+
+      for (Index f = 0 ; f < comp_table.flat_size() ; ++f)
+      {
+        const auto tensor_id = comp_table.flat_to_tensor(f);
+        const Index dof_pos = dof_position[comp_table[f]];
+
+        bool is_interior = true;
+        Index pos = 0;
+        for (int dir = dim-1 ; dir >= 0 ; --dir)
+        {
+          const Index i = tensor_id[dir] - first[dir];
+          is_interior = is_interior && i >= 0 && i < n_interior_[comp][dir];
+          pos = pos * n_interior_[comp][dir] + i;
+        }
+
+        if (is_interior)
+          interior_pos_[comp][pos] = dof_pos;
+        else
+        {
+          // the diagonal of the Kronecker-product operator
+          Real mass_diag = 1.0;
+          for (int dir = 0 ; dir < dim ; ++dir)
+            mass_diag *= mass[dir](tensor_id[dir],tensor_id[dir]);
+
+          Real diag = mass_coeff_ * mass_diag;
+          for (int dir = 0 ; dir < dim ; ++dir)
+          {
+            Real stiffness_diag = 1.0;
+            for (int d = 0 ; d < dim ; ++d)
+            {
+              const BandedMatrix &matrix = (d == dir) ? stiffness[d] : mass[d];
+              stiffness_diag *= matrix(tensor_id[d],tensor_id[d]);
+            }
+            diag += stiffness_coeff_ * stiffness_diag;
+          }
+          AssertThrow(diag > 0.0, ExcMessage("Zero diagonal entry."));
+
+          boundary_pos_.emplace_back(dof_pos);
+          boundary_diag_.emplace_back(diag);
+        }
+      }
+      //--------------------------------------------------------------------------
+
+      //--------------------------------------------------------------------------
+      // eigenvalues of the Kronecker-product operator
+      auto &eig = eigenvalues_sum_[comp];
+      eig.assign(n_int_comp,mass_coeff_);
+      for (Index pos = 0 ; pos < n_int_comp ; ++pos)
+      {
+        Index p = pos;
+        for (int dir = 0 ; dir < dim ; ++dir)
+        {
+          const Size n_int = n_interior_[comp][dir];
+          eig[pos] += stiffness_coeff_ * eigenvalues_[comp][dir][p % n_int];
+          p /= n_int;
+        }
+        max_eig = std::max(max_eig,std::abs(eig[pos]));
+      }
+      //--------------------------------------------------------------------------
+    }
+
+    // the (numerically) zero eigenvalues are not inverted (pseudo-inverse)
+    for (auto &eig : eigenvalues_sum_)
+      for (auto &e : eig)
+        e = (std::abs(e) > 1.0e-12 * max_eig) ? 1.0 / e : 0.0;
+  }
+
+  /**
+   * Copy constructor. Not allowed to be used.
+   */
+  FastDiagonalization(const FastDiagonalization &op) = delete;
+
+  /**
+   * Move constructor. Not allowed to be used.
+   */
+  FastDiagonalization(FastDiagonalization &&op) = delete;
+
+  /**
+   * Destructor.
+   */
+  virtual ~FastDiagonalization() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /**
+   * Copy assignment operator. Not allowed to be used.
+   */
+  FastDiagonalization &operator=(const FastDiagonalization &op) = delete;
+
+  /**
+   * Move assignment operator. Not allowed to be used.
+   */
+  FastDiagonalization &operator=(FastDiagonalization &&op) = delete;
+  ///@}
+
+  /** @name Epetra_Operator interface */
+  ///@{
+  /**
+   * The operator is symmetric, therefore using the transpose does not change anything.
+   */
+  virtual int SetUseTranspose(bool use_transpose) override
+  {
+    use_transpose_ = use_transpose;
+    return 0;
+  }
+
+  /**
+   * Computes <tt>Y = A X</tt>, column by column, being <tt>A</tt> the
+   * Kronecker-product operator (with the diagonal of <tt>A</tt> on the
+   * Dirichlet dofs).
+   */
+  virtual int Apply(const Epetra_MultiVector &X, Epetra_MultiVector &Y) const override
+  {
+    if (X.NumVectors() != Y.NumVectors() ||
+        X.MyLength() != Index(dofs_.size()) ||
+        Y.MyLength() != Index(dofs_.size()))
+      return -1;
+
+    SafeSTLVector<Real> x_int;
+    SafeSTLVector<Real> y_int;
+    SafeSTLVector<Real> buf_0;
+    SafeSTLVector<Real> buf_1;
+    for (int j = 0 ; j < X.NumVectors() ; ++j)
+    {
+      const Real *x = X[j];
+      Real *y = Y[j];
+      for (int comp = 0 ; comp < n_components ; ++comp)
+      {
+        const auto &pos = interior_pos_[comp];
+        const Size n = pos.size();
+        x_int.resize(n);
+        for (Index i = 0 ; i < n ; ++i)
+          x_int[i] = x[pos[i]];
+
+        // mass term
+        y_int = x_int;
+        for (int dir = 0 ; dir < dim ; ++dir)
+        {
+          apply_1D(mass_int_[comp][dir],false,n_interior_[comp],dir,y_int,buf_0);
+          y_int.swap(buf_0);
+        }
+        for (auto &v : y_int)
+          v *= mass_coeff_;
+
+        // stiffness terms
+        for (int k_dir = 0 ; k_dir < dim ; ++k_dir)
+        {
+          buf_1 = x_int;
+          for (int dir = 0 ; dir < dim ; ++dir)
+          {
+            const auto &matrix = (dir == k_dir) ?
+                                 stiffness_int_[comp][dir] : mass_int_[comp][dir];
+            apply_1D(matrix,false,n_interior_[comp],dir,buf_1,buf_0);
+            buf_1.swap(buf_0);
+          }
+          for (Index i = 0 ; i < n ; ++i)
+            y_int[i] += stiffness_coeff_ * buf_1[i];
+        }
+
+        for (Index i = 0 ; i < n ; ++i)
+          y[pos[i]] = y_int[i];
+      }
+
+      const Size n_bdry = boundary_pos_.size();
+      for (Index i = 0 ; i < n_bdry ; ++i)
+        y[boundary_pos_[i]] = boundary_diag_[i] * x[boundary_pos_[i]];
+    }
+
+    return 0;
+  }
+
+  /**
+   * Computes <tt>Y = A^{-1} X</tt>, column by column, with the fast
+   * diagonalization method.
+   */
+  virtual int ApplyInverse(const Epetra_MultiVector &X, Epetra_MultiVector &Y) const override
+  {
+    if (X.NumVectors() != Y.NumVectors() ||
+        X.MyLength() != Index(dofs_.size()) ||
+        Y.MyLength() != Index(dofs_.size()))
+      return -1;
+
+    SafeSTLVector<Real> values;
+    SafeSTLVector<Real> buf;
+    for (int j = 0 ; j < X.NumVectors() ; ++j)
+    {
+      const Real *x = X[j];
+      Real *y = Y[j];
+      for (int comp = 0 ; comp < n_components ; ++comp)
+      {
+        const auto &pos = interior_pos_[comp];
+        const Size n = pos.size();
+        values.resize(n);
+        for (Index i = 0 ; i < n ; ++i)
+          values[i] = x[pos[i]];
+
+        for (int dir = 0 ; dir < dim ; ++dir)
+        {
+          apply_1D(eigenvectors_[comp][dir],true,n_interior_[comp],dir,values,buf);
+          values.swap(buf);
+        }
+
+        const auto &inv_eig = eigenvalues_sum_[comp];
+        for (Index i = 0 ; i < n ; ++i)
+          values[i] *= inv_eig[i];
+
+        for (int dir = 0 ; dir < dim ; ++dir)
+        {
+          apply_1D(eigenvectors_[comp][dir],false,n_interior_[comp],dir,values,buf);
+          values.swap(buf);
+        }
+
+        for (Index i = 0 ; i < n ; ++i)
+          y[pos[i]] = values[i];
+      }
+
+      const Size n_bdry = boundary_pos_.size();
+      for (Index i = 0 ; i < n_bdry ; ++i)
+        y[boundary_pos_[i]] = x[boundary_pos_[i]] / boundary_diag_[i];
+    }
+
+    return 0;
+  }
+
+  /**
+   * Not implemented: returns 0.0 (see HasNormInf()).
+   */
+  virtual double NormInf() const override
+  {
+    return 0.0;
+  }
+
+  virtual const char *Label() const override
+  {
+    return "igatools::EpetraTools::FastDiagonalization";
+  }
+
+  virtual bool UseTranspose() const override
+  {
+    return use_transpose_;
+  }
+
+  virtual bool HasNormInf() const override
+  {
+    return false;
+  }
+
+  virtual const Epetra_Comm &Comm() const override
+  {
+    return map_->Comm();
+  }
+
+  virtual const Epetra_Map &OperatorDomainMap() const override
+  {
+    return *map_;
+  }
+
+  virtual const Epetra_Map &OperatorRangeMap() const override
+  {
+    return *map_;
+  }
+  ///@}
+
+  /**
+   * Returns the map used for the domain and the range of the operator.
+   */
+  MapPtr get_map() const
+  {
+    return map_;
+  }
+
+private:
+  /**
+   * Applies the univariate @p matrix (or its transpose, if @p transpose is true)
+   * along the direction @p dir to the tensor @p in of size @p n
+   * (with the first direction running faster).
+   */
+  static void apply_1D(const DenseMatrix &matrix,
+                       const bool transpose,
+                       const SafeSTLArray<Size,dim> &n,
+                       const int dir,
+                       const SafeSTLVector<Real> &in,
+                       SafeSTLVector<Real> &out)
+  {
+    Size n_before = 1;
+    for (int d = 0 ; d < dir ; ++d)
+      n_before *= n[d];
+    const Size n_dir = n[dir];
+    const Size n_after = (n_before * n_dir > 0) ? in.size() / (n_before * n_dir) : 0;
+
+    out.assign(in.size(),0.0);
+    for (Index i_after = 0 ; i_after < n_after ; ++i_after)
+    {
+      const Real *x = &in[i_after * n_dir * n_before];
+      Real *y = &out[i_after * n_dir * n_before];
+      for (Index r = 0 ; r < n_dir ; ++r)
+        for (Index c = 0 ; c < n_dir ; ++c)
+        {
+          const Real a = transpose ? matrix(c,r) : matrix(r,c);
+          if (a == 0.0)
+            continue;
+          for (Index i_before = 0 ; i_before < n_before ; ++i_before)
+            y[r * n_before + i_before] += a * x[c * n_before + i_before];
+        }
+    }
+  }
+
+  /** Coefficient \f$ c_1 \f$ of the stiffness term. */
+  Real stiffness_coeff_;
+
+  /** Coefficient \f$ c_0 \f$ of the mass term. */
+  Real mass_coeff_;
+
+  /** Sorted global ids of the (active) dofs. */
+  SafeSTLVector<Index> dofs_;
+
+  /** Number of univariate basis functions (without the Dirichlet ones). */
+  SafeSTLArray<SafeSTLArray<Size,dim>,n_components> n_interior_;
+
+  /** Univariate mass matrices (without the Dirichlet rows and columns). */
+  SafeSTLArray<SafeSTLArray<DenseMatrix,dim>,n_components> mass_int_;
+
+  /** Univariate stiffness matrices (without the Dirichlet rows and columns). */
+  SafeSTLArray<SafeSTLArray<DenseMatrix,dim>,n_components> stiffness_int_;
+
+  /** Univariate generalized eigenvalues. */
+  SafeSTLArray<SafeSTLArray<SafeSTLVector<Real>,dim>,n_components> eigenvalues_;
+
+  /** Univariate generalized eigenvectors (column-wise). */
+  SafeSTLArray<SafeSTLArray<DenseMatrix,dim>,n_components> eigenvectors_;
+
+  /** Inverse of the eigenvalues of the Kronecker-product operator. */
+  SafeSTLArray<SafeSTLVector<Real>,n_components> eigenvalues_sum_;
+
+  /**
+   * Positions (in the dofs vector) of the non Dirichlet dofs of each component,
+   * in tensor order with the first direction running faster.
+   */
+  SafeSTLArray<SafeSTLVector<Index>,n_components> interior_pos_;
+
+  /** Positions (in the dofs vector) of the Dirichlet dofs. */
+  SafeSTLVector<Index> boundary_pos_;
+
+  /** Diagonal of the Kronecker-product operator on the Dirichlet dofs. */
+  SafeSTLVector<Real> boundary_diag_;
+
+  MapPtr map_;
+
+  bool use_transpose_ = false;
+};
+
+}
+
+#endif // IGATOOLS_USES_TRILINOS
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __EPETRA_FAST_DIAGONALIZATION_H_
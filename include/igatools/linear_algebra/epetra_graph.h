@@ -23,6 +23,7 @@
 
 #include <igatools/base/config.h>
 #include <igatools/linear_algebra/epetra_map.h>
+#include <igatools/linear_algebra/sparsity_pattern.h>
 
 #ifdef IGATOOLS_USES_TRILINOS
 #include <Epetra_CrsGraph.h>
@@ -49,47 +50,36 @@ GraphPtr
 create_graph(const std::map<Index,std::set<Index>> &dofs_connectivity,
              const Comm &comm);
 
+/**
+ * Create an Epetra_CrsGraph object (wrapped by a shared pointer) from the
+ * sparsity @p pattern.
+ *
+ * The row and column ids are passed to Epetra directly from the contiguous arrays
+ * stored in the @p pattern, without intermediate copies.
+ */
+GraphPtr
+create_graph(const SparsityPattern &pattern,
+             const Comm &comm);
 
 
-
+/**
+ * Create an Epetra_CrsGraph object (wrapped by a shared pointer) for the matrix
+ * whose rows are associated to the dofs of @p row_basis with property @p row_property
+ * and whose columns are associated to the dofs of @p col_basis with property @p col_property.
+ *
+ * The sparsity pattern is computed by create_sparsity_pattern(), using
+ * @p n_threads threads.
+ */
 template<class RowBasis, class ColBasis>
 GraphPtr
 create_graph(const RowBasis &row_basis, const std::string &row_property,
              const ColBasis &col_basis, const std::string &col_property,
-             const Comm &comm)
+             const Comm &comm,
+             const int n_threads = thread_tools::get_default_num_threads())
 {
-  std::map<Index,std::set<Index>> dofs_connectivity;
-
-  Assert(row_basis.get_grid() == col_basis.get_grid(),
-         ExcMessage("Row and column basis built on different grids."));
-
-  auto r_elem = row_basis.begin();
-  auto c_elem = col_basis.begin();
-  const auto r_end = row_basis.end();
-
-  LogStream myout;
-  for (; r_elem != r_end ;)
-  {
-#if 0
-    myout.begin_item("Row elem");
-    r_elem->get_index().print_info(myout);
-    myout.end_item();
-
-    myout.begin_item("Col elem");
-    c_elem->get_index().print_info(myout);
-    myout.end_item();
-#endif
-    const auto r_dofs = r_elem->get_local_to_global(row_property);
-    const auto c_dofs = c_elem->get_local_to_global(col_property);
-    for (auto &r_dof : r_dofs)
-      dofs_connectivity[r_dof].insert(c_dofs.begin(),c_dofs.end());
-
-    ++r_elem;
-
-    ++c_elem;
-  }
-
-  return create_graph(dofs_connectivity,comm);
+  return create_graph(
+           create_sparsity_pattern(row_basis,row_property,col_basis,col_property,n_threads),
+           comm);
 }
 
 }
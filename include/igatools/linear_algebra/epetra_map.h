@@ -26,6 +26,7 @@
 #include <igatools/linear_algebra/dense_vector.h>
 #include <igatools/linear_algebra/dense_matrix.h>
 #include <igatools/utils/safe_stl_vector.h>
+#include <igatools/utils/index_set.h>
 
 #ifdef IGATOOLS_USES_TRILINOS
 #include <Epetra_SerialComm.h>
@@ -56,6 +57,12 @@ using MapPtr = std::shared_ptr<Map>;
 MapPtr
 create_map(const std::set<Index> &dofs,const Comm &comm);
 
+/**
+ * Create an Epetra_Map object (wrapped by a shared pointer) from a set of @p dofs.
+ */
+MapPtr
+create_map(const IndexSet<Index> &dofs,const Comm &comm);
+
 /**
  * Create an Epetra_Map object (wrapped by a shared pointer) from a @p basis and the @p dofs_property
  * used to extract the dofs from the basis.
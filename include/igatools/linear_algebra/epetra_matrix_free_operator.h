@@ -0,0 +1,211 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __EPETRA_MATRIX_FREE_OPERATOR_H_
+#define __EPETRA_MATRIX_FREE_OPERATOR_H_
+
+#include <igatools/base/config.h>
+#include <igatools/linear_algebra/epetra_map.h>
+#include <igatools/operators/sum_factorization_operator.h>
+
+#ifdef IGATOOLS_USES_TRILINOS
+#include <Epetra_Operator.h>
+#include <Epetra_MultiVector.h>
+#endif // IGATOOLS_USES_TRILINOS
+
+IGA_NAMESPACE_OPEN
+
+#ifdef IGATOOLS_USES_TRILINOS
+
+namespace EpetraTools
+{
+
+/**
+ * @brief Epetra_Operator wrapping a SumFactorizationOperator, i.e. a (symmetric)
+ * operator whose matrix is never assembled.
+ *
+ * It can be used wherever Trilinos expects an Epetra_Operator, in particular as the
+ * operator of the linear problem solved by the Belos solvers returned by
+ * create_solver().
+ *
+ * The domain and range maps are the same and they are built from the dofs
+ * of the SumFactorizationOperator (see SumFactorizationOperator::get_dofs()),
+ * so the Epetra vectors created with create_map() for the same basis and the
+ * DofProperties::active property can be used with Apply().
+ *
+ * @note All the dofs must be owned by the calling process (i.e. the operator is meant
+ * to be used with an Epetra_SerialComm).
+ *
+ * @ingroup linear_algebra
+ */
+template <int dim>
+class MatrixFreeOperator : public Epetra_Operator
+{
+public:
+  using SFOperator = SumFactorizationOperator<dim>;
+
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. Not allowed to be used.
+   */
+  MatrixFreeOperator() = delete;
+
+  /**
+   * Constructor.
+   */
+  MatrixFreeOperator(const std::shared_ptr<const SFOperator> &op,
+                     const Epetra_Comm &comm)
+    :
+    op_(op)
+  {
+    Assert(op_ != nullptr, ExcNullPtr());
+    const auto &dofs = op_->get_dofs();
+    map_ = std::make_shared<Map>(-1, dofs.size(), dofs.data(), 0, comm);
+    Assert(map_->NumMyElements() == map_->NumGlobalElements(),
+           ExcMessage("All the dofs must be owned by the calling process."));
+  }
+
+  /**
+   * Copy constructor. Not allowed to be used.
+   */
+  MatrixFreeOperator(const MatrixFreeOperator &op) = delete;
+
+  /**
+   * Move constructor. Not allowed to be used.
+   */
+  MatrixFreeOperator(MatrixFreeOperator &&op) = delete;
+
+  /**
+   * Destructor.
+   */
+  virtual ~MatrixFreeOperator() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /**
+   * Copy assignment operator. Not allowed to be used.
+   */
+  MatrixFreeOperator &operator=(const MatrixFreeOperator &op) = delete;
+
+  /**
+   * Move assignment operator. Not allowed to be used.
+   */
+  MatrixFreeOperator &operator=(MatrixFreeOperator &&op) = delete;
+  ///@}
+
+  /** @name Epetra_Operator interface */
+  ///@{
+  /**
+   * The operator is symmetric, therefore using the transpose does not change anything.
+   */
+  virtual int SetUseTranspose(bool use_transpose) override
+  {
+    use_transpose_ = use_transpose;
+    return 0;
+  }
+
+  /**
+   * Computes <tt>Y = A X</tt>, column by column.
+   */
+  virtual int Apply(const Epetra_MultiVector &X, Epetra_MultiVector &Y) const override
+  {
+    if (X.NumVectors() != Y.NumVectors() ||
+        X.MyLength() != op_->get_num_dofs() ||
+        Y.MyLength() != op_->get_num_dofs())
+      return -1;
+
+    for (int j = 0 ; j < X.NumVectors() ; ++j)
+      op_->apply(X[j],Y[j]);
+
+    return 0;
+  }
+
+  /**
+   * Not implemented: returns -1.
+   */
+  virtual int ApplyInverse(const Epetra_MultiVector &X, Epetra_MultiVector &Y) const override
+  {
+    return -1;
+  }
+
+  /**
+   * Not implemented: returns 0.0 (see HasNormInf()).
+   */
+  virtual double NormInf() const override
+  {
+    return 0.0;
+  }
+
+  virtual const char *Label() const override
+  {
+    return "igatools::EpetraTools::MatrixFreeOperator";
+  }
+
+  virtual bool UseTranspose() const override
+  {
+    return use_transpose_;
+  }
+
+  virtual bool HasNormInf() const override
+  {
+    return false;
+  }
+
+  virtual const Epetra_Comm &Comm() const override
+  {
+    return map_->Comm();
+  }
+
+  virtual const Epetra_Map &OperatorDomainMap() const override
+  {
+    return *map_;
+  }
+
+  virtual const Epetra_Map &OperatorRangeMap() const override
+  {
+    return *map_;
+  }
+  ///@}
+
+  /**
+   * Returns the map used for the domain and the range of the operator.
+   */
+  MapPtr get_map() const
+  {
+    return map_;
+  }
+
+private:
+  std::shared_ptr<const SFOperator> op_;
+
+  MapPtr map_;
+
+  bool use_transpose_ = false;
+};
+
+}
+
+#endif // IGATOOLS_USES_TRILINOS
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __EPETRA_MATRIX_FREE_OPERATOR_H_
@@ -45,6 +45,36 @@ create_solver(const Matrix &A, Vector &x, const Vector &b,
               const std::string &solver_type = "CG",
               const Real tolerance = 1.0e-8,
               const int max_num_iters = 400);
+
+/**
+ * Creates a Belos solver for the linear system <tt>A x = b</tt> where the operator
+ * @p A is only known through its action (e.g. a MatrixFreeOperator).
+ *
+ * As the entries of @p A are not available, no preconditioner is set.
+ */
+SolverPtr
+create_solver(const OP &A, Vector &x, const Vector &b,
+              const std::string &solver_type = "CG",
+              const Real tolerance = 1.0e-8,
+              const int max_num_iters = 400);
+
+/**
+ * Creates a Belos solver for the linear system <tt>A x = b</tt>, using the
+ * operator @p preconditioner as (left) preconditioner, instead of the
+ * algebraic multigrid one used by default.
+ *
+ * The action of the preconditioner is its <tt>ApplyInverse()</tt> method,
+ * e.g. the fast diagonalization of the FastDiagonalization class.
+ *
+ * @note The solver keeps a reference to @p preconditioner, that must be
+ * alive while the solver is used.
+ */
+SolverPtr
+create_solver(const OP &A, Vector &x, const Vector &b,
+              const OP &preconditioner,
+              const std::string &solver_type = "CG",
+              const Real tolerance = 1.0e-8,
+              const int max_num_iters = 400);
 }
 
 #endif // IGATOOLS_USES_TRILINOS
@@ -0,0 +1,602 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __SPARSITY_PATTERN_H_
+#define __SPARSITY_PATTERN_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/exceptions.h>
+#include <igatools/base/logstream.h>
+#include <igatools/basis_functions/spline_space.h>
+#include <igatools/utils/safe_stl_vector.h>
+#include <igatools/utils/thread_tools.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <limits>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Sparsity pattern of a matrix, stored in compressed row storage (CSR) format.
+ *
+ * The global column ids of the row <tt>rows_id[i]</tt> are stored (sorted and without
+ * repetitions) in the range <tt>[offsets[i],offsets[i+1])</tt> of the vector
+ * <tt>cols_id</tt>. The global row ids are sorted.
+ *
+ * The data are stored in contiguous arrays, so they can be directly used to
+ * build the linear algebra objects (see EpetraTools::create_graph()).
+ *
+ * @see create_sparsity_pattern()
+ *
+ * @ingroup linear_algebra
+ */
+class SparsityPattern
+{
+public:
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. It builds an empty pattern.
+   */
+  SparsityPattern()
+    :
+    offsets_(1,0)
+  {}
+
+  /**
+   * Builds the pattern from its CSR representation.
+   */
+  SparsityPattern(SafeSTLVector<Index> &&rows_id,
+                  SafeSTLVector<Index> &&offsets,
+                  SafeSTLVector<Index> &&cols_id)
+    :
+    rows_id_(std::move(rows_id)),
+    offsets_(std::move(offsets)),
+    cols_id_(std::move(cols_id))
+  {
+    Assert(offsets_.size() == rows_id_.size()+1,
+           ExcDimensionMismatch(offsets_.size(),rows_id_.size()+1));
+    Assert(offsets_.back() == cols_id_.size(),
+           ExcDimensionMismatch(offsets_.back(),cols_id_.size()));
+  }
+
+  /**
+   * Copy constructor.
+   */
+  SparsityPattern(const SparsityPattern &pattern) = default;
+
+  /**
+   * Move constructor.
+   */
+  SparsityPattern(SparsityPattern &&pattern) = default;
+
+  /**
+   * Destructor.
+   */
+  ~SparsityPattern() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /**
+   * Copy assignment operator.
+   */
+  SparsityPattern &operator=(const SparsityPattern &pattern) = default;
+
+  /**
+   * Move assignment operator.
+   */
+  SparsityPattern &operator=(SparsityPattern &&pattern) = default;
+  ///@}
+
+  /**
+   * Returns the number of rows.
+   */
+  Size get_num_rows() const
+  {
+    return rows_id_.size();
+  }
+
+  /**
+   * Returns the number of nonzero entries.
+   */
+  Size get_num_entries() const
+  {
+    return cols_id_.size();
+  }
+
+  /**
+   * Returns the number of nonzero entries in the <tt>i</tt>-th row
+   * (i.e. the row with global id <tt>get_rows_id()[i]</tt>).
+   */
+  Size get_num_entries_in_row(const Index i) const
+  {
+    Assert(i >= 0 && i < this->get_num_rows(),ExcIndexRange(i,0,this->get_num_rows()));
+    return offsets_[i+1] - offsets_[i];
+  }
+
+  /**
+   * Returns the global row ids (sorted).
+   */
+  const SafeSTLVector<Index> &get_rows_id() const
+  {
+    return rows_id_;
+  }
+
+  /**
+   * Returns the offsets of the rows in the vector returned by get_cols_id().
+   */
+  const SafeSTLVector<Index> &get_offsets() const
+  {
+    return offsets_;
+  }
+
+  /**
+   * Returns the global column ids of all the rows.
+   */
+  const SafeSTLVector<Index> &get_cols_id() const
+  {
+    return cols_id_;
+  }
+
+  /**
+   * Returns true if the two patterns have the same rows and columns.
+   */
+  bool operator==(const SparsityPattern &pattern) const
+  {
+    return rows_id_ == pattern.rows_id_ &&
+           offsets_ == pattern.offsets_ &&
+           cols_id_ == pattern.cols_id_;
+  }
+
+  void print_info(LogStream &out) const
+  {
+    const Size n_rows = this->get_num_rows();
+    for (Index i = 0 ; i < n_rows ; ++i)
+    {
+      out << rows_id_[i] << ": [ ";
+      for (Index k = offsets_[i] ; k < offsets_[i+1] ; ++k)
+        out << cols_id_[k] << " ";
+      out << "]" << std::endl;
+    }
+  }
+
+private:
+  SafeSTLVector<Index> rows_id_;
+
+  SafeSTLVector<Index> offsets_;
+
+  SafeSTLVector<Index> cols_id_;
+};
+
+
+
+namespace sparsity_pattern_tools
+{
+
+/**
+ * Concatenates the CSR chunks computed by the threads (in the order of the threads),
+ * each one made of the global ids, the (local) offsets and the columns of a subset of rows.
+ */
+inline
+SparsityPattern
+concatenate_chunks(const std::vector<SafeSTLVector<Index>> &rows_id_chunks,
+                   const std::vector<SafeSTLVector<Index>> &offsets_chunks,
+                   const std::vector<SafeSTLVector<Index>> &cols_id_chunks)
+{
+  Size n_rows = 0;
+  Size n_entries = 0;
+  const int n_chunks = rows_id_chunks.size();
+  for (int c = 0 ; c < n_chunks ; ++c)
+  {
+    n_rows += rows_id_chunks[c].size();
+    n_entries += cols_id_chunks[c].size();
+  }
+
+  SafeSTLVector<Index> rows_id;
+  SafeSTLVector<Index> offsets;
+  SafeSTLVector<Index> cols_id;
+  rows_id.reserve(n_rows);
+  offsets.reserve(n_rows+1);
+  cols_id.reserve(n_entries);
+
+  offsets.emplace_back(0);
+  for (int c = 0 ; c < n_chunks ; ++c)
+  {
+    const Index shift = cols_id.size();
+    rows_id.insert(rows_id.end(),rows_id_chunks[c].begin(),rows_id_chunks[c].end());
+    for (auto it = offsets_chunks[c].begin() + 1 ; it != offsets_chunks[c].end() ; ++it)
+      offsets.emplace_back(*it + shift);
+    cols_id.insert(cols_id.end(),cols_id_chunks[c].begin(),cols_id_chunks[c].end());
+  }
+
+  return SparsityPattern(std::move(rows_id),std::move(offsets),std::move(cols_id));
+}
+
+
+
+/**
+ * Returns true if the sparsity pattern of the two spaces can be computed using
+ * create_tensor_product_pattern(), i.e. if the spaces are built on the same Grid,
+ * all the elements of the Grid are active and the spaces are not periodic.
+ */
+template <int dim, int r_range, int r_rank, int c_range, int c_rank>
+bool
+has_tensor_product_pattern(const SplineSpace<dim,r_range,r_rank> &row_space,
+                           const SplineSpace<dim,c_range,c_rank> &col_space)
+{
+  const auto grid = row_space.get_grid();
+  if (grid != col_space.get_grid())
+    return false;
+
+  if (grid->get_num_elements(ElementProperties::active) != grid->get_num_all_elems())
+    return false;
+
+  const auto &r_periodic = row_space.get_periodicity();
+  for (int comp = 0 ; comp < SplineSpace<dim,r_range,r_rank>::n_components ; ++comp)
+    for (int dir = 0 ; dir < dim ; ++dir)
+      if (r_periodic[comp][dir])
+        return false;
+
+  const auto &c_periodic = col_space.get_periodicity();
+  for (int comp = 0 ; comp < SplineSpace<dim,c_range,c_rank>::n_components ; ++comp)
+    for (int dir = 0 ; dir < dim ; ++dir)
+      if (c_periodic[comp][dir])
+        return false;
+
+  return true;
+}
+
+
+
+/**
+ * Sparsity pattern computed using the tensor-product structure of the spaces.
+ *
+ * In each direction, the elements in the support of the (one dimensional)
+ * basis function with index <tt>i</tt> form a contiguous interval, and therefore
+ * the column functions whose support overlaps it form a contiguous interval of indices.
+ * The columns of a row are then the tensor product of these intervals,
+ * and they are computed without any loop over the elements.
+ *
+ * The rows are processed concurrently by @p n_threads threads.
+ *
+ * @pre has_tensor_product_pattern(row_space,col_space) must be true.
+ */
+template <int dim, int r_range, int r_rank, int c_range, int c_rank>
+SparsityPattern
+create_tensor_product_pattern(const SplineSpace<dim,r_range,r_rank> &row_space,
+                              const PropId &row_property,
+                              const SplineSpace<dim,c_range,c_rank> &col_space,
+                              const PropId &col_property,
+                              const int n_threads)
+{
+  Assert(n_threads > 0, ExcLowerRange(n_threads,1));
+  Assert((has_tensor_product_pattern(row_space,col_space)),
+         ExcMessage("The spaces have not a tensor-product sparsity pattern."));
+
+  using RowSpace = SplineSpace<dim,r_range,r_rank>;
+  using ColSpace = SplineSpace<dim,c_range,c_rank>;
+  const int r_n_comps = RowSpace::n_components;
+  const int c_n_comps = ColSpace::n_components;
+
+  const auto &r_dof_distr = *row_space.get_dof_distribution();
+  const auto &c_dof_distr = *col_space.get_dof_distribution();
+  const auto &r_index_table = r_dof_distr.get_index_table();
+  const auto &c_index_table = c_dof_distr.get_index_table();
+  const auto &r_dofs_with_property = r_dof_distr.get_global_dofs(row_property);
+  const auto &c_dofs_with_property = c_dof_distr.get_global_dofs(col_property);
+
+  const auto r_accum_mult = row_space.accumulated_interior_multiplicities();
+  const auto c_accum_mult = col_space.accumulated_interior_multiplicities();
+  const auto &r_deg = row_space.get_degree_table();
+  const auto &c_deg = col_space.get_degree_table();
+
+  //------------------------------------------------------------------------------
+  // For each pair of components and each direction, the interval [first,last] of
+  // the column indices overlapping the row index i is stored in cols_interval[i].
+  using Interval = std::pair<Index,Index>;
+  std::vector<std::array<std::vector<Interval>,dim>> cols_intervals(r_n_comps * c_n_comps);
+  for (int r_comp = 0 ; r_comp < r_n_comps ; ++r_comp)
+  {
+    const auto r_size = r_index_table[r_comp].tensor_size();
+    for (int dir = 0 ; dir < dim ; ++dir)
+    {
+      const auto &r_acc = r_accum_mult[r_comp][dir];
+      const Size n_elems = r_acc.size();
+
+      // interval of the elements in the support of the row index i
+      SafeSTLVector<Index> first_elem(r_size[dir],n_elems);
+      SafeSTLVector<Index> last_elem(r_size[dir],-1);
+      for (Index elem = 0 ; elem < n_elems ; ++elem)
+        for (Index i = r_acc[elem] ; i <= r_acc[elem] + r_deg[r_comp][dir] ; ++i)
+        {
+          first_elem[i] = std::min(first_elem[i],elem);
+          last_elem[i] = std::max(last_elem[i],elem);
+        }
+
+      for (int c_comp = 0 ; c_comp < c_n_comps ; ++c_comp)
+      {
+        const auto &c_acc = c_accum_mult[c_comp][dir];
+        auto &intervals = cols_intervals[r_comp * c_n_comps + c_comp][dir];
+        intervals.resize(r_size[dir]);
+        for (Index i = 0 ; i < r_size[dir] ; ++i)
+          intervals[i] = Interval(c_acc[first_elem[i]],
+                                  c_acc[last_elem[i]] + c_deg[c_comp][dir]);
+      }
+    }
+  }
+  //------------------------------------------------------------------------------
+
+
+  //------------------------------------------------------------------------------
+  // rows with the property, sorted by global id
+  struct Row
+  {
+    Index dof;
+    int comp;
+    Index flat_id;
+
+    bool operator<(const Row &row) const
+    {
+      return dof < row.dof;
+    }
+  };
+  std::vector<Row> rows;
+  rows.reserve(r_dofs_with_property.size());
+  for (int r_comp = 0 ; r_comp < r_n_comps ; ++r_comp)
+  {
+    const auto &index_table = r_index_table[r_comp];
+    const Size n_ids = index_table.flat_size();
+    for (Index flat_id = 0 ; flat_id < n_ids ; ++flat_id)
+    {
+      const Index dof = index_table[flat_id];
+      if (r_dofs_with_property.count(dof) > 0)
+        rows.emplace_back(Row {dof,r_comp,flat_id});
+    }
+  }
+  std::sort(rows.begin(),rows.end());
+  //------------------------------------------------------------------------------
+
+  const auto chunks = thread_tools::split_range(rows.size(),n_threads);
+  const int n_chunks = chunks.size() - 1;
+
+  std::vector<SafeSTLVector<Index>> rows_id_chunks(n_chunks);
+  std::vector<SafeSTLVector<Index>> offsets_chunks(n_chunks);
+  std::vector<SafeSTLVector<Index>> cols_id_chunks(n_chunks);
+
+  thread_tools::run_in_parallel(n_chunks,[&](const int c)
+  {
+    auto &rows_id = rows_id_chunks[c];
+    auto &offsets = offsets_chunks[c];
+    auto &cols_id = cols_id_chunks[c];
+    rows_id.reserve(chunks[c+1] - chunks[c]);
+    offsets.reserve(chunks[c+1] - chunks[c] + 1);
+    offsets.emplace_back(0);
+
+    TensorIndex<dim> first;
+    TensorIndex<dim> last;
+    for (Index r = chunks[c] ; r < chunks[c+1] ; ++r)
+    {
+      const auto &row = rows[r];
+      const auto row_t_id = r_index_table[row.comp].flat_to_tensor(row.flat_id);
+      const auto row_begin = cols_id.size();
+
+      for (int c_comp = 0 ; c_comp < c_n_comps ; ++c_comp)
+      {
+        const auto &intervals = cols_intervals[row.comp * c_n_comps + c_comp];
+        for (int dir = 0 ; dir < dim ; ++dir)
+        {
+          first[dir] = intervals[dir][row_t_id[dir]].first;
+          last[dir] = intervals[dir][row_t_id[dir]].second;
+        }
+
+        // loop over the box [first,last] of column indices
+        const auto &index_table = c_index_table[c_comp];
+        TensorIndex<dim> col_t_id = first;
+        while (true)
+        {
+          const Index col_dof = index_table(col_t_id);
+          if (c_dofs_with_property.count(col_dof) > 0)
+            cols_id.emplace_back(col_dof);
+
+          int dir = 0;
+          for (; dir < dim ; ++dir)
+          {
+            if (++col_t_id[dir] <= last[dir])
+              break;
+            col_t_id[dir] = first[dir];
+          }
+          if (dir == dim)
+            break;
+        }
+      } // end loop c_comp
+
+      // for non periodic spaces the column dofs are distinct
+      std::sort(cols_id.begin() + row_begin,cols_id.end());
+
+      rows_id.emplace_back(row.dof);
+      offsets.emplace_back(cols_id.size());
+    } // end loop r
+  });
+
+  return concatenate_chunks(rows_id_chunks,offsets_chunks,cols_id_chunks);
+}
+
+
+
+/**
+ * Sparsity pattern computed from the element-to-dofs connectivity
+ * (see SplineSpace::get_element_dofs_table()) of the active elements of the Grid.
+ *
+ * The elements containing each row dof are stored in a CSR table,
+ * then the rows are processed concurrently by @p n_threads threads: the columns of a
+ * row are gathered from its elements, sorted and made unique.
+ *
+ * This function can be used for any pair of spaces built on the same Grid.
+ */
+template <int dim, int r_range, int r_rank, int c_range, int c_rank>
+SparsityPattern
+create_element_pattern(const SplineSpace<dim,r_range,r_rank> &row_space,
+                       const PropId &row_property,
+                       const SplineSpace<dim,c_range,c_rank> &col_space,
+                       const PropId &col_property,
+                       const int n_threads)
+{
+  Assert(n_threads > 0, ExcLowerRange(n_threads,1));
+  Assert(row_space.get_grid() == col_space.get_grid(),
+         ExcMessage("Row and column spaces built on different grids."));
+
+  const auto &r_table = row_space.get_element_dofs_table(row_property);
+  const auto &c_table = col_space.get_element_dofs_table(col_property);
+
+  SafeSTLVector<Index> elems;
+  for (const auto &elem_id : row_space.get_grid()->get_elements_with_property(ElementProperties::active))
+    elems.emplace_back(elem_id.get_flat_index());
+  const Size n_elems = elems.size();
+
+  //------------------------------------------------------------------------------
+  // global row ids, and position of each global row id in the vector rows_id
+  Index min_row = std::numeric_limits<Index>::max();
+  Index max_row = -1;
+  for (const auto elem : elems)
+    for (const auto dof : r_table.get_global_dofs(elem))
+    {
+      min_row = std::min(min_row,dof);
+      max_row = std::max(max_row,dof);
+    }
+  if (max_row < 0)
+    return SparsityPattern();
+
+  SafeSTLVector<Index> row_pos(max_row - min_row + 1,-1);
+  for (const auto elem : elems)
+    for (const auto dof : r_table.get_global_dofs(elem))
+      row_pos[dof - min_row] = 0;
+
+  SafeSTLVector<Index> rows_id;
+  for (Index dof = min_row ; dof <= max_row ; ++dof)
+    if (row_pos[dof - min_row] == 0)
+    {
+      row_pos[dof - min_row] = rows_id.size();
+      rows_id.emplace_back(dof);
+    }
+    else
+      row_pos[dof - min_row] = -1;
+  const Size n_rows = rows_id.size();
+  //------------------------------------------------------------------------------
+
+
+  //------------------------------------------------------------------------------
+  // row-to-elements table (CSR)
+  SafeSTLVector<Index> row_elems_offsets(n_rows+1,0);
+  for (const auto elem : elems)
+    for (const auto dof : r_table.get_global_dofs(elem))
+      ++row_elems_offsets[row_pos[dof - min_row]+1];
+  for (Index r = 0 ; r < n_rows ; ++r)
+    row_elems_offsets[r+1] += row_elems_offsets[r];
+
+  SafeSTLVector<Index> row_elems(row_elems_offsets.back());
+  {
+    SafeSTLVector<Index> pos(row_elems_offsets.begin(),row_elems_offsets.end()-1);
+    for (Index e = 0 ; e < n_elems ; ++e)
+      for (const auto dof : r_table.get_global_dofs(elems[e]))
+        row_elems[pos[row_pos[dof - min_row]]++] = elems[e];
+  }
+  //------------------------------------------------------------------------------
+
+  const auto chunks = thread_tools::split_range(n_rows,n_threads);
+  const int n_chunks = chunks.size() - 1;
+
+  std::vector<SafeSTLVector<Index>> rows_id_chunks(n_chunks);
+  std::vector<SafeSTLVector<Index>> offsets_chunks(n_chunks);
+  std::vector<SafeSTLVector<Index>> cols_id_chunks(n_chunks);
+
+  thread_tools::run_in_parallel(n_chunks,[&](const int c)
+  {
+    auto &offsets = offsets_chunks[c];
+    auto &cols_id = cols_id_chunks[c];
+    rows_id_chunks[c].assign(rows_id.begin() + chunks[c],rows_id.begin() + chunks[c+1]);
+    offsets.reserve(chunks[c+1] - chunks[c] + 1);
+    offsets.emplace_back(0);
+
+    SafeSTLVector<Index> row_cols;
+    for (Index r = chunks[c] ; r < chunks[c+1] ; ++r)
+    {
+      row_cols.clear();
+      for (Index k = row_elems_offsets[r] ; k < row_elems_offsets[r+1] ; ++k)
+      {
+        const auto elem_cols = c_table.get_global_dofs(row_elems[k]);
+        row_cols.insert(row_cols.end(),elem_cols.begin(),elem_cols.end());
+      }
+      std::sort(row_cols.begin(),row_cols.end());
+      cols_id.insert(cols_id.end(),
+                     row_cols.begin(),
+                     std::unique(row_cols.begin(),row_cols.end()));
+      offsets.emplace_back(cols_id.size());
+    }
+  });
+
+  return concatenate_chunks(rows_id_chunks,offsets_chunks,cols_id_chunks);
+}
+
+} // end namespace sparsity_pattern_tools
+
+
+
+/**
+ * Returns the sparsity pattern of the matrix whose rows are associated to the
+ * basis functions of @p row_basis with the property @p row_property
+ * and whose columns are associated to the basis functions of @p col_basis
+ * with the property @p col_property (i.e. the entry <tt>(i,j)</tt> is nonzero if
+ * the supports of the functions <tt>i</tt> and <tt>j</tt> share an active element).
+ *
+ * If the spaces have a tensor-product structure
+ * (see sparsity_pattern_tools::has_tensor_product_pattern())
+ * the pattern is computed analytically from the one dimensional supports of the
+ * basis functions, otherwise it is computed from the element-to-dofs connectivity.
+ * In both cases the rows are processed by @p n_threads concurrent threads, and the
+ * result does not depend on the number of threads.
+ *
+ * @ingroup linear_algebra
+ */
+template<class RowBasis, class ColBasis>
+SparsityPattern
+create_sparsity_pattern(const RowBasis &row_basis, const PropId &row_property,
+                        const ColBasis &col_basis, const PropId &col_property,
+                        const int n_threads = thread_tools::get_default_num_threads())
+{
+  Assert(row_basis.get_grid() == col_basis.get_grid(),
+         ExcMessage("Row and column basis built on different grids."));
+
+  const auto &row_space = *row_basis.get_spline_space();
+  const auto &col_space = *col_basis.get_spline_space();
+
+  if (sparsity_pattern_tools::has_tensor_product_pattern(row_space,col_space))
+    return sparsity_pattern_tools::create_tensor_product_pattern(
+             row_space,row_property,col_space,col_property,n_threads);
+  else
+    return sparsity_pattern_tools::create_element_pattern(
+             row_space,row_property,col_space,col_property,n_threads);
+}
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __SPARSITY_PATTERN_H_
@@ -72,14 +72,47 @@ public:
   /** Type for the element accessor of the <em>trial</em> physical space. */
   using ElemTrial = ElemTest;
 
-  /** The constructors and destructor are inherithed from the base class. */
-  using base_t::base_t;
-
+  /** Type for the memory used by the temporary data of the sum-factorization. */
+  using Workspace = SumFactorizationWorkspace<dim_>;
 
 
   static const int n_components = BSpline<dim_,range_,rank_>::n_components;
 
 
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. The temporary data are stored in a workspace owned
+   * by the object.
+   */
+  EllipticOperatorsSFIntegrationBSpline()
+    :
+    workspace_(&own_workspace_)
+  {}
+
+  /**
+   * Constructor. The temporary data are stored in the @p workspace, that
+   * is borrowed by the object (and therefore it must live longer than the object).
+   *
+   * If the @p workspace is already sized for the elements on which the
+   * operators are evaluated, the evaluations do not perform any heap allocation.
+   */
+  EllipticOperatorsSFIntegrationBSpline(Workspace &workspace)
+    :
+    workspace_(&workspace)
+  {}
+
+  /** Copy constructor. */
+  EllipticOperatorsSFIntegrationBSpline(const self_t &in) = delete;
+
+  /** Move constructor. */
+  EllipticOperatorsSFIntegrationBSpline(self_t &&in) = delete;
+
+  /** Destructor. */
+  ~EllipticOperatorsSFIntegrationBSpline() = default;
+  ///@}
+
+
 
   /** @name Assignment operators */
   ///@{
@@ -187,6 +220,21 @@ protected:
     const SafeSTLArray<Real,dim_> &length_element_edge) const;
 
 
+  /**
+   * Same as above, but the univariate basis (stored as
+   * <tt>n_basis x n_points</tt> matrices) and the univariate quadrature weights
+   * are passed as pointers, and the result is written in @p moments
+   * (resized if needed).
+   */
+  void
+  evaluate_w_phi1Dtrial_phi1Dtest(
+    const SafeSTLArray<const DenseMatrix *,dim_> &phi_1D_test,
+    const SafeSTLArray<const DenseMatrix *,dim_> &phi_1D_trial,
+    const SafeSTLArray<const SafeSTLVector<Real> *,dim_> &quad_weights,
+    const SafeSTLArray<Real,dim_> &length_element_edge,
+    SafeSTLArray<DynamicMultiArray<Real,3>,dim_> &moments) const;
+
+
   template <int sdim>
   void
   integrate_add_operator_general_order(
@@ -203,6 +251,13 @@ protected:
     const ValueVector<Real> &c,
     const int s_id,
     DenseMatrix &op) const;
+
+private:
+  /** Workspace used when no workspace is passed to the constructor. */
+  Workspace own_workspace_;
+
+  /** Workspace used for the temporary data. */
+  Workspace *workspace_;
 };
 
 
@@ -282,6 +337,59 @@ evaluate_w_phi1Dtrial_phi1Dtest(
 
 
 
+template <int dim_,int range_,int rank_>
+inline
+void
+EllipticOperatorsSFIntegrationBSpline<dim_,range_,rank_>::
+evaluate_w_phi1Dtrial_phi1Dtest(
+  const SafeSTLArray<const DenseMatrix *,dim_> &phi_1D_test,
+  const SafeSTLArray<const DenseMatrix *,dim_> &phi_1D_trial,
+  const SafeSTLArray<const SafeSTLVector<Real> *,dim_> &quad_weights,
+  const SafeSTLArray<Real,dim_> &length_element_edge,
+  SafeSTLArray<DynamicMultiArray<Real,3>,dim_> &moments) const
+{
+  for (int dir = 0 ; dir < dim ; ++dir)
+  {
+    const auto &phi_test  = *phi_1D_test [dir];
+    const auto &phi_trial = *phi_1D_trial[dir];
+    const auto &w = *quad_weights[dir];
+
+    const Size n_basis_test  = phi_test.get_num_rows();
+    const Size n_basis_trial = phi_trial.get_num_rows();
+    const Size n_pts = w.size();
+
+    Assert(phi_test.get_num_cols() == n_pts,
+           ExcDimensionMismatch(phi_test.get_num_cols(),n_pts));
+    Assert(phi_trial.get_num_cols() == n_pts,
+           ExcDimensionMismatch(phi_trial.get_num_cols(),n_pts));
+
+    TensorSize<3> moments1D_tensor_size;
+    moments1D_tensor_size[0] = n_pts;
+    moments1D_tensor_size[1] = n_basis_trial;
+    moments1D_tensor_size[2] = n_basis_test;
+
+    auto &moments1D = moments[dir];
+    moments1D.resize(moments1D_tensor_size);
+
+    const Real edge_length = length_element_edge[dir];
+
+    Index flat_id_I = 0 ;
+    for (Index f_id_test = 0 ; f_id_test < n_basis_test ; ++f_id_test)
+    {
+      for (Index f_id_trial = 0 ; f_id_trial < n_basis_trial ; ++f_id_trial)
+      {
+        for (int pt = 0 ; pt < n_pts ; ++pt)
+        {
+          moments1D[flat_id_I++] =
+            w[pt] * edge_length * phi_test(f_id_test,pt) * phi_trial(f_id_trial,pt);
+        } // end loop pt
+      } // end loop f_id_trial
+    } // end loop f_id_test
+  } // end loop dir
+}
+
+
+
 template <int dim_,int range_,int rank_>
 template <int sdim>
 inline
@@ -342,12 +450,24 @@ integrate_add_operator_general_order(
   Assert(quad_elem_test == quad_elem_trial,
          ExcMessage("Test and trial elements have different quadrature schemes."));
 
-  const auto quad_scheme = extend_sub_elem_quad<sdim,dim_>(*quad_elem_test,s_id);
+  Assert(quad_elem_test->is_tensor_product(),
+         ExcMessage("The quadrature scheme has not the tensor-product structure."));
 
-//  const auto quad_scheme = quad_elem_test;
-  Assert(quad_scheme.is_tensor_product(),
-         ExcMessage("The quadrature scheme has not the tensor-product structure."))
-  const auto points_t_size = quad_scheme.get_num_coords_direction();
+  auto &workspace = *workspace_;
+
+  // univariate quadrature weights of the sub-element quadrature, extended to
+  // the dim-dimensional element (the constant directions have a single point with weight 1)
+  const auto &sub_element = UnitElement<dim>::template get_elem<sdim>(s_id);
+  const auto &active_directions = sub_element.active_directions;
+
+  SafeSTLArray<const SafeSTLVector<Real> *,dim> weights_1D(&workspace.unit_weight);
+  const auto &sub_elem_weights_1D = quad_elem_test->get_weights_1d();
+  for (int i = 0 ; i < sdim ; ++i)
+    weights_1D[active_directions[i]] = &sub_elem_weights_1D.get_data_direction(i);
+
+  TensorSize<dim> points_t_size;
+  for (int i = 0 ; i < dim ; ++i)
+    points_t_size[i] = weights_1D[i]->size();
   //--------------------------------------------------------------------------
 
 
@@ -392,11 +512,11 @@ integrate_add_operator_general_order(
 
   //--------------------------------------------------------------------------
   // getting the 1D values for the test and trial space -- begin
-  SafeSTLArray<ValueTable<Real>,dim> phi_1D_test;
-  SafeSTLArray<ValueTable<Real>,dim> phi_1D_trial;
+  SafeSTLArray<const DenseMatrix *,dim> phi_1D_test;
+  SafeSTLArray<const DenseMatrix *,dim> phi_1D_trial;
 
-  const auto &phi_1D_table_test  = elem_test.template get_splines1D_table(dim_,0); // the 0 index is because sdim == dim
-  const auto &phi_1D_table_trial = elem_test.template get_splines1D_table(dim_,0); // the 0 index is because sdim == dim
+  const auto &phi_1D_table_test  = elem_test.template get_splines1D_table(sdim,s_id);
+  const auto &phi_1D_table_trial = elem_trial.template get_splines1D_table(sdim,s_id);
 
   const auto &phi_1D_comp_test  = phi_1D_table_test [comp_test];
   const auto &phi_1D_comp_trial = phi_1D_table_trial[comp_trial];
@@ -405,34 +525,17 @@ integrate_add_operator_general_order(
   {
     const int n_pts_1D = points_t_size[i];
 
-    const auto &v_test = phi_1D_comp_test[i].get_derivative(deriv_order_test[i]);
-    Assert(v_test.get_num_rows() == basis_t_size_elem_test [i],
-           ExcDimensionMismatch(v_test.get_num_rows(),basis_t_size_elem_test[i]));
-    Assert(v_test.get_num_cols() == n_pts_1D,
-           ExcDimensionMismatch(v_test.get_num_cols(),n_pts_1D));
-
-    const auto &v_trial = phi_1D_comp_trial[i].get_derivative(deriv_order_trial[i]);
-    Assert(v_trial.get_num_rows() == basis_t_size_elem_trial[i],
-           ExcDimensionMismatch(v_trial.get_num_rows(),basis_t_size_elem_trial[i]));
-    Assert(v_trial.get_num_cols() == n_pts_1D,
-           ExcDimensionMismatch(v_trial.get_num_cols(),n_pts_1D));
-
-    phi_1D_test [i].resize(basis_t_size_elem_test [i],n_pts_1D);
-    phi_1D_trial[i].resize(basis_t_size_elem_trial[i],n_pts_1D);
-
-    for (int fn = 0 ; fn < basis_t_size_elem_test[i] ; ++fn)
-    {
-      auto phi_1D_test_fn = phi_1D_test[i].get_function_view(fn);
-      for (int pt = 0 ; pt < n_pts_1D ; ++pt)
-        phi_1D_test_fn[pt] = v_test(fn,pt); // only valid for scalar spaces
-    }
-
-    for (int fn = 0 ; fn < basis_t_size_elem_trial[i] ; ++fn)
-    {
-      auto phi_1D_trial_fn = phi_1D_trial[i].get_function_view(fn);
-      for (int pt = 0 ; pt < n_pts_1D ; ++pt)
-        phi_1D_trial_fn[pt] = v_trial(fn,pt); // only valid for scalar spaces
-    }
+    phi_1D_test[i] = &phi_1D_comp_test[i].get_derivative(deriv_order_test[i]);
+    Assert(phi_1D_test[i]->get_num_rows() == basis_t_size_elem_test [i],
+           ExcDimensionMismatch(phi_1D_test[i]->get_num_rows(),basis_t_size_elem_test[i]));
+    Assert(phi_1D_test[i]->get_num_cols() == n_pts_1D,
+           ExcDimensionMismatch(phi_1D_test[i]->get_num_cols(),n_pts_1D));
+
+    phi_1D_trial[i] = &phi_1D_comp_trial[i].get_derivative(deriv_order_trial[i]);
+    Assert(phi_1D_trial[i]->get_num_rows() == basis_t_size_elem_trial[i],
+           ExcDimensionMismatch(phi_1D_trial[i]->get_num_rows(),basis_t_size_elem_trial[i]));
+    Assert(phi_1D_trial[i]->get_num_cols() == n_pts_1D,
+           ExcDimensionMismatch(phi_1D_trial[i]->get_num_cols(),n_pts_1D));
   }
   // getting the 1D values for the test and trial space -- end
   //--------------------------------------------------------------------------
@@ -458,9 +561,7 @@ integrate_add_operator_general_order(
 
 
 
-  const auto &l_tmp = grid_elem.template get_side_lengths<sdim>(s_id);
-  const auto &sub_element = UnitElement<dim>::template get_elem<sdim>(s_id);
-  const auto &active_directions = sub_element.active_directions;
+  const auto l_tmp = grid_elem.template get_side_lengths<sdim>(s_id);
 
   SafeSTLArray<Real,dim> length_element_edges(1.0);
   for (int i = 0 ; i < sdim ; ++i)
@@ -470,11 +571,13 @@ integrate_add_operator_general_order(
   }
 
 
-  const auto w_phi1Dtrial_phi1Dtest = evaluate_w_phi1Dtrial_phi1Dtest(
-                                        phi_1D_test,
-                                        phi_1D_trial,
-                                        quad_scheme.get_weights_1d(),
-                                        length_element_edges);
+  auto &w_phi1Dtrial_phi1Dtest = workspace.J;
+  evaluate_w_phi1Dtrial_phi1Dtest(
+    phi_1D_test,
+    phi_1D_trial,
+    weights_1D,
+    length_element_edges,
+    w_phi1Dtrial_phi1Dtest);
 
 #ifdef TIME_PROFILING
   this->elapsed_time_compute_phi1Dtest_phi1Dtrial_ +=
@@ -496,12 +599,13 @@ integrate_add_operator_general_order(
   tensor_size_C0[1] = 1; // alpha size
   tensor_size_C0[2] = 1; // beta size
 
-  DynamicMultiArray<Real,3> C0(tensor_size_C0);
+  auto &C0 = workspace.C0;
+  C0.resize(tensor_size_C0);
   const Size n_entries = tensor_size_C0.flat_size();
 
 
-  Assert(coeffs_test_trial.size() == quad_scheme.get_num_points(),
-         ExcDimensionMismatch(coeffs_test_trial.size(),quad_scheme.get_num_points()));
+  Assert(coeffs_test_trial.size() == quad_elem_test->get_num_points(),
+         ExcDimensionMismatch(coeffs_test_trial.size(),quad_elem_test->get_num_points()));
   Assert(n_entries == coeffs_test_trial.flat_size(),
          ExcDimensionMismatch(n_entries,coeffs_test_trial.flat_size()));
   for (Index entry_id = 0 ; entry_id < n_entries ; ++entry_id)
@@ -517,6 +621,7 @@ integrate_add_operator_general_order(
                C0,
                row_id_begin, row_id_last,
                col_id_begin, col_id_last,
+               workspace,
                op);
 
 
@@ -25,6 +25,7 @@
 #include <igatools/utils/dynamic_multi_array.h>
 #include <igatools/utils/multi_array_utils.h>
 #include <igatools/linear_algebra/dense_matrix.h>
+#include <igatools/operators/sum_factorization_kernels.h>
 
 #include <vector>
 
@@ -33,6 +34,175 @@ IGA_NAMESPACE_OPEN
 
 
 
+/**
+ * @brief Memory used for the temporary data in the integration of a local operator
+ * with the sum-factorization technique.
+ *
+ * The workspace contains the arrays used by IntegratorSumFactorization
+ * (the aligned panels storing the transposed moments along the first direction and
+ * the partial contractions) and by the classes
+ * computing the local operators (the coefficients <tt>C0</tt> and the
+ * univariate moments <tt>J</tt>).
+ * All the arrays are resized before their use: as the memory used by an
+ * array is never released when the array shrinks, after the workspace
+ * has been sized (by the constructor, by reserve() or by the first integration)
+ * the integrations of local operators of the same (or smaller) size do not perform any
+ * heap allocation.
+ *
+ * A workspace must not be used concurrently by more than one thread:
+ * in a multithreaded element loop each thread must own its own workspace.
+ *
+ * @ingroup linear_algebra
+ */
+template <int dim>
+class SumFactorizationWorkspace
+{
+public:
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. No memory is reserved.
+   */
+  SumFactorizationWorkspace()
+    :
+    unit_weight(1,1.0)
+  {}
+
+  /**
+   * Constructor. Reserves the memory needed by the integration of local operators
+   * built with (at most) @p max_n_basis_1D univariate basis functions and
+   * (at most) @p max_n_pts_1D quadrature points along each direction.
+   */
+  SumFactorizationWorkspace(const int max_n_basis_1D, const int max_n_pts_1D)
+    :
+    SumFactorizationWorkspace()
+  {
+    this->reserve(max_n_basis_1D,max_n_pts_1D);
+  }
+
+  /**
+   * Copy constructor. Not allowed to be used.
+   */
+  SumFactorizationWorkspace(const SumFactorizationWorkspace &ws) = delete;
+
+  /**
+   * Move constructor.
+   */
+  SumFactorizationWorkspace(SumFactorizationWorkspace &&ws) = default;
+
+  /**
+   * Destructor.
+   */
+  ~SumFactorizationWorkspace() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /**
+   * Copy assignment operator. Not allowed to be used.
+   */
+  SumFactorizationWorkspace &operator=(const SumFactorizationWorkspace &ws) = delete;
+
+  /**
+   * Move assignment operator.
+   */
+  SumFactorizationWorkspace &operator=(SumFactorizationWorkspace &&ws) = default;
+  ///@}
+
+  /**
+   * Reserves the memory needed by the integration of local operators
+   * built with (at most) @p max_n_basis_1D univariate basis functions and
+   * (at most) @p max_n_pts_1D quadrature points along each direction.
+   */
+  void reserve(const int max_n_basis_1D, const int max_n_pts_1D)
+  {
+    Assert(max_n_basis_1D > 0, ExcLowerRange(max_n_basis_1D,1));
+    Assert(max_n_pts_1D > 0, ExcLowerRange(max_n_pts_1D,1));
+
+    TensorSize<3> t_size_J;
+    t_size_J[0] = max_n_pts_1D;
+    t_size_J[1] = max_n_basis_1D;
+    t_size_J[2] = max_n_basis_1D;
+    for (auto &J_dir : J)
+      grow(J_dir,t_size_J);
+
+    Size n_pts = 1;
+    for (int i = 0 ; i < dim ; ++i)
+      n_pts *= max_n_pts_1D;
+
+    TensorSize<3> t_size_C0;
+    t_size_C0[0] = n_pts;
+    t_size_C0[1] = 1;
+    t_size_C0[2] = 1;
+    grow(C0,t_size_C0);
+
+    // panels used by IntegratorSumFactorization: the rows have the (padded) length
+    // of the number of (trial,test) pairs along the first direction
+    const Size n_pairs = max_n_basis_1D * max_n_basis_1D;
+    const Size row_length = sum_factorization_kernels::get_padded_size(n_pairs);
+    grow(moments_0,max_n_pts_1D * row_length);
+
+    // the k-th partial contraction has (n_pts_1D)^(dim-1-k) * (n_pairs)^k rows
+    Size n_rows = n_pts / max_n_pts_1D;
+    Size max_n_rows = n_rows;
+    for (int k = 1 ; k < dim ; ++k)
+    {
+      n_rows = (n_rows / max_n_pts_1D) * n_pairs;
+      max_n_rows = std::max(max_n_rows,n_rows);
+    }
+    grow(panel_0,max_n_rows * row_length);
+    grow(panel_1,max_n_rows * row_length);
+  }
+
+  /**
+   * Univariate moments (quadrature weights times the univariate test and trial
+   * functions) along each direction.
+   */
+  SafeSTLArray<DynamicMultiArray<Real,3>,dim> J;
+
+  /** Coefficients of the operator at the quadrature points. */
+  DynamicMultiArray<Real,3> C0;
+
+  /**
+   * Moments along the first direction, transposed (i.e. with the quadrature
+   * points running along the rows) and padded.
+   */
+  sum_factorization_kernels::AlignedVector moments_0;
+
+  /** Panel for the partial contractions. */
+  sum_factorization_kernels::AlignedVector panel_0;
+
+  /** Panel for the partial contractions. */
+  sum_factorization_kernels::AlignedVector panel_1;
+
+  /**
+   * Vector with the single weight 1.0, used for the directions in which a
+   * sub-element quadrature is constant.
+   */
+  SafeSTLVector<Real> unit_weight;
+
+private:
+  /**
+   * Resizes the array @p a to @p t_size, only if the new size is bigger than the current one.
+   */
+  static void grow(DynamicMultiArray<Real,3> &a, const TensorSize<3> &t_size)
+  {
+    if (t_size.flat_size() > a.flat_size())
+      a.resize(t_size);
+  }
+
+  /**
+   * Resizes the vector @p v to @p size, only if the new size is bigger than the current one.
+   */
+  static void grow(sum_factorization_kernels::AlignedVector &v, const Size size)
+  {
+    if (size > Size(v.size()))
+      v.resize(size);
+  }
+};
+
+
+
 template <int dim>
 class IntegratorSumFactorization
 {
@@ -70,6 +240,23 @@ public:
     const int col_id_begin,
     const int col_id_last,
     DenseMatrix &local_operator) const;
+
+  /**
+   * Same as above, but the temporary data are stored in the @p workspace.
+   */
+  void operator()(
+    const bool is_symmetric,
+    const TensorSize<0> &t_size_theta,
+    const TensorSize<0> &t_size_alpha,
+    const TensorSize<0> &t_size_beta,
+    const SafeSTLArray<DynamicMultiArray<Real,3>,0> &J,
+    const DynamicMultiArray<Real,3> &C,
+    const int row_id_begin,
+    const int row_id_last,
+    const int col_id_begin,
+    const int col_id_last,
+    SumFactorizationWorkspace<0> &workspace,
+    DenseMatrix &local_operator) const;
 };
 
 
@@ -89,6 +276,23 @@ public:
     const int col_id_begin,
     const int col_id_last,
     DenseMatrix &local_operator) const;
+
+  /**
+   * Same as above, but the temporary data are stored in the @p workspace.
+   */
+  void operator()(
+    const bool is_symmetric,
+    const TensorSize<1> &t_size_theta,
+    const TensorSize<1> &t_size_alpha,
+    const TensorSize<1> &t_size_beta,
+    const SafeSTLArray<DynamicMultiArray<Real,3>,1> &J,
+    const DynamicMultiArray<Real,3> &C,
+    const int row_id_begin,
+    const int row_id_last,
+    const int col_id_begin,
+    const int col_id_last,
+    SumFactorizationWorkspace<1> &workspace,
+    DenseMatrix &local_operator) const;
 };
 
 template <>
@@ -107,6 +311,23 @@ public:
     const int col_id_begin,
     const int col_id_last,
     DenseMatrix &local_operator) const;
+
+  /**
+   * Same as above, but the temporary data are stored in the @p workspace.
+   */
+  void operator()(
+    const bool is_symmetric,
+    const TensorSize<2> &t_size_theta,
+    const TensorSize<2> &t_size_alpha,
+    const TensorSize<2> &t_size_beta,
+    const SafeSTLArray<DynamicMultiArray<Real,3>,2> &J,
+    const DynamicMultiArray<Real,3> &C,
+    const int row_id_begin,
+    const int row_id_last,
+    const int col_id_begin,
+    const int col_id_last,
+    SumFactorizationWorkspace<2> &workspace,
+    DenseMatrix &local_operator) const;
 };
 
 
@@ -126,6 +347,23 @@ public:
     const int col_id_begin,
     const int col_id_last,
     DenseMatrix &local_operator) const;
+
+  /**
+   * Same as above, but the temporary data are stored in the @p workspace.
+   */
+  void operator()(
+    const bool is_symmetric,
+    const TensorSize<3> &t_size_theta,
+    const TensorSize<3> &t_size_alpha,
+    const TensorSize<3> &t_size_beta,
+    const SafeSTLArray<DynamicMultiArray<Real,3>,3> &J,
+    const DynamicMultiArray<Real,3> &C,
+    const int row_id_begin,
+    const int row_id_last,
+    const int col_id_begin,
+    const int col_id_last,
+    SumFactorizationWorkspace<3> &workspace,
+    DenseMatrix &local_operator) const;
 };
 
 IGA_NAMESPACE_CLOSE
@@ -0,0 +1,520 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+
+#ifndef __KRONECKER_MASS_H_
+#define __KRONECKER_MASS_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/quadrature.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/linear_algebra/banded_matrix.h>
+#include <igatools/operators/univariate_matrices.h>
+#include <igatools/operators/sum_factorization_kernels.h>
+
+#include <algorithm>
+#include <cmath>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Mass matrix of a (non periodic) BSpline basis, exploiting its
+ * Kronecker-product structure.
+ *
+ * On the parametric domain, the mass matrix of each component of a BSpline basis
+ * is the Kronecker product of the univariate mass matrices
+ * \f[
+ * M = M_{d-1} \otimes \dots \otimes M_0 ,
+ * \f]
+ * therefore it can be inverted by solving (with the banded Cholesky factors
+ * of the univariate matrices, see BandedMatrix) a sequence of univariate problems,
+ * one direction at a time, with a cost of \f$ O(N p) \f$ where \f$ N \f$ is the number
+ * of dofs and \f$ p \f$ is the degree (see solve()).
+ *
+ * The class can also apply (see vmult()) the mass matrix with a variable
+ * coefficient
+ * \f[
+ * (M_c)_{ij} = \int_{\hat{\Omega}} c(\hat{x}) \hat{B}_i(\hat{x}) \hat{B}_j(\hat{x}) \; d\hat{x} ,
+ * \f]
+ * e.g. the mass matrix of a basis on a mapped domain, for which
+ * \f$ c = |\det D F| \f$. The coefficient is given by the integration weights at the
+ * quadrature points of each element (see set_weights()) and \f$ M_c \f$ is never
+ * assembled: on each element the local coefficients are interpolated at the
+ * quadrature points (and scattered back to the basis functions) by <tt>dim</tt>
+ * contractions with the univariate basis values (sum factorization).
+ * As \f$ M_c \f$ is spectrally equivalent to \f$ M \f$, the latter is an
+ * effective preconditioner for the solution of the systems with the first one.
+ *
+ * The vectors used by solve() and vmult() are indexed by the <em>position</em>
+ * of the dofs in the (sorted) set of dofs of the basis (see get_dofs()).
+ *
+ * @ingroup linear_algebra
+ */
+template <int dim, int range>
+class KroneckerMass
+{
+public:
+  using Bs = BSpline<dim,range,1>;
+
+  static const int n_components = Bs::n_components;
+
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. Not allowed to be used.
+   */
+  KroneckerMass() = delete;
+
+  /**
+   * Constructor. It computes and factorizes the univariate mass matrices of
+   * the @p basis.
+   *
+   * @note The basis must satisfy the requirements checked by is_supported().
+   */
+  KroneckerMass(const Bs &basis)
+    :
+    basis_(std::dynamic_pointer_cast<const Bs>(basis.shared_from_this()))
+  {
+    Assert(is_supported(basis,DofProperties::active),
+           ExcMessage("The basis has not the Kronecker-product structure."));
+
+    const auto &space = *basis.get_spline_space();
+    const auto &dof_distribution = *space.get_dof_distribution();
+    const auto &index_table = dof_distribution.get_index_table();
+    const auto &degree_table = space.get_degree_table();
+
+    //--------------------------------------------------------------------------
+    // dofs numbering
+    const auto &global_dofs = dof_distribution.get_global_dofs(DofProperties::active);
+    dofs_.assign(global_dofs.begin(),global_dofs.end());
+
+    const Index max_dof = dofs_.empty() ? -1 : dofs_.back();
+    SafeSTLVector<Index> dof_position(max_dof+1,-1);
+    for (Index pos = 0 ; pos < Index(dofs_.size()) ; ++pos)
+      dof_position[dofs_[pos]] = pos;
+    //--------------------------------------------------------------------------
+
+    for (int comp = 0 ; comp < n_components ; ++comp)
+    {
+      const auto &comp_table = index_table[comp];
+      n_basis_[comp] = comp_table.tensor_size();
+
+      // positions of the dofs, with the first direction running faster
+      dof_pos_[comp].resize(comp_table.flat_size());
+      for (Index f = 0 ; f < comp_table.flat_size() ; ++f)
+      {
+        const auto tensor_id = comp_table.flat_to_tensor(f);
+        Index pos = 0;
+        for (int dir = dim-1 ; dir >= 0 ; --dir)
+          pos = pos * n_basis_[comp][dir] + tensor_id[dir];
+        dof_pos_[comp][pos] = dof_position[comp_table[f]];
+      }
+
+      for (int dir = 0 ; dir < dim ; ++dir)
+      {
+        degree_[comp][dir] = degree_table[comp][dir];
+        univariate_matrices::compute_mass_stiffness(
+          basis,comp,dir,mass_1D_[comp][dir]);
+        mass_1D_[comp][dir].factorize();
+      }
+    }
+  }
+
+  /**
+   * Copy constructor. Not allowed to be used.
+   */
+  KroneckerMass(const KroneckerMass &mass) = delete;
+
+  /**
+   * Move constructor. Not allowed to be used.
+   */
+  KroneckerMass(KroneckerMass &&mass) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~KroneckerMass() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /**
+   * Copy assignment operator. Not allowed to be used.
+   */
+  KroneckerMass &operator=(const KroneckerMass &mass) = delete;
+
+  /**
+   * Move assignment operator. Not allowed to be used.
+   */
+  KroneckerMass &operator=(KroneckerMass &&mass) = delete;
+  ///@}
+
+  /**
+   * Returns true if the mass matrix of the dofs of the @p basis with the
+   * property @p dofs_property has the Kronecker-product structure, i.e. if the basis is
+   * not periodic along any direction and all its dofs have the property @p dofs_property.
+   */
+  static bool is_supported(const Bs &basis, const std::string &dofs_property)
+  {
+    const auto &space = *basis.get_spline_space();
+    const auto &dof_distribution = *space.get_dof_distribution();
+
+    Size n_dofs = 0;
+    for (int comp = 0 ; comp < n_components ; ++comp)
+    {
+      for (int dir = 0 ; dir < dim ; ++dir)
+        if (space.get_periodic_table()[comp][dir])
+          return false;
+      n_dofs += dof_distribution.get_num_dofs_comp(comp);
+    }
+
+    return dof_distribution.get_num_dofs(dofs_property) == n_dofs &&
+           dof_distribution.get_num_dofs(DofProperties::active) == n_dofs;
+  }
+
+  /**
+   * Returns the (sorted) global ids of the dofs. The entries of the vectors used by
+   * solve() and vmult() refer to the dofs in this order.
+   */
+  const SafeSTLVector<Index> &get_dofs() const
+  {
+    return dofs_;
+  }
+
+  /**
+   * Returns the number of dofs, i.e. the size of the vectors used by solve()
+   * and vmult().
+   */
+  Size get_num_dofs() const
+  {
+    return dofs_.size();
+  }
+
+  /**
+   * Solves in place the system \f$ M x = b \f$ with the (constant coefficient)
+   * parametric mass matrix.
+   *
+   * @p x must point to an array of get_num_dofs() entries, containing \f$ b \f$
+   * on input.
+   */
+  void solve(Real *x) const
+  {
+    SafeSTLVector<Real> values;
+    for (int comp = 0 ; comp < n_components ; ++comp)
+    {
+      const auto &dof_pos = dof_pos_[comp];
+      const Size n = dof_pos.size();
+      values.resize(n);
+      for (Index i = 0 ; i < n ; ++i)
+        values[i] = x[dof_pos[i]];
+
+      // the inverse of the Kronecker product is applied direction by direction
+      for (int dir = 0 ; dir < dim ; ++dir)
+      {
+        const auto &n_basis = n_basis_[comp];
+        Size n_before = 1;
+        for (int d = 0 ; d < dir ; ++d)
+          n_before *= n_basis[d];
+        const Size n_dir = n_basis[dir];
+        const Size n_after = n / (n_before * n_dir);
+
+        for (Index i_after = 0 ; i_after < n_after ; ++i_after)
+          for (Index i_before = 0 ; i_before < n_before ; ++i_before)
+            mass_1D_[comp][dir].solve(&values[i_after * n_dir * n_before + i_before],
+                                      n_before);
+      }
+
+      for (Index i = 0 ; i < n ; ++i)
+        x[dof_pos[i]] = values[i];
+    }
+  }
+
+  /**
+   * Solves in place the system \f$ M x = b \f$.
+   */
+  void solve(SafeSTLVector<Real> &x) const
+  {
+    Assert(x.size() == dofs_.size(), ExcDimensionMismatch(x.size(),dofs_.size()));
+    this->solve(x.data());
+  }
+
+  /**
+   * Sets the integration weights defining the mass matrix \f$ M_c \f$ applied
+   * by vmult().
+   *
+   * @param[in] quad Tensor-product quadrature scheme used on each element.
+   * @param[in] elem_intervals Tensor index (in the Grid) of each element.
+   * @param[in] weights Integration weights (i.e. the quadrature weights multiplied
+   * by the element measure and by the coefficient \f$ c \f$): <tt>quad.get_num_points()</tt>
+   * values for each element, with the elements in the order of @p elem_intervals.
+   */
+  void set_weights(const Quadrature<dim> &quad,
+                   const SafeSTLVector<TensorIndex<dim>> &elem_intervals,
+                   const SafeSTLVector<Real> &weights)
+  {
+    Assert(quad.is_tensor_product(),
+           ExcMessage("The quadrature scheme has not the tensor-product structure."));
+    Assert(weights.size() == elem_intervals.size() * quad.get_num_points(),
+           ExcDimensionMismatch(weights.size(),
+                                elem_intervals.size() * quad.get_num_points()));
+
+    n_pts_elem_ = quad.get_num_points();
+    for (int dir = 0 ; dir < dim ; ++dir)
+      n_pts_1D_[dir] = quad.get_coords_direction(dir).size();
+
+    for (int comp = 0 ; comp < n_components ; ++comp)
+      for (int dir = 0 ; dir < dim ; ++dir)
+        univariate_matrices::evaluate_bsplines_on_intervals(
+          *basis_, comp, dir, quad.get_coords_direction(dir),
+          first_basis_1D_[comp][dir], values_1D_[comp][dir]);
+
+    elem_intervals_ = elem_intervals;
+    weights_ = weights;
+  }
+
+  /**
+   * Computes \f$ y = M_c x \f$, with the coefficient defined by set_weights().
+   *
+   * @p x and @p y must point to (non-overlapping) arrays of get_num_dofs() entries.
+   */
+  void vmult(const Real *x, Real *y) const
+  {
+    Assert(!elem_intervals_.empty(), ExcMessage("The weights have not been set."));
+
+    std::fill(y, y + dofs_.size(), 0.0);
+
+    SafeSTLVector<Real> x_loc;
+    SafeSTLVector<Real> buf_0;
+    SafeSTLVector<Real> buf_1;
+    SafeSTLVector<Real> coeffs;
+    SafeSTLVector<Index> loc_pos;
+    for (int comp = 0 ; comp < n_components ; ++comp)
+    {
+      const auto &dof_pos = dof_pos_[comp];
+      const auto &n_basis = n_basis_[comp];
+
+      TensorSize<dim> n_basis_elem;
+      Size n_max = 1;
+      for (int dir = 0 ; dir < dim ; ++dir)
+      {
+        n_basis_elem[dir] = degree_[comp][dir] + 1;
+        n_max *= std::max(n_basis_elem[dir],n_pts_1D_[dir]);
+      }
+      const Size n_loc = n_basis_elem.flat_size();
+      x_loc.resize(n_loc);
+      loc_pos.resize(n_loc);
+      buf_0.resize(n_max);
+      buf_1.resize(n_max);
+      coeffs.resize(*std::max_element(n_basis_elem.begin(),n_basis_elem.end()));
+
+      const Index n_elems = elem_intervals_.size();
+      for (Index e = 0 ; e < n_elems ; ++e)
+      {
+        const auto &intervals = elem_intervals_[e];
+
+        // positions of the local dofs (with the first direction running faster)
+        for (Index i = 0 ; i < n_loc ; ++i)
+        {
+          Index i_dir = i;
+          Index pos = 0;
+          Index stride = 1;
+          for (int dir = 0 ; dir < dim ; ++dir)
+          {
+            const Index fn = i_dir % n_basis_elem[dir];
+            i_dir /= n_basis_elem[dir];
+            pos += (first_basis_1D_[comp][dir][intervals[dir]] + fn) * stride;
+            stride *= n_basis[dir];
+          }
+          loc_pos[i] = dof_pos[pos];
+          x_loc[i] = x[loc_pos[i]];
+        }
+
+        // from the basis functions to the quadrature points
+        TensorSize<dim> sizes = n_basis_elem;
+        const Real *in = x_loc.data();
+        for (int dir = 0 ; dir < dim ; ++dir)
+        {
+          Real *out = (dir % 2 == 0) ? buf_0.data() : buf_1.data();
+          sum_factorization_kernels::contract_direction(
+            dir, true, this->get_table(comp,dir,intervals[dir]),
+            n_basis_elem[dir], n_pts_1D_[dir], sizes, in, out, coeffs.data());
+          in = out;
+        }
+
+        Real *u_pts = const_cast<Real *>(in);
+        const Real *w = &weights_[e * n_pts_elem_];
+        for (Index pt = 0 ; pt < n_pts_elem_ ; ++pt)
+          u_pts[pt] *= w[pt];
+
+        // from the quadrature points to the basis functions
+        for (int dir = 0 ; dir < dim ; ++dir)
+        {
+          Real *out = (in == buf_0.data()) ? buf_1.data() : buf_0.data();
+          sum_factorization_kernels::contract_direction(
+            dir, false, this->get_table(comp,dir,intervals[dir]),
+            n_basis_elem[dir], n_pts_1D_[dir], sizes, in, out, coeffs.data());
+          in = out;
+        }
+
+        for (Index i = 0 ; i < n_loc ; ++i)
+          y[loc_pos[i]] += in[i];
+      } // end loop e
+    } // end loop comp
+  }
+
+  /**
+   * Computes \f$ y = M_c x \f$.
+   */
+  void vmult(const SafeSTLVector<Real> &x, SafeSTLVector<Real> &y) const
+  {
+    Assert(x.size() == dofs_.size(), ExcDimensionMismatch(x.size(),dofs_.size()));
+    y.resize(dofs_.size());
+    this->vmult(x.data(),y.data());
+  }
+
+  /**
+   * Solves in place the system \f$ M_c x = b \f$ (with the coefficient defined by
+   * set_weights()) with the conjugate gradient method, preconditioned
+   * by the parametric mass matrix \f$ M \f$.
+   *
+   * The iterations stop when the norm of the residual is reduced by the factor
+   * @p tolerance.
+   *
+   * @param[in,out] x On input the right hand side \f$ b \f$, on output the solution.
+   * @return The number of iterations, or -1 if the method has not converged within
+   * @p max_num_iters iterations.
+   */
+  int solve_weighted(SafeSTLVector<Real> &x,
+                     const Real tolerance = 1.0e-12,
+                     const int max_num_iters = 400) const
+  {
+    const Size n = dofs_.size();
+    Assert(x.size() == n, ExcDimensionMismatch(x.size(),n));
+
+    auto dot = [n](const SafeSTLVector<Real> &u, const SafeSTLVector<Real> &v)
+    {
+      Real s = 0.0;
+      for (Index i = 0 ; i < n ; ++i)
+        s += u[i] * v[i];
+      return s;
+    };
+
+    // the initial guess is the solution with the parametric mass matrix
+    SafeSTLVector<Real> r = x;
+    this->solve(x);
+
+    SafeSTLVector<Real> q(n);
+    this->vmult(x,q);
+    for (Index i = 0 ; i < n ; ++i)
+      r[i] -= q[i];
+
+    const Real r_norm_0 = std::sqrt(dot(r,r));
+    if (r_norm_0 == 0.0)
+      return 0;
+
+    SafeSTLVector<Real> z = r;
+    this->solve(z);
+    SafeSTLVector<Real> d = z;
+    Real rz = dot(r,z);
+
+    for (int iter = 1 ; iter <= max_num_iters ; ++iter)
+    {
+      this->vmult(d,q);
+      const Real alpha = rz / dot(d,q);
+      for (Index i = 0 ; i < n ; ++i)
+      {
+        x[i] += alpha * d[i];
+        r[i] -= alpha * q[i];
+      }
+
+      if (std::sqrt(dot(r,r)) <= tolerance * r_norm_0)
+        return iter;
+
+      z = r;
+      this->solve(z);
+      const Real rz_new = dot(r,z);
+      const Real beta = rz_new / rz;
+      rz = rz_new;
+      for (Index i = 0 ; i < n ; ++i)
+        d[i] = z[i] + beta * d[i];
+    }
+
+    return -1;
+  }
+
+private:
+  /**
+   * Returns the table of the values of the univariate splines of the component
+   * @p comp, along the direction @p dir, on the interval @p interval.
+   */
+  const Real *get_table(const int comp, const int dir, const Index interval) const
+  {
+    return &values_1D_[comp][dir][interval * (degree_[comp][dir]+1) * n_pts_1D_[dir]];
+  }
+
+  /** Global ids of the dofs (sorted). */
+  SafeSTLVector<Index> dofs_;
+
+  /** Number of basis functions of each component, along each direction. */
+  SafeSTLArray<TensorSize<dim>,n_components> n_basis_;
+
+  /**
+   * For each component, positions of its dofs (in the sorted set of dofs) with the
+   * first direction running faster.
+   */
+  SafeSTLArray<SafeSTLVector<Index>,n_components> dof_pos_;
+
+  /** Degree of each component, along each direction. */
+  SafeSTLArray<SafeSTLArray<int,dim>,n_components> degree_;
+
+  /** Basis whose univariate splines define the mass matrix. */
+  std::shared_ptr<const Bs> basis_;
+
+  /** Cholesky factors of the univariate mass matrices. */
+  SafeSTLArray<SafeSTLArray<BandedMatrix,dim>,n_components> mass_1D_;
+
+  /** Number of univariate quadrature points along each direction. */
+  TensorSize<dim> n_pts_1D_;
+
+  /** Number of quadrature points on each element. */
+  Size n_pts_elem_ = 0;
+
+  /**
+   * Index of the first univariate spline that is not zero on each interval,
+   * for each component and direction.
+   */
+  SafeSTLArray<SafeSTLArray<SafeSTLVector<Index>,dim>,n_components> first_basis_1D_;
+
+  /**
+   * Univariate splines values, for each component and direction:
+   * one <tt>n_basis x n_pts</tt> table for each interval.
+   */
+  SafeSTLArray<SafeSTLArray<SafeSTLVector<Real>,dim>,n_components> values_1D_;
+
+  /** Tensor index of each element. */
+  SafeSTLVector<TensorIndex<dim>> elem_intervals_;
+
+  /** Integration weights (<tt>n_pts_elem_</tt> for each element). */
+  SafeSTLVector<Real> weights_;
+};
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __KRONECKER_MASS_H_
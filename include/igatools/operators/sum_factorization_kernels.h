@@ -0,0 +1,214 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __SUM_FACTORIZATION_KERNELS_H_
+#define __SUM_FACTORIZATION_KERNELS_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/exceptions.h>
+
+#include <igatools/utils/aligned_vector.h>
+#include <igatools/utils/tensor_size.h>
+
+#include <string>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Low level (vectorized) kernels used by the integration of local operators
+ * with the sum-factorization technique.
+ *
+ * Each kernel has a portable (scalar) version and, on x86-64 processors,
+ * versions using the AVX2 (with FMA) and AVX-512 instruction sets.
+ * The vectorized versions are available only if @ref Real is <tt>double</tt>
+ * (i.e. if the library is not configured with REAL_IS_LONG_DOUBLE).
+ * The instruction set is chosen at runtime: by default the most advanced one
+ * supported by the processor is used, but a less advanced one can be selected
+ * with set_instruction_set() (e.g. for benchmarking purposes).
+ *
+ * The kernels are designed to work on <em>panels</em>, i.e. row-major matrices
+ * with rows padded to a multiple of get_simd_width() entries and stored in
+ * memory aligned to get_alignment() bytes (see AlignedVector).
+ */
+namespace sum_factorization_kernels
+{
+
+/**
+ * Instruction sets for which the kernels are implemented.
+ */
+enum class InstructionSet
+{
+  /** Portable version (no explicit vectorization). */
+  scalar = 0,
+
+  /** AVX2 and FMA (4 doubles per register). */
+  avx2 = 1,
+
+  /** AVX-512F (8 doubles per register). */
+  avx512 = 2
+};
+
+/**
+ * Returns the name of the instruction set @p instruction_set.
+ */
+std::string
+get_name(const InstructionSet &instruction_set);
+
+/**
+ * Returns the most advanced instruction set supported by the processor
+ * (and by the compiler used to build the library).
+ */
+InstructionSet
+get_best_instruction_set();
+
+/**
+ * Returns the instruction set currently used by the kernels.
+ */
+InstructionSet
+get_instruction_set();
+
+/**
+ * Sets the instruction set used by the kernels.
+ *
+ * @warning This function must not be called while the kernels are used by other threads.
+ */
+void
+set_instruction_set(const InstructionSet &instruction_set);
+
+/**
+ * Returns the alignment (in bytes) of the panels.
+ */
+constexpr std::size_t
+get_alignment()
+{
+  return aligned_vector_alignment;
+}
+
+/**
+ * Returns the number of entries to which the rows of the panels are padded
+ * (i.e. the number of doubles in the widest supported register).
+ */
+constexpr Size
+get_simd_width()
+{
+  return 8;
+}
+
+/**
+ * Returns @p n rounded up to a multiple of get_simd_width().
+ */
+inline
+Size
+get_padded_size(const Size n)
+{
+  return ((n + get_simd_width() - 1) / get_simd_width()) * get_simd_width();
+}
+
+/**
+ * Computes
+ * \f[ y_i = \sum_{k=0}^{n_k-1} a_k X_{k,i} \quad \text{for } i=0,\dots,n-1 \f]
+ * where the <tt>k</tt>-th row of \f$ X \f$ starts at <tt>X + k * ldx</tt>.
+ * The result overwrites the content of @p y.
+ *
+ * This is the building block of the sum-factorization contractions: the
+ * coefficients \f$ a_k \f$ run along the contracted (short) index, while
+ * the (long and contiguous) index <tt>i</tt> is vectorized.
+ */
+void
+contract(const int n_k,
+         const Size n,
+         const Real *a,
+         const Real *X,
+         const Size ldx,
+         Real *y);
+
+
+/**
+ * Contraction along the direction @p dir of the tensor @p in
+ * (having sizes @p sizes, with the first index running faster)
+ * with the univariate table @p table (of size <tt>n_basis x n_pts</tt>),
+ * computed with contract().
+ *
+ * If @p to_points is true, the index <tt>dir</tt> of @p in runs over the basis
+ * functions and the one of @p out over the points, and viceversa if @p to_points is false.
+ * On exit, <tt>sizes[dir]</tt> is the size of @p out along <tt>dir</tt>.
+ *
+ * @p coeffs is a scratch buffer of (at least) @p n_basis entries.
+ */
+template <int dim>
+void
+contract_direction(const int dir,
+                   const bool to_points,
+                   const Real *table,
+                   const int n_basis,
+                   const int n_pts,
+                   TensorSize<dim> &sizes,
+                   const Real *in,
+                   Real *out,
+                   Real *coeffs)
+{
+  Size stride = 1;
+  for (int i = 0 ; i < dir ; ++i)
+    stride *= sizes[i];
+  Size n_outer = 1;
+  for (int i = dir+1 ; i < dim ; ++i)
+    n_outer *= sizes[i];
+
+  const int n_in  = to_points ? n_basis : n_pts;
+  const int n_out = to_points ? n_pts : n_basis;
+
+  if (to_points && stride == 1)
+  {
+    // the rows of the table (one for each basis function) are contiguous
+    // along the points
+    for (Size o = 0 ; o < n_outer ; ++o)
+      contract(n_in, n_out, in + o * n_in, table, n_pts, out + o * n_out);
+  }
+  else
+  {
+    for (int j = 0 ; j < n_out ; ++j)
+    {
+      const Real *a = table + j * n_pts;
+      if (to_points)
+      {
+        for (int i = 0 ; i < n_in ; ++i)
+          coeffs[i] = table[i * n_pts + j];
+        a = coeffs;
+      }
+
+      for (Size o = 0 ; o < n_outer ; ++o)
+        contract(n_in, stride, a, in + o * n_in * stride, stride,
+                 out + (o * n_out + j) * stride);
+    }
+  }
+  sizes[dir] = n_out;
+}
+
+
+/**
+ * Vector whose entries are stored in memory aligned to get_alignment() bytes.
+ */
+using AlignedVector = iga::AlignedVector;
+
+} // end namespace sum_factorization_kernels
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __SUM_FACTORIZATION_KERNELS_H_
@@ -0,0 +1,461 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __SUM_FACTORIZATION_OPERATOR_H_
+#define __SUM_FACTORIZATION_OPERATOR_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/quadrature.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/bspline_handler.h>
+#include <igatools/operators/sum_factorization_kernels.h>
+#include <igatools/utils/thread_tools.h>
+
+#include <functional>
+#include <vector>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Matrix-free application of the operator
+ * \f[
+ * a(u,v) = \int_{\Omega} c_0(x) u v \; dx + \int_{\Omega} c_1(x) \nabla u \cdot \nabla v \; dx
+ * \f]
+ * discretized with a scalar BSpline basis, using sum factorization.
+ *
+ * The global matrix is never built: the product \f$ y = A x \f$ is computed
+ * element-by-element. On each element the local coefficients are interpolated at the
+ * quadrature points (and scattered back to the basis functions) by a sequence of
+ * <tt>dim</tt> contractions with the univariate basis values (or derivatives),
+ * i.e. with a cost of \f$ O(p^{dim+1}) \f$ per element instead of the
+ * \f$ O(p^{2 dim}) \f$ of the local matrix-vector product.
+ *
+ * Everything that does not depend on the vector \f$ x \f$ is precomputed in the constructor:
+ * - the univariate values and first derivatives of the splines, for each
+ * interval along each coordinate direction (taken from the BSplineElement cache);
+ * - the coefficients \f$ c_0 \f$ and \f$ c_1 \f$ multiplied by the quadrature weights
+ * and by the element measure, at each quadrature point of each element;
+ * - the element-to-dofs connectivity.
+ *
+ * The vectors used by apply() are indexed by the <em>position</em> of the dofs in the
+ * (sorted) set of active dofs of the basis (see get_dofs()), which is the same ordering
+ * of the local ids of the Epetra map created by EpetraTools::create_map().
+ *
+ * The elements are processed by <tt>n_threads</tt> threads, each one writing the
+ * local results of its own elements in a separate buffer; the local results are then
+ * summed into the global vector following the order of the elements in the Grid,
+ * so the result does not depend on the number of threads.
+ *
+ * @note The quadrature scheme must have the tensor-product structure.
+ *
+ * @ingroup linear_algebra
+ */
+template <int dim>
+class SumFactorizationOperator
+{
+public:
+  using Bs = BSpline<dim,1,1>;
+  using Point = Points<dim>;
+
+  /**
+   * Type for the coefficients of the operator, evaluated at the points of the
+   * parametric domain.
+   */
+  using CoeffFunction = std::function<Real(const Point &)>;
+
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. Not allowed to be used.
+   */
+  SumFactorizationOperator() = delete;
+
+  /**
+   * Constructor.
+   *
+   * @param[in] basis Basis used for the discretization.
+   * @param[in] quad Tensor-product quadrature scheme used on each element.
+   * @param[in] mass_coeff Coefficient \f$ c_0 \f$ of the mass term. If it is empty,
+   * the mass term is not considered.
+   * @param[in] stiffness_coeff Coefficient \f$ c_1 \f$ of the stiffness term. If it is empty,
+   * the stiffness term is not considered.
+   * @param[in] n_threads Number of threads used by apply().
+   */
+  SumFactorizationOperator(const std::shared_ptr<const Bs> &basis,
+                           const std::shared_ptr<const Quadrature<dim>> &quad,
+                           const CoeffFunction &mass_coeff,
+                           const CoeffFunction &stiffness_coeff,
+                           const int n_threads = thread_tools::get_default_num_threads())
+    :
+    n_threads_(n_threads),
+    with_mass_(static_cast<bool>(mass_coeff)),
+    with_stiffness_(static_cast<bool>(stiffness_coeff))
+  {
+    Assert(basis != nullptr, ExcNullPtr());
+    Assert(quad != nullptr, ExcNullPtr());
+    Assert(quad->is_tensor_product(),
+           ExcMessage("The quadrature scheme has not the tensor-product structure."));
+    Assert(n_threads_ > 0, ExcLowerRange(n_threads_,1));
+
+    const auto &space = *basis->get_spline_space();
+    const auto &grid = *basis->get_grid();
+
+    //--------------------------------------------------------------------------
+    // dofs numbering
+    const auto &global_dofs =
+      space.get_dof_distribution()->get_global_dofs(DofProperties::active);
+    dofs_.assign(global_dofs.begin(),global_dofs.end());
+
+    const Index max_dof = dofs_.empty() ? -1 : dofs_.back();
+    std::vector<Index> dof_position(max_dof+1,-1);
+    for (Index pos = 0 ; pos < Index(dofs_.size()) ; ++pos)
+      dof_position[dofs_[pos]] = pos;
+    //--------------------------------------------------------------------------
+
+
+    //--------------------------------------------------------------------------
+    const auto &degree = space.get_degree_table()[0];
+    const auto n_intervals = grid.get_num_intervals();
+    for (int dir = 0 ; dir < dim ; ++dir)
+    {
+      n_basis_1D_[dir] = degree[dir] + 1;
+      n_pts_1D_[dir] = quad->get_coords_direction(dir).size();
+
+      const Size table_size = n_basis_1D_[dir] * n_pts_1D_[dir];
+      values_1D_[dir].assign(n_intervals[dir] * table_size, 0.0);
+      derivatives_1D_[dir].assign(n_intervals[dir] * table_size, 0.0);
+    }
+    n_basis_elem_ = n_basis_1D_.flat_size();
+    n_pts_elem_ = n_pts_1D_.flat_size();
+
+    const auto &weights_1D = quad->get_weights_1d();
+    //--------------------------------------------------------------------------
+
+
+    //--------------------------------------------------------------------------
+    // loop over the elements for the precomputation of the element data
+    auto handler = basis->create_cache_handler();
+    handler->set_element_flags(basis_element::Flags::value |
+                               basis_element::Flags::gradient);
+
+    auto elem = basis->begin();
+    const auto end = basis->end();
+    handler->init_element_cache(elem,quad);
+
+    n_elems_ = grid.get_num_elements(ElementProperties::active);
+    elem_intervals_.resize(n_elems_);
+    local_dofs_.reserve(n_elems_ * n_basis_elem_);
+    if (with_mass_)
+      mass_weights_.reserve(n_elems_ * n_pts_elem_);
+    if (with_stiffness_)
+      stiffness_weights_.reserve(n_elems_ * n_pts_elem_);
+
+    Index elem_pos = 0;
+    for (; elem != end ; ++elem, ++elem_pos)
+    {
+      handler->fill_element_cache(elem);
+
+      const auto &grid_elem = elem->get_grid_element();
+      const auto &elem_tensor_id = grid_elem.get_index().get_tensor_index();
+      elem_intervals_[elem_pos] = elem_tensor_id;
+
+      // univariate splines values (the same for all the elements sharing an interval)
+      const auto &bsp_elem = dynamic_cast<const BSplineElement<dim,1,1> &>(*elem);
+      const auto &splines_1D = bsp_elem.get_splines1D_table(dim,0)[0];
+      for (int dir = 0 ; dir < dim ; ++dir)
+      {
+        const auto &phi = splines_1D[dir].get_derivative(0);
+        const auto &D_phi = splines_1D[dir].get_derivative(1);
+        const Size table_size = n_basis_1D_[dir] * n_pts_1D_[dir];
+        Real *const phi_interval = &values_1D_[dir][elem_tensor_id[dir] * table_size];
+        Real *const D_phi_interval = &derivatives_1D_[dir][elem_tensor_id[dir] * table_size];
+        for (int fn = 0 ; fn < n_basis_1D_[dir] ; ++fn)
+          for (int pt = 0 ; pt < n_pts_1D_[dir] ; ++pt)
+          {
+            phi_interval[fn * n_pts_1D_[dir] + pt] = phi(fn,pt);
+            D_phi_interval[fn * n_pts_1D_[dir] + pt] = D_phi(fn,pt);
+          }
+      }
+
+      // element dofs
+      const auto elem_dofs = elem->get_local_to_global_view(DofProperties::active);
+      Assert(elem_dofs.get_num_entries() == n_basis_elem_,
+             ExcDimensionMismatch(elem_dofs.get_num_entries(),n_basis_elem_));
+      for (const auto dof : elem_dofs)
+        local_dofs_.push_back(dof_position[dof]);
+
+      // coefficients times the quadrature weights and the element measure
+      const auto lengths = grid_elem.template get_side_lengths<dim>(0);
+      const auto vertex = grid_elem.vertex(0);
+      Real measure = 1.0;
+      for (int dir = 0 ; dir < dim ; ++dir)
+        measure *= lengths[dir];
+
+      for (Index pt = 0 ; pt < n_pts_elem_ ; ++pt)
+      {
+        Point x;
+        Real w = measure;
+        Index pt_dir = pt;
+        for (int dir = 0 ; dir < dim ; ++dir)
+        {
+          const Index pt_id = pt_dir % n_pts_1D_[dir];
+          pt_dir /= n_pts_1D_[dir];
+
+          x[dir] = vertex[dir] + lengths[dir] * quad->get_coords_direction(dir)[pt_id];
+          w *= weights_1D.get_data_direction(dir)[pt_id];
+        }
+
+        if (with_mass_)
+          mass_weights_.push_back(w * mass_coeff(x));
+        if (with_stiffness_)
+          stiffness_weights_.push_back(w * stiffness_coeff(x));
+      }
+    } // end loop elem
+    //--------------------------------------------------------------------------
+
+    local_results_.resize(n_elems_ * n_basis_elem_);
+  }
+
+  /**
+   * Copy constructor. Not allowed to be used.
+   */
+  SumFactorizationOperator(const SumFactorizationOperator &op) = delete;
+
+  /**
+   * Move constructor. Not allowed to be used.
+   */
+  SumFactorizationOperator(SumFactorizationOperator &&op) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~SumFactorizationOperator() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /**
+   * Copy assignment operator. Not allowed to be used.
+   */
+  SumFactorizationOperator &operator=(const SumFactorizationOperator &op) = delete;
+
+  /**
+   * Move assignment operator. Not allowed to be used.
+   */
+  SumFactorizationOperator &operator=(SumFactorizationOperator &&op) = delete;
+  ///@}
+
+  /**
+   * Returns the (sorted) global ids of the dofs. The entries of the vectors used by
+   * apply() refer to the dofs in this order.
+   */
+  const SafeSTLVector<Index> &get_dofs() const
+  {
+    return dofs_;
+  }
+
+  /**
+   * Returns the number of dofs, i.e. the size of the vectors used by apply().
+   */
+  Size get_num_dofs() const
+  {
+    return dofs_.size();
+  }
+
+  /**
+   * Computes \f$ y = A x \f$.
+   *
+   * @p x and @p y must point to (non-overlapping) arrays of get_num_dofs() entries.
+   *
+   * @warning The function uses an internal buffer, therefore it must not be called
+   * concurrently on the same object.
+   */
+  void apply(const Real *x, Real *y) const
+  {
+    const auto chunks = thread_tools::split_range(n_elems_,n_threads_);
+    const int n_chunks = chunks.size() - 1;
+
+    thread_tools::run_in_parallel(n_chunks,[&](const int t)
+    {
+      Size n_max = 1;
+      Size n_basis_max = 1;
+      for (int dir = 0 ; dir < dim ; ++dir)
+      {
+        n_max *= std::max(n_basis_1D_[dir],n_pts_1D_[dir]);
+        n_basis_max = std::max(n_basis_max,n_basis_1D_[dir]);
+      }
+      std::vector<Real> buf_0(n_max);
+      std::vector<Real> buf_1(n_max);
+      std::vector<Real> coeffs(n_basis_max);
+      std::vector<Real> x_loc(n_basis_elem_);
+      std::vector<Real> u_pts(n_pts_elem_);
+
+      for (Index e = chunks[t] ; e < chunks[t+1] ; ++e)
+      {
+        const Index *const elem_dofs = &local_dofs_[e * n_basis_elem_];
+        for (Index i = 0 ; i < n_basis_elem_ ; ++i)
+          x_loc[i] = x[elem_dofs[i]];
+
+        Real *const y_loc = &local_results_[e * n_basis_elem_];
+        std::fill(y_loc, y_loc + n_basis_elem_, 0.0);
+
+        if (with_mass_)
+          this->apply_term(e, -1, &mass_weights_[e * n_pts_elem_],
+                           x_loc.data(), u_pts.data(), buf_0, buf_1, coeffs, y_loc);
+
+        if (with_stiffness_)
+          for (int k = 0 ; k < dim ; ++k)
+            this->apply_term(e, k, &stiffness_weights_[e * n_pts_elem_],
+                             x_loc.data(), u_pts.data(), buf_0, buf_1, coeffs, y_loc);
+      } // end loop e
+    });
+
+    // scatter, following the order of the elements in the Grid
+    std::fill(y, y + dofs_.size(), 0.0);
+    for (Index e = 0 ; e < n_elems_ ; ++e)
+    {
+      const Index *const elem_dofs = &local_dofs_[e * n_basis_elem_];
+      const Real *const y_loc = &local_results_[e * n_basis_elem_];
+      for (Index i = 0 ; i < n_basis_elem_ ; ++i)
+        y[elem_dofs[i]] += y_loc[i];
+    }
+  }
+
+  /**
+   * Computes \f$ y = A x \f$.
+   */
+  void apply(const SafeSTLVector<Real> &x, SafeSTLVector<Real> &y) const
+  {
+    Assert(x.size() == dofs_.size(), ExcDimensionMismatch(x.size(),dofs_.size()));
+    y.resize(dofs_.size());
+    this->apply(x.data(),y.data());
+  }
+
+  /**
+   * Returns the number of threads used by apply().
+   */
+  int get_num_threads() const
+  {
+    return n_threads_;
+  }
+
+private:
+  /**
+   * Adds to @p y_loc the contribution of the element @p e for the term with the
+   * first derivative along the direction @p deriv_dir
+   * (or for the mass term if <tt>deriv_dir == -1</tt>).
+   */
+  void apply_term(const Index e,
+                  const int deriv_dir,
+                  const Real *weights,
+                  const Real *x_loc,
+                  Real *u_pts,
+                  std::vector<Real> &buf_0,
+                  std::vector<Real> &buf_1,
+                  std::vector<Real> &coeffs,
+                  Real *y_loc) const
+  {
+    const auto &intervals = elem_intervals_[e];
+
+    // from the basis functions to the quadrature points
+    TensorSize<dim> sizes = n_basis_1D_;
+    const Real *in = x_loc;
+    for (int dir = 0 ; dir < dim ; ++dir)
+    {
+      const auto &tables = (dir == deriv_dir) ? derivatives_1D_[dir] : values_1D_[dir];
+      const Real *table = &tables[intervals[dir] * n_basis_1D_[dir] * n_pts_1D_[dir]];
+      Real *out = (dir == dim-1) ? u_pts : ((dir % 2 == 0) ? buf_0.data() : buf_1.data());
+      sum_factorization_kernels::contract_direction(
+        dir, true, table, n_basis_1D_[dir], n_pts_1D_[dir], sizes, in, out, coeffs.data());
+      in = out;
+    }
+
+    for (Index pt = 0 ; pt < n_pts_elem_ ; ++pt)
+      u_pts[pt] *= weights[pt];
+
+    // from the quadrature points to the basis functions
+    in = u_pts;
+    for (int dir = 0 ; dir < dim ; ++dir)
+    {
+      const auto &tables = (dir == deriv_dir) ? derivatives_1D_[dir] : values_1D_[dir];
+      const Real *table = &tables[intervals[dir] * n_basis_1D_[dir] * n_pts_1D_[dir]];
+      Real *out = (dir % 2 == 0) ? buf_0.data() : buf_1.data();
+      sum_factorization_kernels::contract_direction(
+        dir, false, table, n_basis_1D_[dir], n_pts_1D_[dir], sizes, in, out, coeffs.data());
+      in = out;
+    }
+
+    for (Index i = 0 ; i < n_basis_elem_ ; ++i)
+      y_loc[i] += in[i];
+  }
+
+  int n_threads_;
+
+  bool with_mass_;
+
+  bool with_stiffness_;
+
+  /** Global ids of the dofs (sorted). */
+  SafeSTLVector<Index> dofs_;
+
+  Size n_elems_;
+
+  /** Number of univariate basis functions (on each element) along each direction. */
+  TensorSize<dim> n_basis_1D_;
+
+  /** Number of univariate quadrature points along each direction. */
+  TensorSize<dim> n_pts_1D_;
+
+  Size n_basis_elem_;
+
+  Size n_pts_elem_;
+
+  /** Tensor index of each element. */
+  std::vector<TensorIndex<dim>> elem_intervals_;
+
+  /**
+   * Univariate splines values along each direction:
+   * one <tt>n_basis x n_pts</tt> table for each interval.
+   */
+  SafeSTLArray<std::vector<Real>,dim> values_1D_;
+
+  /**
+   * Univariate splines first derivatives along each direction:
+   * one <tt>n_basis x n_pts</tt> table for each interval.
+   */
+  SafeSTLArray<std::vector<Real>,dim> derivatives_1D_;
+
+  /** Positions of the dofs of each element (<tt>n_basis_elem_</tt> for each element). */
+  std::vector<Index> local_dofs_;
+
+  /** Mass coefficient times the quadrature weights (<tt>n_pts_elem_</tt> for each element). */
+  std::vector<Real> mass_weights_;
+
+  /** Stiffness coefficient times the quadrature weights (<tt>n_pts_elem_</tt> for each element). */
+  std::vector<Real> stiffness_weights_;
+
+  /** Buffer for the local results of apply(). */
+  mutable std::vector<Real> local_results_;
+};
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __SUM_FACTORIZATION_OPERATOR_H_
@@ -0,0 +1,181 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+
+#ifndef __UNIVARIATE_MATRICES_H_
+#define __UNIVARIATE_MATRICES_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/linear_algebra/banded_matrix.h>
+#include <igatools/utils/safe_stl_vector.h>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Functions for the evaluation of the univariate B-splines of a BSpline
+ * basis and for the computation of the univariate mass and stiffness matrices.
+ *
+ * The B-splines of degree \f$ p \f$ are defined by a knot vector (with repetitions)
+ * \f$ \tau_0 \leq \dots \leq \tau_{n+p} \f$ and the parametric domain is
+ * \f$ [\tau_p,\tau_n] \f$. The non-empty knot spans
+ * \f$ [\tau_\mu,\tau_{\mu+1}) \f$ inside the domain are the intervals of
+ * the Grid along the corresponding coordinate direction, and the only B-splines that
+ * are not zero on the span \f$ \mu \f$ are the ones with index
+ * \f$ \mu-p,\dots,\mu \f$.
+ *
+ * These functions are used for the operators having the Kronecker-product
+ * structure of the (non periodic) BSpline bases on a Cartesian grid,
+ * e.g. the parametric mass matrix
+ * \f$ M = M_{d-1} \otimes \dots \otimes M_0 \f$.
+ *
+ * @ingroup linear_algebra
+ */
+namespace univariate_matrices
+{
+
+/**
+ * Returns the indices \f$ \mu \f$ of the non-empty knot spans inside the
+ * parametric domain, in ascending order.
+ */
+SafeSTLVector<Index>
+get_knot_spans(const SafeSTLVector<Real> &knots, const int degree);
+
+/**
+ * Evaluates the B-splines of the component @p comp of @p basis along the direction
+ * @p dir (and their first derivatives) on each interval of the Grid, at the points
+ * @p points given in the unit interval \f$ [0,1] \f$ (and mapped on each interval).
+ * The values are computed by BSpline::evaluate_splines_1D().
+ *
+ * On exit, for the interval <tt>k</tt>, <tt>first_basis[k]</tt> is the index of the first
+ * B-spline that is not zero on the interval and the value of its <tt>fn</tt>-th
+ * B-spline at the <tt>pt</tt>-th point is at position
+ * <tt>(k*(degree+1) + fn)*points.size() + pt</tt> of @p values (and the same
+ * for its derivative in @p derivatives, if not <tt>nullptr</tt>).
+ *
+ * @note The basis must not be periodic along the direction @p dir.
+ */
+template <int dim, int range, int rank>
+void
+evaluate_bsplines_on_intervals(const BSpline<dim,range,rank> &basis,
+                               const int comp,
+                               const int dir,
+                               const SafeSTLVector<Real> &points,
+                               SafeSTLVector<Index> &first_basis,
+                               SafeSTLVector<Real> &values,
+                               SafeSTLVector<Real> *derivatives = nullptr)
+{
+  const auto &knots = basis.get_knots_with_repetitions_table()[comp][dir];
+  const int degree = basis.get_spline_space()->get_degree_table()[comp][dir];
+
+  const auto spans = get_knot_spans(knots,degree);
+  const Size n_intervals = spans.size();
+  Assert(n_intervals == basis.get_grid()->get_num_intervals()[dir],
+         ExcDimensionMismatch(n_intervals,basis.get_grid()->get_num_intervals()[dir]));
+
+  const Size n_pts = points.size();
+  const int n_funcs = degree + 1;
+
+  first_basis.resize(n_intervals);
+  values.resize(n_intervals * n_funcs * n_pts);
+  if (derivatives != nullptr)
+    derivatives->resize(n_intervals * n_funcs * n_pts);
+
+  BasisValues1d splines_1D;
+  for (Index k = 0 ; k < n_intervals ; ++k)
+  {
+    first_basis[k] = spans[k] - degree;
+
+    basis.evaluate_splines_1D(comp,dir,k,points,splines_1D);
+    const auto &phi = splines_1D.get_derivative(0);
+    const auto &D_phi = splines_1D.get_derivative(1);
+    for (int fn = 0 ; fn < n_funcs ; ++fn)
+      for (Index pt = 0 ; pt < n_pts ; ++pt)
+      {
+        const Index pos = (k * n_funcs + fn) * n_pts + pt;
+        values[pos] = phi(fn,pt);
+        if (derivatives != nullptr)
+          (*derivatives)[pos] = D_phi(fn,pt);
+      }
+  }
+}
+
+/**
+ * Computes, from the values (and the derivatives, if @p derivatives is not
+ * <tt>nullptr</tt>) of the B-splines defined on the knot vector @p knots, as
+ * returned by evaluate_bsplines_on_intervals() at the points of a quadrature scheme
+ * on \f$ [0,1] \f$ with weights @p weights, the mass matrix
+ * \f$ (M)_{ij} = \int B_i B_j \f$ and the stiffness matrix
+ * \f$ (K)_{ij} = \int B'_i B'_j \f$ of the B-splines.
+ *
+ * Both matrices have bandwidth @p degree. If @p stiffness is <tt>nullptr</tt> only
+ * the mass matrix is computed.
+ */
+void
+integrate_mass_stiffness(const SafeSTLVector<Real> &knots,
+                         const int degree,
+                         const SafeSTLVector<Real> &weights,
+                         const SafeSTLVector<Index> &first_basis,
+                         const SafeSTLVector<Real> &values,
+                         const SafeSTLVector<Real> *derivatives,
+                         BandedMatrix &mass,
+                         BandedMatrix *stiffness);
+
+/**
+ * Computes the mass matrix \f$ (M)_{ij} = \int B_i B_j \f$ and the stiffness matrix
+ * \f$ (K)_{ij} = \int B'_i B'_j \f$ of the B-splines of the component @p comp
+ * of @p basis along the direction @p dir, integrated exactly with
+ * a Gauss-Legendre scheme with <tt>degree+1</tt> points on each interval.
+ *
+ * Both matrices have bandwidth equal to the degree. If @p stiffness is <tt>nullptr</tt> only
+ * the mass matrix is computed.
+ */
+template <int dim, int range, int rank>
+void
+compute_mass_stiffness(const BSpline<dim,range,rank> &basis,
+                       const int comp,
+                       const int dir,
+                       BandedMatrix &mass,
+                       BandedMatrix *stiffness = nullptr)
+{
+  const int degree = basis.get_spline_space()->get_degree_table()[comp][dir];
+
+  const QGauss<1> quad(degree+1);
+
+  SafeSTLVector<Index> first_basis;
+  SafeSTLVector<Real> values;
+  SafeSTLVector<Real> derivatives;
+  evaluate_bsplines_on_intervals(basis, comp, dir, quad.get_coords_direction(0),
+                                 first_basis, values,
+                                 stiffness != nullptr ? &derivatives : nullptr);
+
+  integrate_mass_stiffness(basis.get_knots_with_repetitions_table()[comp][dir],
+                           degree, quad.get_weights_1d().get_data_direction(0),
+                           first_basis, values,
+                           stiffness != nullptr ? &derivatives : nullptr,
+                           mass, stiffness);
+}
+
+}
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __UNIVARIATE_MATRICES_H_
@@ -0,0 +1,87 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __ALIGNED_VECTOR_H_
+#define __ALIGNED_VECTOR_H_
+
+#include <igatools/base/config.h>
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * Alignment (in bytes) of the memory returned by AlignedAllocator.
+ * It is the size of the widest SIMD register (AVX-512).
+ */
+constexpr std::size_t aligned_vector_alignment = 64;
+
+/**
+ * @brief Minimal allocator returning memory aligned to aligned_vector_alignment bytes.
+ */
+template <class T>
+class AlignedAllocator
+{
+public:
+  using value_type = T;
+
+  AlignedAllocator() = default;
+
+  template <class U>
+  AlignedAllocator(const AlignedAllocator<U> &) noexcept
+  {}
+
+  T *allocate(const std::size_t n)
+  {
+    void *p = nullptr;
+    if (posix_memalign(&p, aligned_vector_alignment, n * sizeof(T)) != 0)
+      throw std::bad_alloc();
+    return static_cast<T *>(p);
+  }
+
+  void deallocate(T *p, const std::size_t) noexcept
+  {
+    std::free(p);
+  }
+
+  template <class U>
+  bool operator==(const AlignedAllocator<U> &) const noexcept
+  {
+    return true;
+  }
+
+  template <class U>
+  bool operator!=(const AlignedAllocator<U> &) const noexcept
+  {
+    return false;
+  }
+};
+
+/**
+ * Vector of Real whose entries are stored in memory aligned to
+ * aligned_vector_alignment bytes.
+ */
+using AlignedVector = std::vector<Real,AlignedAllocator<Real>>;
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __ALIGNED_VECTOR_H_
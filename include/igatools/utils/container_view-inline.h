@@ -36,8 +36,7 @@ ViewData(const IteratorType begin, const IteratorType end)
   begin_(begin),
   end_(end)
 {
-  Assert(begin_ < end_, ExcInvalidIterator());
-//    Assert(begin_ < end_ || begin_ == end_, ExcInvalidIterator());
+  Assert(begin_ < end_ || begin_ == end_, ExcInvalidIterator());
 }
 
 template <class IteratorType>
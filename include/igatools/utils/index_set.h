@@ -0,0 +1,444 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __INDEX_SET_H_
+#define __INDEX_SET_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/exceptions.h>
+#include <igatools/base/logstream.h>
+
+#include <vector>
+#include <set>
+#include <cstdint>
+#include <iterator>
+#include <initializer_list>
+#include <type_traits>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Set of non-negative integer ids, stored as a dense bitset.
+ *
+ * It is used (instead of a std::set) when the ids are (almost) contiguous, as the
+ * global dof ids of a DofDistribution. The ids in the range spanned by the set
+ * are stored using one bit per id, therefore:
+ * - the memory footprint is about one bit per id;
+ * - the membership test (count()) has constant complexity;
+ * - the ids are enumerated in increasing order, scanning the bitset one word
+ * (of 64 ids) at a time.
+ *
+ * The interface is a subset of the std::set one (with const iterators only).
+ *
+ * @ingroup serializable
+ */
+template <class T = Index>
+class IndexSet
+{
+  static_assert(std::is_integral<T>::value,"The type T must be an integral type.");
+
+private:
+  using self_t = IndexSet<T>;
+
+  using Word = std::uint64_t;
+
+  static const int bits_per_word = 64;
+
+public:
+  using value_type = T;
+  using key_type = T;
+  using size_type = Size;
+
+  /**
+   * @brief Forward iterator over the ids of the IndexSet (in increasing order).
+   */
+  class const_iterator
+    : public std::iterator<std::forward_iterator_tag,T,std::ptrdiff_t,const T *,T>
+  {
+  public:
+    const_iterator() = default;
+
+    const_iterator(const self_t &set, const Index word_id, const Word bits)
+      :
+      set_(&set),
+      word_id_(word_id),
+      bits_(bits)
+    {
+      this->skip_empty_words();
+    }
+
+    T operator*() const
+    {
+      Assert(bits_ != 0,ExcMessage("Dereferencing an invalid iterator."));
+      return set_->first_ + T(word_id_ * bits_per_word + __builtin_ctzll(bits_));
+    }
+
+    const_iterator &operator++()
+    {
+      // removing the lowest bit set
+      bits_ &= (bits_ - 1);
+      this->skip_empty_words();
+      return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+      const_iterator it = *this;
+      ++(*this);
+      return it;
+    }
+
+    bool operator==(const const_iterator &it) const
+    {
+      return (word_id_ == it.word_id_) && (bits_ == it.bits_);
+    }
+
+    bool operator!=(const const_iterator &it) const
+    {
+      return !(*this == it);
+    }
+
+  private:
+    void skip_empty_words()
+    {
+      const Index n_words = set_->words_.size();
+      while (bits_ == 0 && ++word_id_ < n_words)
+        bits_ = set_->words_[word_id_];
+
+      if (bits_ == 0)
+        word_id_ = n_words;
+    }
+
+    const self_t *set_ = nullptr;
+
+    Index word_id_ = 0;
+
+    /** Bits (of the current word) not visited yet. */
+    Word bits_ = 0;
+  };
+
+  using iterator = const_iterator;
+
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. It builds an empty set.
+   */
+  IndexSet() = default;
+
+  /**
+   * Builds the set with the ids in the range <tt>[first,last)</tt>.
+   */
+  template <class InputIt>
+  IndexSet(InputIt first, InputIt last)
+  {
+    this->insert(first,last);
+  }
+
+  /**
+   * Builds the set with the ids in the list @p ids.
+   */
+  IndexSet(std::initializer_list<T> ids)
+    :
+    IndexSet(ids.begin(),ids.end())
+  {}
+
+  /**
+   * Builds the set with the ids in the std::set @p ids.
+   */
+  explicit IndexSet(const std::set<T> &ids)
+    :
+    IndexSet(ids.begin(),ids.end())
+  {}
+
+  /**
+   * Copy constructor.
+   */
+  IndexSet(const self_t &set) = default;
+
+  /**
+   * Move constructor.
+   */
+  IndexSet(self_t &&set) = default;
+
+  /**
+   * Destructor.
+   */
+  ~IndexSet() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /**
+   * Copy assignment operator.
+   */
+  self_t &operator=(const self_t &set) = default;
+
+  /**
+   * Move assignment operator.
+   */
+  self_t &operator=(self_t &&set) = default;
+  ///@}
+
+  /** @name Functions for querying the set */
+  ///@{
+  /**
+   * Returns the number of ids in the set.
+   */
+  Size size() const
+  {
+    return size_;
+  }
+
+  /**
+   * Returns true if the set is empty.
+   */
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  /**
+   * Returns 1 if the @p id is in the set, 0 otherwise.
+   */
+  Size count(const T id) const
+  {
+    if (id < first_)
+      return 0;
+
+    const auto offset = id - first_;
+    const Index word_id = offset / bits_per_word;
+    if (word_id >= Index(words_.size()))
+      return 0;
+
+    return (words_[word_id] >> (offset % bits_per_word)) & Word(1);
+  }
+
+  /**
+   * Returns an iterator pointing to the @p id, or end() if the @p id is not in the set.
+   */
+  const_iterator find(const T id) const
+  {
+    if (this->count(id) == 0)
+      return this->end();
+
+    const auto offset = id - first_;
+    const Index word_id = offset / bits_per_word;
+    const Word bits = words_[word_id] & (~Word(0) << (offset % bits_per_word));
+    return const_iterator(*this,word_id,bits);
+  }
+
+  /**
+   * Returns true if the two sets contain the same ids.
+   */
+  bool operator==(const self_t &set) const
+  {
+    if (size_ != set.size_)
+      return false;
+
+    for (auto it = this->begin(), it_set = set.begin() ; it != this->end() ; ++it, ++it_set)
+      if (*it != *it_set)
+        return false;
+
+    return true;
+  }
+
+  /**
+   * Returns the ids in a std::set.
+   */
+  std::set<T> get_std_set() const
+  {
+    return std::set<T>(this->begin(),this->end());
+  }
+  ///@}
+
+  /** @name Functions for modifying the set */
+  ///@{
+  /**
+   * Inserts the @p id in the set.
+   */
+  void insert(const T id)
+  {
+    Assert(id >= 0, ExcLowerRange(id,0));
+
+    if (words_.empty())
+      first_ = (id / bits_per_word) * bits_per_word;
+    else if (id < first_)
+    {
+      // adding words at the beginning
+      const T new_first = (id / bits_per_word) * bits_per_word;
+      words_.insert(words_.begin(),(first_ - new_first) / bits_per_word,Word(0));
+      first_ = new_first;
+    }
+
+    const auto offset = id - first_;
+    const Index word_id = offset / bits_per_word;
+    if (word_id >= Index(words_.size()))
+      words_.resize(word_id+1,Word(0));
+
+    auto &word = words_[word_id];
+    const Word mask = Word(1) << (offset % bits_per_word);
+    if ((word & mask) == 0)
+    {
+      word |= mask;
+      ++size_;
+    }
+  }
+
+  /**
+   * Inserts the ids in the range <tt>[first,last)</tt>.
+   */
+  template <class InputIt>
+  void insert(InputIt first, InputIt last)
+  {
+    for (; first != last ; ++first)
+      this->insert(*first);
+  }
+
+  /**
+   * Removes the @p id from the set. Returns the number of ids removed (0 or 1).
+   */
+  Size erase(const T id)
+  {
+    if (this->count(id) == 0)
+      return 0;
+
+    const auto offset = id - first_;
+    words_[offset / bits_per_word] &= ~(Word(1) << (offset % bits_per_word));
+    --size_;
+
+    return 1;
+  }
+
+  /**
+   * Removes all the ids from the set.
+   */
+  void clear()
+  {
+    first_ = 0;
+    words_.clear();
+    size_ = 0;
+  }
+
+  /**
+   * Adds the @p offset to all the ids of the set.
+   */
+  void add_offset(const T offset)
+  {
+    if (offset % bits_per_word == 0 && first_ + offset >= 0)
+    {
+      first_ += offset;
+    }
+    else
+    {
+      const std::vector<T> ids(this->begin(),this->end());
+      this->clear();
+      for (const auto id : ids)
+        this->insert(id + offset);
+    }
+  }
+  ///@}
+
+  /** @name Iterators */
+  ///@{
+  const_iterator begin() const
+  {
+    return words_.empty() ?
+           this->end() :
+           const_iterator(*this,0,words_[0]);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(*this,words_.size(),Word(0));
+  }
+
+  const_iterator cbegin() const
+  {
+    return this->begin();
+  }
+
+  const_iterator cend() const
+  {
+    return this->end();
+  }
+  ///@}
+
+  /**
+   * Prints the ids in the set (with the same format of SafeSTLSet).
+   */
+  void print_info(LogStream &out) const
+  {
+    out << "[ ";
+    for (const auto id : *this)
+      out << id << " ";
+    out << "]";
+  }
+
+private:
+  /** Id corresponding to the first bit of words_[0] (it is a multiple of 64). */
+  T first_ = 0;
+
+  /** Bitset. The bit <tt>b</tt> of words_[w] is relative to the id <tt>first_ + 64*w + b</tt>. */
+  std::vector<Word> words_;
+
+  /** Number of ids in the set. */
+  Size size_ = 0;
+
+#ifdef IGATOOLS_WITH_SERIALIZATION
+  /**
+   * @name Functions needed for serialization
+   * @see <a href="http://uscilab.github.io/cereal/serialization_functions.html">Cereal serialization</a>
+   */
+  ///@{
+  friend class cereal::access;
+
+  template<class Archive>
+  void serialize(Archive &ar)
+  {
+    // the ids are archived as a std::vector, independently of the storage used
+    std::vector<T> ids;
+    const bool is_loading = std::is_same<Archive,IArchive>::value;
+    if (!is_loading)
+      ids.assign(this->begin(),this->end());
+
+    ar &make_nvp("ids_",ids);
+
+    if (is_loading)
+    {
+      this->clear();
+      this->insert(ids.begin(),ids.end());
+    }
+  }
+  ///@}
+#endif // IGATOOLS_WITH_SERIALIZATION
+};
+
+IGA_NAMESPACE_CLOSE
+
+
+#ifdef IGATOOLS_WITH_SERIALIZATION
+using IndexSetIntAlias = iga::IndexSet<int>;
+CEREAL_SPECIALIZE_FOR_ARCHIVE(IArchive,IndexSetIntAlias,cereal::specialization::member_serialize)
+CEREAL_SPECIALIZE_FOR_ARCHIVE(OArchive,IndexSetIntAlias,cereal::specialization::member_serialize)
+#endif // IGATOOLS_WITH_SERIALIZATION
+
+
+#endif // __INDEX_SET_H_
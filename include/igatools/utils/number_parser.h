@@ -0,0 +1,349 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __NUMBER_PARSER_H_
+#define __NUMBER_PARSER_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/exceptions.h>
+#include <igatools/utils/safe_stl_vector.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include <locale.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Collection of functions for parsing numbers (and whitespace separated
+ * lists of numbers) directly from a character buffer.
+ *
+ * The functions work on any character type (e.g. <tt>char</tt> or the UTF-16
+ * <tt>XMLCh</tt> of Xerces-c), so that the text of a document can be parsed
+ * in place, without transcoding or copying it into a <tt>std::string</tt>
+ * and without the overhead of the <tt>std::stringstream</tt> extraction
+ * operators (locale, sentry, virtual calls).
+ *
+ * The accepted syntax is the one of <tt>std::strtol</tt> and <tt>std::strtod</tt>
+ * in the "C" locale, restricted to decimal numbers (i.e. no hexadecimal values,
+ * no <tt>inf</tt> or <tt>nan</tt>).
+ *
+ * The floating point values are computed exactly (as
+ * <tt>mantissa * 10^exponent</tt> in double precision) when the decimal mantissa
+ * fits in 53 bits and <tt>|exponent| <= 22</tt>, that is the case for most of the
+ * values written with the default precision. Otherwise, the
+ * token is passed to <tt>strtod_l</tt> with the "C" locale: the result is
+ * always the correctly rounded value and it does not depend on the global
+ * locale of the program (e.g. on the decimal separator).
+ */
+namespace number_parser
+{
+
+/**
+ * Returns true if the character @p c is a white space.
+ */
+template <class Char>
+inline
+bool
+is_space(const Char c)
+{
+  return c == Char(' ')  || c == Char('\n') || c == Char('\t') ||
+         c == Char('\r') || c == Char('\v') || c == Char('\f');
+}
+
+/**
+ * Returns true if the character @p c is a decimal digit.
+ */
+template <class Char>
+inline
+bool
+is_digit(const Char c)
+{
+  return c >= Char('0') && c <= Char('9');
+}
+
+/**
+ * Returns the "C" locale used by the conversions of parse_real().
+ * It is created at the first call and never released.
+ */
+inline
+locale_t
+get_c_locale()
+{
+  static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", locale_t(0));
+  return c_locale;
+}
+
+/**
+ * Parses the integer contained in the range <tt>[first,last)</tt>
+ * (that must not contain white spaces).
+ *
+ * Returns false (and @p value is not modified) if the range does not contain
+ * a valid integer or if the integer is out of the range of @p Int.
+ */
+template <class Char, class Int>
+inline
+bool
+parse_integer(const Char *first, const Char *last, Int &value)
+{
+  static_assert(std::is_integral<Int>::value,"The type Int must be an integral type.");
+
+  const Char *it = first;
+  bool negative = false;
+  if (it != last && (*it == Char('-') || *it == Char('+')))
+    negative = (*it++ == Char('-'));
+
+  if (it == last)
+    return false;
+
+  using UInt = typename std::make_unsigned<Int>::type;
+  const UInt max_value = negative ?
+                         UInt(std::numeric_limits<Int>::max()) + (std::is_signed<Int>::value ? 1 : 0) :
+                         UInt(std::numeric_limits<Int>::max());
+  if (negative && !std::is_signed<Int>::value)
+    return false;
+
+  UInt v = 0;
+  for (; it != last ; ++it)
+  {
+    if (!is_digit(*it))
+      return false;
+    const UInt d = UInt(*it - Char('0'));
+    if (v > (max_value - d) / 10)
+      return false;
+    v = 10 * v + d;
+  }
+
+  value = negative ? Int(UInt(0) - v) : Int(v);
+  return true;
+}
+
+/**
+ * Parses the floating point number contained in the range <tt>[first,last)</tt>
+ * (that must not contain white spaces).
+ *
+ * Returns false (and @p value is not modified) if the range does not contain
+ * a valid number or if the number overflows.
+ */
+template <class Char>
+inline
+bool
+parse_real(const Char *first, const Char *last, Real &value)
+{
+  // Exactly representable powers of 10.
+  static const double pow10[] =
+  {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const int max_exact_pow10 = 22;
+
+  // Integers up to 10^19 fit in 64 bits.
+  const int max_mantissa_digits = 19;
+
+  const Char *it = first;
+  bool negative = false;
+  if (it != last && (*it == Char('-') || *it == Char('+')))
+    negative = (*it++ == Char('-'));
+
+  std::uint64_t mantissa = 0;
+  int n_digits = 0;
+  int exp10 = 0;
+  bool truncated = false;
+  bool has_digits = false;
+
+  // Integer part.
+  for (; it != last && is_digit(*it) ; ++it)
+  {
+    has_digits = true;
+    const int d = int(*it - Char('0'));
+    if (mantissa == 0 && d == 0)
+      continue;
+    if (n_digits < max_mantissa_digits)
+    {
+      mantissa = 10 * mantissa + d;
+      ++n_digits;
+    }
+    else
+    {
+      ++exp10;
+      truncated |= (d != 0);
+    }
+  }
+
+  // Fractional part.
+  if (it != last && *it == Char('.'))
+  {
+    for (++it ; it != last && is_digit(*it) ; ++it)
+    {
+      has_digits = true;
+      const int d = int(*it - Char('0'));
+      if (mantissa == 0 && d == 0)
+        --exp10;
+      else if (n_digits < max_mantissa_digits)
+      {
+        mantissa = 10 * mantissa + d;
+        ++n_digits;
+        --exp10;
+      }
+      else
+        truncated |= (d != 0);
+    }
+  }
+
+  if (!has_digits)
+    return false;
+
+  // Exponent.
+  if (it != last && (*it == Char('e') || *it == Char('E')))
+  {
+    ++it;
+    bool negative_exp = false;
+    if (it != last && (*it == Char('-') || *it == Char('+')))
+      negative_exp = (*it++ == Char('-'));
+
+    if (it == last)
+      return false;
+
+    int e = 0;
+    for (; it != last ; ++it)
+    {
+      if (!is_digit(*it))
+        return false;
+      // Larger exponents give zero or infinity anyway.
+      if (e < 100000)
+        e = 10 * e + int(*it - Char('0'));
+    }
+    exp10 += negative_exp ? -e : e;
+  }
+
+  if (it != last)
+    return false;
+
+  if (mantissa == 0)
+  {
+    value = negative ? -0.0 : 0.0;
+    return true;
+  }
+
+  // Fast path: both the mantissa and the power of 10 are exactly
+  // representable, therefore the result is correctly rounded.
+  if (!truncated && mantissa <= (std::uint64_t(1) << 53) &&
+      exp10 >= -max_exact_pow10 && exp10 <= max_exact_pow10)
+  {
+    const double m = double(mantissa);
+    const double v = (exp10 < 0) ? m / pow10[-exp10] : m * pow10[exp10];
+    value = negative ? -v : v;
+    return true;
+  }
+
+  // Slow path: the (validated) token is ASCII, it is narrowed and passed to
+  // strtod_l, that (unlike strtod) does not use the global locale.
+  const std::string token(first, last);
+  const double v = strtod_l(token.c_str(), nullptr, get_c_locale());
+  if (std::isinf(v))
+    return false;
+
+  value = v;
+  return true;
+}
+
+/**
+ * Parses the number contained in the range <tt>[first,last)</tt>.
+ */
+template <class Char>
+inline
+bool
+parse(const Char *first, const Char *last, Index &value)
+{
+  return parse_integer(first, last, value);
+}
+
+/**
+ * Parses the number contained in the range <tt>[first,last)</tt>.
+ */
+template <class Char>
+inline
+bool
+parse(const Char *first, const Char *last, Real &value)
+{
+  return parse_real(first, last, value);
+}
+
+/**
+ * Parses the whitespace separated list of numbers contained in the first
+ * @p length characters of @p text, and returns them in a vector.
+ *
+ * The tokens are counted before parsing them, so that the returned vector
+ * is allocated only once.
+ *
+ * @warning It throws an exception if a token is not a valid number of type @p T.
+ */
+template <class T, class Char>
+SafeSTLVector<T>
+parse_values(const Char *text, const Size length)
+{
+  const Char *const end = text + length;
+
+  Size n_tokens = 0;
+  bool in_token = false;
+  for (const Char *it = text ; it != end ; ++it)
+  {
+    const bool space = is_space(*it);
+    n_tokens += (!space && !in_token) ? 1 : 0;
+    in_token = !space;
+  }
+
+  SafeSTLVector<T> values(n_tokens);
+
+  const Char *it = text;
+  for (auto &v : values)
+  {
+    while (is_space(*it))
+      ++it;
+    const Char *token_begin = it;
+    while (it != end && !is_space(*it))
+      ++it;
+
+    if (!parse(token_begin, it, v))
+    {
+      std::string token;
+      for (const Char *c = token_begin ; c != it ; ++c)
+        token += (*c > Char(0) && *c < Char(128)) ? char(*c) : '?';
+      AssertThrow(false, ExcMessage("Impossible to parse \"" + token + "\" as a number."));
+    }
+  }
+
+  return values;
+}
+
+} // end namespace number_parser
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __NUMBER_PARSER_H_
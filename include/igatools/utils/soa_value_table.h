@@ -0,0 +1,369 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __SOA_VALUE_TABLE_H_
+#define __SOA_VALUE_TABLE_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/exceptions.h>
+#include <igatools/utils/aligned_vector.h>
+#include <igatools/utils/value_table.h>
+#include <igatools/utils/value_vector.h>
+
+#include <algorithm>
+#include <iterator>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Structure-of-arrays (SoA) storage for the entries of a ValueTable.
+ *
+ * A ValueTable<T> stores the objects of type @p T (e.g. the gradients of the
+ * basis functions) as a whole, point after point for each function: the same scalar
+ * entry of @p T (e.g. the x-component of the gradient) of different functions
+ * is scattered in memory.
+ *
+ * The SoAValueTable stores instead each of the <tt>T::n_entries</tt> scalar entries
+ * (called <em>components</em>) in a separate block and, inside each block,
+ * the values of all the functions at a given point are contiguous:
+ * the component @p comp of the function @p fn at the point @p pt is stored at the position
+ * <tt>(comp * num_points + pt) * get_leading_dimension() + fn</tt>
+ * of a memory chunk aligned to aligned_vector_alignment bytes.
+ * The leading dimension is the number of functions rounded up to a multiple of 8
+ * and the padding entries are always zero.
+ *
+ * With this layout the loops over the functions are unit-stride and can be vectorized
+ * (see for example BasisElement::integrate_gradu_gradv()).
+ *
+ * The table is filled from a ValueTable with fill() and its content can be
+ * copied back to a ValueTable with copy_to().
+ * The read-only views returned by get_function_view() and get_point_view()
+ * have the same interface of the ValueTable ones,
+ * but the entries are returned by value.
+ *
+ * @tparam T Type of the object represented by each entry of the table.
+ */
+template <class T>
+class SoAValueTable
+{
+public:
+  /** Number of scalar components of an object of type @p T. */
+  static const int n_components = T::n_entries;
+
+  /**
+   * @brief Read-only view of the entries of a SoAValueTable related to the
+   * same function (if @p is_function_view is true) or to the same point
+   * (if @p is_function_view is false).
+   */
+  template <bool is_function_view>
+  class ConstView
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    ConstView(const SoAValueTable<T> &table, const Index id)
+      :
+      table_(&table),
+      id_(id)
+    {}
+
+    /**
+     * Returns the <tt>i</tt>-th entry of the view.
+     */
+    T operator[](const Index i) const
+    {
+      return is_function_view ? table_->get_value(id_,i) : table_->get_value(i,id_);
+    }
+
+    /**
+     * Returns the number of entries of the view.
+     */
+    Size get_num_entries() const
+    {
+      return is_function_view ? table_->get_num_points() : table_->get_num_functions();
+    }
+
+  private:
+    const SoAValueTable<T> *table_;
+
+    Index id_;
+  };
+
+  /** Type for the view of the entries related to the same function. */
+  using const_function_view = ConstView<true>;
+
+  /** Type for the view of the entries related to the same point. */
+  using const_point_view = ConstView<false>;
+
+  /** @name Constructors */
+  ///@{
+  /**
+   * Default constructor. Constructs an empty table.
+   */
+  SoAValueTable() = default;
+
+  /**
+   * Constructs a table for @p num_functions functions and @p num_points points,
+   * with all the entries set to zero.
+   */
+  SoAValueTable(const Size num_functions, const Size num_points)
+  {
+    this->resize(num_functions,num_points);
+  }
+
+  /**
+   * Constructs a table with the same content of the ValueTable @p table.
+   */
+  explicit SoAValueTable(const ValueTable<T> &table)
+  {
+    this->fill(table);
+  }
+
+  /** Copy constructor. */
+  SoAValueTable(const SoAValueTable<T> &table) = default;
+
+  /** Move constructor. */
+  SoAValueTable(SoAValueTable<T> &&table) = default;
+
+  /** Destructor. */
+  ~SoAValueTable() = default;
+  ///@}
+
+  /** @name Assignment operators */
+  ///@{
+  /** Copy assignment operator. */
+  SoAValueTable<T> &operator=(const SoAValueTable<T> &table) = default;
+
+  /** Move assignment operator. */
+  SoAValueTable<T> &operator=(SoAValueTable<T> &&table) = default;
+  ///@}
+
+  /** @name Functions for getting size information */
+  ///@{
+  /** Returns the number of functions. */
+  Size get_num_functions() const noexcept
+  {
+    return num_functions_;
+  }
+
+  /** Returns the number of points. */
+  Size get_num_points() const noexcept
+  {
+    return num_points_;
+  }
+
+  /**
+   * Returns the distance (in number of entries) between the values of the functions
+   * at two consecutive points (or components), i.e. the number of functions
+   * rounded up to a multiple of 8.
+   */
+  Size get_leading_dimension() const noexcept
+  {
+    return leading_dimension_;
+  }
+  ///@}
+
+  /**
+   * Resizes the table for @p num_functions functions and @p num_points points,
+   * setting all the entries to zero.
+   * @note No memory is allocated if the new size is not bigger than the capacity
+   * of the table.
+   */
+  void resize(const Size num_functions, const Size num_points)
+  {
+    Assert(num_functions >= 0, ExcLowerRange(num_functions,0));
+    Assert(num_points >= 0, ExcLowerRange(num_points,0));
+
+    num_functions_ = num_functions;
+    num_points_ = num_points;
+    leading_dimension_ = ((num_functions + 7) / 8) * 8;
+    data_.assign(n_components * num_points_ * leading_dimension_, 0.0);
+  }
+
+  /** @name Conversion from/to ValueTable */
+  ///@{
+  /**
+   * Copies the content of the ValueTable @p table into this table
+   * (resized if needed).
+   */
+  void fill(const ValueTable<T> &table)
+  {
+    const Size n_funcs = table.get_num_functions();
+    const Size n_pts = table.get_num_points();
+    if (n_funcs != num_functions_ || n_pts != num_points_)
+      this->resize(n_funcs,n_pts);
+
+    const Size comp_stride = num_points_ * leading_dimension_;
+    auto table_it = table.cbegin();
+    for (Index fn = 0 ; fn < n_funcs ; ++fn)
+      for (Index pt = 0 ; pt < n_pts ; ++pt, ++table_it)
+      {
+        const auto values = (*table_it).get_flat_values();
+        Real *entry = &data_[pt * leading_dimension_ + fn];
+        for (int comp = 0 ; comp < n_components ; ++comp, entry += comp_stride)
+          *entry = values[comp];
+      }
+  }
+
+  /**
+   * Copies into this table (resized if needed) the values of the functions
+   * of the ValueTable @p table whose indices are listed in @p functions:
+   * the <tt>k</tt>-th function of this table is the function
+   * <tt>functions[k]</tt> of @p table.
+   * @note No memory is allocated if the new size is not bigger than the capacity
+   * of the table.
+   */
+  template <class FunctionIds>
+  void fill(const ValueTable<T> &table, const FunctionIds &functions)
+  {
+    const Size n_funcs = std::distance(functions.begin(),functions.end());
+    const Size n_pts = table.get_num_points();
+    if (n_funcs != num_functions_ || n_pts != num_points_)
+      this->resize(n_funcs,n_pts);
+
+    const Size comp_stride = num_points_ * leading_dimension_;
+    Index fn = 0;
+    for (const auto table_fn : functions)
+    {
+      Assert(table_fn >= 0 && table_fn < table.get_num_functions(),
+             ExcIndexRange(table_fn,0,table.get_num_functions()));
+      const auto table_fn_values = table.get_function_view(table_fn);
+      for (Index pt = 0 ; pt < n_pts ; ++pt)
+      {
+        const auto values = table_fn_values[pt].get_flat_values();
+        Real *entry = &data_[pt * leading_dimension_ + fn];
+        for (int comp = 0 ; comp < n_components ; ++comp, entry += comp_stride)
+          *entry = values[comp];
+      }
+      ++fn;
+    }
+  }
+
+  /**
+   * Copies the content of this table into the ValueTable @p table,
+   * that must have the same number of functions and points.
+   */
+  void copy_to(ValueTable<T> &table) const
+  {
+    Assert(table.get_num_functions() == num_functions_,
+           ExcDimensionMismatch(table.get_num_functions(),num_functions_));
+    Assert(table.get_num_points() == num_points_,
+           ExcDimensionMismatch(table.get_num_points(),num_points_));
+
+    auto table_it = table.begin();
+    for (Index fn = 0 ; fn < num_functions_ ; ++fn)
+      for (Index pt = 0 ; pt < num_points_ ; ++pt, ++table_it)
+        *table_it = this->get_value(fn,pt);
+  }
+  ///@}
+
+  /** @name Access to the entries */
+  ///@{
+  /**
+   * Returns the object associated to the function @p fn at the point @p pt.
+   */
+  T get_value(const Index fn, const Index pt) const
+  {
+    Assert(fn >= 0 && fn < num_functions_, ExcIndexRange(fn,0,num_functions_));
+    Assert(pt >= 0 && pt < num_points_, ExcIndexRange(pt,0,num_points_));
+
+    SafeSTLArray<Real,n_components> values;
+    const Size comp_stride = num_points_ * leading_dimension_;
+    const Real *entry = &data_[pt * leading_dimension_ + fn];
+    for (int comp = 0 ; comp < n_components ; ++comp, entry += comp_stride)
+      values[comp] = *entry;
+    return T(values);
+  }
+
+  /**
+   * Returns a pointer to the (contiguous) values of the component @p comp
+   * of all the functions at the point @p pt.
+   * The values at the point <tt>pt+1</tt> follow after get_leading_dimension() entries.
+   */
+  const Real *get_component(const int comp, const Index pt) const
+  {
+    Assert(comp >= 0 && comp < n_components, ExcIndexRange(comp,0,n_components));
+    Assert(pt >= 0 && pt < num_points_, ExcIndexRange(pt,0,num_points_));
+    return &data_[(comp * num_points_ + pt) * leading_dimension_];
+  }
+
+  /**
+   * Returns a pointer to the (contiguous) values of the component @p comp
+   * of all the functions at the point @p pt.
+   * The values at the point <tt>pt+1</tt> follow after get_leading_dimension() entries.
+   */
+  Real *get_component(const int comp, const Index pt)
+  {
+    Assert(comp >= 0 && comp < n_components, ExcIndexRange(comp,0,n_components));
+    Assert(pt >= 0 && pt < num_points_, ExcIndexRange(pt,0,num_points_));
+    return &data_[(comp * num_points_ + pt) * leading_dimension_];
+  }
+
+  /**
+   * Returns a view of the entries related to the <tt>i</tt>-th function.
+   */
+  const_function_view get_function_view(const int i) const
+  {
+    Assert(i >= 0 && i < num_functions_, ExcIndexRange(i,0,num_functions_));
+    return const_function_view(*this,i);
+  }
+
+  /**
+   * Returns a view of the entries related to the <tt>i</tt>-th point.
+   */
+  const_point_view get_point_view(const int i) const
+  {
+    Assert(i >= 0 && i < num_points_, ExcIndexRange(i,0,num_points_));
+    return const_point_view(*this,i);
+  }
+  ///@}
+
+  /**
+   * Multiplies all the entries at the point <tt>pt</tt> by <tt>weights[pt]</tt>.
+   */
+  void scale_points(const ValueVector<Real> &weights)
+  {
+    Assert(weights.size() == num_points_,
+           ExcDimensionMismatch(weights.size(),num_points_));
+
+    Real *row = data_.data();
+    for (int comp = 0 ; comp < n_components ; ++comp)
+      for (Index pt = 0 ; pt < num_points_ ; ++pt, row += leading_dimension_)
+      {
+        const Real w = weights[pt];
+        for (Index fn = 0 ; fn < num_functions_ ; ++fn)
+          row[fn] *= w;
+      }
+  }
+
+private:
+  Size num_functions_ = 0;
+
+  Size num_points_ = 0;
+
+  Size leading_dimension_ = 0;
+
+  AlignedVector data_;
+};
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __SOA_VALUE_TABLE_H_
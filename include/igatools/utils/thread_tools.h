@@ -0,0 +1,137 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#ifndef __THREAD_TOOLS_H_
+#define __THREAD_TOOLS_H_
+
+#include <igatools/base/config.h>
+#include <igatools/base/exceptions.h>
+#include <igatools/utils/safe_stl_vector.h>
+
+#include <thread>
+#include <vector>
+#include <exception>
+
+IGA_NAMESPACE_OPEN
+
+/**
+ * @brief Collection of helper functions for the (shared memory) multithreaded
+ * execution of loops.
+ *
+ * The threads are plain <tt>std::thread</tt> objects, spawned and joined at each call
+ * of run_in_parallel(). The objects used by the threads (element accessors,
+ * cache handlers, etc.) are meant to be created by the calling thread <b>before</b>
+ * the threads are spawned, so that each thread works only on its own data.
+ */
+namespace thread_tools
+{
+
+/**
+ * Returns the number of concurrent threads supported by the hardware
+ * (or 1 if this information is not available).
+ */
+inline
+int
+get_default_num_threads()
+{
+  const int n_threads = std::thread::hardware_concurrency();
+  return (n_threads > 0) ? n_threads : 1;
+}
+
+/**
+ * Splits the range <tt>[0,n_items)</tt> in (at most) <tt>n_chunks</tt> contiguous
+ * chunks of (almost) equal size.
+ *
+ * The <tt>i</tt>-th chunk is the range <tt>[offsets[i],offsets[i+1])</tt>, where
+ * <tt>offsets</tt> is the returned vector. The chunks are sorted, therefore
+ * concatenating them gives back the original range.
+ */
+inline
+SafeSTLVector<Index>
+split_range(const Size n_items, const int n_chunks)
+{
+  Assert(n_items >= 0, ExcLowerRange(n_items,0));
+  Assert(n_chunks > 0, ExcLowerRange(n_chunks,1));
+
+  const int n_active_chunks = std::max(std::min(n_chunks,n_items),1);
+
+  SafeSTLVector<Index> offsets(n_active_chunks+1);
+  const Size chunk_size = n_items / n_active_chunks;
+  const Size remainder  = n_items % n_active_chunks;
+
+  offsets[0] = 0;
+  for (int c = 0 ; c < n_active_chunks ; ++c)
+    offsets[c+1] = offsets[c] + chunk_size + (c < remainder ? 1 : 0);
+
+  return offsets;
+}
+
+/**
+ * Executes <tt>func(thread_id)</tt> for each <tt>thread_id</tt> in
+ * <tt>[0,n_threads)</tt>, concurrently.
+ *
+ * The call with <tt>thread_id == 0</tt> is executed by the calling thread, while
+ * the others are executed by <tt>n_threads-1</tt> new threads.
+ * The function returns when all the calls are completed.
+ *
+ * If one or more calls throw an exception, the exception raised by the call with
+ * the lowest <tt>thread_id</tt> is re-thrown in the calling thread (after all the
+ * threads are joined).
+ */
+template <class Func>
+void
+run_in_parallel(const int n_threads, const Func &func)
+{
+  Assert(n_threads > 0, ExcLowerRange(n_threads,1));
+
+  std::vector<std::exception_ptr> errors(n_threads,nullptr);
+
+  auto guarded_func = [&func,&errors](const int thread_id)
+  {
+    try
+    {
+      func(thread_id);
+    }
+    catch (...)
+    {
+      errors[thread_id] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(n_threads-1);
+  for (int t = 1 ; t < n_threads ; ++t)
+    threads.emplace_back(guarded_func,t);
+
+  guarded_func(0);
+
+  for (auto &thread : threads)
+    thread.join();
+
+  for (const auto &error : errors)
+    if (error != nullptr)
+      std::rethrow_exception(error);
+}
+
+} // end namespace thread_tools
+
+IGA_NAMESPACE_CLOSE
+
+#endif // __THREAD_TOOLS_H_
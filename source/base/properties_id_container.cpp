@@ -184,6 +184,25 @@ empty() const noexcept
 
 
 
+bool
+PropertiesDofs::
+test_id_for_property(const int id, const PropId &property) const
+{
+  return (*this)[property].count(id) > 0;
+}
+
+
+
+void
+PropertiesDofs::
+add_offset(const int offset)
+{
+  for (auto &property_dofs : *this)
+    property_dofs.second.add_offset(offset);
+}
+
+
+
 void
 PropertiesDofs::
 set_property_status_for_id(const PropId &property,
@@ -243,6 +262,8 @@ set_property_status_for_id(const PropId &property,
     Assert(!list.empty(),ExcEmptyObject());
     list.erase(std::find(list.cbegin(),list.cend(),elem_id));
   }
+
+  this->update_positions(property);
 }
 
 
@@ -268,6 +289,74 @@ set_property_status_for_ids(const PropId &property,
     for (const auto &elem_id : ids)
       list.erase(std::find(list.cbegin(),list.cend(),elem_id));
   }
+
+  this->update_positions(property);
+}
+
+
+
+template <int dim>
+Index
+PropertiesElementID<dim>::
+get_position(const PropId &property,
+             const ElementIndex<dim> &elem_id) const
+{
+  const auto &list = (*this)[property];
+  const Size n_elems = list.size();
+
+  const auto positions_it = positions_.find(property);
+  if (positions_it != positions_.end())
+  {
+    const auto &positions = positions_it->second;
+    const Index flat_id = elem_id.get_flat_index();
+    if (flat_id >= 0 && flat_id < Index(positions.size()))
+    {
+      const Index pos = positions[flat_id];
+      if (pos >= 0 && pos < n_elems && list[pos] == elem_id)
+        return pos;
+    }
+  }
+
+  // element without the property (or index not up to date): binary search in the (sorted) list
+  const auto it = std::lower_bound(list.begin(),list.end(),elem_id);
+  return (it != list.end() && *it == elem_id) ? Index(it - list.begin()) : -1;
+}
+
+
+
+template <int dim>
+void
+PropertiesElementID<dim>::
+update_positions(const PropId &property)
+{
+  const auto &list = (*this)[property];
+
+  auto &positions = positions_[property];
+  positions.clear();
+  if (!list.empty())
+  {
+    // the list is sorted by tensor index, therefore the last element
+    // is not necessarily the one with the largest flat id
+    Index max_flat_id = 0;
+    for (const auto &elem_id : list)
+      max_flat_id = std::max(max_flat_id,elem_id.get_flat_index());
+    positions.resize(max_flat_id+1,-1);
+
+    Index pos = 0;
+    for (const auto &elem_id : list)
+      positions[elem_id.get_flat_index()] = pos++;
+  }
+}
+
+
+
+template <int dim>
+void
+PropertiesElementID<dim>::
+update_positions()
+{
+  for (const auto &property : this->get_properties())
+    this->update_positions(property);
 }
 
 IGA_NAMESPACE_CLOSE
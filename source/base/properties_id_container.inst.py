@@ -36,6 +36,8 @@ for dim in inst.sub_domain_dims + inst.domain_dims:
 
 obj = 'PropertiesIdContainer<int>'
 containers.append(obj)
+obj = 'PropertiesIdContainer<int,IndexSet>'
+containers.append(obj)
 
 for obj in unique(containers):
     f.write('template class %s;\n' %(obj))
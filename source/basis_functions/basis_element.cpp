@@ -23,6 +23,7 @@
 #include <igatools/basis_functions/basis_element.h>
 #include <igatools/basis_functions/reference_basis_element.h>
 #include <igatools/basis_functions/physical_basis_element.h>
+#include <igatools/operators/sum_factorization_kernels.h>
 
 
 IGA_NAMESPACE_OPEN
@@ -30,6 +31,64 @@ IGA_NAMESPACE_OPEN
 
 //#define SUM_FACTORIZATION
 
+namespace
+{
+/**
+ * Returns the (symmetric) matrix with entries
+ * \f$ M_{ij} = \sum_{pt} (u_i(pt) : u_j(pt)) w(pt) \f$.
+ *
+ * The values @p u_soa are stored in SoA layout, so that each row of the matrix is
+ * computed (with the vectorized kernel sum_factorization_kernels::contract())
+ * as a linear combination of the contiguous values of the functions at the points,
+ * for all the components.
+ * The buffers @p w_u_i and @p M_i are scratch space, reused between calls.
+ */
+template <class T>
+DenseMatrix
+integrate_scalar_products(const SoAValueTable<T> &u_soa, const ValueVector<Real> &w_meas,
+                          AlignedVector &w_u_i, AlignedVector &M_i)
+{
+  const int n_basis = u_soa.get_num_functions();
+  const int n_pts = u_soa.get_num_points();
+  const int n_comps = SoAValueTable<T>::n_components;
+  const int n_entries = n_comps * n_pts;
+  const Size ld = u_soa.get_leading_dimension();
+
+  Assert(w_meas.size() == n_pts, ExcDimensionMismatch(w_meas.size(),n_pts));
+
+  DenseMatrix M(n_basis,n_basis);
+  if (n_basis == 0 || n_pts == 0)
+  {
+    M = 0.0;
+    return M;
+  }
+
+  w_u_i.resize(n_entries);
+  M_i.resize(ld);
+
+  const Real *const u_data = u_soa.get_component(0,0);
+  for (int i = 0; i < n_basis; ++i)
+  {
+    // all the components of w * u_i, at all the points
+    for (int comp = 0, k = 0; comp < n_comps; ++comp)
+      for (int pt = 0; pt < n_pts; ++pt, ++k)
+        w_u_i[k] = w_meas[pt] * u_data[k * ld + i];
+
+    // M(i,j) for j >= i
+    sum_factorization_kernels::contract(
+      n_entries, n_basis - i, w_u_i.data(), u_data + i, ld, M_i.data());
+
+    for (int j = i; j < n_basis; ++j)
+      M(i,j) = M_i[j - i];
+
+    for (int j = 0; j < i; ++j)
+      M(i,j) = M(j,i);
+  } // end loop i
+
+  return M;
+}
+} // end anonymous namespace
+
 template<int dim_,int codim_,int range_,int rank_>
 BasisElement<dim_,codim_,range_,rank_>::
 BasisElement(const std::shared_ptr<Bs> &basis)
@@ -77,22 +136,40 @@ get_index() const -> const IndexType &
 
 
 
+template<int dim_,int codim_,int range_,int rank_>
+auto
+BasisElement<dim_,codim_,range_,rank_>::
+get_local_to_global_view(const std::string &dofs_property) const -> DofsConstView
+{
+  return this->basis_->get_spline_space()->get_element_dofs_table(dofs_property).
+         get_global_dofs(this->get_index().get_flat_index());
+}
+
+template<int dim_,int codim_,int range_,int rank_>
+auto
+BasisElement<dim_,codim_,range_,rank_>::
+get_local_to_patch_view(const std::string &dofs_property) const -> DofsConstView
+{
+  return this->basis_->get_spline_space()->get_element_dofs_table(dofs_property).
+         get_local_to_patch(this->get_index().get_flat_index());
+}
+
+template<int dim_,int codim_,int range_,int rank_>
+auto
+BasisElement<dim_,codim_,range_,rank_>::
+get_local_dofs_view(const std::string &dofs_property) const -> DofsConstView
+{
+  return this->basis_->get_spline_space()->get_element_dofs_table(dofs_property).
+         get_local_to_elem(this->get_index().get_flat_index());
+}
+
 template<int dim_,int codim_,int range_,int rank_>
 SafeSTLVector<Index>
 BasisElement<dim_,codim_,range_,rank_>::
 get_local_to_global(const std::string &dofs_property) const
 {
-  SafeSTLVector<Index> dofs_global;
-  SafeSTLVector<Index> dofs_loc_to_patch;
-  SafeSTLVector<Index> dofs_loc_to_elem;
-  this->basis_->get_spline_space()->get_element_dofs(
-    this->get_index(),
-    dofs_global,
-    dofs_loc_to_patch,
-    dofs_loc_to_elem,
-    dofs_property);
-
-  return dofs_global;
+  const auto dofs = this->get_local_to_global_view(dofs_property);
+  return SafeSTLVector<Index>(dofs.begin(),dofs.end());
 }
 
 template<int dim_,int codim_,int range_,int rank_>
@@ -100,17 +177,8 @@ SafeSTLVector<Index>
 BasisElement<dim_,codim_,range_,rank_>::
 get_local_to_patch(const std::string &dofs_property) const
 {
-  SafeSTLVector<Index> dofs_global;
-  SafeSTLVector<Index> dofs_loc_to_patch;
-  SafeSTLVector<Index> dofs_loc_to_elem;
-  this->basis_->get_spline_space()->get_element_dofs(
-    this->get_index(),
-    dofs_global,
-    dofs_loc_to_patch,
-    dofs_loc_to_elem,
-    dofs_property);
-
-  return dofs_loc_to_patch;
+  const auto dofs = this->get_local_to_patch_view(dofs_property);
+  return SafeSTLVector<Index>(dofs.begin(),dofs.end());
 }
 
 template<int dim_,int codim_,int range_,int rank_>
@@ -118,17 +186,8 @@ SafeSTLVector<Index>
 BasisElement<dim_,codim_,range_,rank_>::
 get_local_dofs(const std::string &dofs_property) const
 {
-  SafeSTLVector<Index> dofs_global;
-  SafeSTLVector<Index> dofs_loc_to_patch;
-  SafeSTLVector<Index> dofs_loc_to_elem;
-  this->basis_->get_spline_space()->get_element_dofs(
-    this->get_index(),
-    dofs_global,
-    dofs_loc_to_patch,
-    dofs_loc_to_elem,
-    dofs_property);
-
-  return dofs_loc_to_elem;
+  const auto dofs = this->get_local_dofs_view(dofs_property);
+  return SafeSTLVector<Index>(dofs.begin(),dofs.end());
 }
 
 template<int dim_,int codim_,int range_,int rank_>
@@ -136,8 +195,8 @@ Size
 BasisElement<dim_,codim_,range_,rank_>::
 get_num_basis(const std::string &dofs_property) const
 {
-  const auto dofs_global = this->get_local_to_global(dofs_property);
-  return dofs_global.size();
+  return this->basis_->get_spline_space()->get_element_dofs_table(dofs_property).
+         get_num_dofs(this->get_index().get_flat_index());
 }
 
 
@@ -256,34 +315,13 @@ integrate_u_v(const int s_id,
 {
 #ifndef SUM_FACTORIZATION
   const auto &w_meas = this->template get_w_measures<sdim>(s_id);
-  const auto &u = this->template get_basis_data<basis_element::_Value,sdim>(s_id,dofs_property);
-
-  const int n_pts = u.get_num_points();
-
-  const int n_basis = u.get_num_functions();
-  DenseMatrix M(n_basis,n_basis);
-  M = 0.0;
-
-  for (int i = 0; i < n_basis; ++i)
-  {
-    const auto u_i = u.get_function_view(i);
-
-    for (int j = i; j < n_basis; ++j)
-    {
-      const auto u_j = u.get_function_view(j);
-
-      Real sum = 0.0;
-      for (int pt = 0; pt < n_pts; ++pt)
-        sum += scalar_product(u_i[pt],u_j[pt]) * w_meas[pt];
-
-      M(i,j) = sum;
-    } // end loop j
+  const auto &u = all_sub_elems_cache_.template get_sub_elem_cache<sdim>(s_id).
+                  template get_data<basis_element::_Value>();
 
-    for (int j = 0; j < i; ++j)
-      M(i,j) = M(j,i);
-  } // end loop i
+  auto &scratch = scalar_products_scratch_;
+  scratch.values.fill(u,this->get_local_dofs_view(dofs_property));
 
-  return M;
+  return integrate_scalar_products(scratch.values,w_meas,scratch.w_u_i,scratch.M_i);
 #else
   return this->integrate_u_v_sum_factorization_impl(
            Topology<sdim>(),s_id,dofs_property);
@@ -300,34 +338,13 @@ integrate_gradu_gradv(const int s_id,
 {
 #ifndef SUM_FACTORIZATION
   const auto &w_meas = this->template get_w_measures<sdim>(s_id);
-  const auto &gradu = this->template get_basis_data<basis_element::_Gradient,sdim>(s_id,dofs_property);
-
-  const int n_pts = gradu.get_num_points();
-
-  const int n_basis = gradu.get_num_functions();
-  DenseMatrix M(n_basis,n_basis);
-  M = 0.0;
-
-  for (int i = 0; i < n_basis; ++i)
-  {
-    const auto gradu_i = gradu.get_function_view(i);
-
-    for (int j = i; j < n_basis; ++j)
-    {
-      const auto gradu_j = gradu.get_function_view(j);
+  const auto &gradu = all_sub_elems_cache_.template get_sub_elem_cache<sdim>(s_id).
+                      template get_data<basis_element::_Gradient>();
 
-      Real sum = 0.0;
-      for (int pt = 0; pt < n_pts; ++pt)
-        sum += scalar_product(gradu_i[pt],gradu_j[pt]) * w_meas[pt];
+  auto &scratch = scalar_products_scratch_;
+  scratch.gradients.fill(gradu,this->get_local_dofs_view(dofs_property));
 
-      M(i,j) = sum;
-    } // end loop j
-
-    for (int j = 0; j < i; ++j)
-      M(i,j) = M(j,i);
-  } // end loop i
-
-  return M;
+  return integrate_scalar_products(scratch.gradients,w_meas,scratch.w_u_i,scratch.M_i);
 #else
   return this->integrate_gradu_gradv_sum_factorization_impl(
            Topology<sdim>(),s_id,dofs_property);
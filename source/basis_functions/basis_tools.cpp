@@ -18,3 +18,94 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //-+--------------------------------------------------------------------
 
+
+#include <igatools/basis_functions/basis_tools.h>
+
+#include <algorithm>
+
+IGA_NAMESPACE_OPEN
+
+namespace basis_tools
+{
+
+bool
+compute_knot_insertion_matrix_1D(
+  const SafeSTLVector<Real> &old_knots,
+  const SafeSTLVector<Real> &new_knots,
+  const int degree,
+  SafeSTLVector<Index> &first_old_basis,
+  SafeSTLVector<Real> &alpha)
+{
+  Assert(degree >= 0, ExcLowerRange(degree,0));
+
+  const int p = degree;
+  const Size n_old = old_knots.size() - p - 1;
+  const Size n_new = new_knots.size() - p - 1;
+  if (n_old < 1 || n_new < n_old)
+    return false;
+
+  // new_knots must contain old_knots (with multiplicities)
+  if (!std::includes(new_knots.begin(), new_knots.end(),
+                     old_knots.begin(), old_knots.end()))
+    return false;
+
+  // parametric domain of the old basis
+  const Real a = old_knots[p];
+  const Real b = old_knots[n_old];
+
+  first_old_basis.resize(n_new);
+  alpha.assign(n_new * (p+1), 0.0);
+
+  SafeSTLVector<Real> b_old(p+1);
+  SafeSTLVector<Real> b_new(p+1);
+  for (Index j = 0 ; j < n_new ; ++j)
+  {
+    // a non-empty interval of the new knots in the support of the j-th new
+    // basis function and inside the domain
+    Index nu = -1;
+    for (Index v = j ; v <= j + p ; ++v)
+    {
+      if (new_knots[v] < new_knots[v+1] &&
+          new_knots[v] >= a && new_knots[v+1] <= b)
+      {
+        nu = v;
+        break;
+      }
+    }
+    if (nu == -1)
+      return false;
+
+    // the (unique) interval of the old knots containing it
+    Index mu = p;
+    for (Index i = p ; i < n_old ; ++i)
+      if (old_knots[i] <= new_knots[nu] && old_knots[i] < old_knots[i+1])
+        mu = i;
+
+    // Oslo recurrence: the coefficients of the j-th new basis function are
+    // the blossoms of the old basis functions mu-p,...,mu evaluated at
+    // new_knots[j+1],...,new_knots[j+p]
+    b_old[0] = 1.0;
+    for (int k = 1 ; k <= p ; ++k)
+    {
+      const Real x = new_knots[j+k];
+      std::fill(b_new.begin(), b_new.begin() + k + 1, 0.0);
+      for (int r = 0 ; r < k ; ++r)
+      {
+        const Index i = mu - k + 1 + r;
+        const Real w = (x - old_knots[i]) / (old_knots[i+k] - old_knots[i]);
+        b_new[r]   += (1.0 - w) * b_old[r];
+        b_new[r+1] += w * b_old[r];
+      }
+      std::swap(b_old, b_new);
+    }
+
+    first_old_basis[j] = mu - p;
+    std::copy(b_old.begin(), b_old.begin() + p + 1, alpha.begin() + j * (p+1));
+  }
+
+  return true;
+}
+
+}
+
+IGA_NAMESPACE_CLOSE
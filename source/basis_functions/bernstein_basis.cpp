@@ -21,43 +21,219 @@
 
 #include <igatools/basis_functions/bernstein_basis.h>
 
-#include <boost/math/special_functions/binomial.hpp>
-#include <boost/numeric/ublas/matrix_proxy.hpp>
-
-using boost::numeric::ublas::row;
-using boost::numeric::ublas::matrix;
-using boost::math::binomial_coefficient;
 
 IGA_NAMESPACE_OPEN
 
+namespace
+{
+/**
+ * Computes the values of the Bernstein's basis of degree @p q
+ * (with q less or equal to the degree used to compute the powers @p t and @p one_t)
+ * and writes them in @p B.
+ */
+inline
+void
+evaluate_from_powers(const int q,
+                     const Real *t,
+                     const Real *one_t,
+                     const int n_points,
+                     Real *B)
+{
+  Real C = 1.0;
+  for (int i = 0 ; i <= q ; ++i)
+  {
+    // C is the binomial coefficient (q i), computed exactly for the degrees of interest
+    if (i > 0)
+      C = (C * (q - i + 1)) / i;
+
+    const Real *t_i = t + i * n_points;
+    const Real *one_t_q_i = one_t + (q-i) * n_points;
+    Real *B_i = B + i * n_points;
+    for (int j = 0 ; j < n_points ; ++j)
+      B_i[j] = C * t_i[j] * one_t_q_i[j];
+  }
+}
 
 
-DenseVector
-BernsteinBasis::evaluate(const int p, const Real x)
+/**
+ * Computes the derivatives of the Bernstein's basis of degree <tt>q</tt>
+ * from the derivatives (of one order less) of the Bernstein's basis of degree <tt>q-1</tt>,
+ * using the formula
+ * dB^q_i = q * ( dB^{q-1}_{i-1} - dB^{q-1}_{i}).
+ */
+inline
+void
+derivative_from_lower_degree(const int q,
+                             const Real *B,
+                             const int n_points,
+                             Real *dB)
 {
-  Assert(x >= 0.0 && x <= 1.0,
-         ExcMessage("Point not in the unit interval [0,1]"));
-  Assert(p >= 0, ExcLowerRange(p,0));
+  const Real *B_first = B;
+  const Real *B_last = B + (q-1) * n_points;
+  Real *dB_first = dB;
+  Real *dB_last = dB + q * n_points;
+  for (int j = 0 ; j < n_points ; ++j)
+  {
+    dB_first[j] = (- B_first[j]) * q;
+    dB_last[j] = B_last[j] * q;
+  }
 
-  const int n_basis = p + 1 ;
+  for (int i = 1 ; i < q ; ++i)
+  {
+    const Real *B_i_1 = B + (i-1) * n_points;
+    const Real *B_i = B + i * n_points;
+    Real *dB_i = dB + i * n_points;
+    for (int j = 0 ; j < n_points ; ++j)
+      dB_i[j] = (B_i_1[j] - B_i[j]) * q;
+  }
+}
+
+
+/**
+ * Implementation of BernsteinBasis::evaluate_derivatives().
+ * If the template argument @p P is non-negative, it is used as (compile-time) degree,
+ * otherwise the (run-time) degree @p p_rt is used.
+ */
+template <int P>
+void
+evaluate_derivatives_impl(const int p_rt,
+                          const int n_orders,
+                          const Real *x,
+                          const int n_points,
+                          Real *D_B,
+                          Real *work)
+{
+  const int p = (P >= 0) ? P : p_rt;
+  const int n_basis = p + 1;
+  const Size table_size = n_basis * n_points;
+
+  Real *t = work;
+  Real *one_t = t + table_size;
+  Real *buffer[2] = {one_t + table_size, one_t + 2 * table_size};
+
+  /*
+   * First we compute 2 tables where in each row we store
+   * 1 1 1, t t t, t^2 t^2 t^2, ...
+   * 1 1 1, 1-t 1-t 1-t, (1-t)^2 (1-t)^2 (1-t)^2, ...
+   */
+  for (int j = 0 ; j < n_points ; ++j)
+  {
+    t[j] = 1.0;
+    one_t[j] = 1.0;
+  }
+  for (int i = 1 ; i < n_basis ; ++i)
+  {
+    const Real *t_prev = t + (i-1) * n_points;
+    const Real *one_t_prev = one_t + (i-1) * n_points;
+    Real *t_i = t + i * n_points;
+    Real *one_t_i = one_t + i * n_points;
+    for (int j = 0 ; j < n_points ; ++j)
+    {
+      t_i[j] = t_prev[j] * x[j];
+      one_t_i[j] = one_t_prev[j] * (1. - x[j]);
+    }
+  }
 
-  DenseVector B(n_basis);
+  for (int k = 0 ; k < n_orders ; ++k)
+  {
+    Real *D_B_k = D_B + k * table_size;
 
-  boost::numeric::ublas::scalar_vector<Real> ones(n_basis,1.0);
-  boost::numeric::ublas::vector<Real> t(ones);
-  boost::numeric::ublas::vector<Real> one_t(ones);
+    if (k == 0)
+    {
+      evaluate_from_powers(p,t,one_t,n_points,D_B_k);
+      continue;
+    }
 
-  for (int k = 1 ; k < n_basis ; ++k)
-    for (int i = k ; i < n_basis ; ++i)
+    /*
+     * The k-th derivative of the basis of degree p is obtained applying k times the
+     * recursion formula, starting from the values of the basis of degree p-k
+     * (or from zero, at degree 0, if k > p).
+     */
+    const int q_start = std::max(p - k, 0);
+    const int n_levels = p - q_start;
+
+    Real *B = (n_levels == 0) ? D_B_k : buffer[n_levels % 2];
+    if (k <= p)
+      evaluate_from_powers(q_start,t,one_t,n_points,B);
+    else
+      for (int j = 0 ; j < n_points ; ++j)
+        B[j] = 0.0;
+
+    for (int q = q_start + 1 ; q <= p ; ++q)
     {
-      t(i)     *= x;
-      one_t(i) *= 1.-x;
+      Real *dB = (q == p) ? D_B_k : buffer[(p - q) % 2];
+      derivative_from_lower_degree(q,B,n_points,dB);
+      B = dB;
     }
+  } // end loop k
+}
+
+} // end anonymous namespace
+
+
+
+Size
+BernsteinBasis::get_work_size(const int p, const int n_points)
+{
+  Assert(p >= 0, ExcLowerRange(p,0));
+  Assert(n_points >= 0, ExcLowerRange(n_points,0));
+
+  return 4 * (p + 1) * n_points;
+}
+
 
-  for (int i = 0 ; i < n_basis ; ++i)
-    B(i) = binomial_coefficient<Real>(p,i) * t(i) * one_t(p-i) ;
 
-  return B;
+void
+BernsteinBasis::evaluate_derivatives(const int p,
+                                     const int n_orders,
+                                     const Real *x,
+                                     const int n_points,
+                                     Real *D_B,
+                                     Real *work)
+{
+  Assert(p >= 0, ExcLowerRange(p,0));
+  Assert(n_orders >= 1, ExcLowerRange(n_orders,1));
+  Assert(n_points >= 0, ExcLowerRange(n_points,0));
+  Assert(n_points == 0 || (x != nullptr && D_B != nullptr && work != nullptr),
+         ExcNullPtr());
+
+#ifndef NDEBUG
+  for (int j = 0 ; j < n_points ; ++j)
+    Assert(x[j] >= 0.0 && x[j] <= 1.0,
+           ExcMessage("Point " + std::to_string(j) + "not in the unit interval [0,1]"));
+#endif
+
+  switch (p)
+  {
+    case 1:
+      evaluate_derivatives_impl<1>(p,n_orders,x,n_points,D_B,work);
+      break;
+    case 2:
+      evaluate_derivatives_impl<2>(p,n_orders,x,n_points,D_B,work);
+      break;
+    case 3:
+      evaluate_derivatives_impl<3>(p,n_orders,x,n_points,D_B,work);
+      break;
+    case 4:
+      evaluate_derivatives_impl<4>(p,n_orders,x,n_points,D_B,work);
+      break;
+    case 5:
+      evaluate_derivatives_impl<5>(p,n_orders,x,n_points,D_B,work);
+      break;
+    case 6:
+      evaluate_derivatives_impl<6>(p,n_orders,x,n_points,D_B,work);
+      break;
+    default:
+      evaluate_derivatives_impl<-1>(p,n_orders,x,n_points,D_B,work);
+  }
+}
+
+
+
+DenseVector
+BernsteinBasis::evaluate(const int p, const Real x)
+{
+  return BernsteinBasis::derivative(0,p,x);
 }
 
 DenseVector
@@ -75,79 +251,21 @@ BernsteinBasis::derivative(
 
   const int n_basis = p + 1 ;
 
+  SafeSTLVector<Real> D_B((order + 1) * n_basis);
+  SafeSTLVector<Real> work(get_work_size(p,1));
+  evaluate_derivatives(p,order+1,&x,1,D_B.data(),work.data());
 
-  if (order > 0)
-  {
-    /*
-     * To compute derivatives we use the recusion formula
-     * dB^k = p* ( dB^{k-1}_{i-1} - dB^{k-1}_{i}).
-     * To stop the recusion we specialize to the function evaluation in
-     * derivative<0>.
-     */
-    if (p==0)
-      return boost::numeric::ublas::zero_vector<Real>(n_basis);
-
-    DenseVector dB(n_basis);
-    DenseVector B = BernsteinBasis::derivative(order-1,p-1,x);
-
-    dB(0) = - B(0);
-    dB(p) =   B(p-1);
-    for (int i = 1 ; i < p ; ++i)
-      dB(i) = B(i-1) - B(i);
-
-    dB *= p;
+  DenseVector dB(n_basis);
+  std::copy(D_B.begin() + order * n_basis, D_B.end(), dB.begin());
 
-    return dB;
-  } // end if (order > 0)
-  else
-  {
-    return BernsteinBasis::evaluate(p,x);
-  } // end if (order == 0)
+  return dB;
 }
 
 
 DenseMatrix
 BernsteinBasis::evaluate(const int p,  const SafeSTLVector<Real> &points)
 {
-  /*
-   * First we compute 2 table where each colum we store
-   * 1 1 1, t t t, t^2 t^2 t^2, ...
-   * 1 1 1, 1-t 1-t 1-t, (1-t)^2 (1-t)^2 (1-t)^2, ...
-   *
-   */
-  const int n_points = points.size() ;
-  const int n_basis  = p + 1 ;
-
-#ifndef NDEBUG
-  for (int i = 0 ; i < n_points ; ++i)
-    Assert(points[i] >= 0.0 && points[i] <= 1.0,
-           ExcMessage("Point " + std::to_string(i) + "not in the unit interval [0,1]"));
-#endif
-
-  DenseMatrix B(n_basis, n_points);
-
-  boost::numeric::ublas::scalar_matrix<Real> ones(n_basis,n_points,1.);
-  matrix<Real> t(ones);
-  matrix<Real> one_t(ones);
-
-
-  for (int k = 1 ; k < n_basis ; ++k)
-    for (int i = k ; i < n_basis ; ++i)
-      for (int j = 0 ; j < n_points ; ++j)
-      {
-        t(i,j)   *= points[j];
-        one_t(i,j) *= 1.-points[j];
-      }
-
-
-  for (int i = 0 ; i < n_basis ; ++i)
-  {
-    const Real C = binomial_coefficient<Real>(p, i);
-    for (int j = 0 ; j < n_points ; ++j)
-      B(i,j) = C * t(i,j) * one_t(p-i,j) ;
-  }
-
-  return (B);
+  return derivative(0, p, points);
 }
 
 DenseMatrix
@@ -156,41 +274,22 @@ BernsteinBasis::derivative(
   const int p,
   const SafeSTLVector< Real > &points)
 {
-  if (order > 0)
-  {
-    /*
-     * To compute derivatives we use the recusion formula
-     * dB^k = p* ( dB^{k-1}_{i-1} - dB^{k-1}_{i}).
-     * To stop the recusion we specialize to the function evaluation in
-     * derivative<0>.
-     */
-    const int n_points = points.size() ;
+  Assert(p >= 0, ExcLowerRange(p,0));
 
-#ifndef NDEBUG
-    for (int i = 0 ; i < n_points ; ++i)
-      Assert(points[i] >= 0.0 && points[i] <= 1.0,
-             ExcMessage("Point " + std::to_string(i) + "not in the unit interval [0,1]"));
-#endif
+  Assert(order >= 0, ExcLowerRange(order,0));
 
-    if (p==0)
-      return (boost::numeric::ublas::zero_matrix<Real>(p+1,n_points));
+  const int n_points = points.size() ;
+  const int n_basis  = p + 1 ;
 
-    DenseMatrix dB(p+1, n_points);
-//        matrix<Real> B(p, n_points);
-    const auto B = derivative(order-1,p-1,points);
+  SafeSTLVector<Real> D_B((order + 1) * n_basis * n_points);
+  SafeSTLVector<Real> work(get_work_size(p,n_points));
+  evaluate_derivatives(p,order+1,points.data(),n_points,D_B.data(),work.data());
 
-    row(dB,0) = - row(B,0);
-    row(dB,p) =   row(B,p-1);
-    for (int i = 1 ; i < p ; ++i)
-      row(dB,i) = row(B,i-1) - row(B,i);
+  // the DenseMatrix is stored row-major, as the entries of D_B
+  DenseMatrix dB(n_basis, n_points);
+  std::copy(D_B.begin() + order * n_basis * n_points, D_B.end(), dB.data().begin());
 
-    dB *= p;
-    return (dB);
-  }
-  else
-  {
-    return evaluate(p, points) ;
-  }
+  return dB;
 }
 
 
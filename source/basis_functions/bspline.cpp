@@ -20,10 +20,14 @@
 
 #include <igatools/basis_functions/bspline.h>
 #include <igatools/basis_functions/bspline_handler.h>
+#include <igatools/basis_functions/bernstein_basis.h>
 #include <igatools/functions/sub_function.h>
 #include <igatools/basis_functions/space_tools.h>
 //#include <igatools/functions/grid_function_lib.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 using std::endl;
 
@@ -455,6 +459,101 @@ get_end_behaviour_table() const -> const EndBehaviourTable &
 }
 
 
+template<int dim_, int range_, int rank_>
+void
+BSpline<dim_, range_, rank_>::
+evaluate_splines_1D(const int comp,
+                    const int dir,
+                    const Index interval_id,
+                    const SafeSTLVector<Real> &pt_coords_internal,
+                    BasisValues1d &splines_1D) const
+{
+  Assert(dir >= 0 && dir < dim_, ExcIndexRange(dir,0,dim_));
+
+  const auto &grid = *this->get_grid();
+  const Size n_intervals = grid.get_num_intervals()[dir];
+  Assert(interval_id >= 0 && interval_id < n_intervals,
+         ExcIndexRange(interval_id,0,n_intervals));
+
+  const auto &knots = grid.get_knot_coordinates(dir);
+  const Real interval_length = knots[interval_id+1] - knots[interval_id];
+
+  const auto &oper = operators_.get_operator(dir,interval_id,comp);
+  const int deg = spline_space_->get_degree_table()[comp][dir];
+  const auto &end_interval_comp_dir = end_interval_[comp][dir];
+
+  const int n_pts_1D = pt_coords_internal.size();
+
+  Real alpha;
+
+  SafeSTLVector<Real> pt_coords_boundary(n_pts_1D);
+
+  const SafeSTLVector<Real> *pt_coords_ptr = nullptr;
+
+  if (interval_id == 0) // processing the leftmost interval
+  {
+    // first interval (i.e. left-most interval)
+
+    alpha = end_interval_comp_dir[0];
+    const Real one_minus_alpha = 1. - alpha;
+
+    for (int ipt = 0 ; ipt < n_pts_1D ; ++ipt)
+      pt_coords_boundary[ipt] = one_minus_alpha +
+                                pt_coords_internal[ipt] * alpha;
+
+    pt_coords_ptr = &pt_coords_boundary;
+  } // end process_interval_left
+  else if (interval_id == n_intervals-1) // processing the rightmost interval
+  {
+    // last interval (i.e. right-most interval)
+
+    alpha = end_interval_comp_dir[1];
+
+    for (int ipt = 0 ; ipt < n_pts_1D ; ++ipt)
+      pt_coords_boundary[ipt] = pt_coords_internal[ipt] *
+                                alpha;
+
+    pt_coords_ptr = &pt_coords_boundary;
+  } // end process_interval_right
+  else
+  {
+    // internal interval
+
+    alpha = 1.0;
+
+    pt_coords_ptr = &pt_coords_internal;
+  } // end process_interval_internal
+
+
+  const Real alpha_div_interval_length = alpha / interval_length;
+
+  // all the derivatives of the Bernstein polynomials are computed in a single pass
+  const int n_orders = MAX_NUM_DERIVATIVES;
+  const int n_basis = deg + 1;
+  SafeSTLVector<Real> bernstein_derivatives(n_orders * n_basis * n_pts_1D);
+  SafeSTLVector<Real> work(BernsteinBasis::get_work_size(deg,n_pts_1D));
+  BernsteinBasis::evaluate_derivatives(deg, n_orders,
+                                       pt_coords_ptr->data(), n_pts_1D,
+                                       bernstein_derivatives.data(), work.data());
+
+  DenseMatrix bernstein_values(n_basis, n_pts_1D);
+  for (int order = 0; order < n_orders; ++order)
+  {
+    const Real scaling_factor = std::pow(alpha_div_interval_length, order);
+
+    const auto bernstein_derivatives_order =
+      bernstein_derivatives.begin() + order * n_basis * n_pts_1D;
+    std::copy(bernstein_derivatives_order,
+              bernstein_derivatives_order + n_basis * n_pts_1D,
+              bernstein_values.data().begin());
+
+    auto &splines = splines_1D.get_derivative(order);
+    splines = oper.scale_action(scaling_factor,bernstein_values);
+  } // end loop order
+}
+
+
+
 template<int dim_, int range_, int rank_>
 bool
 BSpline<dim_, range_, rank_>::
@@ -156,6 +156,96 @@ public:
 };
 
 
+
+/**
+ * Returns the univariate orders of the partial derivatives needed for the
+ * values (if @p values is TRUE), the gradients (if @p gradients is TRUE) and
+ * the hessians (if @p hessians is TRUE) of a tensor-product function, without
+ * the ones equal by symmetry.
+ */
+template <int dim>
+SafeSTLVector<TensorIndex<dim>>
+derivative_orders(const bool values, const bool gradients, const bool hessians)
+{
+  SafeSTLVector<TensorIndex<dim>> orders;
+  if (values)
+    orders.emplace_back(TensorIndex<dim>());
+  if (gradients)
+  {
+    const TensorFunctionDerivativesSymmetry<dim,1> sym;
+    orders.insert(orders.end(), sym.univariate_order.begin(), sym.univariate_order.end());
+  }
+  if (hessians)
+  {
+    const TensorFunctionDerivativesSymmetry<dim,2> sym;
+    orders.insert(orders.end(), sym.univariate_order.begin(), sym.univariate_order.end());
+  }
+  return orders;
+}
+
+
+
+/**
+ * Copies the values of the active components to the inactive ones.
+ */
+template <class Value, int n_components>
+void
+copy_batch_values_to_inactive_components(const SafeSTLVector<Index> &inactive_comp,
+                                         const SafeSTLArray<Index,n_components> &active_map,
+                                         const SafeSTLArray<Index,n_components+1> &comp_offset,
+                                         ValueTable<Value> &phi)
+{
+  const int n_points = phi.get_num_points();
+  for (int comp : inactive_comp)
+  {
+    const auto act_comp = active_map[comp];
+    const int n_basis_comp = comp_offset[act_comp+1] - comp_offset[act_comp];
+    for (int basis_i = 0 ; basis_i < n_basis_comp ; ++basis_i)
+    {
+      const auto act_phi = phi.get_function_view(comp_offset[act_comp]+basis_i);
+      auto     inact_phi = phi.get_function_view(comp_offset[comp]+basis_i);
+
+      for (int pt = 0 ; pt < n_points ; ++pt)
+        inact_phi[pt](comp) = act_phi[pt](act_comp);
+    } // end loop basis_i
+  } // end loop comp
+}
+
+
+
+/**
+ * Copies the derivatives of the active components to the inactive ones.
+ */
+template <class Derivative, int n_components>
+void
+copy_batch_derivatives_to_inactive_components(const SafeSTLVector<Index> &inactive_comp,
+                                              const SafeSTLArray<Index,n_components> &active_map,
+                                              const SafeSTLArray<Index,n_components+1> &comp_offset,
+                                              ValueTable<Derivative> &D_phi)
+{
+  const int n_points = D_phi.get_num_points();
+  const int n_ders = Derivative::size;
+  for (int comp : inactive_comp)
+  {
+    const auto act_comp = active_map[comp];
+    const int n_basis_comp = comp_offset[act_comp+1] - comp_offset[act_comp];
+    for (int basis_i = 0 ; basis_i < n_basis_comp ; ++basis_i)
+    {
+      const auto act_D_phi = D_phi.get_function_view(comp_offset[act_comp]+basis_i);
+      auto     inact_D_phi = D_phi.get_function_view(comp_offset[comp]+basis_i);
+
+      for (int pt = 0 ; pt < n_points ; ++pt)
+      {
+        const auto &act_D_phi_pt = act_D_phi[pt];
+        auto &inact_D_phi_pt = inact_D_phi[pt];
+
+        for (int der = 0 ; der < n_ders ; ++der)
+          inact_D_phi_pt(der)(comp) = act_D_phi_pt(der)(act_comp);
+      } // end loop pt
+    } // end loop basis_i
+  } // end loop comp
+}
+
 } // of the namespace
 
 
@@ -219,10 +309,12 @@ BSplineHandler<dim_, range_, rank_>::
 InitCacheDispatcher::
 InitCacheDispatcher(const GridHandler<dim_> &grid_handler,
                     const SafeSTLArray<typename basis_element::Flags, dim+1> &flags,
+                    SafeSTLArray<std::shared_ptr<const GlobalCache>,dim+1> *global_cache,
                     BSplineElem &elem)
   :
   grid_handler_(grid_handler),
   flags_(flags),
+  global_cache_(global_cache),
   bsp_elem_(elem)
 {}
 
@@ -305,6 +397,16 @@ operator()(const std::shared_ptr<const Quadrature<sdim>> &quad)
   init_cache_1D<sdim>();
 
   init_cache_multiD<sdim>();
+
+  if (global_cache_ != nullptr)
+  {
+    const auto &bsp_basis = dynamic_cast<const Basis &>(*bsp_elem_.get_basis());
+
+    auto &global_cache_sdim = (*global_cache_)[sdim];
+    if (global_cache_sdim == nullptr ||
+        !global_cache_sdim->is_built_for(bsp_basis,quad))
+      global_cache_sdim = std::make_shared<const GlobalCache>(bsp_basis,quad);
+  }
 }
 
 
@@ -318,6 +420,7 @@ init_cache_impl(BaseElem &elem,
     InitCacheDispatcher(
       this->grid_handler_,
       this->flags_,
+      use_global_cache_ ? &global_cache_ : nullptr,
       dynamic_cast<BSplineElem &>(elem));
   boost::apply_visitor(init_cache_dispatcher,quad);
 }
@@ -329,10 +432,12 @@ BSplineHandler<dim_, range_, rank_>::
 FillCacheDispatcherNoGlobalCache::
 FillCacheDispatcherNoGlobalCache(const int s_id,
                                  const GridHandler<dim_> &grid_handler,
+                                 SafeSTLArray<SafeSTLVector<BlockEvaluators>,dim+1> &block_evaluators,
                                  BSplineElem &elem)
   :
   s_id_(s_id),
   grid_handler_(grid_handler),
+  block_evaluators_(block_evaluators),
   bsp_elem_(elem)
 {}
 
@@ -424,7 +529,7 @@ void
 BSplineHandler<dim, range, rank>::
 FillCacheDispatcherNoGlobalCache::
 evaluate_bspline_values(
-  const ComponentContainer<std::unique_ptr<const TensorProductFunctionEvaluator<dim>>> &elem_values,
+  const BlockEvaluators &elem_values,
   ValueTable<Value> &phi) const
 {
   const auto &comp_offset = bsp_elem_.get_basis_offset();
@@ -435,19 +540,21 @@ evaluate_bspline_values(
 
   const Size n_points = phi.get_num_points();
   const TensorIndex<dim> der_tensor_id; // [0,0,..,0] tensor index
+  std::vector<Real> block(n_points);
   for (int comp : elem_values.get_active_components_id())
   {
     const auto &values = *elem_values[comp];
     const int n_basis_comp = bsp_elem_.get_num_basis_comp(comp);
     const Size offset = comp_offset[comp];
+    const int order_id = values.get_order_id(der_tensor_id);
 
     for (int func_id = 0; func_id < n_basis_comp; ++func_id)
     {
       auto phi_i = phi.get_function_view(offset + func_id);
-      auto const &func_tensor_id = values.func_flat_to_tensor(func_id);
+      values.evaluate_block(order_id, func_id, block.data());
 
       for (int pt = 0; pt < n_points; ++pt)
-        phi_i[pt](comp) = values.evaluate(der_tensor_id, func_tensor_id, pt);
+        phi_i[pt](comp) = block[pt];
     } // end func_id loop
   } // end comp loop
 
@@ -466,7 +573,7 @@ void
 BSplineHandler<dim, range, rank>::
 FillCacheDispatcherNoGlobalCache::
 evaluate_bspline_derivatives(
-  const ComponentContainer<std::unique_ptr<const TensorProductFunctionEvaluator<dim>>> &elem_values,
+  const BlockEvaluators &elem_values,
   ValueTable<Derivative<order>> &D_phi) const
 {
   /*
@@ -492,21 +599,24 @@ evaluate_bspline_derivatives(
   const auto &univariate_order = sym.univariate_order ;
   const auto &copy_indices = sym.copy_indices;
 
+  std::vector<Real> block(n_points);
   for (int comp : elem_values.get_active_components_id())
   {
     const auto &values = *elem_values[comp];
     const int n_basis_comp = bsp_elem_.get_num_basis_comp(comp);
     const int offset = comp_offset[comp];
 
+    SafeSTLArray<int,n_der> order_id;
+    for (int der_id = 0 ; der_id < n_der ; ++der_id)
+      order_id[der_id] = values.get_order_id(univariate_order[der_id]);
+
     for (int func_id = 0 ; func_id < n_basis_comp; ++func_id)
     {
       auto D_phi_i = D_phi.get_function_view(offset + func_id);
 
-      auto const &func_tensor_id = values.func_flat_to_tensor(func_id);
-
       for (int der_id = 0 ; der_id < n_der ; ++der_id)
       {
-        auto const &der_tensor_id = univariate_order[der_id];
+        values.evaluate_block(order_id[der_id], func_id, block.data());
 
         const auto &copy_indices_der = copy_indices[der_id];
 //                const auto copy_indices_der_size = copy_indices_der.size();
@@ -520,7 +630,7 @@ evaluate_bspline_derivatives(
           auto &der = D_phi_i[pt];
           Real &der_copy_indices_der_0_comp = der(copy_indices_der_0)(comp);
 
-          der_copy_indices_der_0_comp = values.evaluate(der_tensor_id, func_tensor_id, pt);
+          der_copy_indices_der_0_comp = block[pt];
 
 //                    for (int k = 1 ; k < copy_indices_der_size ; ++k)
 //                        der(copy_indices_der[k])(comp) = der_copy_indices_der_0_comp;
@@ -556,25 +666,14 @@ fill_cache_1D(const Quadrature<dim> &extended_sub_elem_quad)
   //--------------------------------------------------------------------------------------
   // filling the 1D cache --- begin
 
-  const auto &grid = *grid_elem.get_grid();
-  const auto n_inter = grid.get_num_intervals();
-
-  const auto elem_size = grid_elem.template get_side_lengths<dim>(0);
   const auto &elem_tensor_id = grid_elem.get_index().get_tensor_index();
 
   const auto &bsp_basis = dynamic_cast<const Basis &>(*bsp_elem_.get_basis());
 
   const auto &spline_space = *bsp_basis.spline_space_;
 
-  const auto &degree = spline_space.get_degree_table();
-
   const auto &active_components_id = spline_space.get_active_components_id();
 
-  const auto &n_coords = extended_sub_elem_quad.get_num_coords_direction();
-
-  const auto &bezier_op   = bsp_basis.operators_;
-  const auto &end_interval = bsp_basis.end_interval_;
-
   auto &splines_1D_table_subelems = bsp_elem_.all_splines_1D_table_[sdim];
   auto &splines_1D_table = splines_1D_table_subelems[s_id_];
 
@@ -582,77 +681,13 @@ fill_cache_1D(const Quadrature<dim> &extended_sub_elem_quad)
   {
     const auto &pt_coords_internal = extended_sub_elem_quad.get_coords_direction(dir);
 
-    const auto len = elem_size[dir];
-
     const auto interval_id = elem_tensor_id[dir];
 
-    Real alpha;
-
-    const int n_pts_1D = n_coords[dir];
-
-    SafeSTLVector<Real> pt_coords_boundary(n_pts_1D);
-
-    const SafeSTLVector<Real> *pt_coords_ptr = nullptr;
-
     for (auto comp : active_components_id)
     {
-      const auto &end_interval_comp_dir = end_interval[comp][dir];
-
-      if (interval_id == 0) // processing the leftmost interval
-      {
-        // first interval (i.e. left-most interval)
-
-        alpha = end_interval_comp_dir[0];
-        const Real one_minus_alpha = 1. - alpha;
-
-        for (int ipt = 0 ; ipt < n_pts_1D ; ++ipt)
-          pt_coords_boundary[ipt] = one_minus_alpha +
-                                    pt_coords_internal[ipt] * alpha;
-
-        pt_coords_ptr = &pt_coords_boundary;
-      } // end process_interval_left
-      else if (interval_id == n_inter[dir]-1) // processing the rightmost interval
-      {
-        // last interval (i.e. right-most interval)
-
-        alpha = end_interval_comp_dir[1];
-
-        for (int ipt = 0 ; ipt < n_pts_1D ; ++ipt)
-          pt_coords_boundary[ipt] = pt_coords_internal[ipt] *
-                                    alpha;
-
-        pt_coords_ptr = &pt_coords_boundary;
-      } // end process_interval_right
-      else
-      {
-        // internal interval
-
-        alpha = 1.0;
-
-        pt_coords_ptr = &pt_coords_internal;
-      } // end process_interval_internal
-
-
-      const Real alpha_div_interval_length = alpha / len;
-
-      const auto &oper = bezier_op.get_operator(dir,interval_id,comp);
-
-      //------------------------------------------------------------
-      //resize_and_fill_bernstein_values
-      const int deg = degree[comp][dir];
-
-      auto &splines_1D_comp = splines_1D_table[comp];
-      auto &splines_1D = splines_1D_comp[dir];
-      for (int order = 0; order < MAX_NUM_DERIVATIVES; ++order)
-      {
-        const Real scaling_factor = std::pow(alpha_div_interval_length, order);
-        const auto &bernstein_values = BernsteinBasis::derivative(order, deg,*pt_coords_ptr);
-
-        auto &splines = splines_1D.get_derivative(order);
-        splines = oper.scale_action(scaling_factor,bernstein_values);
-      } // end loop order
-      //------------------------------------------------------------
-
+      bsp_basis.evaluate_splines_1D(comp,dir,interval_id,
+                                    pt_coords_internal,
+                                    splines_1D_table[comp][dir]);
     } // end loop comp
 
   } // end loop dir
@@ -673,11 +708,42 @@ fill_cache_multiD(const Quadrature<dim> &extended_sub_elem_quad)
   const auto &splines_1D_table_subelems = bsp_elem_.all_splines_1D_table_[sdim];
   const auto &splines_1D_table = splines_1D_table_subelems[s_id_];
 
-  using TPFE = const TensorProductFunctionEvaluator<dim>;
-  ComponentContainer<std::unique_ptr<TPFE>> val_1d(splines_1D_table.get_comp_map());
+  auto &sub_elem_cache =
+    bsp_elem_.all_sub_elems_cache_.template get_sub_elem_cache<sdim>(s_id_);
+
+  using Elem = BasisElement<dim_,0,range_,rank_>;
+  using _Value      = typename Elem::_Value;
+  using _Gradient   = typename Elem::_Gradient;
+  using _Hessian    = typename Elem::_Hessian;
+  using _Divergence = typename Elem::_Divergence;
+
+  const auto orders =
+    derivative_orders<dim>(sub_elem_cache.template status_fill<_Value>(),
+                           sub_elem_cache.template status_fill<_Gradient>(),
+                           sub_elem_cache.template status_fill<_Hessian>());
+
+  auto &block_evaluators_subelems = block_evaluators_[sdim];
+  if (block_evaluators_subelems.size() <= s_id_)
+    block_evaluators_subelems.resize(s_id_+1);
+
+  auto &val_1d = block_evaluators_subelems[s_id_];
+  if (val_1d.get_comp_map() != splines_1D_table.get_comp_map())
+    val_1d = BlockEvaluators(splines_1D_table.get_comp_map());
 
   for (auto c : val_1d.get_active_components_id())
-    val_1d[c] = std::make_unique<TPFE>(extended_sub_elem_quad,splines_1D_table[c]);
+  {
+    TensorSize<dim> n_funcs;
+    for (int dir = 0 ; dir < dim ; ++dir)
+      n_funcs[dir] = splines_1D_table[c][dir].get_num_functions();
+
+    auto &evaluator = val_1d[c];
+    if (evaluator == nullptr ||
+        !evaluator->is_set_up_for(n_funcs,extended_sub_elem_quad,orders))
+      evaluator = std::make_unique<TensorProductBlockEvaluator<dim>>(
+                    n_funcs,extended_sub_elem_quad,orders);
+
+    evaluator->update(splines_1D_table[c]);
+  }
 
   // Multi-variate spline evaluation from 1D values --- end
   //-------------------------------------------------------------------------------
@@ -686,15 +752,6 @@ fill_cache_multiD(const Quadrature<dim> &extended_sub_elem_quad)
 
 
   //-------------------------------------------------------------------------------
-  auto &sub_elem_cache =
-    bsp_elem_.all_sub_elems_cache_.template get_sub_elem_cache<sdim>(s_id_);
-
-
-  using Elem = BasisElement<dim_,0,range_,rank_>;
-  using _Value      = typename Elem::_Value;
-  using _Gradient   = typename Elem::_Gradient;
-  using _Hessian    = typename Elem::_Hessian;
-  using _Divergence = typename Elem::_Divergence;
 
   if (sub_elem_cache.template status_fill<_Value>())
   {
@@ -736,10 +793,8 @@ operator()(const Topology<sdim> &topology)
   auto &grid_elem = bsp_elem_.get_grid_element();
   grid_handler_.template fill_cache<sdim>(grid_elem,s_id_);
 
-  const auto extended_sub_elem_quad =
-    extend_sub_elem_quad<sdim,dim>(
-      *grid_elem.template get_quad<sdim>(),
-      s_id_);
+  const auto &extended_sub_elem_quad =
+    grid_elem.template get_extended_quad<sdim>(s_id_);
 
   fill_cache_1D<sdim>(extended_sub_elem_quad);
 
@@ -748,6 +803,59 @@ operator()(const Topology<sdim> &topology)
 
 
 
+template <int dim_, int range_, int rank_>
+BSplineHandler<dim_, range_, rank_>::
+FillCacheDispatcherGlobalCache::
+FillCacheDispatcherGlobalCache(const int s_id,
+                               const GridHandler<dim_> &grid_handler,
+                               const SafeSTLArray<std::shared_ptr<const GlobalCache>,dim+1> &global_cache,
+                               SafeSTLArray<SafeSTLVector<BlockEvaluators>,dim+1> &block_evaluators,
+                               BSplineElem &elem)
+  :
+  FillCacheDispatcherNoGlobalCache(s_id,grid_handler,block_evaluators,elem),
+  global_cache_(global_cache)
+{}
+
+template<int dim_, int range_ , int rank_>
+template<int sdim>
+void
+BSplineHandler<dim_, range_, rank_>::
+FillCacheDispatcherGlobalCache::
+operator()(const Topology<sdim> &topology)
+{
+  const auto s_id = this->s_id_;
+  auto &bsp_elem = this->bsp_elem_;
+
+  auto &grid_elem = bsp_elem.get_grid_element();
+  this->grid_handler_.template fill_cache<sdim>(grid_elem,s_id);
+
+  const auto &global_cache = global_cache_[sdim];
+  Assert(global_cache != nullptr,
+         ExcMessage("The global cache is not initialized."));
+
+  const auto &extended_sub_elem_quad =
+    grid_elem.template get_extended_quad<sdim>(s_id);
+
+  //--------------------------------------------------------------------------------------
+  // copying the 1D values from the global cache --- begin
+  const auto &elem_tensor_id = grid_elem.get_index().get_tensor_index();
+
+  auto &splines_1D_table = bsp_elem.all_splines_1D_table_[sdim][s_id];
+  for (const auto comp : splines_1D_table.get_active_components_id())
+  {
+    auto &splines_1D_comp = splines_1D_table[comp];
+    for (const int dir : UnitElement<dim>::active_directions)
+      splines_1D_comp[dir] =
+        global_cache->get_splines_1D(s_id,comp,dir,elem_tensor_id[dir]);
+  } // end loop comp
+  // copying the 1D values from the global cache --- end
+  //-------------------------------------------------------------------------------
+
+  this->template fill_cache_multiD<sdim>(extended_sub_elem_quad);
+}
+
+
+
 template<int dim_, int range_ , int rank_>
 void
 BSplineHandler<dim_, range_, rank_>::
@@ -755,12 +863,27 @@ fill_cache_impl(const topology_variant &topology,
                 BaseElem &elem,
                 const int s_id) const
 {
-  auto fill_cache_dispatcher =
-    FillCacheDispatcherNoGlobalCache(
-      s_id,
-      this->grid_handler_,
-      dynamic_cast<BSplineElem &>(elem));
-  boost::apply_visitor(fill_cache_dispatcher,topology);
+  if (use_global_cache_)
+  {
+    auto fill_cache_dispatcher =
+      FillCacheDispatcherGlobalCache(
+        s_id,
+        this->grid_handler_,
+        global_cache_,
+        block_evaluators_,
+        dynamic_cast<BSplineElem &>(elem));
+    boost::apply_visitor(fill_cache_dispatcher,topology);
+  }
+  else
+  {
+    auto fill_cache_dispatcher =
+      FillCacheDispatcherNoGlobalCache(
+        s_id,
+        this->grid_handler_,
+        block_evaluators_,
+        dynamic_cast<BSplineElem &>(elem));
+    boost::apply_visitor(fill_cache_dispatcher,topology);
+  }
 }
 
 template<int dim_, int range_ , int rank_>
@@ -798,79 +921,354 @@ print_info(LogStream &out) const
 
 
 
-#if 0
 template<int dim_, int range_ , int rank_>
+void
 BSplineHandler<dim_, range_, rank_>::
-GlobalCache::
-GlobalCache(const std::shared_ptr<const Quadrature<dim>> &quad, const ComponentMap &component_map)
-  :
-  quad_(quad),
-  basis_values_1d_table_(BasisValues1dTable(component_map))
-{}
+enable_global_cache(const bool use_global_cache)
+{
+  use_global_cache_ = use_global_cache;
+  if (!use_global_cache_)
+    for (auto &global_cache_sdim : global_cache_)
+      global_cache_sdim.reset();
+}
 
 template<int dim_, int range_ , int rank_>
-auto
+bool
 BSplineHandler<dim_, range_, rank_>::
-GlobalCache::
-entry(const int comp, const int dir, const Index interval_id) -> BasisValues1d &
+is_global_cache_enabled() const
+{
+  return use_global_cache_;
+}
+
+template<int dim_, int range_ , int rank_>
+Size
+BSplineHandler<dim_, range_, rank_>::
+get_num_global_cache_tables(const int sdim) const
 {
-  return basis_values_1d_table_[comp][dir][interval_id];
+  Assert(sdim >= 0 && sdim <= dim, ExcIndexRange(sdim,0,dim+1));
+  const auto &global_cache_sdim = global_cache_[sdim];
+  return (global_cache_sdim != nullptr) ? global_cache_sdim->get_num_tables() : 0;
 }
 
 
+
 template<int dim_, int range_ , int rank_>
 void
 BSplineHandler<dim_, range_, rank_>::
-GlobalCache::
-print_info(LogStream &out) const
+fill_cache_batch(const SafeSTLVector<TensorIndex<dim_>> &elems_tensor_id,
+                 const std::shared_ptr<const Quadrature<dim_>> &quad,
+                 const typename basis_element::Flags &flags,
+                 CacheBatch &batch) const
 {
-  using std::to_string;
-  for (const auto comp : basis_values_1d_table_.get_active_components_id())
+  using Flags = basis_element::Flags;
+  Assert(quad != nullptr, ExcNullPtr());
+  AssertThrow(dim_ > 0, ExcNotImplemented());
+
+  const bool fill_values    = contains(flags,Flags::value);
+  const bool fill_gradients = contains(flags,Flags::gradient);
+  const bool fill_hessians  = contains(flags,Flags::hessian);
+
+  const auto &bsp_basis = *this->get_bspline_basis();
+  const auto &grid = *bsp_basis.get_grid();
+  const auto n_inter = grid.get_num_intervals();
+
+  const auto &spline_space = *bsp_basis.spline_space_;
+  const auto &degree = spline_space.get_degree_table();
+  const auto active_components_id = degree.get_active_components_id();
+  const auto inactive_components_id = degree.get_inactive_components_id();
+  const auto &comp_map = degree.get_comp_map();
+
+  SafeSTLArray<Index,n_components+1> comp_offset;
+  comp_offset[0] = 0;
+  for (int comp = 0 ; comp < n_components ; ++comp)
+    comp_offset[comp+1] = comp_offset[comp] + TensorSize<dim_>(degree[comp]+1).flat_size();
+  const Size n_basis = comp_offset[n_components];
+  const Size n_pts = quad->get_num_points();
+
+
+  //-------------------------------------------------------------------------------
+  const auto orders = derivative_orders<dim_>(fill_values,fill_gradients,fill_hessians);
+  const TensorFunctionDerivativesSymmetry<dim_,1> sym_1;
+  const TensorFunctionDerivativesSymmetry<dim_,2> sym_2;
+
+  // one-dimensional values and evaluator of each active component
+  std::vector<ElemFuncValues<dim_>> splines_1D(n_components);
+  std::vector<std::unique_ptr<TensorProductBlockEvaluator<dim_>>> evaluators(n_components);
+  for (int comp : active_components_id)
+    evaluators[comp] = std::make_unique<TensorProductBlockEvaluator<dim_>>(
+                         TensorSize<dim_>(degree[comp]+1),*quad,orders);
+  //-------------------------------------------------------------------------------
+
+
+  //-------------------------------------------------------------------------------
+  const Size n_elems = elems_tensor_id.size();
+
+  const auto init_tables = [&](auto &tables, const bool fill)
   {
-    out.begin_item("Active Component ID: " + to_string(comp));
+    tables.resize(fill ? n_elems : 0);
+    for (auto &table : tables)
+    {
+      table.resize(n_basis,n_pts);
+
+      // for scalar bases all the entries are overwritten
+      if (n_components > 1)
+        table.zero();
+    }
+  };
+  init_tables(batch.values,fill_values);
+  init_tables(batch.gradients,fill_gradients);
+  init_tables(batch.hessians,fill_hessians);
+  //-------------------------------------------------------------------------------
 
-    for (const int dir : UnitElement<dim_>::active_directions)
+
+  const auto update_splines_1D = [&](const int comp, const int dir, const Index interval_id)
+  {
+    bsp_basis.evaluate_splines_1D(comp,dir,interval_id,
+                                  quad->get_coords_direction(dir),
+                                  splines_1D[comp][dir]);
+  };
+
+  std::vector<Real> block(n_pts);
+  for (Size e = 0 ; e < n_elems ; ++e)
+  {
+    const auto &elem_t_id = elems_tensor_id[e];
+
+#ifndef NDEBUG
+    for (int dir = 0 ; dir < dim_ ; ++dir)
+      Assert(elem_t_id[dir] >= 0 && elem_t_id[dir] < n_inter[dir],
+             ExcIndexRange(elem_t_id[dir],0,n_inter[dir]));
+#endif
+
+    bool new_rest = (e == 0);
+    for (int dir = 1 ; dir < dim_ ; ++dir)
+      new_rest = new_rest || (elem_t_id[dir] != elems_tensor_id[e-1][dir]);
+    const bool new_first_dir = (e == 0) || (elem_t_id[0] != elems_tensor_id[e-1][0]);
+
+    for (int comp : active_components_id)
     {
-      out.begin_item("Direction : " + to_string(dir));
+      auto &evaluator = *evaluators[comp];
 
-      for (const auto &interv_id_and_basis : basis_values_1d_table_[comp][dir])
+      if (new_rest)
       {
-        const auto interval_id = interv_id_and_basis.first;
-        const auto &basis = interv_id_and_basis.second;
+        for (int dir = 1 ; dir < dim_ ; ++dir)
+          update_splines_1D(comp,dir,elem_t_id[dir]);
+        evaluator.update_partial_products(splines_1D[comp]);
+      }
 
-        out.begin_item("Interval ID: " + to_string(interval_id));
-        basis.print_info(out);
-        out.end_item();
+      if (new_first_dir)
+      {
+        update_splines_1D(comp,0,elem_t_id[0]);
+        evaluator.update_first_direction(splines_1D[comp]);
       }
-      out.end_item();
+
+      const int n_basis_comp = comp_offset[comp+1] - comp_offset[comp];
+
+      if (fill_values)
+      {
+        auto &phi = batch.values[e];
+        const int order_id = evaluator.get_order_id(TensorIndex<dim_>());
+        for (int fn = 0 ; fn < n_basis_comp ; ++fn)
+        {
+          auto phi_fn = phi.get_function_view(comp_offset[comp] + fn);
+          evaluator.evaluate_block(order_id,fn,block.data());
+          for (int pt = 0 ; pt < n_pts ; ++pt)
+            phi_fn[pt](comp) = block[pt];
+        }
+      }
+
+      const auto fill_derivatives = [&](auto &D_phi, const auto &sym)
+      {
+        const int n_der = sym.univariate_order.size();
+        std::vector<int> order_id(n_der);
+        for (int der_id = 0 ; der_id < n_der ; ++der_id)
+          order_id[der_id] = evaluator.get_order_id(sym.univariate_order[der_id]);
+
+        for (int fn = 0 ; fn < n_basis_comp ; ++fn)
+        {
+          auto D_phi_fn = D_phi.get_function_view(comp_offset[comp] + fn);
+          for (int der_id = 0 ; der_id < n_der ; ++der_id)
+          {
+            evaluator.evaluate_block(order_id[der_id],fn,block.data());
+            const auto &copy_indices_der = sym.copy_indices[der_id];
+            for (int pt = 0 ; pt < n_pts ; ++pt)
+            {
+              auto &der = D_phi_fn[pt];
+              for (const auto &copy_index : copy_indices_der)
+                der(copy_index)(comp) = block[pt];
+            } // end loop pt
+          } // end loop der_id
+        } // end loop fn
+      };
+
+      if (fill_gradients)
+        fill_derivatives(batch.gradients[e],sym_1);
+
+      if (fill_hessians)
+        fill_derivatives(batch.hessians[e],sym_2);
+    } // end loop comp
+
+    if (fill_values)
+      copy_batch_values_to_inactive_components(
+        inactive_components_id,comp_map,comp_offset,batch.values[e]);
+    if (fill_gradients)
+      copy_batch_derivatives_to_inactive_components(
+        inactive_components_id,comp_map,comp_offset,batch.gradients[e]);
+    if (fill_hessians)
+      copy_batch_derivatives_to_inactive_components(
+        inactive_components_id,comp_map,comp_offset,batch.hessians[e]);
+  } // end loop e
+}
+
+
+
+template<int dim_, int range_ , int rank_>
+template<int sdim>
+BSplineHandler<dim_, range_, rank_>::
+GlobalCache::
+GlobalCache(const Basis &basis, const std::shared_ptr<const Quadrature<sdim>> &quad)
+  :
+  quad_(quad),
+  n_intervals_(basis.get_grid()->get_num_intervals())
+{
+  Assert(quad != nullptr, ExcNullPtr());
+
+  const auto &grid = *basis.get_grid();
+
+  const auto &spline_space = *basis.spline_space_;
+
+  const auto &active_components_id = spline_space.get_active_components_id();
+
+  const auto &bezier_op   = basis.operators_;
+
+  const int n_sub_elems = UnitElement<dim>::template num_elem<sdim>();
+  tables_.resize(n_sub_elems);
+
+  for (int s_id = 0 ; s_id < n_sub_elems ; ++s_id)
+  {
+    const auto extended_sub_elem_quad = extend_sub_elem_quad<sdim,dim>(*quad,s_id);
+
+    for (const int dir : UnitElement<dim>::active_directions)
+    {
+      const auto &pt_coords_internal = extended_sub_elem_quad.get_coords_direction(dir);
+
+      const auto &knots = grid.get_knot_coordinates(dir);
+
+      const Size n_inter = n_intervals_[dir];
+
+      for (auto comp : active_components_id)
+      {
+        auto &table = tables_[s_id][comp][dir];
+        table.interval_to_table.resize(n_inter);
+
+        for (Index interval_id = 0 ; interval_id < n_inter ; ++interval_id)
+        {
+          const Real len = knots[interval_id+1] - knots[interval_id];
+
+          const auto &oper = bezier_op.get_operator(dir,interval_id,comp);
+
+          // an interior interval with the same length and the same
+          // extraction operator of the previous (interior) interval shares its values
+          if (interval_id > 1 && interval_id < n_inter-1)
+          {
+            const Real len_prev = knots[interval_id] - knots[interval_id-1];
+            const auto &oper_prev = bezier_op.get_operator(dir,interval_id-1,comp);
+            if (len == len_prev && oper == oper_prev)
+            {
+              table.interval_to_table[interval_id] = table.interval_to_table[interval_id-1];
+              continue;
+            }
+          }
+
+          table.interval_to_table[interval_id] = table.splines_1D.size();
+          table.splines_1D.emplace_back();
+
+          basis.evaluate_splines_1D(comp,dir,interval_id,
+                                    pt_coords_internal,
+                                    table.splines_1D.back());
+        } // end loop interval_id
+      } // end loop comp
     } // end loop dir
-    out.end_item();
-  } // end loop comp
+  } // end loop s_id
 }
 
+template<int dim_, int range_ , int rank_>
+template<int sdim>
+bool
+BSplineHandler<dim_, range_, rank_>::
+GlobalCache::
+is_built_for(const Basis &basis, const std::shared_ptr<const Quadrature<sdim>> &quad) const
+{
+  return quad_ == quad &&
+         n_intervals_ == basis.get_grid()->get_num_intervals();
+}
 
 template<int dim_, int range_ , int rank_>
 auto
 BSplineHandler<dim_, range_, rank_>::
 GlobalCache::
-get_element_values(const TensorIndex<dim> &elem_tensor_id) const
--> ComponentContainer<std::unique_ptr<const TensorProductFunctionEvaluator<dim>>>
+get_splines_1D(const int s_id,
+               const int comp,
+               const int dir,
+               const Index interval_id) const -> const BasisValues1d &
 {
-  ComponentContainer<std::unique_ptr<const TensorProductFunctionEvaluator<dim>> >
-  result(basis_values_1d_table_.get_comp_map());
+  Assert(s_id >= 0 && s_id < tables_.size(), ExcIndexRange(s_id,0,tables_.size()));
+  const auto &table = tables_[s_id][comp][dir];
+  return table.splines_1D[table.interval_to_table[interval_id]];
+}
 
-  SafeSTLArray<BasisValues1dConstView, dim> values_1D;
-  for (auto c : result.get_active_components_id())
+template<int dim_, int range_ , int rank_>
+Size
+BSplineHandler<dim_, range_, rank_>::
+GlobalCache::
+get_num_tables() const
+{
+  Size n_tables = 0;
+  for (const auto &tables_sub_elem : tables_)
+    for (const auto &tables_comp : tables_sub_elem)
+      for (const auto &table : tables_comp)
+        n_tables += table.splines_1D.size();
+
+  return n_tables;
+}
+
+template<int dim_, int range_ , int rank_>
+void
+BSplineHandler<dim_, range_, rank_>::
+GlobalCache::
+print_info(LogStream &out) const
+{
+  using std::to_string;
+  const int n_sub_elems = tables_.size();
+  for (int s_id = 0 ; s_id < n_sub_elems ; ++s_id)
   {
-    const auto &value = basis_values_1d_table_[c];
-    for (int i = 0 ; i < dim_ ; ++i)
-      values_1D[i] = BasisValues1dConstView(value[i].at(elem_tensor_id[i]));
+    out.begin_item("Sub-element ID: " + to_string(s_id));
+    for (int comp = 0 ; comp < n_components ; ++comp)
+    {
+      out.begin_item("Component ID: " + to_string(comp));
+      for (const int dir : UnitElement<dim_>::active_directions)
+      {
+        const auto &table = tables_[s_id][comp][dir];
 
-    result[c] = std::make_unique<const TensorProductFunctionEvaluator<dim>>(*this->quad_,values_1D);
-  }
-  return result;
+        out.begin_item("Direction : " + to_string(dir));
+
+        out.begin_item("Interval to table:");
+        table.interval_to_table.print_info(out);
+        out.end_item();
+
+        const int n_tables = table.splines_1D.size();
+        for (int t = 0 ; t < n_tables ; ++t)
+        {
+          out.begin_item("Table: " + to_string(t));
+          table.splines_1D[t].print_info(out);
+          out.end_item();
+        }
+        out.end_item();
+      } // end loop dir
+      out.end_item();
+    } // end loop comp
+    out.end_item();
+  } // end loop s_id
 }
-#endif
 
 
 IGA_NAMESPACE_CLOSE
@@ -46,6 +46,8 @@ for x in inst.sub_ref_sp_dims + inst.ref_sp_dims:
         handler_funcs.add(func)
         func = 'void %s::FillCacheDispatcherNoGlobalCache::operator()(const Topology<%d> &)' % (handler,k)
         handler_funcs.add(func)
+        func = 'void %s::FillCacheDispatcherGlobalCache::operator()(const Topology<%d> &)' % (handler,k)
+        handler_funcs.add(func)
         
         
         
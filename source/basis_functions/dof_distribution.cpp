@@ -147,14 +147,14 @@ void
 DofDistribution<dim, range, rank>::
 add_dofs_offset(const Index offset)
 {
+  this->update_state_id();
+
   for (auto &index_table_comp : index_table_)
     for (auto &dof : index_table_comp.get_flat_view())
       dof += offset;
 
 
-  for (auto &property_dofs : properties_dofs_)
-    for (auto &dof : property_dofs.second)
-      const_cast<Index &>(dof) += offset;
+  properties_dofs_.add_offset(offset);
 }
 
 
@@ -278,6 +278,14 @@ is_property_defined(const std::string &property) const
   return properties_dofs_.is_property_defined(property);
 }
 
+template<int dim, int range, int rank>
+SafeSTLVector<std::string>
+DofDistribution<dim, range, rank>::
+get_dofs_properties() const
+{
+  return properties_dofs_.get_properties();
+}
+
 template<int dim, int range, int rank>
 bool
 DofDistribution<dim, range, rank>::
@@ -292,6 +300,8 @@ void
 DofDistribution<dim, range, rank>::
 add_dofs_property(const std::string &property)
 {
+  this->update_state_id();
+
   properties_dofs_.add_property(property);
 }
 
@@ -310,7 +320,7 @@ get_num_dofs(const std::string &property) const
 
 
 template<int dim, int range, int rank>
-std::set<Index> &
+IndexSet<Index> &
 DofDistribution<dim, range, rank>::
 get_global_dofs(const std::string &property)
 {
@@ -320,7 +330,7 @@ get_global_dofs(const std::string &property)
 
 
 template<int dim, int range, int rank>
-const std::set<Index> &
+const IndexSet<Index> &
 DofDistribution<dim, range, rank>::
 get_global_dofs(const std::string &property) const
 {
@@ -333,6 +343,8 @@ void
 DofDistribution<dim, range, rank>::
 set_dof_property_status(const std::string &property, const Index dof_id, const bool status)
 {
+  this->update_state_id();
+
   if (status)
     properties_dofs_[property].insert(dof_id);
   else
@@ -349,10 +361,16 @@ set_dof_property_status(const std::string &property,
                         const std::set<Index> ids,
                         const bool status)
 {
+  this->update_state_id();
+
+  auto &dofs = properties_dofs_[property];
   if (status)
-    properties_dofs_[property].insert(ids.begin(),ids.end());
+    dofs.insert(ids.begin(),ids.end());
   else
-    properties_dofs_[property].erase(ids.begin(),ids.end());
+  {
+    for (const auto dof : ids)
+      dofs.erase(dof);
+  }
 }
 
 
@@ -362,13 +380,16 @@ void
 DofDistribution<dim, range, rank>::
 set_all_dofs_property_status(const std::string &property, const bool status)
 {
+  this->update_state_id();
+
   const auto dofs_view = this->get_dofs_const_view();
+  auto &dofs = properties_dofs_[property];
   if (status)
-    properties_dofs_[property].insert(dofs_view.cbegin(),dofs_view.cend());
+    dofs.insert(dofs_view.cbegin(),dofs_view.cend());
   else
   {
     for (const auto &dof : dofs_view)
-      properties_dofs_[property].erase(dof);
+      dofs.erase(dof);
   }
 }
 
@@ -469,6 +490,25 @@ serialize(Archive &ar)
 #endif // IGATOOLS_WITH_SERIALIZATION
 
 
+
+template<int dim, int range, int rank>
+Index
+DofDistribution<dim, range, rank>::
+get_state_id() const
+{
+  return state_id_;
+}
+
+
+
+template<int dim, int range, int rank>
+void
+DofDistribution<dim, range, rank>::
+update_state_id()
+{
+  state_id_ = UniqueIdGenerator::get_unique_id();
+}
+
 IGA_NAMESPACE_CLOSE
 
 #include <igatools/basis_functions/dof_distribution.inst>
@@ -444,6 +444,7 @@ SplineSpace(const DegreeTable &deg,
   interior_mult_(interior_mult),
   deg_(deg),
   periodic_(periodic),
+  element_dofs_tables_state_id_(-1),
   object_id_(UniqueIdGenerator::get_unique_id())
 {
   this->init();
@@ -453,6 +454,7 @@ template<int dim_, int range_, int rank_>
 SplineSpace<dim_, range_, rank_>::
 SplineSpace()
   :
+  element_dofs_tables_state_id_(-1),
   object_id_(UniqueIdGenerator::get_unique_id())
 {}
 
@@ -922,75 +924,137 @@ get_multiplicity_from_regularity(const InteriorReg reg,
 
 
 
+template<int dim_, int range_, int rank_>
+auto
+SplineSpace<dim_, range_, rank_>::
+get_element_dofs_table(const std::string &dofs_property) const
+-> const ElementDofsTable &
+{
+  const auto &dof_distr = *dof_distribution_;
+  const Index dof_distr_state_id = dof_distr.get_state_id();
+
+  ElementDofsTableSlot *table_slot = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(element_dofs_tables_mutex_);
+
+    // the slots for the tables are created again only if the DofDistribution has been modified
+    if (element_dofs_tables_state_id_ != dof_distr_state_id)
+    {
+      if (element_dofs_tables_ != nullptr)
+        old_element_dofs_tables_.push_back(element_dofs_tables_);
+
+      element_dofs_tables_ = std::make_shared<ElementDofsTables>();
+      for (const auto &property : dof_distr.get_dofs_properties())
+        (*element_dofs_tables_)[property] = std::make_unique<ElementDofsTableSlot>();
+
+      element_dofs_tables_state_id_ = dof_distr_state_id;
+    }
+
+    const auto slot = element_dofs_tables_->find(dofs_property);
+    Assert(slot != element_dofs_tables_->end(),
+           ExcMessage("The dofs property \"" + dofs_property + "\" is not defined."));
+    table_slot = slot->second.get();
+  }
+
+  // the table is built outside the lock, in order to build different tables concurrently
+  std::call_once(table_slot->is_built,
+                 [&]()
+  {
+    this->build_element_dofs_table(dofs_property,table_slot->table);
+  });
+
+  return table_slot->table;
+}
+
+
+
 template<int dim_, int range_, int rank_>
 void
 SplineSpace<dim_, range_, rank_>::
-get_element_dofs(
-  const typename GridType::IndexType &elem_id,
-  SafeSTLVector<Index> &dofs_global,
-  SafeSTLVector<Index> &dofs_local_to_patch,
-  SafeSTLVector<Index> &dofs_local_to_elem,
-  const std::string &dofs_property) const
+build_element_dofs_table(const std::string &dofs_property,
+                         ElementDofsTable &table) const
 {
-  const auto &accum_mult = this->accumulated_interior_multiplicities();
+  const auto &dof_distr = *dof_distribution_;
 
-  const auto &dof_distr = *(this->get_dof_distribution());
+  //------------------------------------------------------------------------------
+  // building the table --- begin
+  const auto &accum_mult = this->accumulated_interior_multiplicities();
   const auto &index_table = dof_distr.get_index_table();
+  const auto &dofs_with_property = dof_distr.get_global_dofs(dofs_property);
+  const auto &dofs_tensor_id_elem_table = this->get_dofs_tensor_id_elem_table();
+
+  Size n_dofs_elem = 0;
+  for (const auto comp : components)
+    n_dofs_elem += dofs_tensor_id_elem_table[comp].size();
 
-  dofs_global.clear();
-  dofs_local_to_patch.clear();
-  dofs_local_to_elem.clear();
+  const auto &grid = *grid_;
+  const Size n_elems = grid.get_num_all_elems();
 
-  const auto &elem_t_id = elem_id.get_tensor_index();
+  auto &offsets = table.offsets_;
+  auto &dofs_global = table.dofs_global_;
+  auto &dofs_local_to_patch = table.dofs_local_to_patch_;
+  auto &dofs_local_to_elem = table.dofs_local_to_elem_;
+  offsets.reserve(n_elems+1);
+  dofs_global.reserve(n_elems * n_dofs_elem);
+  dofs_local_to_patch.reserve(n_elems * n_dofs_elem);
+  dofs_local_to_elem.reserve(n_elems * n_dofs_elem);
 
-  TensorIndex<dim_> dof_t_origin;
+  offsets.emplace_back(0);
 
-  Index dof_loc_to_elem = 0;
-  for (const auto comp : components)
+  TensorIndex<dim_> dof_t_origin;
+  for (Index elem_flat_id = 0 ; elem_flat_id < n_elems ; ++elem_flat_id)
   {
-    const auto &index_table_comp = index_table[comp];
+    const auto elem_t_id = grid.flat_to_tensor_element_id(elem_flat_id);
 
-//    const auto dof_t_origin = accum_mult[comp].cartesian_product(elem_t_id);
-    for (int i = 0 ; i < dim_ ; ++i)
-      dof_t_origin[i] = accum_mult[comp][i][elem_t_id[i]];
+    Index dof_loc_to_elem = 0;
+    for (const auto comp : components)
+    {
+      const auto &index_table_comp = index_table[comp];
 
-    const auto &elem_comp_dof_t_id = this->get_dofs_tensor_id_elem_table()[comp];
+      for (int i = 0 ; i < dim_ ; ++i)
+        dof_t_origin[i] = accum_mult[comp][i][elem_t_id[i]];
 
-//        if (dofs_property == DofProperties::active)
-//        {
-//            for (const auto loc_dof_t_id : elem_comp_dof_t_id)
-//            {
-//                const auto dof_global = index_table_comp(dof_t_origin + loc_dof_t_id);
-//                dofs_global.emplace_back(dof_global);
-//
-//                const auto dof_loc_to_patch = this->dof_distribution_->global_to_patch_local(dof_global);
-//                dofs_local_to_patch.emplace_back(dof_loc_to_patch);
-//
-//                dofs_local_to_elem.emplace_back(dof_loc_to_elem);
-//
-//                ++dof_loc_to_elem;
-//            } // end loop loc_dof_t_id
-//        }
-//        else
-    {
-      for (const auto loc_dof_t_id : elem_comp_dof_t_id)
+      for (const auto loc_dof_t_id : dofs_tensor_id_elem_table[comp])
       {
         const auto dof_global = index_table_comp(dof_t_origin + loc_dof_t_id);
-        if (dof_distr.test_if_dof_has_property(dof_global, dofs_property))
+        if (dofs_with_property.count(dof_global) > 0)
         {
           dofs_global.emplace_back(dof_global);
-
-          const auto dof_loc_to_patch = dof_distr.global_to_patch_local(dof_global);
-          dofs_local_to_patch.emplace_back(dof_loc_to_patch);
-
+          dofs_local_to_patch.emplace_back(dof_distr.global_to_patch_local(dof_global));
           dofs_local_to_elem.emplace_back(dof_loc_to_elem);
-
         }
         ++dof_loc_to_elem;
       } // end loop loc_dof_t_id
-    }
+    } // end comp loop
+
+    offsets.emplace_back(dofs_global.size());
+  } // end loop elem_flat_id
+  // building the table --- end
+  //------------------------------------------------------------------------------
+}
+
+
+
+template<int dim_, int range_, int rank_>
+void
+SplineSpace<dim_, range_, rank_>::
+get_element_dofs(
+  const typename GridType::IndexType &elem_id,
+  SafeSTLVector<Index> &dofs_global,
+  SafeSTLVector<Index> &dofs_local_to_patch,
+  SafeSTLVector<Index> &dofs_local_to_elem,
+  const std::string &dofs_property) const
+{
+  const auto &table = this->get_element_dofs_table(dofs_property);
+  const Index elem_flat_id = elem_id.get_flat_index();
+
+  const auto elem_dofs_global = table.get_global_dofs(elem_flat_id);
+  const auto elem_dofs_local_to_patch = table.get_local_to_patch(elem_flat_id);
+  const auto elem_dofs_local_to_elem = table.get_local_to_elem(elem_flat_id);
 
-  } // end comp loop
+  dofs_global.assign(elem_dofs_global.begin(),elem_dofs_global.end());
+  dofs_local_to_patch.assign(elem_dofs_local_to_patch.begin(),elem_dofs_local_to_patch.end());
+  dofs_local_to_elem.assign(elem_dofs_local_to_elem.begin(),elem_dofs_local_to_elem.end());
 }
 
 template<int dim_, int range_, int rank_>
@@ -118,6 +118,10 @@ for space in unique(spaces):
     t7 = 'unique_ptr<const TensorProductFunctionEvaluator<%s>>'%(dim)
     comp_container = '%s::template ComponentContainer<%s>' %(space,t7)
     comp_containers.append('%s' %(comp_container))
+
+    t7 = 'unique_ptr<TensorProductBlockEvaluator<%s>>'%(dim)
+    comp_container = '%s::template ComponentContainer<%s>' %(space,t7)
+    comp_containers.append('%s' %(comp_container))
     
     t8 = 'SafeSTLArray<BasisValues1d,%s>' % (dim)
     comp_container = '%s::template ComponentContainer<%s>' %(space,t8)
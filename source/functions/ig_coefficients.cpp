@@ -20,40 +20,419 @@
 
 #include <igatools/functions/ig_coefficients.h>
 
+#include <stdexcept>
+
 
 IGA_NAMESPACE_OPEN
 
 IgCoefficients::
 IgCoefficients(const std::set<Index> &global_dofs)
 {
+  dense_values_.reserve(global_dofs.size());
   for (const auto &dof : global_dofs)
-    (*this)[dof] = 0.0;
+    this->insert(dof,0.0);
+}
+
+
+
+IgCoefficients::
+IgCoefficients(const IndexSet<Index> &global_dofs)
+{
+  dense_values_.reserve(global_dofs.size());
+  for (const auto dof : global_dofs)
+    this->insert(dof,0.0);
+}
+
+
+
+IgCoefficients::
+IgCoefficients(const std::map<Index,Real> &dofs_values)
+{
+  for (const auto &dof_value : dofs_values)
+    this->insert(dof_value.first,dof_value.second);
+}
+
+
+
+#ifdef IGATOOLS_USES_TRILINOS
+IgCoefficients::
+IgCoefficients(const std::shared_ptr<const EpetraTools::Vector> &vec)
+{
+  Assert(vec != nullptr, ExcNullPtr());
+
+  const auto &map = vec->Map();
+  const Size n_entries = vec->MyLength();
+  if (n_entries == 0)
+    return;
+
+  if (map.LinearMap())
+  {
+    // the global ids are contiguous: the values are not copied
+    first_dof_ = map.MinMyGID();
+    view_owner_ = vec;
+    view_values_ = vec->Values();
+    view_size_ = n_entries;
+  }
+  else
+  {
+    const auto &vec_values = *vec;
+    for (Index loc_id = 0 ; loc_id < n_entries ; ++loc_id)
+      this->insert(map.GID(loc_id),vec_values[loc_id]);
+  }
 }
 
 
 
+IgCoefficients::
+IgCoefficients(const IndexSet<Index> &global_dofs, const EpetraTools::Vector &vec)
+  :
+  IgCoefficients(global_dofs)
+{
+  const auto &map = vec.Map();
+  for (auto dof_value : *this)
+  {
+    const auto loc_id = map.LID(dof_value.first);
+    Assert(loc_id >= 0,
+           ExcMessage("Global dof " + std::to_string(dof_value.first) +
+                      " not present in the input EpetraTools::Vector."));
+    dof_value.second = vec[loc_id];
+  }
+}
+
+
+
+IgCoefficients::
+IgCoefficients(const IndexSet<Index> &global_dofs,
+               const std::shared_ptr<const EpetraTools::Vector> &vec)
+{
+  Assert(vec != nullptr, ExcNullPtr());
+
+  // testing if the global ids of the vector are exactly the global_dofs
+  const auto &map = vec->Map();
+  bool same_dofs = map.LinearMap() && vec->MyLength() == global_dofs.size();
+  Index gid = map.MinMyGID();
+  for (auto dof = global_dofs.begin() ; same_dofs && dof != global_dofs.end() ; ++dof, ++gid)
+    same_dofs = (*dof == gid);
+
+  if (same_dofs)
+    *this = IgCoefficients(vec);
+  else
+    *this = IgCoefficients(global_dofs,*vec);
+}
+#endif // IGATOOLS_USES_TRILINOS
+
+
+
+Size
+IgCoefficients::
+get_num_dense_values() const
+{
+  return (view_values_ != nullptr) ? view_size_ : dense_values_.size();
+}
+
+
+
+const Real *
+IgCoefficients::
+get_dense_values() const
+{
+  return (view_values_ != nullptr) ? view_values_ : dense_values_.data();
+}
+
+
+
+void
+IgCoefficients::
+detach_view()
+{
+  if (view_values_ == nullptr)
+    return;
+
+  dense_values_.assign(view_values_,view_values_ + view_size_);
+
+  view_owner_.reset();
+  view_values_ = nullptr;
+  view_size_ = 0;
+}
+
+
+
+void
+IgCoefficients::
+switch_to_sparse()
+{
+  Assert(is_dense_, ExcMessage("The coefficients are already in the sparse storage."));
+
+  const Size n_values = get_num_dense_values();
+  const Real *values = get_dense_values();
+  for (Index i = 0 ; i < n_values ; ++i)
+    sparse_values_.emplace_hint(sparse_values_.end(),first_dof_ + i, values[i]);
+
+  dense_values_.clear();
+  dense_values_.shrink_to_fit();
+  view_owner_.reset();
+  view_values_ = nullptr;
+  view_size_ = 0;
+
+  is_dense_ = false;
+}
+
+
 
 const Real &
 IgCoefficients::
 operator[](const Index global_dof) const
 {
-  return std::map<Index,Real>::at(global_dof);
+  return this->at(global_dof);
 }
 
+
+
 Real &
 IgCoefficients::
 operator[](const Index global_dof)
 {
-  return std::map<Index,Real>::operator[](global_dof);
+  return this->at(global_dof);
 }
 
+
+
+bool
+IgCoefficients::
+insert(const Index global_dof, const Real value)
+{
+  if (is_dense_)
+  {
+    detach_view();
+
+    const Size n_values = dense_values_.size();
+    if (n_values == 0)
+    {
+      first_dof_ = global_dof;
+      dense_values_.push_back(value);
+      return true;
+    }
+
+    const Index pos = global_dof - first_dof_;
+    if (pos >= 0 && pos < n_values)
+      return false;
+    else if (pos == n_values)
+    {
+      // appending the next contiguous dof
+      dense_values_.push_back(value);
+      return true;
+    }
+    else
+      switch_to_sparse();
+  }
+
+  return sparse_values_.emplace(global_dof,value).second;
+}
+
+
+
+const Real &
+IgCoefficients::
+at(const Index global_dof) const
+{
+  if (is_dense_)
+  {
+    const Index pos = global_dof - first_dof_;
+    if (pos < 0 || pos >= get_num_dense_values())
+      throw std::out_of_range("IgCoefficients::at(): global dof " +
+                              std::to_string(global_dof) + " not present.");
+    return get_dense_values()[pos];
+  }
+  else
+    return sparse_values_.at(global_dof);
+}
+
+
+
+Real &
+IgCoefficients::
+at(const Index global_dof)
+{
+  if (is_dense_)
+  {
+    detach_view();
+    const Index pos = global_dof - first_dof_;
+    if (pos < 0 || pos >= dense_values_.size())
+      throw std::out_of_range("IgCoefficients::at(): global dof " +
+                              std::to_string(global_dof) + " not present.");
+    return dense_values_[pos];
+  }
+  else
+    return sparse_values_.at(global_dof);
+}
+
+
+
+Size
+IgCoefficients::
+count(const Index global_dof) const
+{
+  if (is_dense_)
+  {
+    const Index pos = global_dof - first_dof_;
+    return (pos >= 0 && pos < get_num_dense_values()) ? 1 : 0;
+  }
+  else
+    return sparse_values_.count(global_dof);
+}
+
+
+
 Index
 IgCoefficients::
 size() const
 {
-  return std::map<Index,Real>::size();
+  return is_dense_ ? get_num_dense_values() : sparse_values_.size();
+}
+
+
+
+bool
+IgCoefficients::
+empty() const
+{
+  return this->size() == 0;
+}
+
+
+
+void
+IgCoefficients::
+clear()
+{
+  *this = IgCoefficients();
+}
+
+
+
+void
+IgCoefficients::
+get_local_coeffs(const SafeSTLVector<Index> &global_dofs,
+                 SafeSTLVector<Real> &local_coeffs) const
+{
+  const Size n_dofs = global_dofs.size();
+  local_coeffs.resize(n_dofs);
+
+  if (is_dense_)
+  {
+    const Real *values = get_dense_values();
+    const Index *dofs = global_dofs.data();
+    Real *loc_values = local_coeffs.data();
+
+#ifndef NDEBUG
+    const Size n_values = get_num_dense_values();
+    for (Index i = 0 ; i < n_dofs ; ++i)
+      Assert(dofs[i] >= first_dof_ && dofs[i] - first_dof_ < n_values,
+             ExcMessage("Global dof " + std::to_string(dofs[i]) + " not present."));
+#endif
+
+    const Index first_dof = first_dof_;
+    for (Index i = 0 ; i < n_dofs ; ++i)
+      loc_values[i] = values[dofs[i] - first_dof];
+  }
+  else
+  {
+    for (Index i = 0 ; i < n_dofs ; ++i)
+      local_coeffs[i] = sparse_values_.at(global_dofs[i]);
+  }
+}
+
+
+
+SafeSTLVector<Real>
+IgCoefficients::
+get_local_coeffs(const SafeSTLVector<Index> &global_dofs) const
+{
+  SafeSTLVector<Real> local_coeffs;
+  this->get_local_coeffs(global_dofs,local_coeffs);
+  return local_coeffs;
+}
+
+
+
+bool
+IgCoefficients::
+is_dense() const
+{
+  return is_dense_;
 }
 
+
+
+bool
+IgCoefficients::
+is_view() const
+{
+  return view_values_ != nullptr;
+}
+
+
+
+auto
+IgCoefficients::
+begin() -> iterator
+{
+  detach_view();
+  return iterator(*this,0,sparse_values_.begin());
+}
+
+
+
+auto
+IgCoefficients::
+end() -> iterator
+{
+  detach_view();
+  return is_dense_ ?
+         iterator(*this,dense_values_.size(),sparse_values_.end()) :
+         iterator(*this,0,sparse_values_.end());
+}
+
+
+
+auto
+IgCoefficients::
+cbegin() const -> const_iterator
+{
+  return const_iterator(*this,0,sparse_values_.cbegin());
+}
+
+
+
+auto
+IgCoefficients::
+cend() const -> const_iterator
+{
+  return is_dense_ ?
+         const_iterator(*this,get_num_dense_values(),sparse_values_.cend()) :
+         const_iterator(*this,0,sparse_values_.cend());
+}
+
+
+
+auto
+IgCoefficients::
+begin() const -> const_iterator
+{
+  return this->cbegin();
+}
+
+
+
+auto
+IgCoefficients::
+end() const -> const_iterator
+{
+  return this->cend();
+}
+
+
+
 void
 IgCoefficients::
 print_info(LogStream &out) const
@@ -76,8 +455,18 @@ void
 IgCoefficients::
 serialize(Archive &ar)
 {
-  ar &make_nvp("IgCoeff_base_t",
-               base_class<std::map<Index,Real>>(this));
+  // the coefficients are archived as a std::map<Index,Real>,
+  // independently of the storage used
+  std::map<Index,Real> dofs_values;
+  const bool is_loading = std::is_same<Archive,IArchive>::value;
+  if (!is_loading)
+    for (const auto &dof_value : static_cast<const IgCoefficients &>(*this))
+      dofs_values.emplace_hint(dofs_values.end(),dof_value.first,dof_value.second);
+
+  ar &make_nvp("IgCoeff_base_t",dofs_values);
+
+  if (is_loading)
+    *this = IgCoefficients(dofs_values);
 }
 #endif // IGATOOLS_WITH_SERIALIZATION
 
@@ -47,17 +47,7 @@ IgFunction(const SharedPtrConstnessHandler<PhysBasis> &basis,
   dofs_property_(dofs_property)
 {
   const auto &dof_distribution = *(basis_->get_spline_space()->get_dof_distribution());
-  const auto &active_dofs = dof_distribution.get_global_dofs(dofs_property);
-
-  const auto &epetra_map = coeff.Map();
-
-  for (const auto glob_dof : active_dofs)
-  {
-    auto loc_id = epetra_map.LID(glob_dof);
-    Assert(loc_id >= 0,
-           ExcMessage("Global dof " + std::to_string(glob_dof) + " not present in the input EpetraTools::Vector."));
-    coeffs_[glob_dof] = coeff[loc_id];
-  }
+  coeffs_ = IgCoefficients(dof_distribution.get_global_dofs(dofs_property),coeff);
 }
 #endif // IGATOOLS_USES_TRILINOS
 
@@ -72,17 +62,14 @@ IgFunction(const SharedPtrConstnessHandler<PhysBasis> &basis,
    SharedPtrConstnessHandler<DomainType>(basis.get_ptr_const_data()->get_domain()) :
    SharedPtrConstnessHandler<DomainType>(basis.get_ptr_data()->get_domain())),
   basis_(basis),
+  coeffs_(coeff),
   dofs_property_(dofs_property)
 {
-
 #ifndef NDEBUG
   const auto &dof_distribution = *(basis_->get_spline_space()->get_dof_distribution());
-  const auto &active_dofs = dof_distribution.get_global_dofs(dofs_property);
-
-  for (const auto glob_dof : active_dofs)
-    coeffs_[glob_dof] = coeff.at(glob_dof);
-#else
-  coeffs_ = coeff;
+  for (const auto glob_dof : dof_distribution.get_global_dofs(dofs_property))
+    Assert(coeffs_.count(glob_dof) == 1,
+           ExcMessage("Global dof " + std::to_string(glob_dof) + " not present in the coefficients."));
 #endif
 }
 
@@ -104,6 +91,21 @@ const_create(const std::shared_ptr<const PhysBasis> &basis,
   return ig_func;
 }
 
+
+
+template<int dim,int codim,int range,int rank>
+auto
+IgFunction<dim,codim,range,rank>::
+const_create(const std::shared_ptr<const PhysBasis> &basis,
+             const std::shared_ptr<const EpetraTools::Vector> &coeff,
+             const std::string &dofs_property) ->  std::shared_ptr<const self_t>
+{
+  const auto &dof_distribution = *(basis->get_spline_space()->get_dof_distribution());
+  return self_t::const_create(basis,
+                              IgCoefficients(dof_distribution.get_global_dofs(dofs_property),coeff),
+                              dofs_property);
+}
+
 #endif // IGATOOLS_USES_TRILINOS
 
 
@@ -140,6 +142,21 @@ create(const std::shared_ptr<PhysBasis> &basis,
   return ig_func;
 }
 
+
+
+template<int dim,int codim,int range,int rank>
+auto
+IgFunction<dim,codim,range,rank>::
+create(const std::shared_ptr<PhysBasis> &basis,
+       const std::shared_ptr<const EpetraTools::Vector> &coeff,
+       const std::string &dofs_property) ->  std::shared_ptr<self_t>
+{
+  const auto &dof_distribution = *(basis->get_spline_space()->get_dof_distribution());
+  return self_t::create(basis,
+                        IgCoefficients(dof_distribution.get_global_dofs(dofs_property),coeff),
+                        dofs_property);
+}
+
 #endif // IGATOOLS_USES_TRILINOS
 
 
@@ -220,13 +237,28 @@ rebuild_after_insert_knots(
   const Grid<dim> &grid_old)
 {
   using std::const_pointer_cast;
+  const auto basis_pre_refinement =
+    std::dynamic_pointer_cast<const PhysBasis>(basis_->get_basis_previous_refinement());
   this->function_previous_refinement_ =
     IgFunction<dim,codim,range,rank>::const_create(
-      std::dynamic_pointer_cast<const PhysBasis>(basis_->get_basis_previous_refinement()),
+      basis_pre_refinement,
       coeffs_,
       dofs_property_);
 
 
+  // exact refinement of the coefficients by knot insertion, if possible
+  // (the push-forward does not depend on the knots)
+  IgCoefficients refined_coeffs;
+  if (basis_tools::knot_insertion_coefficients<dim,range,rank>(
+        *(basis_pre_refinement->get_reference_basis()),
+        *(basis_->get_reference_basis()),
+        coeffs_,
+        refined_coeffs))
+  {
+    this->coeffs_ = std::move(refined_coeffs);
+    return;
+  }
+
   const int max_degree = basis_->get_spline_space()->get_max_degree();
 
   const auto quad = QGauss<dim>::create(max_degree+1);
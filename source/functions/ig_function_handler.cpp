@@ -148,9 +148,8 @@ operator()(const Topology<sdim> &sub_elem)
 
     const auto &ig_basis_elem_global_dofs = ig_basis_elem->get_local_to_global(dofs_property);
     const auto &ig_func_coeffs = ig_function.get_coefficients();
-    SafeSTLVector<Real> ig_func_elem_coeffs; // coefficients of the IgGridFunction restricted to the element
-    for (const auto &global_dof : ig_basis_elem_global_dofs)
-      ig_func_elem_coeffs.emplace_back(ig_func_coeffs[global_dof]);
+    // coefficients of the IgGridFunction restricted to the element
+    const auto ig_func_elem_coeffs = ig_func_coeffs.get_local_coeffs(ig_basis_elem_global_dofs);
 
     using _D0 = function_element::template _D<0>;
     if (cache.template status_fill<_D0>())
@@ -42,17 +42,7 @@ IgGridFunction(const SharedPtrConstnessHandler<RefBasis> &ref_basis,
   dofs_property_(dofs_property)
 {
   const auto &dof_distribution = *(ref_basis_->get_spline_space()->get_dof_distribution());
-  const auto &active_dofs = dof_distribution.get_global_dofs(dofs_property_);
-
-  const auto &epetra_map = coeff.Map();
-
-  for (const auto glob_dof : active_dofs)
-  {
-    auto loc_id = epetra_map.LID(glob_dof);
-    Assert(loc_id >= 0,
-           ExcMessage("Global dof " + std::to_string(glob_dof) + " not present in the input EpetraTools::Vector."));
-    coeffs_[glob_dof] = coeff[loc_id];
-  }
+  coeffs_ = IgCoefficients(dof_distribution.get_global_dofs(dofs_property_),coeff);
 }
 
 #endif // IGATOOLS_USES_TRILINOS
@@ -69,16 +59,14 @@ IgGridFunction(const SharedPtrConstnessHandler<RefBasis> &ref_basis,
    SharedPtrConstnessHandler<GridType>(ref_basis->get_grid()) :
    SharedPtrConstnessHandler<GridType>(std::const_pointer_cast<Grid<dim>>(ref_basis->get_grid()))),
   ref_basis_(ref_basis),
+  coeffs_(coeffs),
   dofs_property_(dofs_property)
 {
 #ifndef NDEBUG
   const auto &dof_distribution = *(ref_basis_->get_spline_space()->get_dof_distribution());
-  const auto &active_dofs = dof_distribution.get_global_dofs(dofs_property_);
-
-  for (const auto glob_dof : active_dofs)
-    coeffs_[glob_dof] = coeffs.at(glob_dof);
-#else
-  coeffs_ = coeffs;
+  for (const auto glob_dof : dof_distribution.get_global_dofs(dofs_property_))
+    Assert(coeffs_.count(glob_dof) == 1,
+           ExcMessage("Global dof " + std::to_string(glob_dof) + " not present in the coefficients."));
 #endif
 }
 
@@ -101,6 +89,18 @@ rebuild_after_insert_knots(
 
   const auto &ref_basis = *(this->get_basis());
 
+  // exact refinement of the coefficients by knot insertion, if possible
+  IgCoefficients refined_coeffs;
+  if (basis_tools::knot_insertion_coefficients<dim,range,1>(
+        *(ig_grid_function_pre_refinement->get_basis()),
+        ref_basis,
+        coeffs_,
+        refined_coeffs))
+  {
+    coeffs_ = std::move(refined_coeffs);
+    return;
+  }
+
   const int max_degree = ref_basis.get_spline_space()->get_max_degree();
 
   coeffs_ = basis_tools::projection_l2_grid_function<dim,range>(
@@ -177,6 +177,32 @@ create(const std::shared_ptr<RefBasis> &ref_basis,
     SharedPtrConstnessHandler<RefBasis>(ref_basis),coeffs,dofs_property));
 }
 
+template<int dim,int range>
+auto
+IgGridFunction<dim,range>::
+const_create(const std::shared_ptr<const RefBasis> &ref_basis,
+             const std::shared_ptr<const EpetraTools::Vector> &coeffs,
+             const std::string &dofs_property) -> std::shared_ptr<const self_t>
+{
+  const auto &dof_distribution = *(ref_basis->get_spline_space()->get_dof_distribution());
+  return self_t::const_create(ref_basis,
+                              IgCoefficients(dof_distribution.get_global_dofs(dofs_property),coeffs),
+                              dofs_property);
+}
+
+template<int dim,int range>
+auto
+IgGridFunction<dim,range>::
+create(const std::shared_ptr<RefBasis> &ref_basis,
+       const std::shared_ptr<const EpetraTools::Vector> &coeffs,
+       const std::string &dofs_property) -> std::shared_ptr<self_t>
+{
+  const auto &dof_distribution = *(ref_basis->get_spline_space()->get_dof_distribution());
+  return self_t::create(ref_basis,
+                        IgCoefficients(dof_distribution.get_global_dofs(dofs_property),coeffs),
+                        dofs_property);
+}
+
 #endif // IGATOOLS_USES_TRILINOS
 
 
@@ -22,6 +22,7 @@
 #include <igatools/functions/ig_grid_function.h>
 #include <igatools/functions/grid_function_element.h>
 #include <igatools/basis_functions/reference_basis_handler.h>
+#include <igatools/basis_functions/dof_distribution.h>
 
 IGA_NAMESPACE_OPEN
 
@@ -31,6 +32,9 @@ IgGridFunctionHandler(const std::shared_ptr<GridFunctionType> &ig_grid_function)
   :
   parent_t(ig_grid_function),
   ig_basis_handler_(ig_grid_function->get_basis()->create_cache_handler()),
+  ig_basis_elem_(ig_grid_function->get_basis()->create_element_begin(ElementProperties::active)),
+  ig_basis_elem_state_id_(
+    ig_grid_function->get_basis()->get_spline_space()->get_dof_distribution()->get_state_id()),
   ig_grid_function_(ig_grid_function)
 {}
 
@@ -66,6 +70,10 @@ set_flags(const topology_variant &sdim,
     ig_basis_elem_flags |= BsFlags::hessian;
 
   ig_basis_handler_->set_flags_impl(sdim,ig_basis_elem_flags);
+
+  // the cache of the basis element must be initialized again with the new flags
+  for (auto &quad : ig_basis_elem_quads_)
+    quad.reset();
   //*/
 }
 
@@ -128,12 +136,30 @@ operator()(const Topology<sdim> &sub_elem)
   {
     const auto &grid_elem_id = grid_elem.get_index();
 
-    const auto ig_basis = ig_grid_function.get_basis();
     const auto &ig_basis_handler = *ig_grid_function_handler_.ig_basis_handler_;
-    auto ig_basis_elem = ig_basis->begin();
-    ig_basis_elem->move_to(grid_elem_id);
+    auto &ig_basis_elem = ig_grid_function_handler_.ig_basis_elem_;
+
+    // the basis element is created again if the basis has been modified (e.g. refined)
+    const auto &ig_basis = *ig_grid_function.get_basis();
+    const Index basis_state_id = ig_basis.get_spline_space()->get_dof_distribution()->get_state_id();
+    if (ig_grid_function_handler_.ig_basis_elem_state_id_ != basis_state_id)
+    {
+      ig_basis_elem = ig_basis.create_element_begin(ElementProperties::active);
+      for (auto &quad : ig_grid_function_handler_.ig_basis_elem_quads_)
+        quad.reset();
+      ig_grid_function_handler_.ig_basis_elem_state_id_ = basis_state_id;
+    }
 
-    ig_basis_handler.template init_cache<sdim>(*ig_basis_elem,grid_elem.template get_quad<sdim>());
+    if (ig_basis_elem->get_index() != grid_elem_id)
+      ig_basis_elem->move_to(grid_elem_id);
+
+    const auto quad = grid_elem.template get_quad<sdim>();
+    auto &ig_basis_elem_quad = ig_grid_function_handler_.ig_basis_elem_quads_[sdim];
+    if (ig_basis_elem_quad != quad)
+    {
+      ig_basis_handler.template init_cache<sdim>(*ig_basis_elem,quad);
+      ig_basis_elem_quad = quad;
+    }
     ig_basis_handler.template fill_cache<sdim>(*ig_basis_elem,s_id_);
 
 
@@ -141,9 +167,8 @@ operator()(const Topology<sdim> &sub_elem)
 
     const auto &ig_basis_elem_global_dofs = ig_basis_elem->get_local_to_global(dofs_property);
     const auto &ig_func_coeffs = ig_grid_function.get_coefficients();
-    SafeSTLVector<Real> ig_func_elem_coeffs; // coefficients of the IgGridFunction restricted to the element
-    for (const auto &global_dof : ig_basis_elem_global_dofs)
-      ig_func_elem_coeffs.emplace_back(ig_func_coeffs[global_dof]);
+    // coefficients of the IgGridFunction restricted to the element
+    const auto ig_func_elem_coeffs = ig_func_coeffs.get_local_coeffs(ig_basis_elem_global_dofs);
 
     if (cache.template status_fill<_D<0>>())
     {
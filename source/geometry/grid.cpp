@@ -220,6 +220,7 @@ Grid(const SafeSTLArray<SafeSTLVector<Real>,dim_> &knot_coordinates)
   {
     active_elements.emplace_back(ElementIndex<dim_>(0,TensorIndex<dim_>()));
   } // end if (dim_ == 0)
+  elem_properties_.update_positions(ElementProperties::active);
 
 #ifndef NDEBUG
   for (const int i : UnitElement<dim_>::active_directions)
@@ -817,6 +818,7 @@ insert_knots(SafeSTLArray<SafeSTLVector<Real>,dim_> &knots_to_insert)
       std::sort(elems_id_fine_with_property.begin(),elems_id_fine_with_property.end());
     }
   }
+  elem_properties_.update_positions();
 
 #if 0
   auto coarse_elem = grid_pre_refinement_->begin();
@@ -1218,10 +1220,18 @@ Grid<dim_>::
 element_has_property(const IndexType &elem_id,
                      const PropId &prop) const
 {
-  const auto &elem_list = this->get_elements_with_property(prop);
-  return std::binary_search(elem_list.begin(),
-                            elem_list.end(),
-                            elem_id);
+  return elem_properties_.get_position(prop,elem_id) >= 0;
+}
+
+
+
+template <int dim_>
+Index
+Grid<dim_>::
+get_element_position(const IndexType &elem_id,
+                     const PropId &prop) const
+{
+  return elem_properties_.get_position(prop,elem_id);
 }
 
 
@@ -1240,6 +1250,7 @@ serialize(Archive &ar)
 #endif
 
   ar &make_nvp("properties_elements_id_",elem_properties_);
+  elem_properties_.update_positions();
   ar &make_nvp("object_id_",object_id_);
   ar &make_nvp("name_",name_);
   ar &make_nvp("elems_size_",elems_size_);
@@ -114,13 +114,24 @@ move_to(const IndexType &elem_id)
          ExcMessage("The destination element has not the property \"" + property_ + "\""));
 
   const auto &list = grid_->elem_properties_[property_];
-  index_it_ = std::find(list.begin(),list.end(),elem_id);
+  index_it_ = list.begin() + grid_->elem_properties_.get_position(property_,elem_id);
 
   Assert((index_it_ >= list.begin()) && (index_it_ < list.end()),
          ExcMessage("The index iterator is pointing to an invalid memory location."));
 }
 
 
+
+template <int dim>
+Index
+GridElement<dim>::
+get_position() const
+{
+  Assert(this->has_valid_position(),ExcMessage("The element has an invalid position."));
+  return index_it_ - grid_->elem_properties_[property_].begin();
+}
+
+
 template <int dim>
 bool
 GridElement<dim>::
@@ -394,6 +405,16 @@ get_quad() const -> std::shared_ptr<const Quadrature<sdim>>
 }
 
 
+template <int dim>
+template <int sdim>
+auto
+GridElement<dim>::
+get_extended_quad(const int s_id) const -> const Quadrature<dim> &
+{
+  return quad_list_.template get_extended_quad<sdim>(s_id);
+}
+
+
 template <int dim>
 auto
 GridElement<dim>::
@@ -43,6 +43,9 @@ for dim in inst.domain_dims + inst.sub_domain_dims:
         for k in range(0,dim+1):
           s = fun.replace('k', '%d' % (k)).replace('Element', '%s' % (elem));
           element_funcs.add(s)
+    for k in range(0,dim+1):
+        s = 'const Quadrature<%d> &%s::get_extended_quad<%d>(const int s_id) const' % (dim,elem,k)
+        element_funcs.add(s)
 
  
 
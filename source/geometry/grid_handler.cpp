@@ -84,7 +84,7 @@ init_cache(ElementAccessor &elem,
 {
   Assert(quad != nullptr, ExcNullPtr());
 
-  elem.quad_list_.template get_quad<sdim>() = quad;
+  elem.quad_list_.template set_quad<sdim>(quad);
 
   auto &cache = elem.all_sub_elems_cache_;
   /*
@@ -172,14 +172,22 @@ fill_cache(ElementAccessor &elem, const int s_id) const
 
   if (cache.template status_fill<_Point>())
   {
-    auto quad = extend_sub_elem_quad<sdim,dim>(*s_quad, s_id);
+    // the extended quadrature is computed once, in init_cache()
+    const auto &quad = elem.quad_list_.template get_extended_quad<sdim>(s_id);
 
     const auto translate = elem.vertex(0);
     const auto dilate    = elem.template get_side_lengths<dim>(0);
-    quad.dilate(dilate);
-    quad.translate(translate);
-    cache.template get_data<_Point>().fill(quad.get_points());
-//    cache.template set_status_filled<_Point>(true);
+
+    auto &points = cache.template get_data<_Point>();
+    const int n_pts = quad.get_num_points();
+    for (int pt = 0 ; pt < n_pts ; ++pt)
+    {
+      auto point = quad.get_point(pt);
+      for (int dir = 0 ; dir < dim ; ++dir)
+        point[dir] = point[dir] * dilate[dir] + translate[dir];
+      points[pt] = point;
+    }
+    points.set_status_filled(true);
   }
 
   if (cache.template status_fill<_Weight>())
@@ -0,0 +1,374 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#include <igatools/io/binary_sidecar.h>
+#include <igatools/base/exceptions.h>
+#include <igatools/utils/safe_stl_vector.h>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+
+IGA_NAMESPACE_OPEN
+
+namespace
+{
+/** Magic string at the begin of the sidecar files. */
+const char sidecar_magic[8] = {'I', 'G', 'A', 'B', 'S', 'I', 'D', 'E'};
+
+/**
+ * Byte order mark, read back as a different value on a machine with
+ * a different byte order.
+ */
+const uint32_t sidecar_byte_order = 0x01020304;
+
+/** Size in bytes of each entry of the block table. */
+const uint64_t block_info_size = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+/** Offsets of the fields of the header. */
+const uint64_t version_pos = 8;
+const uint64_t byte_order_pos = 12;
+const uint64_t n_blocks_pos = 16;
+const uint64_t table_pos = 24;
+const uint64_t file_size_pos = 32;
+
+template <class T>
+T
+read_field(const char *data, const uint64_t pos)
+{
+  T v;
+  std::memcpy(&v, data + pos, sizeof(T));
+  return v;
+}
+
+template <class T>
+void
+write_field(char *data, const uint64_t pos, const T &v)
+{
+  std::memcpy(data + pos, &v, sizeof(T));
+}
+
+uint64_t
+align(const uint64_t pos, const uint64_t alignment)
+{
+  return ((pos + alignment - 1) / alignment) * alignment;
+}
+}
+
+
+
+const uint32_t BinarySidecar::FORMAT_VERSION = 1;
+
+const uint64_t BinarySidecar::header_size_ = 64;
+
+const uint64_t BinarySidecar::alignment_ = 64;
+
+
+
+BinarySidecar::
+BinarySidecar()
+  :
+  mapped_data_(nullptr),
+  mapped_size_(0)
+{}
+
+
+
+BinarySidecar::
+BinarySidecar(const string &file_path)
+  :
+  mapped_data_(nullptr),
+  mapped_size_(0)
+{
+  const int fd = ::open(file_path.c_str(), O_RDONLY);
+  AssertThrow(fd != -1, ExcMessage("Could not open the binary sidecar file " +
+                                   file_path + "."));
+
+  struct stat file_stat;
+  const bool stat_ok = (fstat(fd, &file_stat) == 0);
+  if (!stat_ok || uint64_t(file_stat.st_size) < header_size_)
+  {
+    ::close(fd);
+    AssertThrow(false, ExcMessage("The file " + file_path + " is not a valid "
+                                  "binary sidecar file (header not present)."));
+  }
+  mapped_size_ = file_stat.st_size;
+
+  void *addr = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping is still valid after closing the file descriptor.
+  ::close(fd);
+  AssertThrow(addr != MAP_FAILED, ExcMessage("Could not map the binary sidecar file " +
+                                             file_path + "."));
+  mapped_data_ = static_cast<const char *>(addr);
+
+  // The constructor does not complete if the checks fail: the file
+  // is unmapped here.
+  try
+  {
+    const char *data = mapped_data_;
+    AssertThrow(std::memcmp(data, sidecar_magic, sizeof(sidecar_magic)) == 0,
+                ExcMessage("The file " + file_path + " is not a binary sidecar file."));
+    AssertThrow(read_field<uint32_t>(data, byte_order_pos) == sidecar_byte_order,
+                ExcMessage("The binary sidecar file " + file_path + " was written "
+                           "with a different byte order."));
+    const auto version = read_field<uint32_t>(data, version_pos);
+    AssertThrow(version == FORMAT_VERSION,
+                ExcMessage("The binary sidecar file " + file_path + " has format "
+                           "version " + std::to_string(version) + " (expected " +
+                           std::to_string(FORMAT_VERSION) + ")."));
+    AssertThrow(read_field<uint64_t>(data, file_size_pos) == mapped_size_,
+                ExcMessage("The binary sidecar file " + file_path + " is truncated."));
+
+    const auto n_blocks = read_field<uint64_t>(data, n_blocks_pos);
+    const auto table_offset = read_field<uint64_t>(data, table_pos);
+    AssertThrow(table_offset >= header_size_ &&
+                n_blocks <= (mapped_size_ - table_offset) / block_info_size,
+                ExcMessage("The binary sidecar file " + file_path + " has a "
+                           "not valid block table."));
+
+    blocks_.resize(n_blocks);
+    uint64_t pos = table_offset;
+    for (auto &block : blocks_)
+    {
+      block.type      = read_field<uint32_t>(data, pos);
+      block.type_size = read_field<uint32_t>(data, pos + 4);
+      block.n_entries = read_field<uint64_t>(data, pos + 8);
+      block.offset    = read_field<uint64_t>(data, pos + 16);
+      pos += block_info_size;
+
+      AssertThrow(block.offset % alignment_ == 0 &&
+                  block.offset <= mapped_size_ &&
+                  block.type_size > 0 &&
+                  block.n_entries <= (mapped_size_ - block.offset) / block.type_size,
+                  ExcMessage("The binary sidecar file " + file_path + " has a "
+                             "not valid block."));
+    }
+  }
+  catch (...)
+  {
+    munmap(const_cast<char *>(mapped_data_), mapped_size_);
+    throw;
+  }
+}
+
+
+
+BinarySidecar::
+~BinarySidecar()
+{
+  if (mapped_data_ != nullptr)
+    munmap(const_cast<char *>(mapped_data_), mapped_size_);
+}
+
+
+
+auto
+BinarySidecar::
+create() -> SelfPtr_
+{
+  return SelfPtr_(new Self_());
+}
+
+
+
+auto
+BinarySidecar::
+open(const string &file_path) -> SelfPtr_
+{
+  return SelfPtr_(new Self_(file_path));
+}
+
+
+
+Size
+BinarySidecar::
+get_num_blocks() const
+{
+  return blocks_.size();
+}
+
+
+
+bool
+BinarySidecar::
+is_mapped() const
+{
+  return mapped_data_ != nullptr;
+}
+
+
+
+template <>
+uint32_t
+BinarySidecar::
+get_type_id<Real>()
+{
+  return 0;
+}
+
+
+
+template <>
+uint32_t
+BinarySidecar::
+get_type_id<Index>()
+{
+  return 1;
+}
+
+
+
+const char *
+BinarySidecar::
+get_file_data() const
+{
+  return mapped_data_ != nullptr ? mapped_data_ : data_.data();
+}
+
+
+
+template <class T>
+Index
+BinarySidecar::
+add_block(const SafeSTLVector<T> &vector)
+{
+  Assert(!this->is_mapped(),
+         ExcMessage("Blocks can not be added to a mapped sidecar."));
+
+  BlockInfo block;
+  block.type = get_type_id<T>();
+  block.type_size = sizeof(T);
+  block.n_entries = vector.size();
+  block.offset = align(data_.size(), alignment_);
+
+  const uint64_t n_bytes = block.n_entries * sizeof(T);
+  data_.resize(block.offset + n_bytes, 0);
+  if (n_bytes > 0)
+    std::memcpy(data_.data() + block.offset, vector.data(), n_bytes);
+
+  blocks_.push_back(block);
+  return blocks_.size() - 1;
+}
+
+
+
+template <class T>
+const T *
+BinarySidecar::
+get_block_data(const Index block_id, Size &n_entries) const
+{
+  AssertThrow(block_id >= 0 && block_id < this->get_num_blocks(),
+              ExcMessage("Block " + std::to_string(block_id) + " not present "
+                         "in the binary sidecar."));
+
+  const auto &block = blocks_[block_id];
+  AssertThrow(block.type == get_type_id<T>() && block.type_size == sizeof(T),
+              ExcMessage("Block " + std::to_string(block_id) + " of the binary "
+                         "sidecar has not the expected type."));
+
+  AssertThrow(block.n_entries <= uint64_t(std::numeric_limits<Size>::max()),
+              ExcBlockTooLarge(block_id, block.n_entries));
+
+  // The check is written as a division for not overflowing the product
+  // n_entries * sizeof(T).
+  const uint64_t data_size = this->is_mapped() ? mapped_size_ : data_.size();
+  AssertThrow(block.offset <= data_size &&
+              block.n_entries <= (data_size - block.offset) / sizeof(T),
+              ExcBlockOutOfRange(block_id, block.offset, block.n_entries, data_size));
+
+  n_entries = block.n_entries;
+  // The block data is aligned (and the mapping starts at a page boundary).
+  return reinterpret_cast<const T *>(this->get_file_data() + block.offset);
+}
+
+
+
+template <class T>
+SafeSTLVector<T>
+BinarySidecar::
+get_block(const Index block_id) const
+{
+  Size n_entries;
+  const T *data = this->get_block_data<T>(block_id, n_entries);
+  return SafeSTLVector<T>(data, data + n_entries);
+}
+
+
+
+void
+BinarySidecar::
+write_to_file(const string &file_path) const
+{
+  Assert(!this->is_mapped(),
+         ExcMessage("A mapped sidecar can not be written."));
+
+  const uint64_t n_blocks = blocks_.size();
+  const uint64_t table_offset = header_size_;
+  const uint64_t data_offset = align(table_offset + n_blocks * block_info_size,
+                                     alignment_);
+  const uint64_t file_size = data_offset + data_.size();
+
+  std::vector<char> head(data_offset, 0);
+  char *data = head.data();
+  std::memcpy(data, sidecar_magic, sizeof(sidecar_magic));
+  write_field(data, version_pos, FORMAT_VERSION);
+  write_field(data, byte_order_pos, sidecar_byte_order);
+  write_field(data, n_blocks_pos, n_blocks);
+  write_field(data, table_pos, table_offset);
+  write_field(data, file_size_pos, file_size);
+
+  // The block offsets are shifted to be relative to the file begin.
+  uint64_t pos = table_offset;
+  for (const auto &block : blocks_)
+  {
+    write_field(data, pos,      block.type);
+    write_field(data, pos + 4,  block.type_size);
+    write_field(data, pos + 8,  block.n_entries);
+    write_field(data, pos + 16, uint64_t(data_offset + block.offset));
+    pos += block_info_size;
+  }
+
+  std::ofstream file(file_path, std::ios::binary);
+  AssertThrow(file.is_open(), ExcMessage("Could not open the file " +
+                                         file_path + " for writing."));
+  file.write(head.data(), head.size());
+  file.write(data_.data(), data_.size());
+  AssertThrow(file.good(), ExcIO());
+}
+
+
+
+template Index BinarySidecar::add_block<Real>(const SafeSTLVector<Real> &);
+template Index BinarySidecar::add_block<Index>(const SafeSTLVector<Index> &);
+template const Real *BinarySidecar::get_block_data<Real>(const Index, Size &) const;
+template const Index *BinarySidecar::get_block_data<Index>(const Index, Size &) const;
+template SafeSTLVector<Real> BinarySidecar::get_block<Real>(const Index) const;
+template SafeSTLVector<Index> BinarySidecar::get_block<Index>(const Index) const;
+
+IGA_NAMESPACE_CLOSE
@@ -26,6 +26,7 @@
 
 #include <igatools/io/xml_document.h>
 #include <igatools/io/xml_element.h>
+#include <igatools/io/binary_sidecar.h>
 #include <igatools/base/objects_container.h>
 
 #include <igatools/geometry/grid.h>
@@ -39,6 +40,9 @@
 
 #include <boost/fusion/algorithm/iteration/for_each.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using std::string;
 using std::to_string;
 using std::shared_ptr;
@@ -57,6 +61,7 @@ parse(const string &file_path)
 {
   const auto xml_doc = XMLDocument::parse_from_file(file_path,
                                                     ObjectsContainerXMLReader::XML_SCHEMA_);
+  Self_::open_binary_sidecar(file_path, xml_doc);
   const auto xml_elem = xml_doc->get_document_element();
 
   const auto container = ObjectsContainer::create();
@@ -92,6 +97,7 @@ parse_const(const string &file_path)
 {
   const auto xml_doc = XMLDocument::parse_from_file(file_path,
                                                     ObjectsContainerXMLReader::XML_SCHEMA_);
+  Self_::open_binary_sidecar(file_path, xml_doc);
   const auto xml_elem = xml_doc->get_document_element();
 
   const auto container = ObjectsContainer::create();
@@ -121,6 +127,25 @@ parse_const(const string &file_path)
 
 
 
+void
+ObjectsContainerXMLReader::
+open_binary_sidecar(const string &file_path,
+                    const shared_ptr<XMLDocument> xml_doc)
+{
+  const auto igatools_elem = xml_doc->get_document_element();
+  if (!igatools_elem->has_attribute("BinarySidecar"))
+    return;
+
+  const auto sidecar_name = igatools_elem->get_attribute<string>("BinarySidecar");
+  const auto sep = file_path.find_last_of('/');
+  const string sidecar_path = sep == string::npos ?
+                              sidecar_name : file_path.substr(0, sep + 1) + sidecar_name;
+
+  xml_doc->set_binary_sidecar(BinarySidecar::open(sidecar_path));
+}
+
+
+
 void
 ObjectsContainerXMLReader::
 parse_grids(const shared_ptr<XMLElement> xml_elem,
@@ -710,6 +735,11 @@ parse_grid(const shared_ptr<XMLElement> xml_elem,
                            ", in Direction=" + to_string(dir) +
                            " Size=" + to_string(size) + " do not match "
                            "with the vector size."));
+    // Checking that the knot vector has at least 2 knots.
+    AssertThrow(knots[dir].size() >= 2,
+                ExcMessage("Parsing knot vectors for " + parsing_msg +
+                           ", in Direction=" + to_string(dir) +
+                           " at least 2 knots must be defined."));
   }
 
   const auto name = parse_name(xml_elem);
@@ -1943,7 +1973,7 @@ shared_ptr<IgCoefficients>
 ObjectsContainerXMLReader::
 parse_ig_coefficients(const shared_ptr<XMLElement> xml_elem,
                       const string &parsing_msg,
-                      const set<Index> &space_global_dofs)
+                      const IndexSet<Index> &space_global_dofs)
 {
   Assert(xml_elem->has_element("IgCoefficients"),
          ExcMessage("IgCoefficients XML element not present."));
@@ -1967,32 +1997,30 @@ parse_ig_coefficients(const shared_ptr<XMLElement> xml_elem,
                          ", Size=" + to_string(size) + " do not match "
                          "with the vector size."));
 
-  set<Index> indices;
-  for (const auto &i : ig_coefs_ind_vec)
-    indices.insert(i);
-  copy(ig_coefs_ind_vec.cbegin(), ig_coefs_ind_vec.cend(),
-       inserter(indices, indices.begin()));
-
-  // Checking that there are not repeated indices.
-  AssertThrow(size == indices.size(),
+  // Checking that there are not repeated indices (on a sorted copy).
+  std::vector<Index> sorted_indices(ig_coefs_ind_vec.cbegin(), ig_coefs_ind_vec.cend());
+  std::sort(sorted_indices.begin(), sorted_indices.end());
+  AssertThrow(std::adjacent_find(sorted_indices.cbegin(), sorted_indices.cend()) ==
+              sorted_indices.cend(),
               ExcMessage("Parsing IgCoefficients for " + parsing_msg +
                          ", not valid indices vector parsed. Repeated "
                          "indices may found."));
 
-  const auto ig_coefs = shared_ptr<IgCoefficients>(new IgCoefficients(indices));
+  // Checking if the parsed indices match with space_global_dofs.
+  for (const auto &ind : sorted_indices)
+    AssertThrow(space_global_dofs.count(ind) == 1,
+                ExcMessage("Parsing IgCoefficients for " + parsing_msg +
+                           ", " + to_string(ind) + " is not a valid index."));
 
-  // Checking if the parsed indices match with space_global_dofs and
-  // filling the values of the ig coefficients vector.
-  const auto end_dofs = space_global_dofs.cend();
+  // The indices are inserted in increasing order.
+  const auto ig_coefs = shared_ptr<IgCoefficients>(new IgCoefficients(
+                          IndexSet<Index>(sorted_indices.cbegin(), sorted_indices.cend())));
+
+  // Filling the values of the ig coefficients vector.
   auto &igc = *ig_coefs;
   auto ind_it = ig_coefs_ind_vec.cbegin();
   for (const auto &val : ig_coefs_val_vec)
-  {
-    AssertThrow(space_global_dofs.find(*ind_it) != end_dofs,
-                ExcMessage("Parsing IgCoefficients for " + parsing_msg +
-                           ", " + to_string(*ind_it) + " is not a valid index."));
     igc[*ind_it++] = val;
-  }
 
   return ig_coefs;
 }
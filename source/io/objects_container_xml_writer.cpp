@@ -28,6 +28,7 @@
 
 #include <igatools/io/xml_document.h>
 #include <igatools/io/xml_element.h>
+#include <igatools/io/binary_sidecar.h>
 
 #include <igatools/geometry/grid.h>
 #include <igatools/functions/grid_function_lib.h>
@@ -54,7 +55,8 @@ IGA_NAMESPACE_OPEN
 void
 ObjectsContainerXMLWriter::
 write(const string &file_path,
-      const ContPtr_ container)
+      const ContPtr_ container,
+      const bool binary_sidecar)
 {
   // Copying the objects container and filling it with all its dependencies.
   const auto full_container = ContPtr_(new
@@ -66,6 +68,17 @@ write(const string &file_path,
   igatools_elem->add_attribute(string("FormatVersion"),
                                ObjectsContainerXMLReader::IGATOOLS_FILE_FORMAT_VERSION);
 
+  const string sidecar_path = file_path + ".bin";
+  if (binary_sidecar)
+  {
+    xml_doc->set_binary_sidecar(BinarySidecar::create());
+
+    // The sidecar is referenced relative to the directory of the XML file.
+    const auto sep = sidecar_path.find_last_of('/');
+    igatools_elem->add_attribute(string("BinarySidecar"),
+                                 sep == string::npos ? sidecar_path : sidecar_path.substr(sep + 1));
+  }
+
   Self_::write_grids(full_container, xml_doc);
   Self_::write_spline_spaces(full_container, xml_doc);
   Self_::write_reference_bases(full_container, xml_doc);
@@ -75,6 +88,9 @@ write(const string &file_path,
   Self_::write_functions(full_container, xml_doc);
 
   xml_doc->write_to_file(file_path);
+
+  if (binary_sidecar)
+    xml_doc->get_binary_sidecar()->write_to_file(sidecar_path);
 }
 
 
@@ -540,7 +556,7 @@ write_grid(const shared_ptr<Grid> grid,
   for (int dir = 0; dir < dim; ++dir)
   {
     const auto &knt_coord = grid->get_knot_coordinates(dir);
-    const auto knot_elem = xml_doc->create_vector_element("Knots", knt_coord);
+    const auto knot_elem = xml_doc->create_data_vector_element("Knots", knt_coord);
     knot_elem->add_attribute("Direction", dir);
     knot_elem->add_attribute("Size", knt_coord.size());
     knots_elem->append_child_element(knot_elem);
@@ -1002,8 +1018,8 @@ create_ig_coefs_xml_element(const IgCoefficients &coefs,
     *it_val++ = it.second;
   }
 
-  const auto indices_xml = xml_doc->create_vector_element("Indices", indices);
-  const auto values_xml  = xml_doc->create_vector_element("Values",  values);
+  const auto indices_xml = xml_doc->create_data_vector_element("Indices", indices);
+  const auto values_xml  = xml_doc->create_data_vector_element("Values",  values);
 
   ic_elem->append_child_element(indices_xml);
   ic_elem->append_child_element(values_xml);
@@ -24,9 +24,19 @@
 //#include <igatools/functions/identity_function.h>
 #include <igatools/base/quadrature_lib.h>
 #include <igatools/functions/grid_function_lib.h>
+#include <igatools/utils/thread_tools.h>
 
 
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#ifdef IGATOOLS_WITH_ZLIB
+#include <zlib.h>
+#endif
 
 using std::shared_ptr;
 using std::string;
@@ -64,6 +74,294 @@ create_domain_from_grid(const shared_ptr<const Grid<dim>> &grid)
   return domain;
 }
 
+
+/**
+ * Tag used to end the lines of the ascii output.
+ * On a file it writes a plain newline (std::endl would flush the file at
+ * every line), while the LogStream needs std::endl for the line prefixes.
+ */
+struct EndLine {};
+
+inline
+std::ostream &
+operator<<(std::ostream &out, const EndLine &)
+{
+  return out << '\n';
+}
+
+inline
+LogStream &
+operator<<(LogStream &out, const EndLine &)
+{
+  return out << endl;
+}
+
+
+
+/**
+ * Returns the optional attribute @p attr_name (e.g. <tt>Scalars</tt>) of the
+ * <tt>PointData</tt> and <tt>CellData</tt> XML elements, listing the @p names
+ * of the data arrays (or an empty string if there are no @p names).
+ */
+inline
+string
+names_attribute(const string &attr_name, const SafeSTLVector<string> &names)
+{
+  string attr;
+  if (!names.empty())
+  {
+    attr += " " + attr_name + "=\"";
+    for (const string &name : names)
+      attr += name + " ";
+    attr += "\"";
+  }
+  return attr;
+}
+
+
+
+/**
+ * Target number of points written for each block of IGA elements
+ * by the binary output.
+ */
+const Size n_points_per_block = 1 << 16;
+
+
+
+/**
+ * Returns the flat id (with the first direction running faster)
+ * of the entry @p tensor_id of a multi-array of size @p size,
+ * using 64 bits integers.
+ */
+template<int dim>
+inline
+std::int64_t
+flat_id_64(const TensorIndex<dim> &tensor_id, const TensorSize<dim> &size)
+{
+  std::int64_t flat_id = 0;
+  for (int i = dim-1 ; i >= 0 ; --i)
+    flat_id = flat_id * size[i] + tensor_id[i];
+  return flat_id;
+}
+
+
+
+/**
+ * Returns the number of entries of a multi-array of size @p size,
+ * using 64 bits integers.
+ */
+template<int dim>
+inline
+std::int64_t
+flat_size_64(const TensorSize<dim> &size)
+{
+  std::int64_t flat_size = 1;
+  for (int i = 0 ; i < dim ; ++i)
+    flat_size *= size[i];
+  return flat_size;
+}
+
+
+
+/**
+ * Writes the arrays of the appended data section of a .vtu file
+ * (with <tt>header_type="UInt64"</tt>), either raw or compressed with zlib
+ * in the blocks format of <tt>vtkZLibDataCompressor</tt>.
+ *
+ * The data of an array are passed incrementally with append().
+ * When compressing, the data are buffered until <tt>n_threads</tt> blocks
+ * are available, then the blocks are compressed concurrently and written
+ * in order; the sizes of the compressed blocks are written in the array
+ * header when the array is completed.
+ */
+class AppendedDataStream
+{
+public:
+  using Header = std::uint64_t;
+
+  AppendedDataStream(std::ofstream &file, const bool compress, const int n_threads)
+    :
+    file_(file),
+    compress_(compress),
+    n_threads_(n_threads),
+    first_pos_(file.tellp())
+  {
+    Assert(n_threads_ > 0, ExcLowerRange(n_threads_,1));
+#ifndef IGATOOLS_WITH_ZLIB
+    Assert(!compress_, ExcMessage("igatools is built without zlib support."));
+#endif
+  }
+
+  /**
+   * Starts a new array of @p n_bytes bytes, writing its header.
+   * Returns the offset of the array from the beginning of the appended data.
+   */
+  Header begin_array(const Header n_bytes)
+  {
+    Assert(n_missing_bytes_ == 0,
+           ExcMessage("The previous array has not been completed."));
+    const Header offset = file_.tellp() - first_pos_;
+    n_missing_bytes_ = n_bytes;
+
+    if (compress_)
+    {
+      const Header n_blocks = (n_bytes + block_size_ - 1) / block_size_;
+      const Header header[3] = {n_blocks, block_size_, n_bytes % block_size_};
+      this->write(header,3);
+
+      sizes_pos_ = file_.tellp();
+      compressed_sizes_.assign(n_blocks,0);
+      this->write(compressed_sizes_.data(),n_blocks);
+      n_compressed_blocks_ = 0;
+    }
+    else
+      this->write(&n_bytes,1);
+
+    return offset;
+  }
+
+  /**
+   * Appends @p n values to the current array.
+   */
+  template<class V>
+  void append(const V *data, const Size n)
+  {
+    const Header n_bytes = n * sizeof(V);
+    Assert(n_bytes <= n_missing_bytes_,
+           ExcMessage("Too many data for the current array."));
+    n_missing_bytes_ -= n_bytes;
+
+    if (compress_)
+    {
+      const char *bytes = reinterpret_cast<const char *>(data);
+      buffer_.insert(buffer_.end(),bytes,bytes+n_bytes);
+      if (buffer_.size() >= n_threads_ * block_size_)
+        this->compress_buffer();
+    }
+    else
+      this->write(data,n);
+  }
+
+  /**
+   * Completes the current array.
+   */
+  void end_array()
+  {
+    Assert(n_missing_bytes_ == 0,
+           ExcMessage("Missing data for the current array."));
+    if (compress_)
+    {
+      this->compress_buffer();
+      Assert(n_compressed_blocks_ == compressed_sizes_.size(),
+             ExcDimensionMismatch(n_compressed_blocks_,compressed_sizes_.size()));
+
+      const auto end_pos = file_.tellp();
+      file_.seekp(sizes_pos_);
+      this->write(compressed_sizes_.data(),compressed_sizes_.size());
+      file_.seekp(end_pos);
+    }
+    AssertThrow(file_.good(), ExcMessage("Error writing the appended data."));
+  }
+
+private:
+  template<class V>
+  void write(const V *data, const Size n)
+  {
+    file_.write(reinterpret_cast<const char *>(data), n * sizeof(V));
+  }
+
+  /**
+   * Compresses and writes the full blocks in the buffer,
+   * and also the last partial block if the array is complete.
+   */
+  void compress_buffer()
+  {
+#ifdef IGATOOLS_WITH_ZLIB
+    const Size n_full_blocks = buffer_.size() / block_size_;
+    const bool last_block = (n_missing_bytes_ == 0) && (buffer_.size() % block_size_ > 0);
+    const Size n_blocks = n_full_blocks + (last_block ? 1 : 0);
+    if (n_blocks == 0)
+      return;
+
+    compressed_blocks_.resize(n_blocks);
+    const auto chunks = thread_tools::split_range(n_blocks,n_threads_);
+    thread_tools::run_in_parallel(chunks.size()-1,[&](const int t)
+    {
+      for (Index b = chunks[t] ; b < chunks[t+1] ; ++b)
+      {
+        const Header first = b * block_size_;
+        const uLong n_bytes = std::min(block_size_, Header(buffer_.size()) - first);
+
+        auto &block = compressed_blocks_[b];
+        uLongf compressed_size = compressBound(n_bytes);
+        block.resize(compressed_size);
+        const int status = compress2(block.data(), &compressed_size,
+                                     reinterpret_cast<const Bytef *>(&buffer_[first]),
+                                     n_bytes, Z_BEST_SPEED);
+        AssertThrow(status == Z_OK, ExcMessage("Error in the zlib compression."));
+        block.resize(compressed_size);
+      }
+    });
+
+    for (const auto &block : compressed_blocks_)
+    {
+      this->write(block.data(),block.size());
+      compressed_sizes_[n_compressed_blocks_++] = block.size();
+    }
+
+    buffer_.erase(buffer_.begin(),
+                  buffer_.begin() + std::min(Header(buffer_.size()),n_blocks * block_size_));
+#endif
+  }
+
+  std::ofstream &file_;
+
+  const bool compress_;
+
+  const int n_threads_;
+
+  const std::ofstream::pos_type first_pos_;
+
+  /**
+   * Size (in bytes) of the uncompressed blocks.
+   */
+  const Header block_size_ = 1 << 18;
+
+  Header n_missing_bytes_ = 0;
+
+  std::ofstream::pos_type sizes_pos_;
+
+  std::vector<Header> compressed_sizes_;
+
+  Size n_compressed_blocks_ = 0;
+
+  std::vector<char> buffer_;
+
+  std::vector<std::vector<unsigned char>> compressed_blocks_;
+};
+
+
+
+/**
+ * Returns the tensor indices of the vertices of the VTK element
+ * (line, quadrilateral or hexahedron) in the VTK ordering.
+ */
+template<int dim>
+SafeSTLVector< SafeSTLArray<int,dim> >
+vtk_vertices_tensor_id()
+{
+  const int vertices[8][3] = {{0,0,0},{1,0,0},{1,1,0},{0,1,0},
+    {0,0,1},{1,0,1},{1,1,1},{0,1,1}
+  };
+
+  SafeSTLVector< SafeSTLArray<int,dim> > vertices_id(1 << dim);
+  for (int v = 0 ; v < (1 << dim) ; ++v)
+    for (int i = 0 ; i < dim ; ++i)
+      vertices_id[v][i] = vertices[v][i];
+
+  return vertices_id;
+}
+
 };
 
 
@@ -105,11 +403,12 @@ Writer(const shared_ptr<const Domain<dim,codim> > &domain,
   num_points_direction_(quad_plot_->get_num_coords_direction()),
   n_iga_elements_(domain->get_grid_function()->get_grid()->get_num_all_elems()),
   n_points_per_iga_element_(quad_plot_->get_num_points()),
-  n_vtk_points_(n_iga_elements_*n_points_per_iga_element_),
+  n_vtk_points_(std::int64_t(n_iga_elements_)*n_points_per_iga_element_),
   sizeof_Real_(sizeof(T)),
   sizeof_int_(sizeof(int)),
   sizeof_uchar_(sizeof(unsigned char)),
-  offset_(0)
+  n_threads_(thread_tools::get_default_num_threads()),
+  merge_shared_points_(false)
 {
   Assert(domain_ != nullptr, ExcNullPtr());
   Assert(quad_plot_ != nullptr, ExcNullPtr());
@@ -153,11 +452,6 @@ Writer(const shared_ptr<const Domain<dim,codim> > &domain,
   //--------------------------------------------------------------------------
 
 
-  //--------------------------------------------------------------------------
-  appended_data_ << '_';
-  //--------------------------------------------------------------------------
-
-
   if (dim == 1)
   {
     vtk_element_type_ = 3; // VTK_LINE
@@ -257,61 +551,7 @@ get_subelements(
 
   const int iga_element_id = elem_flat_id;
 
-  SafeSTLVector< SafeSTLArray<int,dim> > delta_idx(n_vertices_per_vtk_element_);
-
-  if (dim == 1)
-  {
-    delta_idx[0][0] = 0;
-    delta_idx[1][0] = 1;
-  }
-  else if (dim == 2)
-  {
-    delta_idx[0][0] = 0;
-    delta_idx[0][1] = 0;
-
-    delta_idx[1][0] = 1;
-    delta_idx[1][1] = 0;
-
-    delta_idx[2][0] = 1;
-    delta_idx[2][1] = 1;
-
-    delta_idx[3][0] = 0;
-    delta_idx[3][1] = 1;
-  }
-  else if (dim == 3)
-  {
-    delta_idx[0][0] = 0;
-    delta_idx[0][1] = 0;
-    delta_idx[0][2] = 0;
-
-    delta_idx[1][0] = 1;
-    delta_idx[1][1] = 0;
-    delta_idx[1][2] = 0;
-
-    delta_idx[2][0] = 1;
-    delta_idx[2][1] = 1;
-    delta_idx[2][2] = 0;
-
-    delta_idx[3][0] = 0;
-    delta_idx[3][1] = 1;
-    delta_idx[3][2] = 0;
-
-    delta_idx[4][0] = 0;
-    delta_idx[4][1] = 0;
-    delta_idx[4][2] = 1;
-
-    delta_idx[5][0] = 1;
-    delta_idx[5][1] = 0;
-    delta_idx[5][2] = 1;
-
-    delta_idx[6][0] = 1;
-    delta_idx[6][1] = 1;
-    delta_idx[6][2] = 1;
-
-    delta_idx[7][0] = 0;
-    delta_idx[7][1] = 1;
-    delta_idx[7][2] = 1;
-  }
+  const auto delta_idx = vtk_vertices_tensor_id<dim>();
   //--------------------------------------------------------------------------
 
 
@@ -413,10 +653,11 @@ add_point_data(const int n_values_per_point,
   Assert(type == "scalar" || type == "vector" || type == "tensor",
          ExcMessage("The point_data type can only be \"scalar\", \"vector\" or \"tensor\" (and not \"" + type + "\")"));
 
-  shared_ptr<SafeSTLVector<T>> data_ptr(new SafeSTLVector<T>(n_iga_elements_ * n_points_per_iga_element_ * n_values_per_point));
-  auto &data = *data_ptr;
+  shared_ptr<SafeSTLVector<T>> data_ptr(new SafeSTLVector<T>(
+                                         std::int64_t(n_iga_elements_) * n_points_per_iga_element_ * n_values_per_point));
+  T *const data = data_ptr->data();
 
-  Index pos = 0;
+  std::int64_t pos = 0;
   for (const auto &data_element : data_iga_elements)
   {
     Assert(data_element.size() == n_points_per_iga_element_,
@@ -457,43 +698,171 @@ add_point_data(const int n_values_per_point,
 
 
 
+template<int dim, int codim, class T>
+void
+Writer<dim, codim, T>::
+set_num_threads(const int n_threads)
+{
+  Assert(n_threads > 0, ExcLowerRange(n_threads,1));
+  n_threads_ = n_threads;
+}
+
+
+
+template<int dim, int codim, class T>
+void
+Writer<dim, codim, T>::
+set_merge_shared_points(const bool merge)
+{
+  if (merge)
+  {
+    for (int i = 0 ; i < dim ; ++i)
+    {
+      const auto &coords = quad_plot_->get_coords_direction(i);
+      AssertThrow(coords.front() == 0.0 && coords.back() == 1.0,
+                  ExcMessage("The points shared by adjacent VTK elements can be merged "
+                             "only if the plot points include the vertices of the IGA elements."));
+    }
+  }
+  merge_shared_points_ = merge;
+}
+
+
+
 template<int dim, int codim, class T>
 void Writer<dim, codim, T>::
 save(const string &filename, const string &format) const
 {
   //--------------------------------------------------------------------------
-  Assert(format == "ascii" || format == "appended",
-         ExcMessage("Unsupported format."));
+  AssertThrow(format == "ascii" || format == "appended" || format == "compressed",
+              ExcMessage("Unsupported format."));
   //--------------------------------------------------------------------------
 
-  SafeSTLVector< SafeSTLVector< SafeSTLArray<T,3> > >
-  points_in_iga_elements(n_iga_elements_, SafeSTLVector< SafeSTLArray<T,3> >(n_points_per_iga_element_));
-
-  SafeSTLVector< SafeSTLVector< SafeSTLArray< int, n_vertices_per_vtk_element_> > >
-  vtk_elements_connectivity(n_iga_elements_);
-  for (auto &iga_elem_connectivity : vtk_elements_connectivity)
-    iga_elem_connectivity.resize(n_vtk_elements_per_iga_element_);
-
-  this->fill_points_and_connectivity(points_in_iga_elements, vtk_elements_connectivity);
-
   const string vtu_filename = filename + ".vtu";
 
-
   if (format == "ascii")
   {
+    SafeSTLVector< SafeSTLVector< SafeSTLArray<T,3> > >
+    points_in_iga_elements(n_iga_elements_, SafeSTLVector< SafeSTLArray<T,3> >(n_points_per_iga_element_));
+
+    SafeSTLVector< SafeSTLVector< SafeSTLArray< int, n_vertices_per_vtk_element_> > >
+    vtk_elements_connectivity(n_iga_elements_);
+    for (auto &iga_elem_connectivity : vtk_elements_connectivity)
+      iga_elem_connectivity.resize(n_vtk_elements_per_iga_element_);
+
+    this->fill_points_and_connectivity(points_in_iga_elements, vtk_elements_connectivity);
+
     ofstream file(vtu_filename);
     file.setf(ios::scientific);
     file.precision(precision_);
     this->save_ascii(file, points_in_iga_elements, vtk_elements_connectivity);
   }
-  else if (format == "appended")
+  else
   {
-    this->save_appended(vtu_filename, points_in_iga_elements, vtk_elements_connectivity);
+#ifdef IGATOOLS_WITH_ZLIB
+    const bool compress = (format == "compressed");
+#else
+    const bool compress = false;
+#endif
+    const Size n_layers = domain_->get_grid_function()->get_grid()->get_num_intervals()[dim-1];
+    this->save_binary(vtu_filename, compress, this->get_lexicographic_elements(),
+                      0, n_layers, n_threads_);
   }
 }
 
 
 
+template<int dim, int codim, class T>
+void Writer<dim, codim, T>::
+save_pieces(const string &filename, const int n_pieces, const string &format) const
+{
+  AssertThrow(format == "appended" || format == "compressed",
+              ExcMessage("Unsupported format."));
+  Assert(n_pieces > 0, ExcLowerRange(n_pieces,1));
+
+#ifdef IGATOOLS_WITH_ZLIB
+  const bool compress = (format == "compressed");
+#else
+  const bool compress = false;
+#endif
+
+  //--------------------------------------------------------------------------
+  // the pieces are made by layers of IGA elements along the last direction
+  const Size n_layers = domain_->get_grid_function()->get_grid()->get_num_intervals()[dim-1];
+  const auto pieces = thread_tools::split_range(n_layers,n_pieces);
+  const int n_active_pieces = pieces.size() - 1;
+
+  // the .vtu files are referenced in the .pvtu without the directory
+  const auto dir_end = filename.find_last_of('/');
+  const string basename = (dir_end == string::npos) ? filename : filename.substr(dir_end + 1);
+  auto piece_filename = [](const string &name, const int piece)
+  {
+    return name + "_" + to_string(piece) + ".vtu";
+  };
+
+  const auto elems = this->get_lexicographic_elements();
+  const int n_threads_piece = std::max(1, n_threads_ / n_active_pieces);
+  thread_tools::run_in_parallel(n_active_pieces,[&](const int piece)
+  {
+    this->save_binary(piece_filename(filename,piece), compress, elems,
+                      pieces[piece], pieces[piece+1], n_threads_piece);
+  });
+  //--------------------------------------------------------------------------
+
+
+  //--------------------------------------------------------------------------
+  // writing the .pvtu file
+  const string pvtu_filename = filename + ".pvtu";
+  ofstream file(pvtu_filename);
+  AssertThrow(file.good(), ExcMessage("Error opening the file " + pvtu_filename));
+
+  const string tab1("\t");
+  const string tab2 = tab1 + tab1;
+  const string tab3 = tab2 + tab1;
+
+  file << "<?xml version=\"1.0\"?>\n";
+  file << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << byte_order_
+       << "\" header_type=\"UInt64\">\n";
+  file << tab1 << "<PUnstructuredGrid GhostLevel=\"0\">\n";
+
+  file << tab2 << "<PPoints>\n";
+  file << tab3 << "<PDataArray type=\"" << string_Real_ << "\" NumberOfComponents=\"3\"/>\n";
+  file << tab2 << "</PPoints>\n";
+
+  file << tab2 << "<PPointData"
+       << names_attribute("Scalars",names_point_data_scalar_)
+       << names_attribute("Vectors",names_point_data_vector_)
+       << names_attribute("Tensors",names_point_data_tensor_) << ">\n";
+  for (const auto &point_data : fields_)
+    file << tab3 << "<PDataArray Name=\"" << point_data.name_
+         << "\" type=\"" << string_Real_
+         << "\" NumberOfComponents=\"" << point_data.num_components_ << "\"/>\n";
+  file << tab2 << "</PPointData>\n";
+
+  file << tab2 << "<PCellData"
+       << names_attribute("Scalars",names_cell_data_scalar_)
+       << names_attribute("Vectors",names_cell_data_vector_)
+       << names_attribute("Tensors",names_cell_data_tensor_) << ">\n";
+  for (const auto &cell_data : cell_data_double_)
+    file << tab3 << "<PDataArray Name=\"" << cell_data.name_
+         << "\" type=\"" << string_Real_
+         << "\" NumberOfComponents=\"" << cell_data.num_components_ << "\"/>\n";
+  for (const auto &cell_data : cell_data_int_)
+    file << tab3 << "<PDataArray Name=\"" << cell_data.name_
+         << "\" type=\"Int32\" NumberOfComponents=\"" << cell_data.num_components_ << "\"/>\n";
+  file << tab2 << "</PCellData>\n";
+
+  for (int piece = 0 ; piece < n_active_pieces ; ++piece)
+    file << tab2 << "<Piece Source=\"" << piece_filename(basename,piece) << "\"/>\n";
+
+  file << tab1 << "</PUnstructuredGrid>\n";
+  file << "</VTKFile>\n";
+  AssertThrow(file.good(), ExcMessage("Error writing the file " + pvtu_filename));
+  //--------------------------------------------------------------------------
+}
+
+
+
 template<int dim, int codim, class T>
 template<class Out>
 void Writer<dim, codim, T>::
@@ -507,48 +876,49 @@ save_ascii(Out &file,
   const string tab3 = tab2 + tab1;
   const string tab4 = tab3 + tab1;
   const string tab5 = tab4 + tab1;
+  const EndLine eol;
 
-  file << "<?xml version=\"1.0\"?>" << endl;
-  file << "<VTKFile type=\"UnstructuredGrid\" byte_order=\"" << byte_order_ << "\">" << endl;
+  file << "<?xml version=\"1.0\"?>" << eol;
+  file << "<VTKFile type=\"UnstructuredGrid\" byte_order=\"" << byte_order_ << "\">" << eol;
 
-  file << tab1 << "<UnstructuredGrid>" << endl;
+  file << tab1 << "<UnstructuredGrid>" << eol;
 
-  file << tab2 << "<Piece NumberOfPoints=\"" << to_string(n_vtk_points_) << "\" NumberOfCells=\""<< to_string(n_vtk_elements_) << "\">" << endl;
+  file << tab2 << "<Piece NumberOfPoints=\"" << to_string(n_vtk_points_) << "\" NumberOfCells=\""<< to_string(n_vtk_elements_) << "\">" << eol;
 
-  file << tab3 << "<Points>" << endl;
-  file << tab4 << "<DataArray type=\"" << string_Real_ << "\" NumberOfComponents=\"3\" format=\"ascii\">" << endl;
+  file << tab3 << "<Points>" << eol;
+  file << tab4 << "<DataArray type=\"" << string_Real_ << "\" NumberOfComponents=\"3\" format=\"ascii\">" << eol;
 
   for (const auto &point_in_iga_element : points_in_iga_elements)
     for (const auto &point : point_in_iga_element)
-      file << tab5 << point[0] << " " << point[1] << " " << point[2] << endl;
+      file << tab5 << point[0] << " " << point[1] << " " << point[2] << eol;
 
-  file << tab4 << "</DataArray>" << endl;
-  file << tab3 << "</Points>" << endl;
+  file << tab4 << "</DataArray>" << eol;
+  file << tab3 << "</Points>" << eol;
 
-  file << tab3 << "<Cells>" << endl;
-  file << tab4 << "<DataArray Name=\"connectivity\" type=\"" << string_int_ << "\" format=\"ascii\">" << endl;
+  file << tab3 << "<Cells>" << eol;
+  file << tab4 << "<DataArray Name=\"connectivity\" type=\"" << string_int_ << "\" format=\"ascii\">" << eol;
   file << tab5;
   for (const auto &iga_elem_connectivity : vtk_elements_connectivity)
     for (const auto &vtk_elem_connectivity : iga_elem_connectivity)
       for (const auto &point_id : vtk_elem_connectivity)
         file << point_id << " ";
-  file << endl;
-  file << tab4 << "</DataArray>" << endl;
+  file << eol;
+  file << tab4 << "</DataArray>" << eol;
 
-  file << tab4 << "<DataArray Name=\"offsets\" type=\"" << string_int_ << "\" format=\"ascii\">" << endl;
+  file << tab4 << "<DataArray Name=\"offsets\" type=\"" << string_int_ << "\" format=\"ascii\">" << eol;
   file << tab5;
   for (int vtk_elem_id = 1; vtk_elem_id <= n_vtk_elements_; ++vtk_elem_id)
     file << n_vertices_per_vtk_element_ * vtk_elem_id << " ";
-  file << endl;
-  file << tab4 << "</DataArray>" << endl;
+  file << eol;
+  file << tab4 << "</DataArray>" << eol;
 
-  file << tab4 << "<DataArray Name=\"types\" type=\"" << string_uchar_ << "\" format=\"ascii\">" << endl;
+  file << tab4 << "<DataArray Name=\"types\" type=\"" << string_uchar_ << "\" format=\"ascii\">" << eol;
   file << tab5;
   for (int vtk_elem_id = 1; vtk_elem_id <= n_vtk_elements_; ++vtk_elem_id)
     file << static_cast<int>(vtk_element_type_) << " ";
-  file << endl;
-  file << tab4 << "</DataArray>" << endl;
-  file << tab3 << "</Cells>" << endl;
+  file << eol;
+  file << tab4 << "</DataArray>" << eol;
+  file << tab3 << "</Cells>" << eol;
 
 
   //--------------------------------------------------------------------------
@@ -576,22 +946,22 @@ save_ascii(Out &file,
     point_data_optional_attr+= "\"";
   }
 
-  file << tab3 << "<PointData" << point_data_optional_attr << ">" << endl;
+  file << tab3 << "<PointData" << point_data_optional_attr << ">" << eol;
   for (const auto &point_data : fields_)
   {
     file << tab4 << "<DataArray Name=\"" << point_data.name_
          << "\" type=\"" << string_Real_
          << "\" NumberOfComponents=\""<< point_data.num_components_
-         << "\" format=\"ascii\">" << endl;
+         << "\" format=\"ascii\">" << eol;
 
     file << tab5;
     for (const auto &v : *point_data.values_)
       file << v << " ";
-    file << endl;
+    file << eol;
 
-    file << tab4 << "</DataArray>" << endl;
+    file << tab4 << "</DataArray>" << eol;
   }
-  file << tab3 << "</PointData>" << endl;
+  file << tab3 << "</PointData>" << eol;
   //--------------------------------------------------------------------------
 
 
@@ -620,278 +990,460 @@ save_ascii(Out &file,
     cell_data_optional_attr+= "\"";
   }
 
-  file << tab3 << "<CellData" << cell_data_optional_attr << ">" << endl;
+  file << tab3 << "<CellData" << cell_data_optional_attr << ">" << eol;
   for (const auto &cell_data : cell_data_double_)
   {
     file << tab4 << "<DataArray Name=\"" << cell_data.name_
          << "\" type=\"" << string_Real_
          << "\" NumberOfComponents=\""<< cell_data.num_components_
-         << "\" format=\"ascii\">" << endl;
+         << "\" format=\"ascii\">" << eol;
     file << tab5;
     for (const double &v : *cell_data.values_)
       file << v << " ";
-    file << endl;
-    file << tab4 << "</DataArray>" << endl;
+    file << eol;
+    file << tab4 << "</DataArray>" << eol;
   }
   for (const auto &cell_data : cell_data_int_)
   {
     file << tab4 << "<DataArray Name=\"" << cell_data.name_
          << "\" type=\"" << string_int_
          << "\" NumberOfComponents=\""<< cell_data.num_components_
-         << "\" format=\"ascii\">" << endl;
+         << "\" format=\"ascii\">" << eol;
     file << tab5;
     for (const int &v : *cell_data.values_)
       file << v << " ";
-    file << endl;
-    file << tab4 << "</DataArray>" << endl;
+    file << eol;
+    file << tab4 << "</DataArray>" << eol;
   }
-  file << tab3 << "</CellData>" << endl;
+  file << tab3 << "</CellData>" << eol;
   //--------------------------------------------------------------------------
 
-  file << tab2 << "</Piece>" << endl;
-  file << tab1 << "</UnstructuredGrid>" << endl;
+  file << tab2 << "</Piece>" << eol;
+  file << tab1 << "</UnstructuredGrid>" << eol;
   file << "</VTKFile>";
 }
 
 
 
 template<int dim, int codim, class T>
-void Writer<dim, codim, T>::
-save_appended(const string &filename,
-              const SafeSTLVector< SafeSTLVector< SafeSTLArray<T,3> > > &points_in_iga_elements,
-              const SafeSTLVector< SafeSTLVector< SafeSTLArray< int,n_vertices_per_vtk_element_> > >
-              &vtk_elements_connectivity) const
+auto
+Writer<dim, codim, T>::
+get_lexicographic_elements() const -> LexicographicElements
 {
-  ofstream file(filename);
-  file.setf(ios::scientific);
-  file.precision(precision_);
-
-  const string tab1("\t");
-  const string tab2 = tab1 + tab1;
-  const string tab3 = tab2 + tab1;
-  const string tab4 = tab3 + tab1;
-  const string tab5 = tab4 + tab1;
-
-  int offset = 0;
-
-
-  file << "<?xml version=\"1.0\"?>" << endl;
-  file << "<VTKFile type=\"UnstructuredGrid\" byte_order=\"" << byte_order_ << "\">" << endl;
-
-  file << tab1 << "<UnstructuredGrid>" << endl;
-
-  file << tab2 << "<Piece NumberOfPoints=\"" << to_string(n_vtk_points_) << "\" NumberOfCells=\""<< to_string(n_vtk_elements_) << "\">" << endl;
-
-  file << tab3 << "<Points>" << endl;
-  file << tab4 << "<DataArray type=\"" << string_Real_ << "\" NumberOfComponents=\"3\" format=\"appended\" offset=\"" << offset << "\"/>" << endl;
-  const int n_bytes_points = n_vtk_points_ * 3 * sizeof_Real_;
-  offset += sizeof_int_ + n_bytes_points;
-  file << tab3 << "</Points>" << endl;
-
-
-  file << tab3 << "<Cells>" << endl;
-  file << tab4 << "<DataArray Name=\"connectivity\" type=\"" << string_int_ << "\" format=\"appended\" offset=\"" << offset << "\"/>" << endl;
-  const int n_bytes_connectivity = n_vtk_elements_ * n_vertices_per_vtk_element_ * sizeof_int_;
-  offset += sizeof_int_ + n_bytes_connectivity;
-
+  const auto grid = domain_->get_grid_function()->get_grid();
+  const auto &elems_id = grid->get_elements_with_property(ElementProperties::active);
+  AssertThrow(Size(elems_id.size()) == n_iga_elements_,
+              ExcMessage("The binary output requires all the IGA elements to be active."));
+
+  const TensorSize<dim> n_elems_dir = grid->get_num_intervals();
+
+  LexicographicElements elems;
+  elems.index.resize(n_iga_elements_);
+  elems.position.resize(n_iga_elements_);
+  Index position = 0;
+  for (const auto &elem_id : elems_id)
+  {
+    const auto lex_id = flat_id_64(elem_id.get_tensor_index(),n_elems_dir);
+    elems.index[lex_id] = &elem_id;
+    elems.position[lex_id] = position++;
+  }
+  return elems;
+}
 
-  file << tab4 << "<DataArray Name=\"offsets\" type=\"" << string_int_ << "\" format=\"appended\" offset=\"" << offset << "\"/>" << endl;
-  const int n_bytes_offsets = n_vtk_elements_ * sizeof_int_;
-  offset += sizeof_int_ + n_bytes_offsets;
 
 
-  file << tab4 << "<DataArray Name=\"types\" type=\"" << string_uchar_ << "\" format=\"appended\" offset=\"" << offset << "\"/>" << endl;
-  const int n_bytes_types = n_vtk_elements_ * sizeof_uchar_;
-  offset += sizeof_int_ + n_bytes_types;
-  file << tab3 << "</Cells>" << endl;
+template<int dim, int codim, class T>
+void Writer<dim, codim, T>::
+save_binary(const string &filename, const bool compress,
+            const LexicographicElements &lex_elems,
+            const Index piece_first_layer, const Index piece_last_layer,
+            const int n_threads) const
+{
+  using Header = AppendedDataStream::Header;
+  using Int = std::int64_t;
 
+  const auto &elems_index = lex_elems.index;
+  const auto &elems_position = lex_elems.position;
 
   //--------------------------------------------------------------------------
-  // writing the <PointData> section
-  string point_data_optional_attr;
-  if (!names_point_data_scalar_.empty())
-  {
-    point_data_optional_attr += " Scalars=\"";
-    for (const string &name : names_point_data_scalar_)
-      point_data_optional_attr += name + " ";
-    point_data_optional_attr+= "\"";
-  }
-  if (!names_point_data_vector_.empty())
-  {
-    point_data_optional_attr += " Vectors=\"";
-    for (const string &name : names_point_data_vector_)
-      point_data_optional_attr += name + " ";
-    point_data_optional_attr+= "\"";
-  }
-  if (!names_point_data_tensor_.empty())
-  {
-    point_data_optional_attr += " Tensors=\"";
-    for (const string &name : names_point_data_tensor_)
-      point_data_optional_attr += name + " ";
-    point_data_optional_attr+= "\"";
-  }
-
-  SafeSTLVector<int> n_bytes_point_data;
-  file << tab3 << "<PointData" << point_data_optional_attr << ">" << endl;
-  for (const auto &point_data : fields_)
-  {
-
-    file << tab4 << "<DataArray Name=\"" << point_data.name_
-         << "\" type=\"" << string_Real_
-         << "\" NumberOfComponents=\""<< point_data.num_components_
-         << "\" format=\"appended\" offset=\"" << offset << "\"/>" << endl;
-
-    n_bytes_point_data.emplace_back(point_data.values_->size() * sizeof_Real_);
-    offset += sizeof_int_ + n_bytes_point_data.back();
-  }
-  file << tab3 << "</PointData>" << endl;
+  // The IGA elements are processed in lexicographic order (with the first
+  // direction running faster), in blocks of layers along the last direction.
+  const TensorSize<dim> n_elems_dir = domain_->get_grid_function()->get_grid()->get_num_intervals();
+
+  const Size n_elems_layer = n_iga_elements_ / n_elems_dir[dim-1];
+  const Size n_layers_block =
+    std::max(Size(1), Size(n_points_per_block / (n_elems_layer * n_points_per_iga_element_)));
+  const Int piece_first_lex_id = Int(piece_first_layer) * n_elems_layer;
+  const Size n_piece_elems = (piece_last_layer - piece_first_layer) * n_elems_layer;
   //--------------------------------------------------------------------------
 
 
   //--------------------------------------------------------------------------
-  // writing the <CellData> section
-  string cell_data_optional_attr;
-  if (!names_cell_data_scalar_.empty())
+  // If the shared points are merged, the points are the ones of the lattice
+  // made by the plot points of all the IGA elements of the piece; otherwise
+  // each IGA element has its own points.
+  const TensorSize<dim> n_pts_dir = num_points_direction_;
+  TensorSize<dim> n_lattice_pts_dir;
+  TensorIndex<dim> last_elem_id;
+  for (int i = 0 ; i < dim ; ++i)
   {
-    cell_data_optional_attr += " Scalars=\"";
-    for (const string &name : names_cell_data_scalar_)
-      cell_data_optional_attr += name + " ";
-    cell_data_optional_attr+= "\"";
+    n_lattice_pts_dir[i] = n_elems_dir[i] * (n_pts_dir[i] - 1) + 1;
+    last_elem_id[i] = n_elems_dir[i] - 1;
   }
-  if (!names_cell_data_vector_.empty())
+  n_lattice_pts_dir[dim-1] = (piece_last_layer - piece_first_layer) * (n_pts_dir[dim-1] - 1) + 1;
+  last_elem_id[dim-1] = piece_last_layer - 1;
+  const Index piece_first_pt = piece_first_layer * (n_pts_dir[dim-1] - 1);
+
+  const Header n_points = merge_shared_points_ ?
+                          Header(flat_size_64(n_lattice_pts_dir)) :
+                          Header(n_piece_elems) * n_points_per_iga_element_;
+  const Header n_cells = Header(n_piece_elems) * n_vtk_elements_per_iga_element_;
+
+  // Calls func(lex_elem_id,local_point_id) for each point written
+  // for the layers [first_layer,last_layer), in the output order.
+  auto for_each_point = [&](const Index first_layer, const Index last_layer, const auto &func)
   {
-    cell_data_optional_attr += " Vectors=\"";
-    for (const string &name : names_cell_data_vector_)
-      cell_data_optional_attr += name + " ";
-    cell_data_optional_attr+= "\"";
-  }
-  if (!names_cell_data_tensor_.empty())
-  {
-    cell_data_optional_attr += " Tensors=\"";
-    for (const string &name : names_cell_data_tensor_)
-      cell_data_optional_attr += name + " ";
-    cell_data_optional_attr+= "\"";
-  }
+    if (merge_shared_points_)
+    {
+      const Index first = first_layer * (n_pts_dir[dim-1] - 1);
+      const Index last = last_layer * (n_pts_dir[dim-1] - 1) + (last_layer == piece_last_layer ? 1 : 0);
+
+      TensorSize<dim> n_block_pts_dir = n_lattice_pts_dir;
+      n_block_pts_dir[dim-1] = last - first;
+
+      TensorIndex<dim> pt_id;
+      pt_id[dim-1] = first;
+      TensorIndex<dim> elem_id;
+      TensorIndex<dim> local_pt_id;
+      const Int n_block_pts = flat_size_64(n_block_pts_dir);
+      for (Int i = 0 ; i < n_block_pts ; ++i)
+      {
+        for (int k = 0 ; k < dim ; ++k)
+        {
+          elem_id[k] = std::min(pt_id[k] / (n_pts_dir[k] - 1), last_elem_id[k]);
+          local_pt_id[k] = pt_id[k] - elem_id[k] * (n_pts_dir[k] - 1);
+        }
+        func(flat_id_64(elem_id,n_elems_dir), flat_id_64(local_pt_id,n_pts_dir));
+
+        for (int k = 0 ; k < dim ; ++k)
+        {
+          if (++pt_id[k] < n_lattice_pts_dir[k] || k == dim-1)
+            break;
+          pt_id[k] = 0;
+        }
+      }
+    }
+    else
+    {
+      for (Int lex_id = Int(first_layer) * n_elems_layer ;
+           lex_id < Int(last_layer) * n_elems_layer ; ++lex_id)
+        for (Index pt = 0 ; pt < n_points_per_iga_element_ ; ++pt)
+          func(lex_id,pt);
+    }
+  };
+  //--------------------------------------------------------------------------
 
-  file << tab3 << "<CellData" << cell_data_optional_attr << ">" << endl;
 
-  SafeSTLVector<int> n_bytes_cell_data_double;
-  for (const auto &cell_data : cell_data_double_)
+  //--------------------------------------------------------------------------
+  // The points of the IGA elements are evaluated concurrently: each thread
+  // owns its element accessor and cache handler.
+  const int n_eval_threads = std::max(1, std::min(n_threads, n_elems_layer * n_layers_block));
+  using Handler = typename Domain<dim,codim>::Handler;
+  using ElemAccessor = typename Domain<dim,codim>::ElementAccessor;
+  std::vector<std::unique_ptr<Handler>> handlers;
+  std::vector<std::unique_ptr<ElemAccessor>> elems;
+  for (int t = 0 ; t < n_eval_threads ; ++t)
   {
-    file << tab4 << "<DataArray Name=\"" << cell_data.name_
-         << "\" type=\"" << string_Real_
-         << "\" NumberOfComponents=\""<< cell_data.num_components_
-         << "\" format=\"appended\" offset=\"" << offset << "\"/>" << endl;
-
-    n_bytes_cell_data_double.emplace_back(cell_data.values_->size() * sizeof_Real_);
-    offset += sizeof_int_ + n_bytes_cell_data_double.back();
+    handlers.emplace_back(domain_->create_cache_handler());
+    handlers.back()->template set_flags<dim>(domain_element::Flags::point);
+    elems.emplace_back(domain_->create_element_begin(ElementProperties::active));
+    handlers.back()->init_cache(*elems.back(),quad_plot_);
   }
 
-  SafeSTLVector<int> n_bytes_cell_data_int;
-  for (const auto &cell_data : cell_data_int_)
+  const int space_dim = dim + codim;
+  std::vector<T> elems_points;
+  auto evaluate_points = [&](const Int first_lex_id, const Size n_elems)
   {
-    file << tab4 << "<DataArray Name=\"" << cell_data.name_
-         << "\" type=\"" << string_int_
-         << "\" NumberOfComponents=\""<< cell_data.num_components_
-         << "\" format=\"appended\" offset=\"" << offset << "\"/>" << endl;
-
-    n_bytes_cell_data_int.emplace_back(cell_data.values_->size() * sizeof_int_);
-    offset += sizeof_int_ + n_bytes_cell_data_int.back();
-  }
-  file << tab3 << "</CellData>" << endl;
+    elems_points.resize(Header(n_elems) * n_points_per_iga_element_ * 3);
+    const auto chunks = thread_tools::split_range(n_elems,n_eval_threads);
+    thread_tools::run_in_parallel(chunks.size()-1,[&](const int t)
+    {
+      auto &elem = *elems[t];
+      auto &handler = *handlers[t];
+      for (Index i = chunks[t] ; i < chunks[t+1] ; ++i)
+      {
+        elem.move_to(*elems_index[first_lex_id + i]);
+        handler.template fill_cache<dim>(elem,0);
+        const auto &points = elem.template get_points<dim>(0);
+
+        T *elem_points = &elems_points[Header(i) * n_points_per_iga_element_ * 3];
+        for (int pt = 0 ; pt < n_points_per_iga_element_ ; ++pt, elem_points += 3)
+        {
+          const auto &point = points[pt];
+          for (int k = 0 ; k < space_dim ; ++k)
+            elem_points[k] = point[k];
+          for (int k = space_dim ; k < 3 ; ++k)
+            elem_points[k] = T(0.0);
+        }
+      }
+    });
+  };
   //--------------------------------------------------------------------------
 
 
+  //--------------------------------------------------------------------------
+  // Writing the XML part of the file. The offsets of the arrays in the
+  // appended data are written at the end, over fixed width placeholders.
+  ofstream file(filename, ios::binary);
+  AssertThrow(file.good(), ExcMessage("Error opening the file " + filename));
 
-  file << tab2 << "</Piece>" << endl;
+  const string tab1("\t");
+  const string tab2 = tab1 + tab1;
+  const string tab3 = tab2 + tab1;
+  const string tab4 = tab3 + tab1;
 
-  file << tab1 << "</UnstructuredGrid>" << endl;
+  const int offset_width = 20;
+  std::vector<ofstream::pos_type> offset_positions;
+  auto data_array = [&](const string &name, const string &type, const int n_components)
+  {
+    file << tab4 << "<DataArray";
+    if (!name.empty())
+      file << " Name=\"" << name << "\"";
+    file << " type=\"" << type << "\"";
+    if (n_components > 0)
+      file << " NumberOfComponents=\"" << n_components << "\"";
+    file << " format=\"appended\" offset=\"";
+    offset_positions.emplace_back(file.tellp());
+    file << string(offset_width,'0') << "\"/>\n";
+  };
+
+  file << "<?xml version=\"1.0\"?>\n";
+  file << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << byte_order_
+       << "\" header_type=\"UInt64\"";
+  if (compress)
+    file << " compressor=\"vtkZLibDataCompressor\"";
+  file << ">\n";
+  file << tab1 << "<UnstructuredGrid>\n";
+  file << tab2 << "<Piece NumberOfPoints=\"" << n_points << "\" NumberOfCells=\"" << n_cells << "\">\n";
+
+  file << tab3 << "<Points>\n";
+  data_array("",string_Real_,3);
+  file << tab3 << "</Points>\n";
+
+  file << tab3 << "<Cells>\n";
+  data_array("connectivity","Int64",0);
+  data_array("offsets","Int64",0);
+  data_array("types",string_uchar_,0);
+  file << tab3 << "</Cells>\n";
+
+  file << tab3 << "<PointData"
+       << names_attribute("Scalars",names_point_data_scalar_)
+       << names_attribute("Vectors",names_point_data_vector_)
+       << names_attribute("Tensors",names_point_data_tensor_) << ">\n";
+  for (const auto &point_data : fields_)
+    data_array(point_data.name_,string_Real_,point_data.num_components_);
+  file << tab3 << "</PointData>\n";
 
+  file << tab3 << "<CellData"
+       << names_attribute("Scalars",names_cell_data_scalar_)
+       << names_attribute("Vectors",names_cell_data_vector_)
+       << names_attribute("Tensors",names_cell_data_tensor_) << ">\n";
+  for (const auto &cell_data : cell_data_double_)
+    data_array(cell_data.name_,string_Real_,cell_data.num_components_);
+  for (const auto &cell_data : cell_data_int_)
+    data_array(cell_data.name_,"Int32",cell_data.num_components_);
+  file << tab3 << "</CellData>\n";
 
-  file << tab1 << "<AppendedData encoding=\"raw\">" << endl;
+  file << tab2 << "</Piece>\n";
+  file << tab1 << "</UnstructuredGrid>\n";
+  file << tab1 << "<AppendedData encoding=\"raw\">\n";
   file << tab2 << "_";
-
-  //--------------------------------------------------------------------------
-  // writing the points coordinate
-  file.write((char *) &n_bytes_points, sizeof_int_);
-  for (const auto &point_in_iga_element : points_in_iga_elements)
-    for (const auto &point : point_in_iga_element)
-      file.write((char *) &point[0], 3 * sizeof_Real_);
   //--------------------------------------------------------------------------
 
-  //--------------------------------------------------------------------------
-  // writing the element connectivity
-  file.write((char *) &n_bytes_connectivity, sizeof_int_);
-  for (const auto &iga_elem_connectivity : vtk_elements_connectivity)
-    for (const auto &vtk_elem_connectivity : iga_elem_connectivity)
-      file.write((char *) vtk_elem_connectivity.data(), n_vertices_per_vtk_element_ * sizeof_int_);
-  //--------------------------------------------------------------------------
 
   //--------------------------------------------------------------------------
-  // writing the element offsets
-  file.write((char *) &n_bytes_offsets, sizeof_int_);
-  for (int i = 1; i <= n_vtk_elements_; ++i)
-  {
-    const int tmp = i * n_vertices_per_vtk_element_;
-    file.write((char *) &tmp, sizeof_int_);
-  }
-  //--------------------------------------------------------------------------
+  // Writing the appended data, one block of layers of IGA elements at a time.
+  AppendedDataStream stream(file,compress,n_threads);
+  std::vector<Header> offsets;
 
+  auto for_each_block = [&](const auto &func)
+  {
+    for (Index first_layer = piece_first_layer ; first_layer < piece_last_layer ;
+         first_layer += n_layers_block)
+      func(first_layer, std::min(first_layer + n_layers_block, piece_last_layer));
+  };
+
+  // points
+  std::vector<T> points_buffer;
+  offsets.emplace_back(stream.begin_array(n_points * 3 * sizeof(T)));
+  for_each_block([&](const Index first_layer, const Index last_layer)
+  {
+    const Int first_lex_id = Int(first_layer) * n_elems_layer;
+    evaluate_points(first_lex_id,(last_layer - first_layer) * n_elems_layer);
 
-  //--------------------------------------------------------------------------
-  // writing the element types
-  file.write((char *) &n_bytes_types, sizeof_int_);
-  for (int vtk_elem_id = 1; vtk_elem_id <= n_vtk_elements_; ++vtk_elem_id)
-    file.write((char *) &vtk_element_type_, sizeof_uchar_);
-  //--------------------------------------------------------------------------
-
+    points_buffer.clear();
+    for_each_point(first_layer,last_layer,[&](const Int lex_id, const Index pt)
+    {
+      const T *point = &elems_points[((lex_id - first_lex_id) * n_points_per_iga_element_ + pt) * 3];
+      points_buffer.insert(points_buffer.end(),point,point+3);
+    });
+    stream.append(points_buffer.data(),points_buffer.size());
+  });
+  stream.end_array();
+
+  // connectivity
+  const TensorSize<dim> n_cells_dir = num_subelements_direction_;
+  std::vector<TensorIndex<dim>> cells_id;
+  for (Index cell = 0 ; cell < n_vtk_elements_per_iga_element_ ; ++cell)
+  {
+    TensorIndex<dim> cell_id;
+    Index flat = cell;
+    for (int k = 0 ; k < dim ; ++k)
+    {
+      cell_id[k] = flat % n_cells_dir[k];
+      flat /= n_cells_dir[k];
+    }
+    cells_id.emplace_back(cell_id);
+  }
 
+  const auto vertices_id = vtk_vertices_tensor_id<dim>();
+  std::vector<Int> connectivity_buffer;
+  offsets.emplace_back(stream.begin_array(n_cells * n_vertices_per_vtk_element_ * sizeof(Int)));
+  for_each_block([&](const Index first_layer, const Index last_layer)
+  {
+    connectivity_buffer.clear();
+    for (Int lex_id = Int(first_layer) * n_elems_layer ;
+         lex_id < Int(last_layer) * n_elems_layer ; ++lex_id)
+    {
+      TensorIndex<dim> elem_id;
+      Int flat = lex_id;
+      for (int k = 0 ; k < dim ; ++k)
+      {
+        elem_id[k] = flat % n_elems_dir[k];
+        flat /= n_elems_dir[k];
+      }
 
-  //--------------------------------------------------------------------------
-  // writing the point data
-  const int n_point_data = fields_.size();
-  for (int i = 0; i < n_point_data; ++i)
+      for (const auto &cell_id : cells_id)
+        for (const auto &vertex : vertices_id)
+        {
+          TensorIndex<dim> pt_id;
+          for (int k = 0 ; k < dim ; ++k)
+            pt_id[k] = cell_id[k] + vertex[k];
+
+          if (merge_shared_points_)
+          {
+            for (int k = 0 ; k < dim ; ++k)
+              pt_id[k] += elem_id[k] * (n_pts_dir[k] - 1);
+            pt_id[dim-1] -= piece_first_pt;
+            connectivity_buffer.emplace_back(flat_id_64(pt_id,n_lattice_pts_dir));
+          }
+          else
+            connectivity_buffer.emplace_back((lex_id - piece_first_lex_id) * n_points_per_iga_element_ +
+                                             flat_id_64(pt_id,n_pts_dir));
+        }
+    }
+    stream.append(connectivity_buffer.data(),connectivity_buffer.size());
+  });
+  stream.end_array();
+
+  // offsets and types
+  const Int n_cells_block = Int(n_elems_layer) * n_layers_block * n_vtk_elements_per_iga_element_;
+  offsets.emplace_back(stream.begin_array(n_cells * sizeof(Int)));
+  for (Int first = 0 ; first < Int(n_cells) ; first += n_cells_block)
   {
-    file.write((char *) &n_bytes_point_data[i], sizeof_int_);
-    file.write((char *) fields_[i].values_->data(), n_bytes_point_data[i]);
+    connectivity_buffer.clear();
+    for (Int cell = first ; cell < std::min(first + n_cells_block, Int(n_cells)) ; ++cell)
+      connectivity_buffer.emplace_back((cell + 1) * n_vertices_per_vtk_element_);
+    stream.append(connectivity_buffer.data(),connectivity_buffer.size());
   }
-  //--------------------------------------------------------------------------
+  stream.end_array();
 
+  const std::vector<unsigned char> types(std::min(Int(n_cells),n_cells_block),vtk_element_type_);
+  offsets.emplace_back(stream.begin_array(n_cells * sizeof(unsigned char)));
+  for (Int first = 0 ; first < Int(n_cells) ; first += n_cells_block)
+    stream.append(types.data(),std::min(n_cells_block, Int(n_cells) - first));
+  stream.end_array();
 
+  // point data (evaluated by add_field()), streamed one block at a time
+  std::vector<T> data_buffer;
+  for (const auto &point_data : fields_)
+  {
+    const Size n_comps = point_data.num_components_;
+    const Header n_values_elem = Header(n_points_per_iga_element_) * n_comps;
+    const T *values = point_data.values_->data();
 
-  //--------------------------------------------------------------------------
-  // writing the cell data (double)
-  const int n_cell_data_double = cell_data_double_.size();
-  for (int i = 0; i < n_cell_data_double; ++i)
+    offsets.emplace_back(stream.begin_array(n_points * n_comps * sizeof(T)));
+    for_each_block([&](const Index first_layer, const Index last_layer)
+    {
+      data_buffer.clear();
+      for_each_point(first_layer,last_layer,[&](const Int lex_id, const Index pt)
+      {
+        const T *value = values + Header(elems_position[lex_id]) * n_values_elem + pt * n_comps;
+        data_buffer.insert(data_buffer.end(),value,value+n_comps);
+      });
+      stream.append(data_buffer.data(),data_buffer.size());
+    });
+    stream.end_array();
+  }
+
+  // cell data (in the same order of the IGA elements of the connectivity).
+  // The data can be given for each IGA element (and in this case they are
+  // repeated on its VTK elements) or for each VTK element.
+  auto write_cell_data = [&](const auto &values, const Size n_comps, auto &buffer)
   {
-    file.write((char *) &n_bytes_cell_data_double[i], sizeof_int_);
+    using V = typename std::remove_reference<decltype(buffer)>::type::value_type;
+    const Size n_values = values.size();
+    AssertThrow(n_values == n_iga_elements_ * n_comps ||
+                n_values == n_vtk_elements_ * n_comps,
+                ExcMessage("The cell data must be given for each IGA element or for each VTK element."));
+    const Size n_vtk_values = (n_values == n_vtk_elements_ * n_comps) ?
+                              n_vtk_elements_per_iga_element_ : 1;
+
+    offsets.emplace_back(stream.begin_array(n_cells * n_comps * sizeof(V)));
+    for_each_block([&](const Index first_layer, const Index last_layer)
+    {
+      buffer.clear();
+      for (Int lex_id = Int(first_layer) * n_elems_layer ;
+           lex_id < Int(last_layer) * n_elems_layer ; ++lex_id)
+      {
+        const Header first = Header(elems_position[lex_id]) * n_vtk_values * n_comps;
+        for (Index cell = 0 ; cell < n_vtk_elements_per_iga_element_ ; ++cell)
+        {
+          const Header cell_first = first + (n_vtk_values > 1 ? cell * n_comps : 0);
+          for (Header i = cell_first ; i < cell_first + n_comps ; ++i)
+            buffer.emplace_back(values[i]);
+        }
+      }
+      stream.append(buffer.data(),buffer.size());
+    });
+    stream.end_array();
+  };
 
-    const int n_values = cell_data_double_[i].values_->size();
-    //here we convert the type double in CellData.values_ to type T
-    SafeSTLVector<T> buffer(n_values);
-    for (int j = 0; j < n_values; ++j)
-      buffer[j] = (*cell_data_double_[i].values_)[j];
+  for (const auto &cell_data : cell_data_double_)
+    write_cell_data(*cell_data.values_,cell_data.num_components_,data_buffer);
 
-    file.write((char *) buffer.data(), n_bytes_cell_data_double[i]);
-  }
+  std::vector<int> int_buffer;
+  for (const auto &cell_data : cell_data_int_)
+    write_cell_data(*cell_data.values_,cell_data.num_components_,int_buffer);
+
+  file << "\n" << tab1 << "</AppendedData>\n";
+  file << "</VTKFile>\n";
   //--------------------------------------------------------------------------
 
 
   //--------------------------------------------------------------------------
-  // writing the cell data (int)
-  const int n_cell_data_int = cell_data_int_.size();
-  for (int i = 0; i < n_cell_data_int; ++i)
+  // Writing the offsets in the XML part of the file.
+  Assert(offsets.size() == offset_positions.size(),
+         ExcDimensionMismatch(offsets.size(),offset_positions.size()));
+  for (Size i = 0 ; i < offsets.size() ; ++i)
   {
-    file.write((char *) &n_bytes_cell_data_int[i], sizeof_int_);
-    file.write((char *) cell_data_int_[i].values_->data(), n_bytes_cell_data_int[i]);
+    std::ostringstream offset;
+    offset << std::setw(offset_width) << std::setfill('0') << offsets[i];
+    file.seekp(offset_positions[i]);
+    file << offset.str();
   }
+  AssertThrow(file.good(), ExcMessage("Error writing the file " + filename));
   //--------------------------------------------------------------------------
-
-
-  file << endl;
-  file << tab1 << "</AppendedData>" << endl;
-
-  file << "</VTKFile>";
 }
 
 
@@ -23,6 +23,7 @@
 #ifdef IGATOOLS_WITH_XML_IO
 
 #include <igatools/io/xml_element.h>
+#include <igatools/io/binary_sidecar.h>
 #include <igatools/base/logstream.h>
 #include <igatools/utils/safe_stl_vector.h>
 
@@ -225,7 +226,7 @@ auto
 XMLDocument::
 get_document_element() const -> XMLElemPtr_
 {
-  return XMLElement::create(xml_doc_->getDocumentElement());
+  return XMLElement::create(xml_doc_->getDocumentElement(), sidecar_);
 }
 
 
@@ -360,6 +361,40 @@ create_vector_element(const std::string &name,
 
 
 
+template <class T>
+auto
+XMLDocument::
+create_data_vector_element(const std::string &name,
+                           const SafeSTLVector<T> &vec) const -> XMLElemPtr_
+{
+  if (sidecar_ == nullptr)
+    return this->create_vector_element(name, vec);
+
+  const auto new_elem = this->create_new_element(name);
+  new_elem->add_attribute("BinaryBlock", sidecar_->add_block(vec));
+  return new_elem;
+}
+
+
+
+void
+XMLDocument::
+set_binary_sidecar(const shared_ptr<BinarySidecar> sidecar)
+{
+  sidecar_ = sidecar;
+}
+
+
+
+auto
+XMLDocument::
+get_binary_sidecar() const -> shared_ptr<BinarySidecar>
+{
+  return sidecar_;
+}
+
+
+
 void
 XMLDocument::
 write_to_file(const string &file_path,
@@ -560,6 +595,10 @@ template shared_ptr<XMLElement> XMLDocument::create_vector_element<float>
 (const std::string &, const SafeSTLVector<float> &, const int &, const bool) const;
 template shared_ptr<XMLElement> XMLDocument::create_vector_element<Index>
 (const std::string &, const SafeSTLVector<Index> &, const int &, const bool) const;
+template shared_ptr<XMLElement> XMLDocument::create_data_vector_element<Real>
+(const std::string &, const SafeSTLVector<Real> &) const;
+template shared_ptr<XMLElement> XMLDocument::create_data_vector_element<Index>
+(const std::string &, const SafeSTLVector<Index> &) const;
 
 IGA_NAMESPACE_CLOSE
 
@@ -23,6 +23,8 @@
 #ifdef IGATOOLS_WITH_XML_IO
 
 #include <igatools/utils/safe_stl_vector.h>
+#include <igatools/utils/number_parser.h>
+#include <igatools/io/binary_sidecar.h>
 
 #include <xercesc/util/XMLString.hpp>
 #include <xercesc/dom/DOMElement.hpp>
@@ -47,9 +49,11 @@ IGA_NAMESPACE_OPEN
 
 
 XMLElement::
-XMLElement(const DOMElemPtr_ dom_elem)
+XMLElement(const DOMElemPtr_ dom_elem,
+           const shared_ptr<const BinarySidecar> sidecar)
   :
-  root_elem_(dom_elem)
+  root_elem_(dom_elem),
+  sidecar_(sidecar)
 {
   Assert(root_elem_ != nullptr, ExcNullPtr());
 }
@@ -58,10 +62,11 @@ XMLElement(const DOMElemPtr_ dom_elem)
 
 auto
 XMLElement::
-create(const DOMElemPtr_ dom_elem) ->
+create(const DOMElemPtr_ dom_elem,
+       const shared_ptr<const BinarySidecar> sidecar) ->
 SelfPtr_
 {
-  return SelfPtr_(new XMLElement(dom_elem));
+  return SelfPtr_(new XMLElement(dom_elem, sidecar));
 }
 
 
@@ -85,7 +90,7 @@ SafeSTLVector<SelfPtr_>
     {
       const auto elem_ptr = dynamic_cast<DOMElemPtr_>(n);
       Assert(elem_ptr != nullptr, ExcNullPtr());
-      children.push_back(Self_::create(elem_ptr));
+      children.push_back(Self_::create(elem_ptr, sidecar_));
     }
   }
 
@@ -113,7 +118,7 @@ SafeSTLVector<SelfPtr_>
     {
       const auto elem_ptr = dynamic_cast<DOMElemPtr_>(n);
       Assert(elem_ptr != nullptr, ExcNullPtr());
-      children.push_back(Self_::create(elem_ptr));
+      children.push_back(Self_::create(elem_ptr, sidecar_));
     }
   }
 
@@ -326,25 +331,20 @@ SafeSTLVector<Real>
 XMLElement::
 get_values_vector() const
 {
-  SafeSTLVector<Real> data;
-  const auto text_elem = this->get_single_text_element();
-
-  const string str = XMLString::transcode(text_elem->getWholeText());
-
-  try
+  if (this->has_attribute("BinaryBlock"))
   {
-    Real v;
-    std::stringstream line_stream(str);
-    while (line_stream >> v)
-      data.push_back(v);
-
-  }
-  catch (...)
-  {
-    AssertThrow(false, ExcMessage("Impossible to parse vector."));
+    AssertThrow(sidecar_ != nullptr,
+                ExcMessage("The element " + this->get_name() + " refers to a "
+                           "binary block, but no binary sidecar is present."));
+    return sidecar_->get_block<Real>(this->get_attribute<Index>("BinaryBlock"));
   }
 
-  return data;
+  const auto text_elem = this->get_single_text_element();
+
+  // The whole text (i.e. including the adjacent text nodes) is parsed in
+  // place, without transcoding it.
+  const XMLCh *text = text_elem->getWholeText();
+  return number_parser::parse_values<Real>(text, XMLString::stringLen(text));
 }
 
 
@@ -354,25 +354,20 @@ SafeSTLVector<Index>
 XMLElement::
 get_values_vector() const
 {
-  SafeSTLVector<Index> data;
-  const auto text_elem = this->get_single_text_element();
-
-  const string str = XMLString::transcode(text_elem->getWholeText());
-
-  try
+  if (this->has_attribute("BinaryBlock"))
   {
-    Index v;
-    std::stringstream line_stream(str);
-    while (line_stream >> v)
-      data.push_back(v);
-
-  }
-  catch (...)
-  {
-    AssertThrow(false, ExcMessage("Impossible to parse vector."));
+    AssertThrow(sidecar_ != nullptr,
+                ExcMessage("The element " + this->get_name() + " refers to a "
+                           "binary block, but no binary sidecar is present."));
+    return sidecar_->get_block<Index>(this->get_attribute<Index>("BinaryBlock"));
   }
 
-  return data;
+  const auto text_elem = this->get_single_text_element();
+
+  // The whole text (i.e. including the adjacent text nodes) is parsed in
+  // place, without transcoding it.
+  const XMLCh *text = text_elem->getWholeText();
+  return number_parser::parse_values<Index>(text, XMLString::stringLen(text));
 }
 
 
@@ -447,7 +442,7 @@ get_single_element() -> SelfPtr_
     if (n->getNodeType() && // true is not NULL
     n->getNodeType() == DOMNode::ELEMENT_NODE)  // is element
     {
-      element = Self_::create(dynamic_cast<DOMElemPtr_>(n));
+      element = Self_::create(dynamic_cast<DOMElemPtr_>(n), sidecar_);
       break;
     }
   }
@@ -487,7 +482,7 @@ get_single_element(const string &name) -> SelfPtr_
     auto *elem = dynamic_cast<DOMElemPtr_>(children->item(c));
     if (elem != nullptr && XMLString::transcode(elem->getNodeName()) == name)
     {
-      element = Self_::create(elem);
+      element = Self_::create(elem, sidecar_);
       ++n_matching_childs;
     }
   }
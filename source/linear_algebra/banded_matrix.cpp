@@ -0,0 +1,188 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+
+#include <igatools/linear_algebra/banded_matrix.h>
+#include <igatools/base/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+
+IGA_NAMESPACE_OPEN
+
+BandedMatrix::
+BandedMatrix(const Size n_rows, const Size bandwidth)
+  :
+  n_rows_(n_rows),
+  bandwidth_(bandwidth),
+  entries_(n_rows * (bandwidth+1), 0.0)
+{
+  Assert(n_rows >= 0, ExcLowerRange(n_rows,0));
+  Assert(bandwidth >= 0, ExcLowerRange(bandwidth,0));
+}
+
+
+
+Size
+BandedMatrix::
+get_num_rows() const
+{
+  return n_rows_;
+}
+
+
+
+Size
+BandedMatrix::
+get_bandwidth() const
+{
+  return bandwidth_;
+}
+
+
+
+Real &
+BandedMatrix::
+operator()(const Index i, const Index j)
+{
+  const Index row = std::max(i,j);
+  const Index col = std::min(i,j);
+  Assert(row < n_rows_, ExcIndexRange(row,0,n_rows_));
+  Assert(row - col <= bandwidth_,
+         ExcMessage("The entry (" + std::to_string(i) + "," + std::to_string(j) +
+                    ") is outside the band."));
+  return entries_[row * (bandwidth_+1) + bandwidth_ + col - row];
+}
+
+
+
+Real
+BandedMatrix::
+operator()(const Index i, const Index j) const
+{
+  const Index row = std::max(i,j);
+  const Index col = std::min(i,j);
+  Assert(col >= 0, ExcLowerRange(col,0));
+  Assert(row < n_rows_, ExcIndexRange(row,0,n_rows_));
+  if (row - col > bandwidth_)
+    return 0.0;
+  return entries_[row * (bandwidth_+1) + bandwidth_ + col - row];
+}
+
+
+
+void
+BandedMatrix::
+vmult(const Real *x, Real *y, const Size stride) const
+{
+  Assert(!factorized_, ExcMessage("The matrix has been factorized."));
+
+  const Size w = bandwidth_ + 1;
+  for (Index i = 0 ; i < n_rows_ ; ++i)
+    y[i*stride] = 0.0;
+
+  for (Index i = 0 ; i < n_rows_ ; ++i)
+  {
+    const Real *row = &entries_[i * w + bandwidth_];
+    Real y_i = row[0] * x[i*stride];
+    for (Index k = 1 ; k <= std::min(bandwidth_,i) ; ++k)
+    {
+      // a_{i,i-k} = a_{i-k,i}
+      y_i += row[-k] * x[(i-k)*stride];
+      y[(i-k)*stride] += row[-k] * x[i*stride];
+    }
+    y[i*stride] += y_i;
+  }
+}
+
+
+
+void
+BandedMatrix::
+factorize()
+{
+  Assert(!factorized_, ExcMessage("The matrix has been already factorized."));
+
+  const Size w = bandwidth_ + 1;
+  for (Index i = 0 ; i < n_rows_ ; ++i)
+  {
+    Real *row_i = &entries_[i * w + bandwidth_];
+    const Index first = std::max(Index(0), i - bandwidth_);
+    for (Index j = first ; j <= i ; ++j)
+    {
+      const Real *row_j = &entries_[j * w + bandwidth_];
+      // l_{ij} = (a_{ij} - sum_{k<j} l_{ik} l_{jk}) / l_{jj}
+      Real s = row_i[j-i];
+      for (Index k = std::max(first, j - bandwidth_) ; k < j ; ++k)
+        s -= row_i[k-i] * row_j[k-j];
+
+      if (j < i)
+        row_i[j-i] = s / row_j[0];
+      else
+      {
+        AssertThrow(s > 0.0, ExcMessage("The matrix is not positive definite."));
+        row_i[0] = std::sqrt(s);
+      }
+    }
+  }
+  factorized_ = true;
+}
+
+
+
+bool
+BandedMatrix::
+is_factorized() const
+{
+  return factorized_;
+}
+
+
+
+void
+BandedMatrix::
+solve(Real *x, const Size stride) const
+{
+  Assert(factorized_, ExcMessage("The matrix has not been factorized."));
+
+  const Size w = bandwidth_ + 1;
+
+  // forward substitution: L z = b
+  for (Index i = 0 ; i < n_rows_ ; ++i)
+  {
+    const Real *row = &entries_[i * w + bandwidth_];
+    Real s = x[i*stride];
+    for (Index k = 1 ; k <= std::min(bandwidth_,i) ; ++k)
+      s -= row[-k] * x[(i-k)*stride];
+    x[i*stride] = s / row[0];
+  }
+
+  // backward substitution: L^T x = z
+  for (Index i = n_rows_ - 1 ; i >= 0 ; --i)
+  {
+    x[i*stride] /= entries_[i * w + bandwidth_];
+    const Real x_i = x[i*stride];
+    const Real *row = &entries_[i * w + bandwidth_];
+    for (Index k = 1 ; k <= std::min(bandwidth_,i) ; ++k)
+      x[(i-k)*stride] -= row[-k] * x_i;
+  }
+}
+
+IGA_NAMESPACE_CLOSE
@@ -51,9 +51,9 @@ DenseMatrix(const Index n,const bool init_to_zero)
 DenseMatrix &
 DenseMatrix::operator=(const Real value)
 {
-  using zero_matrix = boost::numeric::ublas::zero_matrix<Real>;
   Assert(value==0, ExcNonZero(value));
-  *this = zero_matrix(this->size1(), this->size2());
+  // zeroing the entries in place (i.e. without allocating a temporary matrix)
+  this->clear();
   return *this;
 }
 
@@ -542,6 +542,68 @@ void eig_dense_matrix_symm(const DenseMatrix &A,
     }
   }
 }
+
+
+
+void eig_dense_matrix_symm_generalized(const DenseMatrix &A,
+                                       const DenseMatrix &B,
+                                       SafeSTLVector<Real> &eigenvalues,
+                                       DenseMatrix &eigenvectors)
+{
+  const int n = A.get_num_rows();
+#ifndef NDEBUG
+  Assert(n == A.get_num_cols(),ExcDimensionMismatch(n,A.get_num_cols()));
+  Assert(A.is_symmetric(),ExcMessage("The matrix A is not symmetric."));
+  Assert(B.get_num_rows() == n,ExcDimensionMismatch(B.get_num_rows(),n));
+  Assert(B.get_num_cols() == n,ExcDimensionMismatch(B.get_num_cols(),n));
+  Assert(B.is_symmetric(),ExcMessage("The matrix B is not symmetric."));
+#endif
+
+  eigenvalues.resize(n);
+
+  Teuchos::LAPACK<int, double> lapack;
+  int info;
+
+  const int workspace_size = std::max(10*n,1); // this should be >= 3*n-1
+  SafeSTLVector<double> workspace(workspace_size);
+
+  // A and B are symmetric, therefore the row-wise storage is the same of the
+  // column-wise storage assumed by the Lapack SYGV routine,
+  // but the output eigenvectors are sorted column-wise
+  DenseMatrix eigenvectors_trans = A;
+  DenseMatrix B_factor = B;
+  const int itype = 1; // A u = lambda B u
+  const char jobz = 'V'; // computes eigenvalues and eigenvectors
+  const char uplo = 'L'; // using the lower triangular part of the matrices
+  lapack.SYGV(itype,
+              jobz,
+              uplo,
+              n,
+              const_cast<Real *>(&(eigenvectors_trans.data()[0])),
+              n,
+              const_cast<Real *>(&(B_factor.data()[0])),
+              n,
+              eigenvalues.data(),
+              workspace.data(),
+              workspace_size,
+              &info);
+  if (info > n)
+  {
+    AssertThrow(false,ExcMessage("The matrix B is not positive definite."));
+  }
+  else if (info > 0)
+  {
+    AssertThrow(false,ExcMessage("The algorithm failed to converge."));
+  }
+  else if (info < 0)
+  {
+    AssertThrow(false,ExcMessage("The " + std::to_string(std::abs(info)) + "-th argument " +
+                                 "had an illegal value."));
+  }
+
+  // the eigenvalues are returned in ascending order
+  eigenvectors = boost::numeric::ublas::trans(eigenvectors_trans);
+}
 #endif // IGATOOLS_USES_TRILINOS
 
 
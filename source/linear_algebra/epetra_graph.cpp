@@ -20,6 +20,8 @@
 
 #include <igatools/linear_algebra/epetra_graph.h>
 
+#include <algorithm>
+
 IGA_NAMESPACE_OPEN
 
 #ifdef IGATOOLS_USES_TRILINOS
@@ -31,24 +33,51 @@ GraphPtr
 create_graph(const std::map<Index,std::set<Index>> &dofs_connectivity,
              const Comm &comm)
 {
-  const int n_rows = dofs_connectivity.size();
-  SafeSTLVector<Size> n_dofs_per_row(n_rows);
+  const Size n_rows = dofs_connectivity.size();
+  Size n_entries = 0;
+  for (const auto &row_id_and_dofs : dofs_connectivity)
+    n_entries += row_id_and_dofs.second.size();
 
-  std::set<Index> row_all_dofs;
-  std::set<Index> col_all_dofs;
+  SafeSTLVector<Index> rows_id;
+  SafeSTLVector<Index> offsets;
+  SafeSTLVector<Index> cols_id;
+  rows_id.reserve(n_rows);
+  offsets.reserve(n_rows+1);
+  cols_id.reserve(n_entries);
 
-  Index j = 0;
+  offsets.emplace_back(0);
   for (const auto &row_id_and_dofs : dofs_connectivity)
   {
-    const auto &col_dofs = row_id_and_dofs.second;
-    n_dofs_per_row[j++] = col_dofs.size();
-
-    row_all_dofs.insert(row_id_and_dofs.first);
-    col_all_dofs.insert(col_dofs.begin(),col_dofs.end());
+    rows_id.emplace_back(row_id_and_dofs.first);
+    cols_id.insert(cols_id.end(),row_id_and_dofs.second.begin(),row_id_and_dofs.second.end());
+    offsets.emplace_back(cols_id.size());
   }
-  const auto row_map = create_map(row_all_dofs,comm);
-  const auto col_map = create_map(col_all_dofs,comm);
 
+  return create_graph(SparsityPattern(std::move(rows_id),std::move(offsets),std::move(cols_id)),
+                      comm);
+}
+
+
+
+GraphPtr
+create_graph(const SparsityPattern &pattern,
+             const Comm &comm)
+{
+  const auto &rows_id = pattern.get_rows_id();
+  const auto &offsets = pattern.get_offsets();
+  const auto &cols_id = pattern.get_cols_id();
+  const Size n_rows = pattern.get_num_rows();
+
+  SafeSTLVector<Size> n_dofs_per_row(n_rows);
+  for (Index i = 0 ; i < n_rows ; ++i)
+    n_dofs_per_row[i] = offsets[i+1] - offsets[i];
+
+  SafeSTLVector<Index> col_all_dofs(cols_id.begin(),cols_id.end());
+  std::sort(col_all_dofs.begin(),col_all_dofs.end());
+  col_all_dofs.erase(std::unique(col_all_dofs.begin(),col_all_dofs.end()),col_all_dofs.end());
+
+  const auto row_map = std::make_shared<Map>(-1, rows_id.size(), rows_id.data(), 0, comm);
+  const auto col_map = std::make_shared<Map>(-1, col_all_dofs.size(), col_all_dofs.data(), 0, comm);
 
   const bool is_static_profile = true;
   auto graph = std::make_shared<Graph>(Epetra_DataAccess::Copy,
@@ -56,12 +85,11 @@ create_graph(const std::map<Index,std::set<Index>> &dofs_connectivity,
                                        n_dofs_per_row.data(),
                                        is_static_profile);
 
-  for (const auto &row_id_and_dofs : dofs_connectivity)
-  {
-    const Index row_id = row_id_and_dofs.first;
-    SafeSTLVector<Index> cols_id(row_id_and_dofs.second.begin(),row_id_and_dofs.second.end());
-    graph->InsertGlobalIndices(row_id, cols_id.size(), cols_id.data());
-  }
+  // Epetra_CrsGraph::InsertGlobalIndices() takes a non-const pointer,
+  // but (in Copy mode) it does not modify the indices.
+  for (Index i = 0 ; i < n_rows ; ++i)
+    graph->InsertGlobalIndices(rows_id[i], n_dofs_per_row[i],
+                               const_cast<Index *>(cols_id.data()) + offsets[i]);
 
   int res = graph->FillComplete(*col_map,*row_map);
   AssertThrow(res == 0, ExcMessage("Error raised by Epetra_CrsGraph::FillComplete()"));
@@ -35,6 +35,16 @@ create_map(const std::set<Index> &dofs,
   return std::make_shared<Map>(-1, dofs_vec.size(), dofs_vec.data(), 0, comm);
 }
 
+MapPtr
+create_map(const IndexSet<Index> &dofs,
+           const Comm &comm)
+{
+  SafeSTLVector<Index> dofs_vec;
+  dofs_vec.reserve(dofs.size());
+  dofs_vec.insert(dofs_vec.end(), dofs.begin(), dofs.end());
+  return std::make_shared<Map>(-1, dofs_vec.size(), dofs_vec.data(), 0, comm);
+}
+
 }
 
 #endif //IGATOOLS_USES_TRILINOS
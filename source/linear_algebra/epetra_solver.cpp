@@ -30,10 +30,17 @@ IGA_NAMESPACE_OPEN
 namespace EpetraTools
 {
 
-SolverPtr create_solver(const Matrix &A, Vector &x, const Vector &b,
-                        const std::string &solver_type,
-                        const Real tolerance,
-                        const int max_num_iters)
+namespace
+{
+/**
+ * Creates the Belos solver for <tt>A x = b</tt>, with @p preconditioner as
+ * left preconditioner if it is not null.
+ */
+SolverPtr create_solver_impl(const OP &A, Vector &x, const Vector &b,
+                             const Teuchos::RCP<OP> &preconditioner,
+                             const std::string &solver_type,
+                             const Real tolerance,
+                             const int max_num_iters)
 {
   using Teuchos::ParameterList;
   using Teuchos::parameterList;
@@ -45,7 +52,6 @@ SolverPtr create_solver(const Matrix &A, Vector &x, const Vector &b,
   solverParams->set("Maximum Iterations", max_num_iters);
   solverParams->set("Convergence Tolerance", tolerance);
 
-//    SolverPtr solver = factory.create("CG", solverParams);
   SolverPtr solver = factory.create(solver_type, solverParams);
   RCP<Belos::LinearProblem<double, MV, OP> > problem =
     rcp(new Belos::LinearProblem<double, MV, OP> (
@@ -53,17 +59,55 @@ SolverPtr create_solver(const Matrix &A, Vector &x, const Vector &b,
           rcp<MV>(&x,false),
           rcp<const MV>(&b,false)));
 
-  RCP<ML_Epetra::MultiLevelPreconditioner> Prec =
-    rcp(new ML_Epetra::MultiLevelPreconditioner(A, true));
-
-  RCP<Belos::EpetraPrecOp> belosPrec = rcp(new Belos::EpetraPrecOp(Prec));
-  problem->setLeftPrec(belosPrec);
+  if (preconditioner != Teuchos::null)
+  {
+    RCP<Belos::EpetraPrecOp> belosPrec = rcp(new Belos::EpetraPrecOp(preconditioner));
+    problem->setLeftPrec(belosPrec);
+  }
   problem->setProblem();
 
   solver->setProblem(problem);
 
   return solver;
 }
+}
+
+
+
+SolverPtr create_solver(const Matrix &A, Vector &x, const Vector &b,
+                        const std::string &solver_type,
+                        const Real tolerance,
+                        const int max_num_iters)
+{
+  Teuchos::RCP<OP> Prec =
+    Teuchos::rcp(new ML_Epetra::MultiLevelPreconditioner(A, true));
+
+  return create_solver_impl(A,x,b,Prec,solver_type,tolerance,max_num_iters);
+}
+
+
+
+SolverPtr create_solver(const OP &A, Vector &x, const Vector &b,
+                        const std::string &solver_type,
+                        const Real tolerance,
+                        const int max_num_iters)
+{
+  return create_solver_impl(A,x,b,Teuchos::null,solver_type,tolerance,max_num_iters);
+}
+
+
+
+SolverPtr create_solver(const OP &A, Vector &x, const Vector &b,
+                        const OP &preconditioner,
+                        const std::string &solver_type,
+                        const Real tolerance,
+                        const int max_num_iters)
+{
+  // Belos::EpetraPrecOp only uses the const method ApplyInverse()
+  Teuchos::RCP<OP> Prec = Teuchos::rcp<OP>(const_cast<OP *>(&preconditioner),false);
+
+  return create_solver_impl(A,x,b,Prec,solver_type,tolerance,max_num_iters);
+}
 
 }
 
@@ -21,64 +21,72 @@
 #include <igatools/operators/integrator_sum_factorization.h>
 #include <igatools/base/exceptions.h>
 
+#include <algorithm>
 
-#include <chrono>
-
-
-#define TIME_PROFILING
 
 IGA_NAMESPACE_OPEN
 
 
+namespace
+{
 
-#ifdef TIME_PROFILING
-using Clock = std::chrono::high_resolution_clock;
-using TimePoint = std::chrono::time_point<Clock>;
-using Duration = std::chrono::duration<Real>;
-#endif // TIME_PROFILING
-
-
-
-
-
-
+using sum_factorization_kernels::AlignedVector;
 
-void
-IntegratorSumFactorization<0>::
-operator()(
-  const bool is_symmetric,
-  const TensorSize<0> &t_size_theta,
-  const TensorSize<0> &t_size_alpha,
-  const TensorSize<0> &t_size_beta,
-  const SafeSTLArray<DynamicMultiArray<Real,3>,0> &J,
-  const DynamicMultiArray<Real,3> &Cpre,
-  const int row_id_begin,
-  const int row_id_last,
-  const int col_id_begin,
-  const int col_id_last,
-  DenseMatrix &local_operator) const
+/**
+ * Resizes the vector @p v to @p size, only if the new size is bigger than the current one.
+ */
+void grow(AlignedVector &v, const Size size)
 {
-  AssertThrow(false,ExcNotImplemented());
+  if (size > Size(v.size()))
+    v.resize(size);
 }
 
 
+/**
+ * Integration of the local operator with the sum-factorization technique.
+ *
+ * The contractions along the directions are performed one after the other,
+ * starting from the first one. Each contraction is a sequence of calls to
+ * sum_factorization_kernels::contract(), in which the vectorized (contiguous) index
+ * runs over the (trial,test) pairs of the directions already contracted,
+ * while the contracted index runs over the quadrature points of the current direction:
+ * - the first contraction builds, for each (theta_1,...,theta_{dim-1}),
+ *   the panel row
+ *   \f$ P_1(\theta_1,\dots,\theta_{dim-1})[\alpha_0\beta_0] =
+ *   \sum_{\theta_0} C(\theta_0,\dots,\theta_{dim-1}) J_0(\theta_0,\alpha_0,\beta_0) \f$
+ *   (the rows are padded to a multiple of the SIMD width);
+ * - the d-th contraction builds, for each (theta_{d+1},...,theta_{dim-1}) and
+ *   (alpha_d,beta_d), the panel block
+ *   \f$ P_{d+1}(\theta_{d+1},\dots)[\alpha_d\beta_d][\dots] =
+ *   \sum_{\theta_d} J_d(\theta_d,\alpha_d,\beta_d) P_d(\theta_d,\theta_{d+1},\dots)[\dots] \f$.
+ *
+ * At the end, the last panel contains all the entries of the local operator,
+ * that are added to @p local_operator.
+ *
+ * If @p is_symmetric is true, the last contraction is performed only for the
+ * pairs with \f$ \alpha_{dim-1} \geq \beta_{dim-1} \f$ (i.e. the upper triangular
+ * part of the block, up to the entries with the same \f$ \alpha_{dim-1} \f$ and
+ * \f$ \beta_{dim-1} \f$) and the lower triangular part of the block is copied
+ * from the upper one.
+ */
+template <int dim>
 void
-IntegratorSumFactorization<1>::
-operator()(
+integrate_with_panels(
   const bool is_symmetric,
-  const TensorSize<1> &t_size_theta,
-  const TensorSize<1> &t_size_alpha,
-  const TensorSize<1> &t_size_beta,
-  const SafeSTLArray<DynamicMultiArray<Real,3>,1> &J,
+  const TensorSize<dim> &t_size_theta,
+  const TensorSize<dim> &t_size_alpha,
+  const TensorSize<dim> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,dim> &J,
   const DynamicMultiArray<Real,3> &C,
   const int row_id_begin,
   const int row_id_last,
   const int col_id_begin,
   const int col_id_last,
-  DenseMatrix &local_operator) const
+  SumFactorizationWorkspace<dim> &workspace,
+  DenseMatrix &local_operator)
 {
-  const int n_rows = row_id_last - row_id_begin + 1;
 #ifndef NDEBUG
+  const int n_rows = row_id_last - row_id_begin + 1;
   Assert(n_rows >= 1,ExcLowerRange(n_rows,1));
   Assert(n_rows <= local_operator.get_num_rows(),
          ExcUpperRange(n_rows,local_operator.get_num_rows()));
@@ -98,189 +106,145 @@ operator()(
   Assert(col_id_begin >= 0,ExcLowerRange(col_id_begin,0));
   Assert(col_id_last <= (local_operator.get_num_cols()-1),
          ExcUpperRange(col_id_last,local_operator.get_num_cols()-1));
-#endif
-
-  TensorIndex<3> t_id_J;
-  TensorIndex<3> t_id_C;
-
-  //--------------------------------------------------------------
-  t_id_C[0] = 0;
-  t_id_C[1] = 0;
-  t_id_C[2] = 0;
-
-  t_id_J[0] = 0;
-
-  const Real *const C_it_begin = &C(t_id_C);
-  const Real *const C_it_end = C_it_begin + t_size_theta[0];
-
-  for (Index beta_0 = 0 ; beta_0 < t_size_beta[0] ; ++beta_0)
-  {
-    t_id_J[2] = beta_0 + row_id_begin;
-    for (Index alpha_0 = (is_symmetric ? beta_0 : 0) ;
-         alpha_0 < t_size_alpha[0] ;
-         ++alpha_0)
-    {
-      t_id_J[1] = alpha_0 + col_id_begin;
 
-      const Real *const J0_it_begin = &J[0](t_id_J);
-
-      local_operator(beta_0,alpha_0) += std::inner_product(C_it_begin,C_it_end,J0_it_begin,0.0);
-    }
-  }
+  Assert(C.flat_size() == t_size_theta.flat_size(),
+         ExcDimensionMismatch(C.flat_size(),t_size_theta.flat_size()));
 
   if (is_symmetric)
   {
-    // here we copy the upper triangular part of the current block on the lower triangular part
-    for (int loc_row = 0 ; loc_row < n_rows ; ++loc_row)
-    {
-      const int r_src = loc_row + row_id_begin;
-      const int c_tgt = loc_row + col_id_begin;
-      for (int loc_col = loc_row+1 ; loc_col < n_rows ; ++loc_col)
-      {
-        const int r_tgt = loc_col + row_id_begin;
-        const int c_src = loc_col + col_id_begin;
-        local_operator(r_tgt,c_tgt) =
-          local_operator(r_src,c_src);
-      } // end loop loc_col
-    } // end_loop loc_row
-    //--------------------------------------------------------------
-
-  } // end if (is_symmetric)
-}
-
-void
-IntegratorSumFactorization<2>::
-operator()(
-  const bool is_symmetric,
-  const TensorSize<2> &t_size_theta,
-  const TensorSize<2> &t_size_alpha,
-  const TensorSize<2> &t_size_beta,
-  const SafeSTLArray<DynamicMultiArray<Real,3>,2> &J,
-  const DynamicMultiArray<Real,3> &C,
-  const int row_id_begin,
-  const int row_id_last,
-  const int col_id_begin,
-  const int col_id_last,
-  DenseMatrix &local_operator) const
-{
-  const int n_rows = row_id_last - row_id_begin + 1;
-#ifndef NDEBUG
-  Assert(n_rows >= 1,ExcLowerRange(n_rows,1));
-  Assert(n_rows <= local_operator.get_num_rows(),
-         ExcUpperRange(n_rows,local_operator.get_num_rows()));
-  Assert(t_size_beta.flat_size() == n_rows,
-         ExcDimensionMismatch(t_size_beta.flat_size(),n_rows));
-  Assert(row_id_begin >= 0,ExcLowerRange(row_id_begin,0));
-  Assert(row_id_last <= (local_operator.get_num_rows()-1),
-         ExcUpperRange(row_id_last,local_operator.get_num_rows()-1));
+    Assert(n_rows == n_cols,ExcDimensionMismatch(n_rows,n_cols));
+  }
+#endif
 
+  using sum_factorization_kernels::contract;
 
-  const int n_cols = col_id_last - col_id_begin + 1;
-  Assert(n_cols >= 1,ExcLowerRange(n_cols,1));
-  Assert(n_cols <= local_operator.get_num_cols(),
-         ExcUpperRange(n_cols,local_operator.get_num_cols()));
-  Assert(t_size_alpha.flat_size() == n_cols,
-         ExcDimensionMismatch(t_size_alpha.flat_size(),n_cols));
-  Assert(col_id_begin >= 0,ExcLowerRange(col_id_begin,0));
-  Assert(col_id_last <= (local_operator.get_num_cols()-1),
-         ExcUpperRange(col_id_last,local_operator.get_num_cols()-1));
-#endif
+  // number of (trial,test) pairs along each direction
+  TensorSize<dim> n_pairs;
+  for (int i = 0 ; i < dim ; ++i)
+    n_pairs[i] = t_size_alpha[i] * t_size_beta[i];
 
+  const Size row_length = sum_factorization_kernels::get_padded_size(n_pairs[0]);
 
 
+  //--------------------------------------------------------------
+  // moments along the first direction: transposed and padded
+  const Size n_theta_0 = t_size_theta[0];
 
+  auto &moments_0 = workspace.moments_0;
+  grow(moments_0,n_theta_0 * row_length);
 
-  TensorIndex<3> t_id_J;
-  TensorIndex<3> t_id_C;
+  const auto &J0 = J[0];
+  for (Index theta_0 = 0 ; theta_0 < n_theta_0 ; ++theta_0)
+  {
+    Real *const row = &moments_0[theta_0 * row_length];
+    for (Index pair_0 = 0 ; pair_0 < n_pairs[0] ; ++pair_0)
+      row[pair_0] = J0[pair_0 * n_theta_0 + theta_0];
+    std::fill(row + n_pairs[0], row + row_length, 0.0);
+  }
+  //--------------------------------------------------------------
 
 
   //--------------------------------------------------------------
-  TensorIndex<3> t_id_C1;
-  TensorSize<3> t_size_C1;
-  t_size_C1[0] = t_size_theta[1];
-  t_size_C1[1] = t_size_alpha[0];
-  t_size_C1[2] = t_size_beta[0];
-  DynamicMultiArray<Real,3> C1(t_size_C1);
+  // contraction along the first direction
+  Size n_theta_left = t_size_theta.flat_size() / n_theta_0;
+
+  AlignedVector *panel_in  = &workspace.panel_0;
+  AlignedVector *panel_out = &workspace.panel_1;
+  grow(*panel_in,n_theta_left * row_length);
+
+  for (Index r = 0 ; r < n_theta_left ; ++r)
+    contract(n_theta_0, row_length,
+             &C[r * n_theta_0],
+             moments_0.data(), row_length,
+             panel_in->data() + r * row_length);
   //--------------------------------------------------------------
 
 
   //--------------------------------------------------------------
+  // contraction along the other directions
+  Size block_length = row_length;
+  for (int dir = 1 ; dir < dim ; ++dir)
   {
-    t_id_C[0] = 0;
-    t_id_C[1] = 0;
-    t_id_C[2] = 0;
-    const Real *C_it_begin = &C(t_id_C);
+    const Size n_theta_dir = t_size_theta[dir];
+    const Size n_pairs_dir = n_pairs[dir];
+    n_theta_left /= n_theta_dir;
 
-    t_id_J[0] = 0;
+    grow(*panel_out,n_theta_left * n_pairs_dir * block_length);
 
-    for (Index beta_0 = 0 ; beta_0 < t_size_beta[0] ; ++beta_0)
+    // for symmetric operators the pairs with alpha < beta along the last direction
+    // are not computed (and not used in the final step)
+    const bool skip_lower = is_symmetric && (dir == dim-1);
+    const Index n_alpha_dir = t_size_alpha[dir];
+
+    const auto &J_dir = J[dir];
+    for (Index r = 0 ; r < n_theta_left ; ++r)
     {
-      t_id_J [2] = beta_0;
-      t_id_C1[2] = beta_0;
-      for (Index alpha_0 = 0 ; alpha_0 < t_size_alpha[0] ; ++alpha_0)
+      const Real *const in = panel_in->data() + r * n_theta_dir * block_length;
+      Real *const out = panel_out->data() + r * n_pairs_dir * block_length;
+      for (Index pair = 0 ; pair < n_pairs_dir ; ++pair)
       {
-        t_id_J [1] = alpha_0;
-        t_id_C1[1] = alpha_0;
-
-        const Real *const J0_it_begin = &J[0](t_id_J);
-        const Real *const J0_it_end = J0_it_begin + t_size_theta[0];
-
-        t_id_C1[0] = 0;
-        Real *const C1_it_begin = &C1(t_id_C1);
-        Real *const C1_it_end = C1_it_begin + t_size_theta[1];
-
-        const Real *C_it = C_it_begin;
-        for (Real *C1_it = C1_it_begin; C1_it != C1_it_end ; ++C1_it, C_it += t_size_theta[0])
-        {
-          (*C1_it) = std::inner_product(J0_it_begin,J0_it_end,C_it,0.0);
-        } //end loop theta_1
+        if (skip_lower && (pair % n_alpha_dir) < (pair / n_alpha_dir))
+          continue;
+
+        contract(n_theta_dir, block_length,
+                 &J_dir[pair * n_theta_dir],
+                 in, block_length,
+                 out + pair * block_length);
+      }
+    }
 
-      } //end loop alpha_0
-    } // end loop beta_0
+    block_length *= n_pairs_dir;
+    std::swap(panel_in,panel_out);
   }
   //--------------------------------------------------------------
 
 
   //--------------------------------------------------------------
-  t_id_C1[0] = 0;
-  t_id_J[0] = 0;
-
-  for (Index beta_1 = 0 ; beta_1 < t_size_beta[1] ; ++beta_1)
+  // adding the result to the local operator
+  const Real *const result = panel_in->data();
+  const Size n_outer = block_length / row_length;
+  for (Index outer = 0 ; outer < n_outer ; ++outer)
   {
-    t_id_J[2] = beta_1;
-    for (Index beta_0 = 0 ; beta_0 < t_size_beta[0] ; ++beta_0)
+    // (alpha,beta) along the directions 1,...,dim-1
+    Index row_outer = 0;
+    Index col_outer = 0;
+    Index pairs_id = outer;
+    Index row_weight = t_size_beta[0];
+    Index col_weight = t_size_alpha[0];
+    bool is_lower = false;
+    for (int dir = 1 ; dir < dim ; ++dir)
     {
-      Index beta_0_1 = beta_1*t_size_beta[0] + beta_0 + row_id_begin;
+      const Index pair = pairs_id % n_pairs[dir];
+      pairs_id /= n_pairs[dir];
 
-      t_id_C1[2] = beta_0;
-
-      for (Index alpha_1 = (is_symmetric ? beta_1 : 0) ;
-           alpha_1 < t_size_alpha[1] ;
-           ++alpha_1)
-      {
-        t_id_J[1] = alpha_1;
-        t_id_C1[1] = 0;
-
-        const Real *J1_it_begin = &J[1](t_id_J);
-
-        Real *row_it = &local_operator(beta_0_1,alpha_1*t_size_alpha[0] + col_id_begin);
-        const Real *const row_it_end = row_it + t_size_alpha[0];
-        for (; row_it != row_it_end ; ++t_id_C1[1], ++row_it)
-        {
-          const Real *C1_it_begin = &C1(t_id_C1);
-          const Real *const C1_it_end = C1_it_begin + t_size_theta[1];
+      const Index alpha = pair % t_size_alpha[dir];
+      const Index beta = pair / t_size_alpha[dir];
+      col_outer += alpha * col_weight;
+      row_outer += beta * row_weight;
+      col_weight *= t_size_alpha[dir];
+      row_weight *= t_size_beta[dir];
 
+      is_lower = is_symmetric && (dir == dim-1) && (alpha < beta);
+    }
+    if (is_lower)
+      continue;
 
-          (*row_it) += std::inner_product(C1_it_begin,C1_it_end,J1_it_begin,0.0);
+    const Real *const result_row = result + outer * row_length;
+    Index pair_0 = 0;
+    for (Index beta_0 = 0 ; beta_0 < t_size_beta[0] ; ++beta_0)
+    {
+      const Index row = row_id_begin + row_outer + beta_0;
+      for (Index alpha_0 = 0 ; alpha_0 < t_size_alpha[0] ; ++alpha_0, ++pair_0)
+        local_operator(row, col_id_begin + col_outer + alpha_0) += result_row[pair_0];
+    }
+  }
+  //--------------------------------------------------------------
 
-        } //end loop row_it
-      } //end loop alpha_1
-    } // end loop beta_0
-  } // end loop beta_1
 
   if (is_symmetric)
   {
     // here we copy the upper triangular part of the current block on the lower triangular part
+    const int n_rows = row_id_last - row_id_begin + 1;
     for (int loc_row = 0 ; loc_row < n_rows ; ++loc_row)
     {
       const int r_src = loc_row + row_id_begin;
@@ -289,22 +253,24 @@ operator()(
       {
         const int r_tgt = loc_col + row_id_begin;
         const int c_src = loc_col + col_id_begin;
-        local_operator(r_tgt,c_tgt) =
-          local_operator(r_src,c_src);
+        local_operator(r_tgt,c_tgt) = local_operator(r_src,c_src);
       } // end loop loc_col
     } // end_loop loc_row
-  }//end if (is_symmetric)
+  } // end if (is_symmetric)
 }
 
+} // end anonymous namespace
+
+
 
 void
-IntegratorSumFactorization<3>::
+IntegratorSumFactorization<0>::
 operator()(
   const bool is_symmetric,
-  const TensorSize<3> &t_size_theta,
-  const TensorSize<3> &t_size_alpha,
-  const TensorSize<3> &t_size_beta,
-  const SafeSTLArray<DynamicMultiArray<Real,3>,3> &J,
+  const TensorSize<0> &t_size_theta,
+  const TensorSize<0> &t_size_alpha,
+  const TensorSize<0> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,0> &J,
   const DynamicMultiArray<Real,3> &C,
   const int row_id_begin,
   const int row_id_last,
@@ -312,273 +278,191 @@ operator()(
   const int col_id_last,
   DenseMatrix &local_operator) const
 {
-  const int n_rows = row_id_last - row_id_begin + 1;
-#ifndef NDEBUG
-  Assert(n_rows >= 1,ExcLowerRange(n_rows,1));
-  Assert(n_rows <= local_operator.get_num_rows(),
-         ExcUpperRange(n_rows,local_operator.get_num_rows()));
-  Assert(t_size_beta.flat_size() == n_rows,
-         ExcDimensionMismatch(t_size_beta.flat_size(),n_rows));
-  Assert(row_id_begin >= 0,ExcLowerRange(row_id_begin,0));
-  Assert(row_id_last <= (local_operator.get_num_rows()-1),
-         ExcUpperRange(row_id_last,local_operator.get_num_rows()-1));
-
-
-  const int n_cols = col_id_last - col_id_begin + 1;
-  Assert(n_cols >= 1,ExcLowerRange(n_cols,1));
-  Assert(n_cols <= local_operator.get_num_cols(),
-         ExcUpperRange(n_cols,local_operator.get_num_cols()));
-  Assert(t_size_alpha.flat_size() == n_cols,
-         ExcDimensionMismatch(t_size_alpha.flat_size(),n_cols));
-  Assert(col_id_begin >= 0,ExcLowerRange(col_id_begin,0));
-  Assert(col_id_last <= (local_operator.get_num_cols()-1),
-         ExcUpperRange(col_id_last,local_operator.get_num_cols()-1));
-#endif
-
-
-
-  TensorIndex<3> t_id_J;
-  TensorIndex<3> t_id_C;
-
-  //--------------------------------------------------------------
-  TensorIndex<3> t_id_C1;
-  TensorSize<3> t_size_C1;
-  t_size_C1[0] = t_size_theta[1] * t_size_theta[2];
-  t_size_C1[1] = t_size_alpha[0];
-  t_size_C1[2] = t_size_beta[0];
-  DynamicMultiArray<Real,3> C1(t_size_C1);
-  //--------------------------------------------------------------
-
-
-  //--------------------------------------------------------------
-  TensorIndex<3> t_id_C2;
-  TensorSize<3> t_size_C2;
-  t_size_C2[0] = t_size_theta[2];
-  t_size_C2[1] = t_size_alpha[0] * t_size_alpha[1];
-  t_size_C2[2] = t_size_beta [0] * t_size_beta [1];
-  DynamicMultiArray<Real,3> C2(t_size_C2);
-  //--------------------------------------------------------------
-
-
-  //--------------------------------------------------------------
-#ifdef TIME_PROFILING
-  const auto start_l1 = Clock::now();
-#endif // TIME_PROFILING
-
-  t_id_J[0] = 0;
-
-  t_id_C[0] = 0;
-  t_id_C[1] = 0;
-  t_id_C[2] = 0;
-
-  t_id_C1[0] = 0;
-  for (Index beta_0 = 0 ; beta_0 < t_size_beta[0] ; ++beta_0)
-  {
-    t_id_J [2] = beta_0;
-    t_id_C1[2] = beta_0;
-    for (Index alpha_0 = 0 ; alpha_0 < t_size_alpha[0] ; ++alpha_0)
-    {
-      t_id_J [1] = alpha_0;
-      t_id_C1[1] = alpha_0;
-
-
-      Real *C1_it = &C1(t_id_C1);
-
-      const Real *C_it_begin = &C(t_id_C);
-
-      const Real *J0_it_begin = &J[0](t_id_J);
-      const Real *const J0_it_end = J0_it_begin + t_size_theta[0];
-
-      for (Index theta_2 = 0; theta_2 < t_size_theta[2] ; ++theta_2)
-      {
-        const Real *const C1_it_end = C1_it + t_size_theta[1];
-        for (; C1_it != C1_it_end ; ++C1_it, C_it_begin += t_size_theta[0])
-        {
-          (*C1_it) = std::inner_product(
-                       J0_it_begin + 1,
-                       J0_it_end,
-                       C_it_begin + 1,
-                       (*C_it_begin) * (*J0_it_begin));
-        } // end loop theta_1
-      } // end loop theta_2
-    } // end loop alpha_0
-  } // end loop beta_0
-#ifdef TIME_PROFILING
-  const Duration time_l1 = Clock::now() - start_l1;
-  std::cout << "Elapsed_seconds loop1 = " << time_l1.count() << std::endl;
-#endif // TIME_PROFILING
-
-  //--------------------------------------------------------------
-
-
-
-  //--------------------------------------------------------------
-#ifdef TIME_PROFILING
-  const auto start_l2 = Clock::now();
-#endif // TIME_PROFILING
-
-  t_id_C2[0] = 0;
-  t_id_C1[0] = 0;
-  t_id_J[0] = 0;
-
-  for (t_id_J[2] = 0 ; t_id_J[2] < t_size_beta[1] ; ++t_id_J[2])
-  {
-    t_id_C2[2] = t_id_J[2]*t_size_beta[0];
-    for (t_id_C1[2] = 0 ; t_id_C1[2] < t_size_beta[0] ; ++t_id_C1[2], ++t_id_C2[2])
-    {
-      t_id_C2[1] = 0;
-      for (t_id_J[1] = 0 ;
-           t_id_J[1] < t_size_alpha[1] ;
-           ++t_id_J[1],
-           t_id_C2[1] += t_size_alpha[0])
-      {
-        t_id_C1[1] = 0;
-        t_id_C2[1] = t_id_J[1]*t_size_alpha[0];
-
-        const Real *const J1_it_begin = &J[1](t_id_J);
-
-        for (t_id_C1[1] = 0 ; t_id_C1[1] < t_size_alpha[0] ; ++t_id_C1[1],++t_id_C2[1])
-        {
-          const Real *const C1_it_begin = &C1(t_id_C1);
-          const Real *const C1_it_end = C1_it_begin + t_size_theta[1];
-
-
-          Real *const C2_it_begin = &C2(t_id_C2);
-          const Real *const C2_it_end = C2_it_begin + t_size_C2[0];
-          for (Real *C2_it = C2_it_begin; C2_it != C2_it_end ; ++C2_it)
-          {
-            (*C2_it) = std::inner_product(
-                         C1_it_begin + 1,
-                         C1_it_end,
-                         J1_it_begin + 1,
-                         (*C1_it_begin) * (*J1_it_begin));
-          } // end loop C2_it
-        } //end loop t_id_C1[1]
-      } //end loop t_id_J[1]
-    } // end loop beta_0
-  } // end loop beta_1
-#ifdef TIME_PROFILING
-  const Duration time_l2 = Clock::now() - start_l2;
-  std::cout << "Elapsed_seconds loop2 = " << time_l2.count() << std::endl;
-#endif // TIME_PROFILING
-
-  //--------------------------------------------------------------
-
-
-  //--------------------------------------------------------------
-#ifdef TIME_PROFILING
-  const auto start_l3 = Clock::now();
-#endif // TIME_PROFILING
-
-
-  t_id_C2[0] = 0;
-  t_id_C2[1] = 0;
-  t_id_J[0] = 0;
+  SumFactorizationWorkspace<0> workspace;
+  this->operator()(is_symmetric,
+                   t_size_theta,t_size_alpha,t_size_beta,
+                   J,C,
+                   row_id_begin,row_id_last,
+                   col_id_begin,col_id_last,
+                   workspace,
+                   local_operator);
+}
 
-  const int n_pts = t_size_C2[0];
 
-  const int size_alpha_0 = t_size_alpha[0];
-  const int size_alpha_1 = t_size_alpha[1];
+void
+IntegratorSumFactorization<0>::
+operator()(
+  const bool is_symmetric,
+  const TensorSize<0> &t_size_theta,
+  const TensorSize<0> &t_size_alpha,
+  const TensorSize<0> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,0> &J,
+  const DynamicMultiArray<Real,3> &C,
+  const int row_id_begin,
+  const int row_id_last,
+  const int col_id_begin,
+  const int col_id_last,
+  SumFactorizationWorkspace<0> &workspace,
+  DenseMatrix &local_operator) const
+{
+  AssertThrow(false,ExcNotImplemented());
+}
 
-//  bool not_symm =false;
 
-  for (t_id_J[2] = 0 ; t_id_J[2] < t_size_beta[2] ; ++t_id_J[2])
-  {
-    const Index b_tmp_2 = t_id_J[2]*t_size_beta[1];
+void
+IntegratorSumFactorization<1>::
+operator()(
+  const bool is_symmetric,
+  const TensorSize<1> &t_size_theta,
+  const TensorSize<1> &t_size_alpha,
+  const TensorSize<1> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,1> &J,
+  const DynamicMultiArray<Real,3> &C,
+  const int row_id_begin,
+  const int row_id_last,
+  const int col_id_begin,
+  const int col_id_last,
+  DenseMatrix &local_operator) const
+{
+  SumFactorizationWorkspace<1> workspace;
+  this->operator()(is_symmetric,
+                   t_size_theta,t_size_alpha,t_size_beta,
+                   J,C,
+                   row_id_begin,row_id_last,
+                   col_id_begin,col_id_last,
+                   workspace,
+                   local_operator);
+}
 
-    t_id_C2[2] = 0;
-    for (Index beta_1 = 0 ; beta_1 < t_size_beta[1] ; ++beta_1)
-    {
-      const Index beta_0_1_2 = (b_tmp_2 + beta_1) * t_size_beta[0] + row_id_begin;
 
-      int r_id = beta_0_1_2;
+void
+IntegratorSumFactorization<1>::
+operator()(
+  const bool is_symmetric,
+  const TensorSize<1> &t_size_theta,
+  const TensorSize<1> &t_size_alpha,
+  const TensorSize<1> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,1> &J,
+  const DynamicMultiArray<Real,3> &C,
+  const int row_id_begin,
+  const int row_id_last,
+  const int col_id_begin,
+  const int col_id_last,
+  SumFactorizationWorkspace<1> &workspace,
+  DenseMatrix &local_operator) const
+{
+  integrate_with_panels<1>(is_symmetric,
+                           t_size_theta,t_size_alpha,t_size_beta,
+                           J,C,
+                           row_id_begin,row_id_last,
+                           col_id_begin,col_id_last,
+                           workspace,
+                           local_operator);
+}
 
-      for (Index beta_0 = 0;
-           beta_0 < t_size_beta[0] ;
-           ++beta_0,
-           ++t_id_C2[2],
-           ++r_id)
-      {
-        Real *const row_it_begin_0 = &local_operator(r_id,0);
-
-        for (t_id_J[1] = (is_symmetric ? t_id_J[2] : 0) ;
-             t_id_J[1] < t_size_alpha[2] ;
-             ++t_id_J[1])
-        {
-          const Real *J2_it_begin = &J[2](t_id_J);
-
-          const Real *C2_it_begin = &C2(t_id_C2);
-
-          const int c_begin = t_id_J[1] * size_alpha_1 * size_alpha_0 + col_id_begin;
-
-          Real *row_it_begin = row_it_begin_0 + c_begin;
-          const Real *row_it_end = row_it_begin + size_alpha_0;
-
-          const Real *const block_end = row_it_begin + size_alpha_0 * size_alpha_1;
-
-          for (;
-               row_it_begin != block_end ;
-               row_it_begin += size_alpha_0,
-               row_it_end   += size_alpha_0) // loop of size_alpha_1 iterations
-          {
-            for (Real *row_it = row_it_begin ;
-                 row_it != row_it_end ;
-                 C2_it_begin += n_pts,
-                 ++row_it) // loop of size_alpha_0 iterations
-            {
-//              (*row_it) += std::inner_product(C2_it_begin,C2_it_begin+n_pts,J2_it_begin,0.0);
-
-              (*row_it) += std::inner_product(
-                             C2_it_begin + 1,
-                             C2_it_begin + n_pts,
-                             J2_it_begin + 1,
-                             (*C2_it_begin) * (*J2_it_begin));
-            } // end loop row_it
-          } // end loop alpha_1
-        } // end loop alpha_2
-      } // end loop beta_0
-    } // end loop beta_1
-  } // end loop beta_2
-#ifdef TIME_PROFILING
-  const Duration time_l3 = Clock::now() - start_l3;
-  std::cout << "Elapsed_seconds loop3 = " << time_l3.count() << std::endl;
-#endif // TIME_PROFILING
 
-  //--------------------------------------------------------------
+void
+IntegratorSumFactorization<2>::
+operator()(
+  const bool is_symmetric,
+  const TensorSize<2> &t_size_theta,
+  const TensorSize<2> &t_size_alpha,
+  const TensorSize<2> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,2> &J,
+  const DynamicMultiArray<Real,3> &C,
+  const int row_id_begin,
+  const int row_id_last,
+  const int col_id_begin,
+  const int col_id_last,
+  DenseMatrix &local_operator) const
+{
+  SumFactorizationWorkspace<2> workspace;
+  this->operator()(is_symmetric,
+                   t_size_theta,t_size_alpha,t_size_beta,
+                   J,C,
+                   row_id_begin,row_id_last,
+                   col_id_begin,col_id_last,
+                   workspace,
+                   local_operator);
+}
 
 
-  if (is_symmetric)
-  {
-#ifdef TIME_PROFILING
-    const auto start_l4 = Clock::now();
-#endif // TIME_PROFILING
+void
+IntegratorSumFactorization<2>::
+operator()(
+  const bool is_symmetric,
+  const TensorSize<2> &t_size_theta,
+  const TensorSize<2> &t_size_alpha,
+  const TensorSize<2> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,2> &J,
+  const DynamicMultiArray<Real,3> &C,
+  const int row_id_begin,
+  const int row_id_last,
+  const int col_id_begin,
+  const int col_id_last,
+  SumFactorizationWorkspace<2> &workspace,
+  DenseMatrix &local_operator) const
+{
+  integrate_with_panels<2>(is_symmetric,
+                           t_size_theta,t_size_alpha,t_size_beta,
+                           J,C,
+                           row_id_begin,row_id_last,
+                           col_id_begin,col_id_last,
+                           workspace,
+                           local_operator);
+}
 
-    // here we copy the upper triangular part of the current block on the lower triangular part
-    for (int loc_row = 0 ; loc_row < n_rows ; ++loc_row)
-    {
-      const int r_src = loc_row + row_id_begin;
-      const int c_tgt = loc_row + col_id_begin;
-      for (int loc_col = loc_row+1 ; loc_col < n_rows ; ++loc_col)
-      {
-        const int r_tgt = loc_col + row_id_begin;
-        const int c_src = loc_col + col_id_begin;
-        local_operator(r_tgt,c_tgt) =
-          local_operator(r_src,c_src);
-      } // end loop loc_col
-    } // end_loop loc_row
-    //*/
 
-    //*/
-    //--------------------------------------------------------------
-#ifdef TIME_PROFILING
-    const Duration time_l4 = Clock::now() - start_l4;
-    std::cout << "Elapsed_seconds loop4 = " << time_l4.count() << std::endl;
-#endif // TIME_PROFILING
+void
+IntegratorSumFactorization<3>::
+operator()(
+  const bool is_symmetric,
+  const TensorSize<3> &t_size_theta,
+  const TensorSize<3> &t_size_alpha,
+  const TensorSize<3> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,3> &J,
+  const DynamicMultiArray<Real,3> &C,
+  const int row_id_begin,
+  const int row_id_last,
+  const int col_id_begin,
+  const int col_id_last,
+  DenseMatrix &local_operator) const
+{
+  SumFactorizationWorkspace<3> workspace;
+  this->operator()(is_symmetric,
+                   t_size_theta,t_size_alpha,t_size_beta,
+                   J,C,
+                   row_id_begin,row_id_last,
+                   col_id_begin,col_id_last,
+                   workspace,
+                   local_operator);
+}
 
 
-  } // end if (is_symmetric)
+void
+IntegratorSumFactorization<3>::
+operator()(
+  const bool is_symmetric,
+  const TensorSize<3> &t_size_theta,
+  const TensorSize<3> &t_size_alpha,
+  const TensorSize<3> &t_size_beta,
+  const SafeSTLArray<DynamicMultiArray<Real,3>,3> &J,
+  const DynamicMultiArray<Real,3> &C,
+  const int row_id_begin,
+  const int row_id_last,
+  const int col_id_begin,
+  const int col_id_last,
+  SumFactorizationWorkspace<3> &workspace,
+  DenseMatrix &local_operator) const
+{
+  integrate_with_panels<3>(is_symmetric,
+                           t_size_theta,t_size_alpha,t_size_beta,
+                           J,C,
+                           row_id_begin,row_id_last,
+                           col_id_begin,col_id_last,
+                           workspace,
+                           local_operator);
 }
 
 
 IGA_NAMESPACE_CLOSE
-
@@ -0,0 +1,254 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+#include <igatools/operators/sum_factorization_kernels.h>
+
+#include <algorithm>
+
+// The vectorized kernels work on doubles: with REAL_IS_LONG_DOUBLE only the
+// scalar kernel is available.
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(REAL_IS_LONG_DOUBLE)
+#define IGATOOLS_SF_KERNELS_X86_64
+#include <immintrin.h>
+#endif
+
+
+IGA_NAMESPACE_OPEN
+
+namespace sum_factorization_kernels
+{
+
+namespace
+{
+
+using ContractFunction = void (*)(const int, const Size, const Real *,
+                                  const Real *, const Size, Real *);
+
+void
+contract_scalar(const int n_k,
+                const Size n,
+                const Real *a,
+                const Real *X,
+                const Size ldx,
+                Real *y)
+{
+  for (Size i = 0 ; i < n ; ++i)
+    y[i] = a[0] * X[i];
+
+  for (int k = 1 ; k < n_k ; ++k)
+  {
+    const Real a_k = a[k];
+    const Real *const X_k = X + k * ldx;
+    for (Size i = 0 ; i < n ; ++i)
+      y[i] += a_k * X_k[i];
+  }
+}
+
+
+#ifdef IGATOOLS_SF_KERNELS_X86_64
+
+__attribute__((target("avx2,fma")))
+void
+contract_avx2(const int n_k,
+              const Size n,
+              const Real *a,
+              const Real *X,
+              const Size ldx,
+              Real *y)
+{
+  Size i = 0;
+
+  // two registers at a time, in order to hide the latency of the FMA
+  for (; i + 8 <= n ; i += 8)
+  {
+    __m256d y_0 = _mm256_setzero_pd();
+    __m256d y_1 = _mm256_setzero_pd();
+    const Real *X_k = X + i;
+    for (int k = 0 ; k < n_k ; ++k, X_k += ldx)
+    {
+      const __m256d a_k = _mm256_broadcast_sd(a + k);
+      y_0 = _mm256_fmadd_pd(a_k, _mm256_loadu_pd(X_k), y_0);
+      y_1 = _mm256_fmadd_pd(a_k, _mm256_loadu_pd(X_k + 4), y_1);
+    }
+    _mm256_storeu_pd(y + i, y_0);
+    _mm256_storeu_pd(y + i + 4, y_1);
+  }
+
+  for (; i + 4 <= n ; i += 4)
+  {
+    __m256d y_0 = _mm256_setzero_pd();
+    const Real *X_k = X + i;
+    for (int k = 0 ; k < n_k ; ++k, X_k += ldx)
+      y_0 = _mm256_fmadd_pd(_mm256_broadcast_sd(a + k), _mm256_loadu_pd(X_k), y_0);
+    _mm256_storeu_pd(y + i, y_0);
+  }
+
+  if (i < n)
+    contract_scalar(n_k, n - i, a, X + i, ldx, y + i);
+}
+
+
+__attribute__((target("avx512f")))
+void
+contract_avx512(const int n_k,
+                const Size n,
+                const Real *a,
+                const Real *X,
+                const Size ldx,
+                Real *y)
+{
+  Size i = 0;
+
+  for (; i + 16 <= n ; i += 16)
+  {
+    __m512d y_0 = _mm512_setzero_pd();
+    __m512d y_1 = _mm512_setzero_pd();
+    const Real *X_k = X + i;
+    for (int k = 0 ; k < n_k ; ++k, X_k += ldx)
+    {
+      const __m512d a_k = _mm512_set1_pd(a[k]);
+      y_0 = _mm512_fmadd_pd(a_k, _mm512_loadu_pd(X_k), y_0);
+      y_1 = _mm512_fmadd_pd(a_k, _mm512_loadu_pd(X_k + 8), y_1);
+    }
+    _mm512_storeu_pd(y + i, y_0);
+    _mm512_storeu_pd(y + i + 8, y_1);
+  }
+
+  if (i < n)
+  {
+    // the last (partial) registers are handled with masked loads and stores
+    for (; i < n ; i += 8)
+    {
+      const int n_left = std::min(Size(8), n - i);
+      const __mmask8 mask = static_cast<__mmask8>((1u << n_left) - 1u);
+
+      __m512d y_0 = _mm512_setzero_pd();
+      const Real *X_k = X + i;
+      for (int k = 0 ; k < n_k ; ++k, X_k += ldx)
+        y_0 = _mm512_fmadd_pd(_mm512_set1_pd(a[k]), _mm512_maskz_loadu_pd(mask, X_k), y_0);
+      _mm512_mask_storeu_pd(y + i, mask, y_0);
+    }
+  }
+}
+
+#endif // IGATOOLS_SF_KERNELS_X86_64
+
+
+InstructionSet
+detect_instruction_set()
+{
+#ifdef IGATOOLS_SF_KERNELS_X86_64
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return InstructionSet::avx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return InstructionSet::avx2;
+#endif
+  return InstructionSet::scalar;
+}
+
+
+ContractFunction
+get_contract_function(const InstructionSet &instruction_set)
+{
+#ifdef IGATOOLS_SF_KERNELS_X86_64
+  if (instruction_set == InstructionSet::avx512)
+    return contract_avx512;
+  if (instruction_set == InstructionSet::avx2)
+    return contract_avx2;
+#endif
+  return contract_scalar;
+}
+
+
+const InstructionSet best_instruction_set = detect_instruction_set();
+
+InstructionSet current_instruction_set = best_instruction_set;
+
+ContractFunction contract_function = get_contract_function(best_instruction_set);
+
+} // end anonymous namespace
+
+
+
+std::string
+get_name(const InstructionSet &instruction_set)
+{
+  switch (instruction_set)
+  {
+    case InstructionSet::scalar:
+      return "scalar";
+    case InstructionSet::avx2:
+      return "avx2";
+    case InstructionSet::avx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+
+
+InstructionSet
+get_best_instruction_set()
+{
+  return best_instruction_set;
+}
+
+
+
+InstructionSet
+get_instruction_set()
+{
+  return current_instruction_set;
+}
+
+
+
+void
+set_instruction_set(const InstructionSet &instruction_set)
+{
+  AssertThrow(static_cast<int>(instruction_set) <= static_cast<int>(best_instruction_set),
+              ExcMessage("The instruction set " + get_name(instruction_set) +
+                         " is not supported by this processor."));
+
+  current_instruction_set = instruction_set;
+  contract_function = get_contract_function(instruction_set);
+}
+
+
+
+void
+contract(const int n_k,
+         const Size n,
+         const Real *a,
+         const Real *X,
+         const Size ldx,
+         Real *y)
+{
+  Assert(n_k > 0, ExcLowerRange(n_k,1));
+  Assert(n >= 0, ExcLowerRange(n,0));
+  Assert(ldx >= n, ExcLowerRange(ldx,n));
+
+  contract_function(n_k, n, a, X, ldx, y);
+}
+
+} // end namespace sum_factorization_kernels
+
+IGA_NAMESPACE_CLOSE
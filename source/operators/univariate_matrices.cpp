@@ -0,0 +1,99 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+
+#include <igatools/operators/univariate_matrices.h>
+#include <igatools/base/exceptions.h>
+
+IGA_NAMESPACE_OPEN
+
+namespace univariate_matrices
+{
+
+SafeSTLVector<Index>
+get_knot_spans(const SafeSTLVector<Real> &knots, const int degree)
+{
+  Assert(degree >= 0, ExcLowerRange(degree,0));
+  const Index n_basis = knots.size() - degree - 1;
+  Assert(n_basis > degree, ExcLowerRange(n_basis,degree+1));
+
+  SafeSTLVector<Index> spans;
+  for (Index mu = degree ; mu < n_basis ; ++mu)
+    if (knots[mu] < knots[mu+1])
+      spans.push_back(mu);
+
+  return spans;
+}
+
+
+
+void
+integrate_mass_stiffness(const SafeSTLVector<Real> &knots,
+                         const int degree,
+                         const SafeSTLVector<Real> &weights,
+                         const SafeSTLVector<Index> &first_basis,
+                         const SafeSTLVector<Real> &values,
+                         const SafeSTLVector<Real> *derivatives,
+                         BandedMatrix &mass,
+                         BandedMatrix *stiffness)
+{
+  Assert(derivatives != nullptr || stiffness == nullptr, ExcNullPtr());
+
+  const Size n_basis = knots.size() - degree - 1;
+  const int n_funcs = degree + 1;
+  const Size n_pts = weights.size();
+
+  mass = BandedMatrix(n_basis, degree);
+  if (stiffness != nullptr)
+    *stiffness = BandedMatrix(n_basis, degree);
+
+  const auto spans = get_knot_spans(knots,degree);
+  Assert(first_basis.size() == spans.size(),
+         ExcDimensionMismatch(first_basis.size(),spans.size()));
+  Assert(values.size() == spans.size() * n_funcs * n_pts,
+         ExcDimensionMismatch(values.size(),spans.size() * n_funcs * n_pts));
+  for (Index k = 0 ; k < Index(spans.size()) ; ++k)
+  {
+    const Real h = knots[spans[k]+1] - knots[spans[k]];
+    const Real *phi = &values[k * n_funcs * n_pts];
+    const Real *D_phi = stiffness != nullptr ? &(*derivatives)[k * n_funcs * n_pts] : nullptr;
+
+    for (int i = 0 ; i < n_funcs ; ++i)
+      for (int j = 0 ; j <= i ; ++j)
+      {
+        Real m_ij = 0.0;
+        Real k_ij = 0.0;
+        for (Index pt = 0 ; pt < n_pts ; ++pt)
+        {
+          const Real w = h * weights[pt];
+          m_ij += w * phi[i*n_pts+pt] * phi[j*n_pts+pt];
+          if (D_phi != nullptr)
+            k_ij += w * D_phi[i*n_pts+pt] * D_phi[j*n_pts+pt];
+        }
+        mass(first_basis[k]+i, first_basis[k]+j) += m_ij;
+        if (stiffness != nullptr)
+          (*stiffness)(first_basis[k]+i, first_basis[k]+j) += k_ij;
+      }
+  }
+}
+
+}
+
+IGA_NAMESPACE_CLOSE
@@ -25,7 +25,8 @@ include_files = ['utils/tensor_index.h',
                  'basis_functions/values1d_const_view.h',
                  'basis_functions/nurbs.h',
                  'utils/concatenated_iterator.h',
-                 'io/writer.h']
+                 'io/writer.h',
+                 'base/quadrature.h']
 data = Instantiation(include_files)
 f = data.file_output
 inst = data.inst
@@ -43,6 +44,7 @@ classes.append('BernsteinOperator');
 classes.append('const BernsteinOperator *');
 classes.append('SafeSTLVector<BernsteinOperator>');
 classes.append('const SafeSTLVector<BernsteinOperator> *');
+classes.append('BasisValues1d');
 for dim in inst.all_domain_dims:
     classes.append('TensorIndex<%d>' %(dim))
     classes.append('ElementIndex<%d>' %(dim))
@@ -53,6 +55,7 @@ for dim in inst.all_domain_dims:
     classes.append('SafeSTLArray<SafeSTLVector<BernsteinOperator>,%d>' %(dim));
     classes.append('SafeSTLArray<SafeSTLVector<const BernsteinOperator *>,%d>' %(dim));
     classes.append('SafeSTLArray<const SafeSTLVector<BernsteinOperator> *,%d>' %(dim));
+    classes.append('std::shared_ptr<const Quadrature<%d>>' %(dim))
 
 vec_int = 'SafeSTLVector<int>'
 t = 'ConstView<ConcatenatedIterator<ContainerView<%s>>,ConcatenatedConstIterator<ContainerView<%s>,ConstContainerView<%s>>>' %(vec_int,vec_int,vec_int)
@@ -61,9 +64,11 @@ classes.append('%s' % (t))
 
 space = 'SplineSpace<0,0,1>'
 classes.append('typename %s::template ComponentContainer<SafeSTLArray<BasisValues1d,0>>' % (space));
+classes.append('typename %s::template ComponentContainer<std::unique_ptr<TensorProductBlockEvaluator<0>>>' % (space));
 for x in inst.sub_ref_sp_dims + inst.ref_sp_dims:
     space = 'SplineSpace<%d,%d,%d>' %(x.dim, x.range, x.rank)
     classes.append('typename %s::template ComponentContainer<SafeSTLArray<BasisValues1d,%d>>' %(space,x.dim));
+    classes.append('typename %s::template ComponentContainer<std::unique_ptr<TensorProductBlockEvaluator<%d>>>' %(space,x.dim));
     
 
 for x in inst.sub_ref_sp_dims + inst.ref_sp_dims:
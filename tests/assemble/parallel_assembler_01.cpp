@@ -0,0 +1,147 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the ParallelAssembler: the global mass matrix and load vector
+ *  assembled with different numbers of threads and block sizes
+ *  must be bitwise identical to the ones assembled with the serial loop.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/parallel_assembler.h>
+
+
+template<int dim>
+void parallel_assembler(const int n_knots, const int deg)
+{
+  OUTSTART
+
+  using Bs = Basis<dim,0,1,1>;
+  using Assembler = ParallelAssembler<dim,0,1,1>;
+  using ElementAccessor = typename Assembler::ElementAccessor;
+  using LocalContribution = typename Assembler::LocalContribution;
+  using Value = typename Bs::Value;
+
+  auto grid = Grid<dim>::create(n_knots);
+  auto space = SplineSpace<dim>::create(deg, grid);
+  const std::shared_ptr<const Bs> basis = BSpline<dim>::create(space);
+  auto quad = QGauss<dim>::create(deg+1);
+
+  const int n_basis = basis->get_num_basis();
+  const int n_pts = quad->get_num_points();
+
+  using Flags = basis_element::Flags;
+  const auto flags = Flags::value | Flags::w_measure;
+
+  // serial assembly
+  DenseMatrix mat_serial(n_basis,n_basis);
+  DenseVector vec_serial(n_basis);
+  mat_serial = 0.0;
+  vec_serial = 0.0;
+  {
+    auto handler = basis->create_cache_handler();
+    handler->set_element_flags(flags);
+
+    auto elem = basis->begin();
+    const auto end = basis->end();
+    handler->init_element_cache(elem,quad);
+
+    const ValueVector<Value> f_values(n_pts,Value({1.0}));
+    for (; elem != end; ++elem)
+    {
+      handler->fill_element_cache(elem);
+      const auto loc_mat = elem->template integrate_u_v<dim>(0);
+      const auto loc_vec = elem->template integrate_u_func<dim>(f_values,0);
+      const auto dofs = elem->get_local_to_global();
+
+      const int n_dofs = dofs.size();
+      for (int i = 0 ; i < n_dofs ; ++i)
+      {
+        vec_serial(dofs[i]) += loc_vec(i);
+        for (int j = 0 ; j < n_dofs ; ++j)
+          mat_serial(dofs[i],dofs[j]) += loc_mat(i,j);
+      }
+    }
+  }
+
+  // each thread owns its own vector of function values
+  auto create_local_work = [n_pts]()
+  {
+    auto f_values = std::make_shared<ValueVector<Value>>(n_pts,Value({1.0}));
+    return [f_values](ElementAccessor &elem, LocalContribution &loc)
+    {
+      loc.matrix = elem.template integrate_u_v<dim>(0);
+      loc.vector = elem.template integrate_u_func<dim>(*f_values,0);
+    };
+  };
+
+  for (const int n_threads : {1,2,3,4})
+  {
+    for (const int block_size : {1,2,5})
+    {
+      DenseMatrix mat(n_basis,n_basis);
+      DenseVector vec(n_basis);
+      mat = 0.0;
+      vec = 0.0;
+
+      Assembler assembler(basis,quad,flags,n_threads,block_size);
+      assembler.assemble(create_local_work,[&](const LocalContribution &loc)
+      {
+        const int n_dofs = loc.dofs.size();
+        for (int i = 0 ; i < n_dofs ; ++i)
+        {
+          vec(loc.dofs[i]) += loc.vector(i);
+          for (int j = 0 ; j < n_dofs ; ++j)
+            mat(loc.dofs[i],loc.dofs[j]) += loc.matrix(i,j);
+        }
+      });
+
+      bool same_result = true;
+      for (int i = 0 ; i < n_basis ; ++i)
+      {
+        same_result = same_result && (vec(i) == vec_serial(i));
+        for (int j = 0 ; j < n_basis ; ++j)
+          same_result = same_result && (mat(i,j) == mat_serial(i,j));
+      }
+
+      out << "n_threads: " << n_threads
+          << "   block_size: " << block_size
+          << "   same as serial: " << (same_result ? "true" : "false") << endl;
+    }
+  }
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  parallel_assembler<1>(7,2);
+  parallel_assembler<2>(4,2);
+  parallel_assembler<3>(3,1);
+
+  return  0;
+}
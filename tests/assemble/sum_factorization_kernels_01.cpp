@@ -0,0 +1,264 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the vectorized sum-factorization kernels.
+ *  The kernel contract() is compared with a naive implementation for all the
+ *  instruction sets supported by the processor; then the local mass matrix with
+ *  a variable coefficient, computed with the sum-factorization technique, is
+ *  compared with the one computed with the standard quadrature.
+ *  Finally, the local operator computed with the symmetric shortcut of
+ *  IntegratorSumFactorization is compared with the full one.
+ *  All the comparisons use a tolerance relative to the magnitude of the summed terms.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/operators/elliptic_operators_sf_integration.h>
+#include <igatools/operators/integrator_sum_factorization.h>
+#include <igatools/operators/sum_factorization_kernels.h>
+
+#include <limits>
+
+using namespace sum_factorization_kernels;
+
+
+/**
+ * Relative tolerance of the comparisons: the results are compared with
+ * a tolerance proportional to the sum of the absolute values of the summed terms.
+ */
+const Real rel_tol = 100 * std::numeric_limits<Real>::epsilon();
+
+
+SafeSTLVector<InstructionSet> get_supported_instruction_sets()
+{
+  SafeSTLVector<InstructionSet> instruction_sets;
+  for (int i = 0 ; i <= static_cast<int>(get_best_instruction_set()) ; ++i)
+    instruction_sets.push_back(static_cast<InstructionSet>(i));
+  return instruction_sets;
+}
+
+
+
+void contract_kernel()
+{
+  OUTSTART
+
+  bool same = true;
+  for (const auto &instruction_set : get_supported_instruction_sets())
+  {
+    set_instruction_set(instruction_set);
+
+    for (int n_k = 1 ; n_k <= 9 ; ++n_k)
+      for (Size n = 1 ; n <= 37 ; ++n)
+      {
+        const Size ldx = get_padded_size(n);
+        AlignedVector a(n_k);
+        AlignedVector X(n_k * ldx);
+        AlignedVector y(ldx, -1.0);
+        for (int k = 0 ; k < n_k ; ++k)
+          a[k] = 1.0 / (k + 1);
+        for (Size j = 0 ; j < n_k * ldx ; ++j)
+          X[j] = Real((7 * j) % 13) - 6.0;
+
+        contract(n_k,n,a.data(),X.data(),ldx,y.data());
+
+        for (Size i = 0 ; i < n ; ++i)
+        {
+          Real y_i = 0.0;
+          Real abs_sum = 0.0;
+          for (int k = 0 ; k < n_k ; ++k)
+          {
+            y_i += a[k] * X[k * ldx + i];
+            abs_sum += std::abs(a[k] * X[k * ldx + i]);
+          }
+          same = same && std::abs(y[i] - y_i) <= rel_tol * abs_sum;
+        }
+
+        // the entries after the n-th must not be modified
+        for (Size i = n ; i < ldx ; ++i)
+          same = same && (y[i] == -1.0);
+      }
+  }
+  set_instruction_set(get_best_instruction_set());
+
+  out << "Same results as the naive contraction for all the instruction sets: "
+      << (same ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+template<int dim>
+void variable_coefficient(const int n_knots, const int deg)
+{
+  OUTSTART
+
+  auto grid = Grid<dim>::create(n_knots);
+  auto space = SplineSpace<dim>::create(deg, grid);
+  auto basis = BSpline<dim>::create(space);
+  auto quad = QGauss<dim>::create(deg+1);
+
+  using Flags = basis_element::Flags;
+  auto handler = basis->create_cache_handler();
+  handler->set_element_flags(Flags::value | Flags::w_measure);
+
+  auto elem = basis->begin();
+  const auto end = basis->end();
+  handler->init_element_cache(elem,quad);
+
+  const int n_basis = elem->get_num_basis();
+  const int n_pts = quad->get_num_points();
+
+  ValueVector<Real> coeffs(n_pts);
+  for (int q = 0 ; q < n_pts ; ++q)
+    coeffs[q] = 1.0 + 0.1 * q;
+
+  const EllipticOperatorsSFIntegrationBSpline<dim,1,1> operators;
+  DenseMatrix op_u_v(n_basis,n_basis);
+
+  bool same = true;
+  for (; elem != end; ++elem)
+  {
+    handler->fill_element_cache(elem);
+    const auto &bsp_elem = dynamic_cast<const BSplineElement<dim,1,1> &>(*elem);
+
+    using _Value = typename BSplineElement<dim,1,1>::_Value;
+    const auto &phi = elem->template get_basis_data<_Value,dim>(0,DofProperties::active);
+    const auto w_meas = elem->template get_w_measures<dim>(0);
+
+    for (const auto &instruction_set : get_supported_instruction_sets())
+    {
+      set_instruction_set(instruction_set);
+
+      op_u_v = 0.0;
+      operators.template eval_operator_u_v<dim>(
+        bsp_elem,bsp_elem,coeffs,0,op_u_v);
+
+      for (int i = 0 ; i < n_basis ; ++i)
+      {
+        const auto phi_i = phi.get_function_view(i);
+        for (int j = 0 ; j < n_basis ; ++j)
+        {
+          const auto phi_j = phi.get_function_view(j);
+          Real op_ij = 0.0;
+          Real abs_sum = 0.0;
+          for (int q = 0 ; q < n_pts ; ++q)
+          {
+            const Real term = coeffs[q] * w_meas[q] * phi_i[q][0] * phi_j[q][0];
+            op_ij += term;
+            abs_sum += std::abs(term);
+          }
+          same = same && std::abs(op_u_v(i,j) - op_ij) <= rel_tol * abs_sum;
+        }
+      }
+    }
+  }
+  set_instruction_set(get_best_instruction_set());
+
+  out << "Same local matrices as the standard quadrature: " << (same ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+template<int dim>
+void symmetric_operator(const int n_basis_1D, const int n_pts_1D)
+{
+  OUTSTART
+
+  const TensorSize<dim> t_size_theta(n_pts_1D);
+  const TensorSize<dim> t_size_alpha(n_basis_1D);
+
+  // symmetric 1D moments J(theta,alpha,beta) = phi(theta,alpha) * phi(theta,beta)
+  TensorSize<3> t_size_J;
+  t_size_J[0] = n_pts_1D;
+  t_size_J[1] = n_basis_1D;
+  t_size_J[2] = n_basis_1D;
+
+  SafeSTLArray<DynamicMultiArray<Real,3>,dim> J;
+  for (int dir = 0 ; dir < dim ; ++dir)
+  {
+    J[dir].resize(t_size_J);
+    Index id = 0;
+    for (int beta = 0 ; beta < n_basis_1D ; ++beta)
+      for (int alpha = 0 ; alpha < n_basis_1D ; ++alpha)
+        for (int theta = 0 ; theta < n_pts_1D ; ++theta)
+          J[dir][id++] = std::sin(1.0 + theta + (dir + 1) * alpha) *
+                         std::sin(1.0 + theta + (dir + 1) * beta);
+  }
+
+  TensorSize<3> t_size_C;
+  t_size_C[0] = t_size_theta.flat_size();
+  t_size_C[1] = 1;
+  t_size_C[2] = 1;
+  DynamicMultiArray<Real,3> C(t_size_C);
+  for (Index i = 0 ; i < C.flat_size() ; ++i)
+    C[i] = 1.0 + 0.1 * i;
+
+  const int n_basis = t_size_alpha.flat_size();
+  DenseMatrix op_full(n_basis,n_basis);
+  DenseMatrix op_sym(n_basis,n_basis);
+  op_full = 0.0;
+  op_sym = 0.0;
+
+  const IntegratorSumFactorization<dim> integrate;
+  integrate(false,t_size_theta,t_size_alpha,t_size_alpha,J,C,
+            0,n_basis-1,0,n_basis-1,op_full);
+  integrate(true,t_size_theta,t_size_alpha,t_size_alpha,J,C,
+            0,n_basis-1,0,n_basis-1,op_sym);
+
+  Real max_entry = 0.0;
+  Real max_diff = 0.0;
+  for (int i = 0 ; i < n_basis ; ++i)
+    for (int j = 0 ; j < n_basis ; ++j)
+    {
+      max_entry = std::max(max_entry,std::abs(op_full(i,j)));
+      max_diff = std::max(max_diff,std::abs(op_sym(i,j) - op_full(i,j)));
+    }
+
+  out << "Same local operator with the symmetric shortcut: "
+      << (max_diff <= rel_tol * max_entry ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  contract_kernel();
+
+  variable_coefficient<1>(5,3);
+  variable_coefficient<2>(4,2);
+  variable_coefficient<3>(3,3);
+
+  symmetric_operator<1>(4,5);
+  symmetric_operator<2>(3,4);
+  symmetric_operator<3>(4,5);
+
+  return  0;
+}
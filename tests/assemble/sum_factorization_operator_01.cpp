@@ -0,0 +1,163 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the SumFactorizationOperator: the matrix-free product (with variable
+ *  coefficients) is compared with the product by the global matrix assembled
+ *  from the element values and gradients of the basis functions.
+ *  The product must be the same for any number of threads.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/operators/sum_factorization_operator.h>
+
+
+template<int dim>
+void sum_factorization_operator(const int n_knots, const int deg,
+                                const bool with_mass, const bool with_stiffness)
+{
+  OUTSTART
+
+  using Operator = SumFactorizationOperator<dim>;
+  using Point = typename Operator::Point;
+
+  auto grid = Grid<dim>::create(n_knots);
+  auto space = SplineSpace<dim>::create(deg, grid);
+  auto basis = BSpline<dim>::create(space);
+  auto quad = QGauss<dim>::create(deg+1);
+
+  typename Operator::CoeffFunction c0;
+  typename Operator::CoeffFunction c1;
+  if (with_mass)
+    c0 = [](const Point &x)
+  {
+    return 1.0 + x[0];
+  };
+  if (with_stiffness)
+    c1 = [](const Point &x)
+  {
+    return 2.0 + x[dim-1] * x[dim-1];
+  };
+
+  const int n_basis = basis->get_num_basis();
+
+  // global matrix assembled from the element values
+  DenseMatrix A(n_basis,n_basis);
+  A = 0.0;
+  {
+    using Flags = basis_element::Flags;
+    auto handler = basis->create_cache_handler();
+    handler->set_element_flags(Flags::value | Flags::gradient |
+                               Flags::point | Flags::w_measure);
+
+    auto elem = basis->begin();
+    const auto end = basis->end();
+    handler->init_element_cache(elem,quad);
+
+    for (; elem != end; ++elem)
+    {
+      handler->fill_element_cache(elem);
+      const auto &phi = elem->get_element_values();
+      const auto &grad_phi = elem->get_element_gradients();
+      const auto w_meas = elem->get_element_w_measures();
+      const auto &points = elem->get_grid_element().get_element_points();
+      const auto dofs = elem->get_local_to_global();
+
+      const int n_dofs = dofs.size();
+      const int n_pts = w_meas.size();
+      for (int i = 0 ; i < n_dofs ; ++i)
+      {
+        const auto phi_i = phi.get_function_view(i);
+        const auto grad_phi_i = grad_phi.get_function_view(i);
+        for (int j = 0 ; j < n_dofs ; ++j)
+        {
+          const auto phi_j = phi.get_function_view(j);
+          const auto grad_phi_j = grad_phi.get_function_view(j);
+
+          Real a_ij = 0.0;
+          for (int q = 0 ; q < n_pts ; ++q)
+          {
+            if (with_mass)
+              a_ij += w_meas[q] * c0(points[q]) *
+                      phi_i[q][0] * phi_j[q][0];
+            if (with_stiffness)
+              a_ij += w_meas[q] * c1(points[q]) *
+                      scalar_product(grad_phi_i[q],grad_phi_j[q]);
+          }
+          A(dofs[i],dofs[j]) += a_ij;
+        }
+      }
+    }
+  }
+
+  SafeSTLVector<Real> x(n_basis);
+  for (int i = 0 ; i < n_basis ; ++i)
+    x[i] = std::sin(1.0 + i);
+
+  SafeSTLVector<Real> y_ref(n_basis,0.0);
+  Real norm_ref = 0.0;
+  for (int i = 0 ; i < n_basis ; ++i)
+  {
+    for (int j = 0 ; j < n_basis ; ++j)
+      y_ref[i] += A(i,j) * x[j];
+    norm_ref = std::max(norm_ref,std::abs(y_ref[i]));
+  }
+
+  SafeSTLVector<Real> y_serial;
+  for (const int n_threads : {1,2,3})
+  {
+    const Operator op(basis,quad,c0,c1,n_threads);
+
+    SafeSTLVector<Real> y;
+    op.apply(x,y);
+
+    Real err = 0.0;
+    for (int i = 0 ; i < n_basis ; ++i)
+      err = std::max(err,std::abs(y[i] - y_ref[i]));
+
+    if (n_threads == 1)
+      y_serial = y;
+
+    out << "n_threads: " << n_threads
+        << "   num dofs: " << op.get_num_dofs()
+        << "   error below tolerance: " << (err < 1.0e-12 * norm_ref ? "true" : "false")
+        << "   same as serial: " << (y == y_serial ? "true" : "false") << endl;
+  }
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  sum_factorization_operator<1>(7,2,true,true);
+  sum_factorization_operator<2>(4,2,true,false);
+  sum_factorization_operator<2>(4,3,false,true);
+  sum_factorization_operator<2>(5,2,true,true);
+  sum_factorization_operator<3>(3,2,true,true);
+
+  return  0;
+}
@@ -0,0 +1,145 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the SumFactorizationWorkspace: once the workspace is sized, the
+ *  evaluation of the local mass and stiffness matrices with the sum-factorization
+ *  technique must not perform any heap allocation.
+ *  The local matrices are compared with the ones computed with the standard
+ *  quadrature.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/operators/elliptic_operators_sf_integration.h>
+
+#include <cstdlib>
+#include <new>
+
+
+// heap allocations counter (active only when count_allocations is true)
+bool count_allocations = false;
+long n_allocations = 0;
+
+void *operator new(std::size_t size)
+{
+  if (count_allocations)
+    ++n_allocations;
+
+  void *p = std::malloc(size > 0 ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+
+
+template<int dim>
+void sum_factorization_workspace(const int n_knots, const int deg)
+{
+  OUTSTART
+
+  auto grid = Grid<dim>::create(n_knots);
+  auto space = SplineSpace<dim>::create(deg, grid);
+  auto basis = BSpline<dim>::create(space);
+  auto quad = QGauss<dim>::create(deg+1);
+
+  using Flags = basis_element::Flags;
+  auto handler = basis->create_cache_handler();
+  handler->set_element_flags(Flags::value | Flags::gradient | Flags::w_measure);
+
+  auto elem = basis->begin();
+  const auto end = basis->end();
+  handler->init_element_cache(elem,quad);
+
+  const int n_basis = elem->get_num_basis();
+  const int n_pts = quad->get_num_points();
+
+  SumFactorizationWorkspace<dim> workspace(deg+1,deg+1);
+  const EllipticOperatorsSFIntegrationBSpline<dim,1,1> operators(workspace);
+
+  const ValueVector<Real> coeffs_u_v(n_pts,1.0);
+  SafeSTLArray<ValueVector<Real>,dim> coeffs_gradu_gradv;
+  for (int i = 0 ; i < dim ; ++i)
+    coeffs_gradu_gradv[i] = ValueVector<Real>(n_pts,1.0);
+
+  DenseMatrix op_u_v(n_basis,n_basis);
+  DenseMatrix op_gradu_gradv(n_basis,n_basis);
+
+  long n_allocs_steady_state = 0;
+  bool same_as_std = true;
+  for (; elem != end; ++elem)
+  {
+    handler->fill_element_cache(elem);
+    const auto &bsp_elem = dynamic_cast<const BSplineElement<dim,1,1> &>(*elem);
+
+    n_allocations = 0;
+    count_allocations = true;
+
+    op_u_v = 0.0;
+    operators.template eval_operator_u_v<dim>(
+      bsp_elem,bsp_elem,coeffs_u_v,0,op_u_v);
+
+    op_gradu_gradv = 0.0;
+    operators.template eval_operator_gradu_gradv<dim>(
+      bsp_elem,bsp_elem,coeffs_gradu_gradv,0,op_gradu_gradv);
+
+    count_allocations = false;
+    n_allocs_steady_state += n_allocations;
+
+    const auto std_u_v = elem->template integrate_u_v<dim>(0);
+    const auto std_gradu_gradv = elem->template integrate_gradu_gradv<dim>(0);
+    for (int i = 0 ; i < n_basis ; ++i)
+      for (int j = 0 ; j < n_basis ; ++j)
+        same_as_std = same_as_std &&
+                      std::abs(op_u_v(i,j) - std_u_v(i,j)) < 1.0e-14 &&
+                      std::abs(op_gradu_gradv(i,j) - std_gradu_gradv(i,j)) < 1.0e-12;
+  }
+
+  out << "Heap allocations in the local matrices evaluation: " << n_allocs_steady_state << endl;
+  out << "Same local matrices as the standard quadrature: " << (same_as_std ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  sum_factorization_workspace<1>(5,3);
+  sum_factorization_workspace<2>(4,2);
+  sum_factorization_workspace<3>(3,2);
+
+  return  0;
+}
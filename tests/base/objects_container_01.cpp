@@ -107,7 +107,7 @@ void insert_objects(const std::shared_ptr<ObjectsContainer> container)
 
   IgCoefficients weights;
   for (int dof = 0 ; dof < n_scalar_basis ; ++dof)
-    weights[dof] = 1.0;
+    weights.insert(dof, 1.0);
 
   const auto w_func = WeightFuncType::create(scalar_basis,weights);
   w_func->set_name("my_weight_function");
@@ -0,0 +1,114 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the allocation-free Bernstein kernel BernsteinBasis::evaluate_derivatives():
+ *  the values and the derivatives (computed in a single pass for all the orders)
+ *  are compared with the explicit formula
+ *  d^k B^p_i = p!/(p-k)! sum_{j=0}^{k} (-1)^{k+j} (k j) B^{p-k}_{i-j}
+ *  for the degrees handled by the specialized versions and for higher degrees.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/basis_functions/bernstein_basis.h>
+#include <boost/math/special_functions/binomial.hpp>
+
+using boost::math::binomial_coefficient;
+
+
+Real bernstein(const int p, const int i, const Real x)
+{
+  if (i < 0 || i > p)
+    return 0.0;
+  return binomial_coefficient<Real>(p,i) * std::pow(x,i) * std::pow(1.0-x,p-i);
+}
+
+
+Real bernstein_derivative(const int k, const int p, const int i, const Real x)
+{
+  if (k > p)
+    return 0.0;
+
+  Real factor = 1.0;
+  for (int l = 0 ; l < k ; ++l)
+    factor *= (p - l);
+
+  Real res = 0.0;
+  for (int j = 0 ; j <= k ; ++j)
+    res += ((k+j) % 2 == 0 ? 1.0 : -1.0) * binomial_coefficient<Real>(k,j) *
+           bernstein(p-k,i-j,x);
+
+  return factor * res;
+}
+
+
+
+void bernstein_kernel(const int p, const int n_orders)
+{
+  const int n_pts = 7;
+  SafeSTLVector<Real> points(n_pts);
+  for (int j = 0 ; j < n_pts ; ++j)
+    points[j] = Real(j)/(n_pts-1);
+
+  const int n_basis = p+1;
+  SafeSTLVector<Real> D_B(n_orders * n_basis * n_pts);
+  SafeSTLVector<Real> work(BernsteinBasis::get_work_size(p,n_pts));
+  BernsteinBasis::evaluate_derivatives(p,n_orders,points.data(),n_pts,D_B.data(),work.data());
+
+  Real max_err = 0.0;
+  for (int k = 0 ; k < n_orders ; ++k)
+    for (int i = 0 ; i < n_basis ; ++i)
+      for (int j = 0 ; j < n_pts ; ++j)
+      {
+        const Real exact = bernstein_derivative(k,p,i,points[j]);
+        const Real err = std::abs(D_B[(k*n_basis+i)*n_pts+j] - exact) / std::max(1.0,std::abs(exact));
+        max_err = std::max(max_err,err);
+      }
+
+  // the kernel must give the same values of BernsteinBasis::derivative()
+  bool same_as_derivative = true;
+  for (int k = 0 ; k < n_orders ; ++k)
+  {
+    const auto D_B_k = BernsteinBasis::derivative(k,p,points);
+    for (int i = 0 ; i < n_basis ; ++i)
+      for (int j = 0 ; j < n_pts ; ++j)
+        same_as_derivative = same_as_derivative &&
+                             (D_B_k(i,j) == D_B[(k*n_basis+i)*n_pts+j]);
+  }
+
+  out << "degree: " << p << "   orders: " << n_orders
+      << "   error below tolerance: " << (max_err < 1.0e-12 ? "true" : "false")
+      << "   same as derivative(): " << (same_as_derivative ? "true" : "false") << endl;
+}
+
+
+
+int main()
+{
+  for (int p = 0 ; p <= 9 ; ++p)
+    bernstein_kernel(p,4);
+
+  bernstein_kernel(3,1);
+  bernstein_kernel(6,7);
+
+  return 0;
+}
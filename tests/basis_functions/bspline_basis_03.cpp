@@ -74,7 +74,7 @@ int main()
 
   IgCoefficients coeffs;
   for (int dof = 0 ; dof < n_basis ; ++dof)
-    coeffs[dof] = 1.0;
+    coeffs.insert(dof, 1.0);
 
 
   using IgGridFunc = IgGridFunction<dim,1>;
@@ -0,0 +1,140 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for BSplineHandler::fill_cache_batch(): the values, gradients and hessians
+ *  computed for a batch of elements must be equal (up to round-off) to the ones
+ *  computed by the element cache, for the elements in the iteration order
+ *  (i.e. rows along the direction 0) and in the reverse order.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/bspline_handler.h>
+#include <igatools/base/quadrature_lib.h>
+
+
+template <class T>
+bool close_values(const ValueTable<T> &a, const ValueTable<T> &b)
+{
+  if (a.get_num_functions() != b.get_num_functions() ||
+      a.get_num_points() != b.get_num_points())
+    return false;
+
+  auto it_b = b.cbegin();
+  for (auto it_a = a.cbegin() ; it_a != a.cend() ; ++it_a, ++it_b)
+    if ((*it_a - *it_b).norm() > 1.0e-12 * std::max(1.0, (*it_a).norm()))
+      return false;
+
+  return true;
+}
+
+
+
+template<int dim, int range = 1>
+void batch(const int n_knots, const typename SplineSpace<dim,range>::DegreeTable &deg)
+{
+  OUTSTART
+
+  using Space = SplineSpace<dim,range>;
+  auto grid = Grid<dim>::const_create(n_knots);
+  auto int_mult = Space::get_multiplicity_from_regularity(InteriorReg::maximum,
+                                                          deg, grid->get_num_intervals());
+  auto space = Space::const_create(deg,grid,int_mult);
+  using Basis = BSpline<dim,range>;
+  auto basis = Basis::const_create(space);
+
+  auto quad = QGauss<dim>::create(3);
+  auto flag = basis_element::Flags::value |
+              basis_element::Flags::gradient|
+              basis_element::Flags::hessian;
+
+  auto handler = basis->create_cache_handler();
+  handler->template set_flags<dim>(flag);
+
+  using Elem = typename Basis::ElementAccessor;
+  using _Value = typename Elem::_Value;
+  using _Gradient = typename Elem::_Gradient;
+  using _Hessian = typename Elem::_Hessian;
+
+  auto elem = basis->begin();
+  auto end =  basis->end();
+  handler->template init_cache<dim>(*elem,quad);
+
+  SafeSTLVector<TensorIndex<dim>> elems_t_id;
+  using Handler = BSplineHandler<dim,range,1>;
+  typename Handler::CacheBatch elem_data;
+  for (; elem != end; ++elem)
+  {
+    handler->template fill_cache<dim>(*elem,0);
+    elems_t_id.push_back(elem->get_index().get_tensor_index());
+    elem_data.values.push_back(
+      elem->template get_basis_data<_Value,dim>(0,DofProperties::active));
+    elem_data.gradients.push_back(
+      elem->template get_basis_data<_Gradient,dim>(0,DofProperties::active));
+    elem_data.hessians.push_back(
+      elem->template get_basis_data<_Hessian,dim>(0,DofProperties::active));
+  }
+  const int n_elems = elems_t_id.size();
+
+  const auto &bsp_handler = dynamic_cast<const Handler &>(*handler);
+
+  typename Handler::CacheBatch batch_data;
+  bsp_handler.fill_cache_batch(elems_t_id,quad,flag,batch_data);
+  bool same = true;
+  for (int e = 0 ; e < n_elems ; ++e)
+    same = same &&
+           close_values(elem_data.values[e],batch_data.values[e]) &&
+           close_values(elem_data.gradients[e],batch_data.gradients[e]) &&
+           close_values(elem_data.hessians[e],batch_data.hessians[e]);
+  out << "Same values in the iteration order: " << (same ? "true" : "false") << endl;
+
+  SafeSTLVector<TensorIndex<dim>> elems_t_id_rev(elems_t_id.rbegin(),elems_t_id.rend());
+  bsp_handler.fill_cache_batch(elems_t_id_rev,quad,basis_element::Flags::gradient,batch_data);
+  same = batch_data.values.empty() && batch_data.hessians.empty();
+  for (int e = 0 ; e < n_elems ; ++e)
+    same = same && close_values(elem_data.gradients[n_elems-1-e],batch_data.gradients[e]);
+  out << "Same gradients in the reverse order: " << (same ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  batch<1>(6,typename SplineSpace<1>::DegreeTable(TensorIndex<1>(3)));
+  batch<2>(5,typename SplineSpace<2>::DegreeTable(TensorIndex<2>(2)));
+  batch<3>(4,typename SplineSpace<3>::DegreeTable(TensorIndex<3>(2)));
+
+  // inactive components
+  batch<2,2>(4,typename SplineSpace<2,2>::DegreeTable(TensorIndex<2>(2)));
+
+  typename SplineSpace<2,2>::DegreeTable deg_2 = { {{3,2}}, {{2,3}} };
+  batch<2,2>(4,deg_2);
+
+  typename SplineSpace<3,3>::DegreeTable deg_3 = { {{3,2,2}}, {{2,3,2}}, {{2,2,3}} };
+  batch<3,3>(3,deg_3);
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the BSplineHandler global cache: the values, gradients and hessians
+ *  (on the elements and on their faces) computed using the global cache must be
+ *  identical to the ones computed without it.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/bspline_handler.h>
+#include <igatools/base/quadrature_lib.h>
+
+
+template <class T>
+bool same_values(const ValueTable<T> &a, const ValueTable<T> &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  auto it_b = b.cbegin();
+  for (auto it_a = a.cbegin() ; it_a != a.cend() ; ++it_a, ++it_b)
+    if ((*it_a - *it_b).norm_square() != 0.0)
+      return false;
+
+  return true;
+}
+
+
+
+template<int dim, int k=dim-1>
+void global_cache(const int n_knots, const int deg)
+{
+  OUTSTART
+
+  auto grid = Grid<dim>::const_create(n_knots);
+  auto space = SplineSpace<dim>::const_create(deg, grid);
+  using Basis = BSpline<dim>;
+  auto basis = Basis::const_create(space);
+
+  auto quad = QGauss<dim>::create(deg+1);
+  auto k_quad = QGauss<k>::create(deg+1);
+  auto flag = basis_element::Flags::value |
+              basis_element::Flags::gradient|
+              basis_element::Flags::hessian;
+
+  auto handler = basis->create_cache_handler();
+  auto handler_gc = basis->create_cache_handler();
+  auto &bsp_handler_gc = dynamic_cast<BSplineHandler<dim,1,1> &>(*handler_gc);
+  bsp_handler_gc.enable_global_cache();
+
+  for (auto *h : {handler.get(),handler_gc.get()})
+  {
+    h->template set_flags<dim>(flag);
+    h->template set_flags<k>(flag);
+  }
+
+  using Elem = typename Basis::ElementAccessor;
+  using _Value = typename Elem::_Value;
+  using _Gradient = typename Elem::_Gradient;
+  using _Hessian = typename Elem::_Hessian;
+
+  auto elem = basis->begin();
+  auto elem_gc = basis->begin();
+  auto end =  basis->end();
+
+  handler->template init_cache<dim>(*elem,quad);
+  handler->template init_cache<k>(*elem,k_quad);
+  handler_gc->template init_cache<dim>(*elem_gc,quad);
+  handler_gc->template init_cache<k>(*elem_gc,k_quad);
+
+  out << "Global cache enabled: " << bsp_handler_gc.is_global_cache_enabled() << endl;
+  out << "Number of 1D tables (sdim = " << dim << "): "
+      << bsp_handler_gc.get_num_global_cache_tables(dim) << endl;
+  out << "Number of 1D tables (sdim = " << k << "): "
+      << bsp_handler_gc.get_num_global_cache_tables(k) << endl;
+
+  bool same = true;
+  for (; elem != end; ++elem, ++elem_gc)
+  {
+    handler->template fill_cache<dim>(*elem,0);
+    handler_gc->template fill_cache<dim>(*elem_gc,0);
+
+    same = same &&
+           same_values(elem->template get_basis_data<_Value,dim>(0,DofProperties::active),
+                       elem_gc->template get_basis_data<_Value,dim>(0,DofProperties::active)) &&
+           same_values(elem->template get_basis_data<_Gradient,dim>(0,DofProperties::active),
+                       elem_gc->template get_basis_data<_Gradient,dim>(0,DofProperties::active)) &&
+           same_values(elem->template get_basis_data<_Hessian,dim>(0,DofProperties::active),
+                       elem_gc->template get_basis_data<_Hessian,dim>(0,DofProperties::active));
+
+    for (auto &s_id : UnitElement<dim>::template elems_ids<k>())
+    {
+      handler->template fill_cache<k>(*elem,s_id);
+      handler_gc->template fill_cache<k>(*elem_gc,s_id);
+
+      same = same &&
+             same_values(elem->template get_basis_data<_Value,k>(s_id,DofProperties::active),
+                         elem_gc->template get_basis_data<_Value,k>(s_id,DofProperties::active)) &&
+             same_values(elem->template get_basis_data<_Gradient,k>(s_id,DofProperties::active),
+                         elem_gc->template get_basis_data<_Gradient,k>(s_id,DofProperties::active)) &&
+             same_values(elem->template get_basis_data<_Hessian,k>(s_id,DofProperties::active),
+                         elem_gc->template get_basis_data<_Hessian,k>(s_id,DofProperties::active));
+    } // end loop s_id
+  } // end loop elem
+
+  out << "Same values with and without global cache: " << (same ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  global_cache<1>(12,3);
+  global_cache<2>(8,2);
+  global_cache<3>(5,2);
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the multithreaded norm difference and integrate functions:
+ *  the norms and the element contributions must be the same for
+ *  any number of threads.
+ *
+ */
+
+#include "../tests.h"
+
+#include "common_functions.h"
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/basis_tools.h>
+#include <igatools/functions/grid_function_lib.h>
+#include <igatools/functions/function_lib.h>
+
+
+template<int dim>
+void norm_difference_grid_func(const int n_knots)
+{
+  OUTSTART
+
+  auto grid = Grid<dim>::const_create(n_knots);
+
+  const int n_qpoints = ceil((2*dim + 1)/2.);
+  auto quad = QGauss<dim>::const_create(n_qpoints);
+
+  auto f = ProductGridFunction<dim,1>::const_create(grid);
+  auto g = grid_functions::ConstantGridFunction<dim,1>::const_create(grid, {0.});
+
+  using ElemErr = SafeSTLMap<ElementIndex<dim>,Real>;
+  SafeSTLArray<Real,3> err_serial;
+  SafeSTLArray<ElemErr,3> elem_err_serial;
+  for (const int n_threads : {1,2,3,7})
+  {
+    SafeSTLArray<ElemErr,3> elem_err;
+    SafeSTLArray<Real,3> err;
+    err[0] = basis_tools::l2_norm_difference<dim,1>(*f,*g,quad,elem_err[0],n_threads);
+    err[1] = basis_tools::h1_norm_difference<dim,1>(*f,*g,quad,elem_err[1],n_threads);
+    err[2] = basis_tools::inf_norm_difference<dim,1>(*f,*g,quad,elem_err[2],n_threads);
+
+    if (n_threads == 1)
+    {
+      err_serial = err;
+      elem_err_serial = elem_err;
+    }
+
+    out << "n_threads: " << n_threads
+        << "   L2: " << err[0]
+        << "   H1: " << err[1]
+        << "   inf: " << err[2]
+        << "   same as serial: "
+        << (err == err_serial && elem_err == elem_err_serial ? "true" : "false") << endl;
+  }
+
+  OUTEND
+}
+
+
+
+template<int dim>
+void norm_difference_func(const int n_knots)
+{
+  OUTSTART
+
+  auto grid = Grid<dim>::create(n_knots);
+  auto domain = Domain<dim,0>::create(grid_functions::IdentityGridFunction<dim>::create(grid));
+
+  const int n_qpoints = ceil((2*dim + 1)/2.);
+  auto quad = QGauss<dim>::const_create(n_qpoints);
+
+  using LinFunc = functions::LinearFunction<dim,0,1>;
+  using Grad = typename LinFunc::Gradient;
+  using Value = typename LinFunc::Value;
+
+  Grad A;
+  A[0][0] = 1.0;
+  Value b;
+
+  auto f = LinFunc::const_create(domain, A,b);
+  auto g = functions::ConstantFunction<dim,0,1,1>::const_create(domain, {0.});
+
+  using ElemErr = SafeSTLMap<ElementIndex<dim>,Real>;
+  SafeSTLArray<Real,3> err_serial;
+  SafeSTLArray<ElemErr,3> elem_err_serial;
+  for (const int n_threads : {1,2,3,7})
+  {
+    SafeSTLArray<ElemErr,3> elem_err;
+    SafeSTLArray<Real,3> err;
+    err[0] = basis_tools::l2_norm_difference<dim,0,1,1>(*f,*g,quad,elem_err[0],n_threads);
+    err[1] = basis_tools::h1_norm_difference<dim,0,1,1>(*f,*g,quad,elem_err[1],n_threads);
+    err[2] = basis_tools::inf_norm_difference<dim,0,1,1>(*f,*g,quad,elem_err[2],n_threads);
+
+    SafeSTLMap<ElementIndex<dim>,Value> elem_int;
+    const auto integral = basis_tools::integrate<0,dim,0,1,1>(*f,quad,elem_int,n_threads);
+
+    if (n_threads == 1)
+    {
+      err_serial = err;
+      elem_err_serial = elem_err;
+    }
+
+    out << "n_threads: " << n_threads
+        << "   L2: " << err[0]
+        << "   H1: " << err[1]
+        << "   inf: " << err[2]
+        << "   same as serial: "
+        << (err == err_serial && elem_err == elem_err_serial ? "true" : "false") << endl;
+    out << "Integral: " << integral << endl;
+  }
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  norm_difference_grid_func<2>(10);
+  norm_difference_func<2>(10);
+
+  return  0;
+}
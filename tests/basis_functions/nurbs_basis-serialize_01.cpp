@@ -121,7 +121,7 @@ void do_test()
 
   IgCoefficients weights;
   for (int dof = 0 ; dof < n_scalar_basis ; ++dof)
-    weights[dof] = 1.0;
+    weights.insert(dof, 1.0);
 
   auto w_func = WeightFunc::create(scalar_space,weights);
 
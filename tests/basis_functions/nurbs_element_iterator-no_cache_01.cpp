@@ -59,7 +59,7 @@ void test()
 
   IgCoefficients weights;
   for (int dof = 0 ; dof < n_scalar_basis ; ++dof)
-    weights[dof] = 1.0;
+    weights.insert(dof, 1.0);
 
   const auto w_func = WeightFunc::const_create(scalar_bsp_basis,weights);
 
@@ -49,7 +49,7 @@ void sub_basis(TensorSize<dim> n, const int degree = 1)
 
   IgCoefficients weights;
   for (int dof = 0 ; dof < n_scalar_basis ; ++dof)
-    weights[dof] = dof * 1.0;
+    weights.insert(dof, dof * 1.0);
 
   const auto w_func = WeightFunc::const_create(scalar_bsp_basis,weights);
 
@@ -92,62 +92,62 @@ create_function(shared_ptr<const BSpline<dim, dim + codim>> basis)
   if (dim == 1)
   {
     int id = 0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
   }
   else if (dim == 2)
   {
     int id = 0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
   }
   else if (dim == 3)
   {
     int id = 0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
   }
 
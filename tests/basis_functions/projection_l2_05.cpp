@@ -0,0 +1,124 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the fast (Kronecker-product) l2 projection functions.
+ *  The projection of a function in the space must return its coefficients:
+ *  - for a BSpline basis (Cartesian case, banded univariate solves);
+ *  - for a PhysicalBasis on a mapped domain (preconditioned CG with the
+ *    matrix-free mass matrix).
+ */
+
+#include "../tests.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/functions/grid_function_lib.h>
+#include <igatools/functions/ig_grid_function.h>
+#include <igatools/functions/ig_function.h>
+
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/physical_basis.h>
+#include <igatools/basis_functions/physical_basis_element.h>
+
+#include <igatools/basis_functions/basis_tools.h>
+
+
+
+template<class Basis>
+IgCoefficients
+create_coefficients(const Basis &basis)
+{
+  IgCoefficients coeffs;
+  const auto &dofs =
+    basis.get_spline_space()->get_dof_distribution()->get_global_dofs();
+  for (const auto dof : dofs)
+    coeffs.insert(dof, 1.0 + 0.5 * (dof % 7));
+
+  return coeffs;
+}
+
+
+
+template<int dim, int range>
+void project_grid_function(const int p, const int n_knots = 3)
+{
+  OUTSTART
+
+  auto grid = Grid<dim>::const_create(n_knots);
+  auto space = SplineSpace<dim,range>::const_create(p, grid);
+  auto basis = BSpline<dim,range>::const_create(space);
+
+  const auto coeffs = create_coefficients(*basis);
+  auto f = IgGridFunction<dim,range>::const_create(basis,coeffs);
+
+  auto quad = QGauss<dim>::const_create(p+1);
+  const auto proj_coeffs =
+    basis_tools::fast_projection_l2_grid_function<dim,range>(*f,*basis,quad);
+  proj_coeffs.print_info(out);
+
+  OUTEND
+}
+
+
+
+template<int dim>
+void project_function(const int p, const int n_knots = 3)
+{
+  OUTSTART
+
+  // quarter of annulus
+  BBox<dim> box;
+  box[0] = {0.5, 1.};
+  for (int i = 1 ; i < dim ; ++i)
+    box[i] = {0., 0.5 * numbers::PI};
+
+  auto grid = Grid<dim>::const_create(box, n_knots);
+  auto map = grid_functions::BallGridFunction<dim>::const_create(grid);
+  auto domain = Domain<dim,0>::const_create(map);
+
+  auto space = SplineSpace<dim>::const_create(p, grid);
+  auto ref_basis = BSpline<dim>::const_create(space);
+  auto basis = PhysicalBasis<dim,1,1,0>::const_create(ref_basis,domain);
+
+  const auto coeffs = create_coefficients(*basis);
+  auto f = IgFunction<dim,0,1,1>::const_create(basis,coeffs);
+
+  auto quad = QGauss<dim>::const_create(p+2);
+  const auto proj_coeffs =
+    basis_tools::fast_projection_l2_function<dim,0,1,1>(*f,*basis,quad);
+  proj_coeffs.print_info(out);
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  project_grid_function<1,1>(3,4);
+  project_grid_function<2,1>(2);
+  project_grid_function<2,2>(1);
+  project_grid_function<3,1>(1);
+
+  project_function<2>(2);
+
+  return 0;
+}
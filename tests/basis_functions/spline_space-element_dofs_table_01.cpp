@@ -0,0 +1,122 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for SplineSpace::get_element_dofs_table(): the element-to-dofs table
+ *  is printed for the active dofs and for the dofs with a user-defined property,
+ *  before and after the modification of the property
+ *  (that must trigger the rebuild of the table).
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/basis_functions/spline_space.h>
+#include <igatools/basis_functions/dof_distribution.h>
+
+#include <algorithm>
+
+
+template <class Table>
+void print_table(const Table &table, const Size n_elems)
+{
+  for (Index elem = 0 ; elem < n_elems ; ++elem)
+  {
+    out << "Element: " << elem << endl;
+
+    out << "   Global dofs: ";
+    for (const auto dof : table.get_global_dofs(elem))
+      out << dof << " ";
+    out << endl;
+
+    out << "   Local-to-patch dofs: ";
+    for (const auto dof : table.get_local_to_patch(elem))
+      out << dof << " ";
+    out << endl;
+
+    out << "   Local-to-element dofs: ";
+    for (const auto dof : table.get_local_to_elem(elem))
+      out << dof << " ";
+    out << endl;
+
+    out << "   Number of dofs: " << table.get_num_dofs(elem) << endl;
+  }
+}
+
+
+
+template<int dim, int range>
+void element_dofs_table(const int deg, const int n_knots)
+{
+  OUTSTART
+
+  const std::string marked = "marked";
+
+  auto grid = Grid<dim>::create(n_knots);
+  const Size n_elems = grid->get_num_all_elems();
+
+  auto space = SplineSpace<dim,range>::create(deg, grid);
+  auto dof_distribution = space->get_dof_distribution();
+  dof_distribution->add_dofs_property(marked);
+  for (Index dof = 0 ; dof < dof_distribution->get_num_dofs(DofProperties::active) ; dof += 2)
+    dof_distribution->set_dof_property_status(marked,dof,true);
+
+  out.begin_item("Active dofs:");
+  print_table(space->get_element_dofs_table(DofProperties::active),n_elems);
+  out.end_item();
+
+  out.begin_item("Marked dofs:");
+  const auto *marked_table = &space->get_element_dofs_table(marked);
+  print_table(*marked_table,n_elems);
+  out.end_item();
+
+  out << "Same table on second request: "
+      << (marked_table == &space->get_element_dofs_table(marked) ? "true" : "false") << endl;
+
+  dof_distribution->set_dof_property_status(marked,0,false);
+
+  // the first element contains the dof 0 (having the "marked" property before the change)
+  const auto elem_0_dofs = space->get_element_dofs_table(marked).get_global_dofs(0);
+  out << "Table rebuilt after property change: "
+      << (std::find(elem_0_dofs.begin(),elem_0_dofs.end(),0) == elem_0_dofs.end() ?
+          "true" : "false") << endl;
+
+  // the table built before the change is still alive and unchanged
+  const auto old_elem_0_dofs = marked_table->get_global_dofs(0);
+  out << "Old table still valid: "
+      << (std::find(old_elem_0_dofs.begin(),old_elem_0_dofs.end(),0) != old_elem_0_dofs.end() ?
+          "true" : "false") << endl;
+
+  out.begin_item("Marked dofs (after removing dof 0):");
+  print_table(space->get_element_dofs_table(marked),n_elems);
+  out.end_item();
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  element_dofs_table<1,1>(2,4);
+  element_dofs_table<2,2>(1,3);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for TensorProductBlockEvaluator: the blocks of values of the
+ *  derivatives (up to the second order) must be equal (up to round-off) to the
+ *  ones computed by TensorProductFunctionEvaluator::evaluate().
+ *  The number of multiplications of the direct evaluation is printed
+ *  (together with the ones actually performed, if TIME_PROFILING is defined).
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/values1d_const_view.h>
+
+
+template <int dim>
+void block_evaluator(const TensorSize<dim> &n_funcs, const TensorSize<dim> &n_pts)
+{
+  OUTSTART
+
+  auto quad = QGauss<dim>::create(n_pts);
+
+  ElemFuncValues<dim> values_1D;
+  for (int dir = 0 ; dir < dim ; ++dir)
+  {
+    values_1D[dir].resize(n_funcs[dir],n_pts[dir]);
+    for (int order = 0 ; order < 3 ; ++order)
+    {
+      auto &values = values_1D[dir].get_derivative(order);
+      for (int fn = 0 ; fn < n_funcs[dir] ; ++fn)
+        for (int pt = 0 ; pt < n_pts[dir] ; ++pt)
+          values(fn,pt) = 1.0 + 0.3 * order - 0.1 * fn + 0.07 * pt * (dir+1);
+    }
+  }
+
+  // values, first and second derivatives
+  SafeSTLVector<TensorIndex<dim>> orders;
+  orders.emplace_back(TensorIndex<dim>());
+  for (int i = 0 ; i < dim ; ++i)
+  {
+    TensorIndex<dim> order;
+    order[i] = 1;
+    orders.push_back(order);
+  }
+  for (int i = 0 ; i < dim ; ++i)
+    for (int j = i ; j < dim ; ++j)
+    {
+      TensorIndex<dim> order;
+      order[i] += 1;
+      order[j] += 1;
+      orders.push_back(order);
+    }
+
+  TensorProductBlockEvaluator<dim> block_eval(n_funcs,*quad,orders);
+  block_eval.update(values_1D);
+  const TensorProductFunctionEvaluator<dim> direct_eval(*quad,values_1D);
+
+  const int n_funcs_total = n_funcs.flat_size();
+  const int n_pts_total = quad->get_num_points();
+  SafeSTLVector<Real> block(n_pts_total);
+
+  bool same = true;
+  for (int k = 0 ; k < orders.size() ; ++k)
+    for (int fn = 0 ; fn < n_funcs_total ; ++fn)
+    {
+      block_eval.evaluate_block(k,fn,block.data());
+      for (int pt = 0 ; pt < n_pts_total ; ++pt)
+      {
+        const Real exact = direct_eval.evaluate(orders[k],direct_eval.func_flat_to_tensor(fn),pt);
+        same = same && std::abs(block[pt] - exact) < 1.0e-14 * std::max(1.0,std::abs(exact));
+      }
+    }
+
+  out << "Same values of the direct evaluation: " << (same ? "true" : "false") << endl;
+
+#ifdef TIME_PROFILING
+  const auto &op_counts = block_eval.get_operation_counts();
+  out << "Multiplications (partial products): " << op_counts.partial_products << endl;
+  out << "Multiplications (blocks): " << op_counts.block_products << endl;
+#endif // #ifdef TIME_PROFILING
+  out << "Multiplications (direct evaluation): " << block_eval.get_num_products_direct() << endl;
+  block_eval.print_info(out);
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  block_evaluator<1>(TensorSize<1>({4}),TensorSize<1>({3}));
+  block_evaluator<2>(TensorSize<2>({3,4}),TensorSize<2>({2,3}));
+  block_evaluator<3>(TensorSize<3>({3,4,2}),TensorSize<3>({2,3,4}));
+  block_evaluator<3>(TensorSize<3>(5),TensorSize<3>(5));
+
+  return 0;
+}
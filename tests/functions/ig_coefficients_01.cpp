@@ -0,0 +1,117 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the IgCoefficients class: dense storage for contiguous
+ *  global dofs, insertion, switch to the sparse storage, iteration and element gather.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/functions/ig_coefficients.h>
+
+
+void print_coeffs(const IgCoefficients &coeffs)
+{
+  out << "Dense storage: " << (coeffs.is_dense() ? "true" : "false") << endl;
+  out << "Size: " << coeffs.size() << endl;
+  out.begin_item("Coefficients:");
+  coeffs.print_info(out);
+  out.end_item();
+}
+
+
+
+void print_local_coeffs(const IgCoefficients &coeffs,
+                        const SafeSTLVector<Index> &dofs)
+{
+  out.begin_item("Local coefficients of dofs:");
+  dofs.print_info(out);
+  out << endl;
+  coeffs.get_local_coeffs(dofs).print_info(out);
+  out << endl;
+  out.end_item();
+}
+
+
+
+void ig_coefficients()
+{
+  OUTSTART
+
+  // contiguous dofs inserted in increasing order: dense storage
+  IgCoefficients coeffs;
+  for (int dof = 3 ; dof < 8 ; ++dof)
+    coeffs.insert(dof, 0.5 * dof);
+  print_coeffs(coeffs);
+  print_local_coeffs(coeffs, {7,3,5});
+
+  out << "Number of coefficients for dof 10: " << coeffs.count(10) << endl;
+  try
+  {
+    coeffs.at(10);
+  }
+  catch (const std::out_of_range &)
+  {
+    out << "Coefficient for dof 10 not present." << endl;
+  }
+
+  // the access operator does not insert new coefficients
+  try
+  {
+    coeffs[10] = 1.0;
+  }
+  catch (const std::out_of_range &)
+  {
+    out << "Coefficient for dof 10 not inserted by operator[]." << endl;
+  }
+  out << "Inserted dof 3 (already present): "
+      << (coeffs.insert(3, -1.0) ? "true" : "false") << endl;
+
+  // modification through the iterators
+  for (auto dof_value : coeffs)
+    dof_value.second *= 2.0;
+  print_coeffs(coeffs);
+
+  // a non-contiguous dof: sparse storage
+  coeffs.insert(20, 1.0);
+  print_coeffs(coeffs);
+  print_local_coeffs(coeffs, {20,4});
+
+  // initialization from a set of non-contiguous dofs
+  const IgCoefficients coeffs_set(std::set<Index>({0,1,2,5}));
+  print_coeffs(coeffs_set);
+
+  // initialization from a map of contiguous dofs
+  const IgCoefficients coeffs_map(std::map<Index,Real>({{2,1.0},{1,2.0},{0,3.0}}));
+  print_coeffs(coeffs_map);
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  ig_coefficients();
+
+  return 0;
+}
@@ -65,141 +65,141 @@ void ig_grid_function_bspline(const int deg = 2)
     int id = 0 ;
 
     // x coords
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 1.5 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 1.5);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 2.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 2.0);
 
 
     // y coords
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 0.0);
   }
   else if (dim == 3)
   {
     int id = 0 ;
 
     // x coords
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 1.5 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 1.5);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 2.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 2.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 1.5 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 1.5);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 2.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 2.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 1.5 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 1.5);
 
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 2.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 2.0);
 
 
     // y coords
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 1.5 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 1.5);
+    control_pts.insert(id++, 0.0);
 
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 2.0 ;
-    control_pts[id++] = 0.0 ;
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 2.0);
+    control_pts.insert(id++, 0.0);
 
     // z coords
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
-    control_pts[id++] = 0.0 ;
-
-    control_pts[id++] = 0.5 ;
-    control_pts[id++] = 0.5 ;
-    control_pts[id++] = 0.5 ;
-    control_pts[id++] = 0.5 ;
-    control_pts[id++] = 0.5 ;
-    control_pts[id++] = 0.5 ;
-    control_pts[id++] = 0.5 ;
-    control_pts[id++] = 0.5 ;
-    control_pts[id++] = 0.5 ;
-
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
-    control_pts[id++] = 1.0 ;
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
+    control_pts.insert(id++, 0.0);
+
+    control_pts.insert(id++, 0.5);
+    control_pts.insert(id++, 0.5);
+    control_pts.insert(id++, 0.5);
+    control_pts.insert(id++, 0.5);
+    control_pts.insert(id++, 0.5);
+    control_pts.insert(id++, 0.5);
+    control_pts.insert(id++, 0.5);
+    control_pts.insert(id++, 0.5);
+    control_pts.insert(id++, 0.5);
+
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
+    control_pts.insert(id++, 1.0);
 
   }
   auto F = Function::create(basis, control_pts);
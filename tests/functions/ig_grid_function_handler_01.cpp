@@ -0,0 +1,152 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the IgGridFunctionHandler: the handler (that owns a persistent element
+ *  of the basis) is used on all the elements and faces, and with different quadratures,
+ *  also after a modification of the DofDistribution of the basis.
+ *  The values must be identical to the ones computed by a newly created handler.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/functions/ig_grid_function.h>
+#include <igatools/functions/grid_function_element.h>
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+
+
+template <class T>
+bool same_values(const ValueVector<T> &a, const ValueVector<T> &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  auto it_b = b.cbegin();
+  for (auto it_a = a.cbegin() ; it_a != a.cend() ; ++it_a, ++it_b)
+    if ((*it_a - *it_b).norm_square() != 0.0)
+      return false;
+
+  return true;
+}
+
+
+
+template <int dim, int sdim>
+bool
+same_as_new_handler(const IgGridFunction<dim,dim> &F,
+                    const typename IgGridFunction<dim,dim>::ElementAccessor &elem,
+                    const std::shared_ptr<const Quadrature<sdim>> &quad,
+                    const int s_id)
+{
+  using Flags = grid_function_element::Flags;
+  using D0 = grid_function_element::template _D<0>;
+  using D1 = grid_function_element::template _D<1>;
+  using D2 = grid_function_element::template _D<2>;
+
+  auto handler = F.create_cache_handler();
+  handler->template set_flags<sdim>(Flags::D0 | Flags::D1 | Flags::D2);
+
+  auto elem_ref = F.cbegin();
+  elem_ref->move_to(elem.get_index());
+  handler->init_cache(*elem_ref,quad);
+  handler->template fill_cache<sdim>(*elem_ref,s_id);
+
+  return
+    same_values(elem.template get_values_from_cache<D0,sdim>(s_id),
+                elem_ref->template get_values_from_cache<D0,sdim>(s_id)) &&
+    same_values(elem.template get_values_from_cache<D1,sdim>(s_id),
+                elem_ref->template get_values_from_cache<D1,sdim>(s_id)) &&
+    same_values(elem.template get_values_from_cache<D2,sdim>(s_id),
+                elem_ref->template get_values_from_cache<D2,sdim>(s_id));
+}
+
+
+
+template <int dim>
+void ig_grid_function_handler(const int n_knots, const int deg)
+{
+  OUTSTART
+
+  const int k = dim-1;
+  using Function = IgGridFunction<dim,dim>;
+
+  auto grid = Grid<dim>::create(n_knots);
+  auto space = SplineSpace<dim,dim>::create(deg,grid);
+  auto basis = BSpline<dim,dim>::create(space);
+
+  IgCoefficients coeffs;
+  const int n_basis = basis->get_num_basis();
+  for (int i = 0 ; i < n_basis ; ++i)
+    coeffs.insert(i, 1.0 / (i+1));
+
+  auto F = Function::create(basis, coeffs);
+
+  using Flags = grid_function_element::Flags;
+  const auto flag = Flags::D0 | Flags::D1 | Flags::D2;
+
+  auto handler = F->create_cache_handler();
+  handler->template set_flags<dim>(flag);
+  handler->template set_flags<k>(flag);
+
+  bool same = true;
+  for (const int n_pts : {2,3})
+  {
+    // the handler must create again its basis element after this change
+    if (n_pts == 3)
+      space->get_dof_distribution()->add_dofs_property("marked");
+
+    auto quad = QGauss<dim>::create(n_pts);
+    auto k_quad = QGauss<k>::create(n_pts);
+
+    auto elem = F->cbegin();
+    auto end  = F->cend();
+    handler->init_cache(*elem,quad);
+    handler->init_cache(*elem,k_quad);
+
+    for (; elem != end; ++elem)
+    {
+      handler->template fill_cache<dim>(*elem,0);
+      same = same && same_as_new_handler<dim,dim>(*F,*elem,quad,0);
+
+      for (auto &s_id : UnitElement<dim>::template elems_ids<k>())
+      {
+        handler->template fill_cache<k>(*elem,s_id);
+        same = same && same_as_new_handler<dim,k>(*F,*elem,k_quad,s_id);
+      }
+    }
+  }
+
+  out << "Same values as new handler: " << (same ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  ig_grid_function_handler<1>(4,2);
+  ig_grid_function_handler<2>(3,2);
+  ig_grid_function_handler<3>(3,1);
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for GridElement::move_to() and Grid::get_element_position():
+ *  the elements with a given property are visited in reverse order (by random access)
+ *  before and after the property of some elements is changed, and after the list of
+ *  elements of the property is modified directly.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/geometry/grid.h>
+#include <igatools/geometry/grid_element.h>
+
+
+template <int dim>
+bool
+check_random_access(const Grid<dim> &grid, const PropId &prop)
+{
+  const auto &list = grid.get_elements_with_property(prop);
+
+  bool same = true;
+  auto elem = grid.cbegin(prop);
+  for (Index pos = list.size()-1 ; pos >= 0 ; --pos)
+  {
+    elem->move_to(list[pos]);
+    same = same &&
+           (elem->get_index() == list[pos]) &&
+           (elem->get_position() == pos) &&
+           (grid.get_element_position(list[pos],prop) == pos) &&
+           grid.element_has_property(list[pos],prop);
+  }
+
+  Size n_elems_with_prop = 0;
+  for (const auto &grid_elem : grid)
+    if (grid.element_has_property(grid_elem.get_index(),prop))
+      ++n_elems_with_prop;
+    else
+      same = same && (grid.get_element_position(grid_elem.get_index(),prop) == -1);
+
+  return same && (n_elems_with_prop == Size(list.size()));
+}
+
+
+
+template <int dim>
+void move_to(const int n_knots)
+{
+  OUTSTART
+
+  const PropId marked = "marked";
+
+  auto grid = Grid<dim>::create(n_knots);
+  grid->add_property(marked);
+
+  for (const auto &elem : *grid)
+    if (elem.get_index().get_flat_index() % 2 == 0)
+      grid->set_property_status_elem(marked,elem.get_index(),true);
+
+  out << "Active elements: "
+      << (check_random_access(*grid,ElementProperties::active) ? "true" : "false") << endl;
+  out << "Marked elements: "
+      << (check_random_access(*grid,marked) ? "true" : "false") << endl;
+
+  // removing the property to some elements
+  for (const auto &elem : *grid)
+    if (elem.get_index().get_flat_index() % 4 == 0)
+      grid->set_property_status_elem(marked,elem.get_index(),false);
+
+  out << "Marked elements (after removing the property): "
+      << (check_random_access(*grid,marked) ? "true" : "false") << endl;
+
+  // modifying directly the list of the marked elements
+  auto &marked_list = grid->get_elements_with_property(marked);
+  for (const auto &elem : *grid)
+    if (elem.get_index().get_flat_index() % 4 == 0)
+      marked_list.emplace_back(elem.get_index());
+  std::sort(marked_list.begin(),marked_list.end());
+
+  out << "Marked elements (after modifying the list): "
+      << (check_random_access(*grid,marked) ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  move_to<1>(9);
+  move_to<2>(6);
+  move_to<3>(4);
+
+  return 0;
+}
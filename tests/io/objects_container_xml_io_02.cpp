@@ -0,0 +1,141 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/**
+ *  @file
+ *  @brief  Testing the objects container writer and reader with the
+ *          numeric arrays stored in a binary sidecar file: the values read
+ *          through the sidecar must be the written ones and must agree with
+ *          the values read from the text file
+ */
+
+#include "../tests.h"
+#include <igatools/base/objects_container.h>
+#include <igatools/functions/ig_grid_function.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/io/binary_sidecar.h>
+#include <igatools/io/objects_container_xml_reader.h>
+#include <igatools/io/objects_container_xml_writer.h>
+
+using namespace iga;
+using namespace std;
+
+
+template <int dim>
+shared_ptr<IgGridFunction<dim,dim>>
+read_grid_function(const string &file_path)
+{
+  using GridFunc = GridFunction<dim,dim>;
+
+  const auto container = ObjectsContainerXMLReader::parse(file_path);
+  const auto ids = container->template get_object_ids<GridFunc>();
+  AssertThrow(ids.size() == 1, ExcDimensionMismatch(ids.size(), 1));
+
+  const auto func = dynamic_pointer_cast<IgGridFunction<dim,dim>>(
+                      container->template get_object<GridFunc>(*ids.begin()));
+  AssertThrow(func != nullptr, ExcNullPtr());
+  return func;
+}
+
+
+/**
+ * Returns the pairs (global dof, value) of the coefficients of @p func,
+ * followed by the knot coordinates of its grid.
+ */
+template <int dim>
+SafeSTLVector<Real>
+get_values(const IgGridFunction<dim,dim> &func)
+{
+  SafeSTLVector<Real> values;
+  for (const auto &coef : func.get_coefficients())
+  {
+    values.push_back(coef.first);
+    values.push_back(coef.second);
+  }
+
+  const auto grid = func.get_grid();
+  for (int dir = 0 ; dir < dim ; ++dir)
+    for (const auto &knot : grid->get_knot_coordinates(dir))
+      values.push_back(knot);
+
+  return values;
+}
+
+
+template <int dim>
+void test()
+{
+  OUTSTART
+
+  auto grid = Grid<dim>::create(4);
+  grid->set_name("grid");
+  auto basis = BSpline<dim,dim>::create(SplineSpace<dim,dim>::create(2, grid));
+
+  IgCoefficients coeffs;
+  const int n_basis = basis->get_num_basis();
+  for (int i = 0 ; i < n_basis ; ++i)
+    coeffs.insert(i, std::sin(1.0 + i));
+  auto func = IgGridFunction<dim,dim>::create(basis, coeffs);
+  func->set_name("grid_func");
+
+  const auto container = ObjectsContainer::create();
+  container->insert_object<GridFunction<dim,dim>>(func);
+
+  const string text_path = "test_text_" + std::to_string(dim) + ".xml";
+  const string sidecar_path = "test_sidecar_" + std::to_string(dim) + ".xml";
+  ObjectsContainerXMLWriter::write(text_path, container);
+  const bool binary_sidecar = true;
+  ObjectsContainerXMLWriter::write(sidecar_path, container, binary_sidecar);
+
+  // The knots of each direction, the coefficient indices and values.
+  const auto sidecar = BinarySidecar::open(sidecar_path + ".bin");
+  out << "Sidecar mapped: " << (sidecar->is_mapped() ? "true" : "false") << endl;
+  out << "Number of sidecar blocks: " << sidecar->get_num_blocks() << endl;
+
+  const auto values = get_values(*func);
+  const auto text_values = get_values(*read_grid_function<dim>(text_path));
+  const auto sidecar_values = get_values(*read_grid_function<dim>(sidecar_path));
+
+  out << "Number of values: " << values.size() << endl;
+
+  // The sidecar stores the values in binary form: they are read back exactly.
+  out << "Sidecar values equal to the written ones: "
+      << (sidecar_values == values ? "true" : "false") << endl;
+
+  // The text file stores the values with 15 significant digits.
+  const Size n_values = values.size();
+  bool agree = (Size(text_values.size()) == n_values);
+  for (int i = 0 ; agree && i < n_values ; ++i)
+    agree = std::abs(sidecar_values[i] - text_values[i]) <=
+            1.0e-14 * std::max(std::abs(sidecar_values[i]), 1.0);
+  out << "Sidecar values agree with the text file: "
+      << (agree ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+int main()
+{
+  test<2>();
+  test<3>();
+
+  return 0;
+}
@@ -84,7 +84,7 @@ create_ig_function(const shared_ptr<const Domain<dim,codim>> &domain)
 
   IgCoefficients coeffs;
   for (int dof = 0 ; dof < n_basis ; ++dof)
-    coeffs[dof] = 1.0;
+    coeffs.insert(dof, 1.0);
 
   auto ig_func = IgFunction<dim,codim,range,1>::const_create(phys_basis,coeffs);
 
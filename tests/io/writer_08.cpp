@@ -0,0 +1,223 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ * Testing the writer, the binary (raw and compressed) appended output,
+ * with and without merging the points shared by the VTK elements.
+ * The .vtu files are read back and their arrays are printed.
+ *
+ */
+
+#include "../tests.h"
+#include "igatools/io/writer.h"
+#include "igatools/functions/grid_function_lib.h"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#ifdef IGATOOLS_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+using std::uint64_t;
+
+
+/**
+ * Returns the value of the attribute @p name in the XML tag @p tag
+ * (or an empty string if the attribute is not present).
+ */
+string
+get_attribute(const string &tag, const string &name)
+{
+  const string key = " " + name + "=\"";
+  const auto begin = tag.find(key);
+  if (begin == string::npos)
+    return "";
+  const auto first = begin + key.size();
+  return tag.substr(first, tag.find('"',first) - first);
+}
+
+
+/**
+ * Reads the bytes of the appended array starting at @p data.
+ */
+string
+read_array(const char *data, const bool compressed)
+{
+  uint64_t header[3];
+  std::memcpy(header, data, sizeof(uint64_t));
+  if (!compressed)
+    return string(data + sizeof(uint64_t), header[0]);
+
+  std::memcpy(header, data, 3 * sizeof(uint64_t));
+  const uint64_t n_blocks = header[0];
+  std::vector<uint64_t> sizes(n_blocks);
+  std::memcpy(sizes.data(), data + 3 * sizeof(uint64_t), n_blocks * sizeof(uint64_t));
+
+  string bytes;
+#ifdef IGATOOLS_WITH_ZLIB
+  const char *block = data + (3 + n_blocks) * sizeof(uint64_t);
+  for (uint64_t b = 0 ; b < n_blocks ; ++b)
+  {
+    uLongf n_bytes = (b == n_blocks-1 && header[2] > 0) ? header[2] : header[1];
+    string uncompressed(n_bytes, ' ');
+    uncompress(reinterpret_cast<Bytef *>(&uncompressed[0]), &n_bytes,
+               reinterpret_cast<const Bytef *>(block), sizes[b]);
+    bytes += uncompressed.substr(0,n_bytes);
+    block += sizes[b];
+  }
+#endif
+  return bytes;
+}
+
+
+template<class V>
+void
+print_values(const string &bytes)
+{
+  const int n_values = bytes.size() / sizeof(V);
+  std::vector<V> values(n_values);
+  std::memcpy(values.data(), bytes.data(), bytes.size());
+  for (const auto &v : values)
+    out << v << " ";
+  out << endl;
+}
+
+
+/**
+ * Prints the name, the type and the values of the arrays
+ * in the .vtu file @p filename.
+ */
+void
+print_vtu(const string &filename)
+{
+  ifstream file(filename, std::ios::binary);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const string content = buffer.str();
+
+  const auto data_begin = content.find('_', content.find("<AppendedData")) + 1;
+  const string xml = content.substr(0, data_begin);
+  const bool compressed = !get_attribute(xml, "compressor").empty();
+
+  const auto piece_begin = xml.find("<Piece");
+  const string piece = xml.substr(piece_begin, xml.find('>',piece_begin) - piece_begin);
+  out << "NumberOfPoints: " << get_attribute(piece,"NumberOfPoints") << endl;
+  out << "NumberOfCells: " << get_attribute(piece,"NumberOfCells") << endl;
+
+  for (auto begin = xml.find("<DataArray") ; begin != string::npos ;
+       begin = xml.find("<DataArray", begin + 1))
+  {
+    const string tag = xml.substr(begin, xml.find('>',begin) - begin);
+    const string name = get_attribute(tag,"Name");
+    const string type = get_attribute(tag,"type");
+    const uint64_t offset = std::stoull(get_attribute(tag,"offset"));
+
+    out << (name.empty() ? "points" : name) << " (" << type << "): ";
+    const string bytes = read_array(content.data() + data_begin + offset, compressed);
+    if (type == "Float64")
+      print_values<double>(bytes);
+    else if (type == "Int64")
+      print_values<int64_t>(bytes);
+    else if (type == "Int32")
+      print_values<int32_t>(bytes);
+    else if (type == "UInt8")
+    {
+      for (const unsigned char v : bytes)
+        out << int(v) << " ";
+      out << endl;
+    }
+  }
+}
+
+
+template<int dim>
+void
+test(const int n_pts)
+{
+  OUTSTART
+
+  TensorSize<dim> n_knots;
+  for (int i = 0 ; i < dim ; ++i)
+    n_knots[i] = 4 - i;
+  auto grid = Grid<dim>::const_create(n_knots);
+
+  using F = grid_functions::LinearGridFunction<dim,dim>;
+  typename F::Gradient A;
+  typename F::Value b;
+  for (int i = 0 ; i < dim ; ++i)
+  {
+    for (int j = 0 ; j < dim ; ++j)
+      A[i][j] = (i == j) ? 2.0 : 0.5;
+    b[i] = i;
+  }
+  auto domain = Domain<dim,0>::const_create(F::const_create(grid,A,b));
+
+  Writer<dim> writer(domain,n_pts);
+
+  const int n_elems = writer.get_num_iga_elements();
+  const int n_pts_elem = writer.get_num_points_per_iga_element();
+  using Vec = SafeSTLVector<Real>;
+  using VecOfVec = SafeSTLVector<Vec>;
+  SafeSTLVector<VecOfVec> point_data(n_elems, VecOfVec(n_pts_elem, Vec(1)));
+  for (int elem = 0 ; elem < n_elems ; ++elem)
+    for (int pt = 0 ; pt < n_pts_elem ; ++pt)
+      point_data[elem][pt][0] = 100 * elem + pt;
+  writer.add_point_data(1, "scalar", point_data, "scalar field");
+
+  SafeSTLVector<int> cell_data(n_elems);
+  for (int elem = 0 ; elem < n_elems ; ++elem)
+    cell_data[elem] = elem;
+  writer.add_element_data(cell_data, "elem id");
+
+  writer.set_num_threads(2);
+
+  const string filename = "binary_" + to_string(dim);
+
+  out.begin_item("Appended:");
+  writer.save(filename, "appended");
+  print_vtu(filename + ".vtu");
+  out.end_item();
+
+  writer.set_merge_shared_points(true);
+
+  out.begin_item("Appended, merged points:");
+  writer.save(filename + "_merged", "appended");
+  print_vtu(filename + "_merged.vtu");
+  out.end_item();
+
+  out.begin_item("Compressed, merged points:");
+  writer.save(filename + "_compressed", "compressed");
+  print_vtu(filename + "_compressed.vtu");
+  out.end_item();
+
+  OUTEND
+}
+
+
+int main()
+{
+  test<1>(3);
+  test<2>(3);
+  test<3>(2);
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ * Testing the writer, the output split in pieces (.pvtu file).
+ * The .pvtu file is printed and the .vtu pieces are read back
+ * and their arrays are printed.
+ *
+ */
+
+#include "../tests.h"
+#include "igatools/io/writer.h"
+#include "igatools/functions/grid_function_lib.h"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+using std::uint64_t;
+
+
+string
+get_attribute(const string &tag, const string &name)
+{
+  const string key = " " + name + "=\"";
+  const auto begin = tag.find(key);
+  if (begin == string::npos)
+    return "";
+  const auto first = begin + key.size();
+  return tag.substr(first, tag.find('"',first) - first);
+}
+
+
+string
+read_file(const string &filename)
+{
+  ifstream file(filename, std::ios::binary);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+
+
+template<class V>
+void
+print_values(const char *data)
+{
+  uint64_t n_bytes;
+  std::memcpy(&n_bytes, data, sizeof(uint64_t));
+  std::vector<V> values(n_bytes / sizeof(V));
+  std::memcpy(values.data(), data + sizeof(uint64_t), n_bytes);
+  for (const auto &v : values)
+    out << +v << " ";
+  out << endl;
+}
+
+
+/**
+ * Prints the arrays of the .vtu file @p filename, written with
+ * raw appended data.
+ */
+void
+print_vtu(const string &filename)
+{
+  const string content = read_file(filename);
+  const auto data_begin = content.find('_', content.find("<AppendedData")) + 1;
+  const string xml = content.substr(0, data_begin);
+
+  const auto piece_begin = xml.find("<Piece");
+  const string piece = xml.substr(piece_begin, xml.find('>',piece_begin) - piece_begin);
+  out << "NumberOfPoints: " << get_attribute(piece,"NumberOfPoints") << endl;
+  out << "NumberOfCells: " << get_attribute(piece,"NumberOfCells") << endl;
+
+  for (auto begin = xml.find("<DataArray") ; begin != string::npos ;
+       begin = xml.find("<DataArray", begin + 1))
+  {
+    const string tag = xml.substr(begin, xml.find('>',begin) - begin);
+    const string name = get_attribute(tag,"Name");
+    const string type = get_attribute(tag,"type");
+    const char *data = content.data() + data_begin + std::stoull(get_attribute(tag,"offset"));
+
+    out << (name.empty() ? "points" : name) << " (" << type << "): ";
+    if (type == "Float64")
+      print_values<double>(data);
+    else if (type == "Int64")
+      print_values<int64_t>(data);
+    else if (type == "Int32")
+      print_values<int32_t>(data);
+    else if (type == "UInt8")
+      print_values<unsigned char>(data);
+  }
+}
+
+
+template<int dim>
+void
+test(const int n_pieces, const bool merge)
+{
+  OUTSTART
+
+  TensorSize<dim> n_knots;
+  for (int i = 0 ; i < dim ; ++i)
+    n_knots[i] = 3 + i;
+  auto grid = Grid<dim>::const_create(n_knots);
+  Writer<dim> writer(grid,2);
+  writer.set_merge_shared_points(merge);
+
+  const int n_elems = writer.get_num_iga_elements();
+  const int n_pts_elem = writer.get_num_points_per_iga_element();
+  using Vec = SafeSTLVector<Real>;
+  using VecOfVec = SafeSTLVector<Vec>;
+  SafeSTLVector<VecOfVec> point_data(n_elems, VecOfVec(n_pts_elem, Vec(1)));
+  for (int elem = 0 ; elem < n_elems ; ++elem)
+    for (int pt = 0 ; pt < n_pts_elem ; ++pt)
+      point_data[elem][pt][0] = 100 * elem + pt;
+  writer.add_point_data(1, "scalar", point_data, "scalar field");
+
+  SafeSTLVector<Real> cell_data(n_elems);
+  for (int elem = 0 ; elem < n_elems ; ++elem)
+    cell_data[elem] = elem;
+  writer.add_element_data(cell_data, "elem id");
+
+  const string filename = "pieces_" + to_string(dim) + (merge ? "_merged" : "");
+  writer.save_pieces(filename, n_pieces, "appended");
+
+  const string pvtu = read_file(filename + ".pvtu");
+  out.begin_item(filename + ".pvtu:");
+  std::istringstream pvtu_lines(pvtu);
+  for (string line ; std::getline(pvtu_lines,line) ;)
+    out << line << endl;
+  out.end_item();
+
+  for (auto begin = pvtu.find("<Piece ") ; begin != string::npos ;
+       begin = pvtu.find("<Piece ", begin + 1))
+  {
+    const string source = get_attribute(pvtu.substr(begin, pvtu.find('>',begin) - begin),"Source");
+    out.begin_item(source + ":");
+    print_vtu(source);
+    out.end_item();
+  }
+
+  OUTEND
+}
+
+
+int main()
+{
+  test<1>(2,false);
+  test<2>(3,false);
+  test<2>(3,true);
+  test<3>(4,true);
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the EpetraTools::FastDiagonalization preconditioner.
+ *  On the parametric domain, the operator applied by the preconditioner is
+ *  compared with the assembled matrix (with homogeneous Dirichlet conditions)
+ *  and the preconditioner is the exact inverse, therefore the preconditioned
+ *  CG converges in one iteration.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/base/quadrature_lib.h>
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/basis_functions/basis_tools.h>
+#include <igatools/linear_algebra/epetra_solver.h>
+#include <igatools/linear_algebra/epetra_fast_diagonalization.h>
+#include <igatools/linear_algebra/dof_tools.h>
+
+using namespace EpetraTools;
+
+
+template<int dim, int range>
+void fast_diagonalization(const int n_knots, const int deg,
+                          const std::set<int> &dirichlet_faces,
+                          const Real mass_coeff)
+{
+  OUTSTART
+
+  using Basis = BSpline<dim,range>;
+
+  auto grid = Grid<dim>::create(n_knots);
+  auto space = SplineSpace<dim,range>::create(deg, grid);
+  auto basis = Basis::create(space);
+  auto quad = QGauss<dim>::create(deg+1);
+
+  Epetra_SerialComm comm;
+
+  const Real stiffness_coeff = 2.0;
+  const FastDiagonalization<dim,range> prec(*basis,comm,dirichlet_faces,
+                                            stiffness_coeff,mass_coeff);
+
+  //----------------------------------------------------------------------------
+  // global matrix
+  auto matrix = create_matrix(*basis,DofProperties::active,comm);
+  {
+    using Flags = basis_element::Flags;
+    auto handler = basis->create_cache_handler();
+    handler->set_element_flags(Flags::value | Flags::gradient | Flags::w_measure);
+
+    auto elem = basis->begin();
+    const auto end = basis->end();
+    handler->init_element_cache(elem,quad);
+
+    for (; elem != end; ++elem)
+    {
+      handler->fill_element_cache(elem);
+      const auto &phi = elem->get_element_values();
+      const auto &grad_phi = elem->get_element_gradients();
+      const auto w_meas = elem->get_element_w_measures();
+
+      const int n_basis = elem->get_num_basis();
+      const int n_pts = w_meas.size();
+      DenseMatrix loc_mat(n_basis,n_basis);
+      loc_mat = 0.0;
+      for (int i = 0 ; i < n_basis ; ++i)
+      {
+        const auto phi_i = phi.get_function_view(i);
+        const auto grad_phi_i = grad_phi.get_function_view(i);
+        for (int j = 0 ; j < n_basis ; ++j)
+        {
+          const auto phi_j = phi.get_function_view(j);
+          const auto grad_phi_j = grad_phi.get_function_view(j);
+          for (int q = 0 ; q < n_pts ; ++q)
+            loc_mat(i,j) += w_meas[q] *
+                            (stiffness_coeff * scalar_product(grad_phi_i[q],grad_phi_j[q]) +
+                             mass_coeff * scalar_product(phi_i[q],phi_j[q]));
+        }
+      }
+
+      const auto loc_dofs = elem->get_local_to_global(DofProperties::active);
+      matrix->add_block(loc_dofs,loc_dofs,loc_mat);
+    }
+    matrix->FillComplete();
+  }
+
+  auto rhs = create_vector(matrix->RangeMap());
+  auto sol = create_vector(matrix->DomainMap());
+
+  std::map<Index,Real> bndry_values;
+  for (const auto dof : basis_tools::get_boundary_dofs<Basis>(basis,dirichlet_faces))
+    bndry_values[dof] = 0.0;
+  dof_tools::apply_boundary_values(bndry_values,*matrix,*rhs,*sol);
+  //----------------------------------------------------------------------------
+
+  //----------------------------------------------------------------------------
+  // x is zero on the Dirichlet dofs
+  auto x = create_vector(matrix->DomainMap());
+  const int n_dofs = x->MyLength();
+  for (int i = 0 ; i < n_dofs ; ++i)
+    (*x)[i] = std::sin(1.0 + i);
+  for (const auto &dof_value : bndry_values)
+    (*x)[x->Map().LID(dof_value.first)] = 0.0;
+
+  auto y_ref = create_vector(matrix->RangeMap());
+  matrix->Multiply(false,*x,*y_ref);
+
+  auto y = create_vector(matrix->RangeMap());
+  prec.Apply(*x,*y);
+
+  auto z = create_vector(matrix->DomainMap());
+  prec.ApplyInverse(*y,*z);
+
+  Real norm_y = 0.0;
+  Real err_apply = 0.0;
+  Real err_inverse = 0.0;
+  Real norm_x = 0.0;
+  for (int i = 0 ; i < n_dofs ; ++i)
+  {
+    norm_y = std::max(norm_y,std::abs((*y_ref)[i]));
+    err_apply = std::max(err_apply,std::abs((*y)[i] - (*y_ref)[i]));
+    norm_x = std::max(norm_x,std::abs((*x)[i]));
+    err_inverse = std::max(err_inverse,std::abs((*z)[i] - (*x)[i]));
+  }
+  //----------------------------------------------------------------------------
+
+  //----------------------------------------------------------------------------
+  // preconditioned CG
+  for (int i = 0 ; i < n_dofs ; ++i)
+    (*rhs)[i] = (*y_ref)[i];
+
+  auto solver = create_solver(*matrix,*sol,*rhs,prec);
+  auto result = solver->solve();
+  AssertThrow(result == Belos::ReturnType::Converged,
+              ExcMessage("No convergence."));
+
+  Real err_sol = 0.0;
+  for (int i = 0 ; i < n_dofs ; ++i)
+    err_sol = std::max(err_sol,std::abs((*sol)[i] - (*x)[i]));
+  //----------------------------------------------------------------------------
+
+  out << "num dofs: " << n_dofs << endl;
+  out << "Apply error below tolerance: "
+      << (err_apply < 1.0e-12 * norm_y ? "true" : "false") << endl;
+  out << "ApplyInverse error below tolerance: "
+      << (err_inverse < 1.0e-10 * norm_x ? "true" : "false") << endl;
+  out << "CG iterations: " << solver->getNumIters() << endl;
+  out << "solution error below tolerance: "
+      << (err_sol < 1.0e-6 * norm_x ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  fast_diagonalization<1,1>(6,3,{0,1},0.0);
+  fast_diagonalization<2,1>(5,2,{0,1,2,3},0.0);
+  fast_diagonalization<2,1>(4,4,{1,2},0.0);
+  fast_diagonalization<2,1>(4,3,{},1.0);
+  fast_diagonalization<2,2>(4,2,{0,2},0.0);
+  fast_diagonalization<3,1>(3,2,{0,1,2,3,4,5},0.5);
+
+  return  0;
+}
@@ -0,0 +1,130 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for create_sparsity_pattern(): the patterns computed using the tensor-product
+ *  structure of the spaces and using the element-to-dofs connectivity
+ *  (with different numbers of threads) must be equal to the one computed with
+ *  the serial element loop.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/basis_functions/bspline_element.h>
+#include <igatools/linear_algebra/sparsity_pattern.h>
+
+
+template<class RowBasis, class ColBasis>
+SparsityPattern
+serial_pattern(const RowBasis &row_basis, const PropId &row_property,
+               const ColBasis &col_basis, const PropId &col_property)
+{
+  std::map<Index,std::set<Index>> dofs_connectivity;
+
+  auto r_elem = row_basis.begin();
+  auto c_elem = col_basis.begin();
+  const auto r_end = row_basis.end();
+  for (; r_elem != r_end ; ++r_elem, ++c_elem)
+  {
+    const auto r_dofs = r_elem->get_local_to_global(row_property);
+    const auto c_dofs = c_elem->get_local_to_global(col_property);
+    for (const auto r_dof : r_dofs)
+      dofs_connectivity[r_dof].insert(c_dofs.begin(),c_dofs.end());
+  }
+
+  SafeSTLVector<Index> rows_id;
+  SafeSTLVector<Index> offsets(1,0);
+  SafeSTLVector<Index> cols_id;
+  for (const auto &row : dofs_connectivity)
+  {
+    rows_id.emplace_back(row.first);
+    cols_id.insert(cols_id.end(),row.second.begin(),row.second.end());
+    offsets.emplace_back(cols_id.size());
+  }
+  return SparsityPattern(std::move(rows_id),std::move(offsets),std::move(cols_id));
+}
+
+
+
+template<int dim, int r_range, int c_range>
+void sparsity_pattern(const int n_knots, const int r_deg, const int c_deg,
+                      const bool print_pattern = false)
+{
+  OUTSTART
+
+  auto grid = Grid<dim>::const_create(n_knots);
+  auto row_basis = BSpline<dim,r_range>::const_create(
+                     SplineSpace<dim,r_range>::const_create(r_deg,grid));
+  auto col_basis = BSpline<dim,c_range>::const_create(
+                     SplineSpace<dim,c_range>::const_create(c_deg,grid));
+
+  out << "dim: " << dim
+      << "   row range: " << r_range << "   row degree: " << r_deg
+      << "   col range: " << c_range << "   col degree: " << c_deg << endl;
+
+  const auto &row_space = *row_basis->get_spline_space();
+  const auto &col_space = *col_basis->get_spline_space();
+  out << "Tensor-product pattern: "
+      << sparsity_pattern_tools::has_tensor_product_pattern(row_space,col_space) << endl;
+
+  const auto &prop = DofProperties::active;
+  const auto serial = serial_pattern(*row_basis,prop,*col_basis,prop);
+  out << "Number of rows: " << serial.get_num_rows()
+      << "   number of entries: " << serial.get_num_entries() << endl;
+
+  for (const int n_threads : {1,2,3,5})
+  {
+    const auto tp_pattern = sparsity_pattern_tools::create_tensor_product_pattern(
+                              row_space,prop,col_space,prop,n_threads);
+    const auto elem_pattern = sparsity_pattern_tools::create_element_pattern(
+                                row_space,prop,col_space,prop,n_threads);
+    const auto pattern = create_sparsity_pattern(*row_basis,prop,*col_basis,prop,n_threads);
+
+    out << "n_threads: " << n_threads
+        << "   tensor-product same as serial: " << (tp_pattern == serial)
+        << "   element same as serial: " << (elem_pattern == serial)
+        << "   default same as serial: " << (pattern == serial) << endl;
+  }
+
+  if (print_pattern)
+  {
+    out.begin_item("Pattern:");
+    serial.print_info(out);
+    out.end_item();
+  }
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  sparsity_pattern<1,1,1>(4,2,2,true);
+  sparsity_pattern<1,1,1>(5,1,3);
+  sparsity_pattern<2,1,1>(4,2,2);
+  sparsity_pattern<2,1,2>(5,2,1);
+  sparsity_pattern<3,1,1>(3,2,2);
+  sparsity_pattern<3,3,1>(3,1,2);
+
+  return  0;
+}
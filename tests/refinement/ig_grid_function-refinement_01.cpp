@@ -0,0 +1,76 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/**
+ *  @file
+ *  @brief  Test for the refinement of the coefficients of an IgGridFunction
+ *  defined on a BSpline basis (computed by knot insertion)
+ */
+
+#include "../tests.h"
+
+#include <igatools/basis_functions/bspline.h>
+#include <igatools/functions/ig_grid_function.h>
+
+
+void refine_ig_grid_function(const int deg,
+                             const IgCoefficients &coeffs,
+                             const int n_subdivisions)
+{
+  OUTSTART
+
+  auto grid = Grid<1>::create(3);
+  auto basis = BSpline<1,1>::create(SplineSpace<1>::create(deg,grid));
+  auto func = IgGridFunction<1,1>::create(basis,coeffs);
+
+  out << "Degree: " << deg << endl;
+  out << "Original coefficients:" << endl;
+  func->get_coefficients().print_info(out);
+
+  grid->refine(n_subdivisions);
+
+  out << "Coefficients after the refinement (" << n_subdivisions
+      << " subdivisions):" << endl;
+  func->get_coefficients().print_info(out);
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  IgCoefficients coeffs_deg2;
+  coeffs_deg2.insert(0, 1.0);
+  coeffs_deg2.insert(1, 3.0);
+  coeffs_deg2.insert(2, -1.0);
+  coeffs_deg2.insert(3, 2.0);
+  refine_ig_grid_function(2,coeffs_deg2,2);
+
+  IgCoefficients coeffs_deg3;
+  coeffs_deg3.insert(0, 1.0);
+  coeffs_deg3.insert(1, 3.0);
+  coeffs_deg3.insert(2, -1.0);
+  coeffs_deg3.insert(3, 2.0);
+  coeffs_deg3.insert(4, 0.0);
+  refine_ig_grid_function(3,coeffs_deg3,3);
+
+  return 0;
+}
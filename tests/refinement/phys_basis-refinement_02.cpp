@@ -57,10 +57,10 @@ void test_evaluate()
   IgCoefficients weights_coef;
   for (int i = 0 ; i < n_scalar_basis ;)
   {
-    weights_coef[i++] = 1.0;
-    weights_coef[i++] = 0.4;
-    weights_coef[i++] = 0.65;
-    weights_coef[i++] = 1.0;
+    weights_coef.insert(i++, 1.0);
+    weights_coef.insert(i++, 0.4);
+    weights_coef.insert(i++, 0.65);
+    weights_coef.insert(i++, 1.0);
   }
 
   using WeightFunc = IgGridFunction<dim,1>;
@@ -67,10 +67,10 @@ void test_evaluate()
   IgCoefficients weights_coef;
   for (int i = 0 ; i < n_scalar_basis ;)
   {
-    weights_coef[i++] = 1.0;
-    weights_coef[i++] = 0.853553390593274;
-    weights_coef[i++] = 0.853553390593274;
-    weights_coef[i++] = 1.0;
+    weights_coef.insert(i++, 1.0);
+    weights_coef.insert(i++, 0.853553390593274);
+    weights_coef.insert(i++, 0.853553390593274);
+    weights_coef.insert(i++, 1.0);
   }
 
   using WeightFunc = IgGridFunction<dim,1>;
@@ -81,60 +81,60 @@ void test_evaluate()
   IgCoefficients control_pts;
   if (dim == 1)
   {
-    control_pts[0] = 1.0;
-    control_pts[1] = 1.0;
-    control_pts[2] = 0.414213562373095;
-    control_pts[3] = 0.0;
+    control_pts.insert(0, 1.0);
+    control_pts.insert(1, 1.0);
+    control_pts.insert(2, 0.414213562373095);
+    control_pts.insert(3, 0.0);
   }
   else if (dim == 2)
   {
     // 1st comp - 1st row
-    control_pts[0] = 1.0;
-    control_pts[1] = 1.0;
-    control_pts[2] = 0.414213562373095;
-    control_pts[3] = 0.0;
+    control_pts.insert(0, 1.0);
+    control_pts.insert(1, 1.0);
+    control_pts.insert(2, 0.414213562373095);
+    control_pts.insert(3, 0.0);
 
     // 1st comp - 2nd row
-    control_pts[4] = 1.375;
-    control_pts[5] = 1.375;
-    control_pts[6] = 0.569543648263006;
-    control_pts[7] = 0.0;
+    control_pts.insert(4, 1.375);
+    control_pts.insert(5, 1.375);
+    control_pts.insert(6, 0.569543648263006);
+    control_pts.insert(7, 0.0);
 
     // 1st comp - 3rd row
-    control_pts[8] = 2.125;
-    control_pts[9] = 2.125;
-    control_pts[10] = 0.880203820042827;
-    control_pts[11] = 0.0;
+    control_pts.insert(8, 2.125);
+    control_pts.insert(9, 2.125);
+    control_pts.insert(10, 0.880203820042827);
+    control_pts.insert(11, 0.0);
 
     // 1st comp - 4th row
-    control_pts[12] = 2.5;
-    control_pts[13] = 2.5;
-    control_pts[14] = 1.03553390593274;
-    control_pts[15] = 0.0;
+    control_pts.insert(12, 2.5);
+    control_pts.insert(13, 2.5);
+    control_pts.insert(14, 1.03553390593274);
+    control_pts.insert(15, 0.0);
 
     // 2nd comp - 1st row
-    control_pts[16] = 0.0;
-    control_pts[17] = 0.414213562373095;
-    control_pts[18] = 1.0;
-    control_pts[19] = 1.0;
+    control_pts.insert(16, 0.0);
+    control_pts.insert(17, 0.414213562373095);
+    control_pts.insert(18, 1.0);
+    control_pts.insert(19, 1.0);
 
     // 2nd comp - 2nd row
-    control_pts[20] = 0.0;
-    control_pts[21] = 0.569543648263006;
-    control_pts[22] = 1.375;
-    control_pts[23] = 1.375;
+    control_pts.insert(20, 0.0);
+    control_pts.insert(21, 0.569543648263006);
+    control_pts.insert(22, 1.375);
+    control_pts.insert(23, 1.375);
 
     // 2nd comp - 3rd row
-    control_pts[24] = 0.0;
-    control_pts[25] = 0.880203820042827;
-    control_pts[26] = 2.125;
-    control_pts[27] = 2.125;
+    control_pts.insert(24, 0.0);
+    control_pts.insert(25, 0.880203820042827);
+    control_pts.insert(26, 2.125);
+    control_pts.insert(27, 2.125);
 
     // 2nd comp - 4th row
-    control_pts[28] = 0.0;
-    control_pts[29] = 1.035533905932738;
-    control_pts[30] = 2.5;
-    control_pts[31] = 2.5;
+    control_pts.insert(28, 0.0);
+    control_pts.insert(29, 1.035533905932738);
+    control_pts.insert(30, 2.5);
+    control_pts.insert(31, 2.5);
   }
   else if (dim == 3)
   {
@@ -0,0 +1,107 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for IndexSet: insertion, removal, membership, iteration (compared with std::set)
+ *  and offset of the ids.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/utils/index_set.h>
+
+
+void index_set()
+{
+  OUTSTART
+
+  IndexSet<Index> set {3, 70, 1, 200, 64, 3};
+  out << "Set: ";
+  set.print_info(out);
+  out << endl;
+  out << "Size: " << set.size() << endl;
+  out << "count(70): " << set.count(70) << "   count(71): " << set.count(71)
+      << "   count(1000): " << set.count(1000) << endl;
+  out << "*find(64): " << *set.find(64) << "   *(++find(70)): " << *(++set.find(70)) << endl;
+  out << "find(5) == end(): " << (set.find(5) == set.end()) << endl;
+
+  set.erase(70);
+  set.erase(71);
+  set.insert(128);
+  out << "Set after erase(70), erase(71), insert(128): ";
+  set.print_info(out);
+  out << endl;
+
+  set.add_offset(64);
+  out << "Set after add_offset(64): ";
+  set.print_info(out);
+  out << endl;
+
+  set.add_offset(-3);
+  out << "Set after add_offset(-3): ";
+  set.print_info(out);
+  out << endl;
+
+  set.clear();
+  out << "Empty after clear(): " << set.empty() << endl;
+
+  OUTEND
+}
+
+
+
+void compare_with_std_set()
+{
+  OUTSTART
+
+  std::set<Index> std_set;
+  IndexSet<Index> set;
+  for (Index i = 0 ; i < 1000 ; ++i)
+  {
+    const Index id = (i * 7919) % 1301;
+    if (i % 3 == 2)
+    {
+      std_set.erase(id);
+      set.erase(id);
+    }
+    else
+    {
+      std_set.insert(id);
+      set.insert(id);
+    }
+  }
+
+  out << "Same size: " << (Size(std_set.size()) == set.size()) << endl;
+  out << "Same ids: " << (std_set == set.get_std_set()) << endl;
+  out << "Same as the IndexSet built from the std::set: " << (set == IndexSet<Index>(std_set)) << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  index_set();
+  compare_with_std_set();
+
+  return 0;
+}
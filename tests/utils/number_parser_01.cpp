@@ -0,0 +1,141 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the number_parser functions: parsing of integers and reals
+ *  (compared with strtod), invalid tokens and lists of numbers stored with
+ *  char and UTF-16 characters.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/utils/number_parser.h>
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+
+template <class T>
+void print_parse(const std::string &token)
+{
+  T v = T(-1);
+  const bool ok = number_parser::parse(token.data(), token.data() + token.size(), v);
+  out << "\"" << token << "\": ";
+  if (ok)
+  {
+    // Printing all the digits, without the LogStream rounding.
+    std::ostringstream os;
+    os << std::setprecision(17) << v;
+    out << os.str() << endl;
+  }
+  else
+    out << "invalid" << endl;
+}
+
+
+
+void parse_integers()
+{
+  OUTSTART
+
+  for (const std::string token :
+       {"0", "42", "-17", "+5", "007", "2147483647", "-2147483648",
+        "2147483648", "-2147483649", "", "-", "1.0", "12a", "1e3"
+       })
+    print_parse<Index>(token);
+
+  OUTEND
+}
+
+
+
+void parse_reals()
+{
+  OUTSTART
+
+  for (const std::string token :
+       {"0", "-0.0", "1", "0.5", ".25", "3.", "-1.5e-3", "2.5E+2", "1e22",
+        "0.1", "0.30000000000000004", "1e-310", "1e400", "", ".", "-", "1e",
+        "1.0.0", "1e5x", "nan"
+       })
+    print_parse<Real>(token);
+
+  // Checking against strtod the values of the fast and of the slow path.
+  int n_different = 0;
+  char buffer[64];
+  for (int i = 0 ; i < 10000 ; ++i)
+  {
+    const double x = std::sin(0.37 * i) * std::pow(10.0, (i % 61) - 30);
+    for (const int digits : {6, 15, 17})
+    {
+      std::snprintf(buffer, sizeof(buffer), "%.*g", digits, x);
+      Real v;
+      number_parser::parse(buffer, buffer + std::strlen(buffer), v);
+      if (v != std::strtod(buffer, nullptr))
+        ++n_different;
+    }
+  }
+  out << "Values different from strtod: " << n_different << endl;
+
+  OUTEND
+}
+
+
+
+template <class Char>
+void parse_values(const std::string &text)
+{
+  OUTSTART
+
+  const std::basic_string<Char> wide_text(text.begin(), text.end());
+  const auto values = number_parser::parse_values<Real>(wide_text.data(), wide_text.size());
+  out << "Number of values: " << values.size() << endl;
+  for (const auto v : values)
+    out << v << " ";
+  out << endl;
+
+  try
+  {
+    const auto ids = number_parser::parse_values<Index>(wide_text.data(), wide_text.size());
+    out << "Parsed as Index: " << ids.size() << " values." << endl;
+  }
+  catch (const ExceptionBase &exc)
+  {
+    out << "Parsing as Index failed." << endl;
+  }
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  parse_integers();
+  parse_reals();
+
+  parse_values<char>("\n   1 2.5\t-3e1 \r\n 0.125   \n");
+  parse_values<char16_t>(" 4  5 6 ");
+  parse_values<char>("   ");
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+//-+--------------------------------------------------------------------
+// Igatools a general purpose Isogeometric analysis library.
+// Copyright (C) 2012-2016  by the igatools authors (see authors.txt).
+//
+// This file is part of the igatools library.
+//
+// The igatools library is free software: you can use it, redistribute
+// it and/or modify it under the terms of the GNU General Public
+// License as published by the Free Software Foundation, either
+// version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//-+--------------------------------------------------------------------
+
+/*
+ *  Test for the SoAValueTable: layout of the components, views and
+ *  conversion from/to ValueTable.
+ *
+ */
+
+#include "../tests.h"
+
+#include <igatools/base/tensor.h>
+#include <igatools/functions/function.h>
+#include <igatools/utils/soa_value_table.h>
+
+
+template <int dim=1, int k=1>
+void soa_value_table(Size n_funcs, Size n_pts)
+{
+  OUTSTART
+
+  using Value = typename Function<dim>::template Derivative<k>;
+
+  ValueTable<Value> table(n_funcs,n_pts);
+  Real val = 0.0;
+  for (auto &v : table)
+  {
+    SafeSTLArray<Real,Value::n_entries> entries;
+    for (auto &e : entries)
+    {
+      e = val;
+      val += 1.0;
+    }
+    v = Value(entries);
+  }
+
+  SoAValueTable<Value> soa_table(table);
+  out << "Number of functions: " << soa_table.get_num_functions() << endl;
+  out << "Number of points: " << soa_table.get_num_points() << endl;
+  out << "Leading dimension: " << soa_table.get_leading_dimension() << endl;
+
+  out << "Components (one row for each point):" << endl;
+  for (int comp = 0 ; comp < SoAValueTable<Value>::n_components ; ++comp)
+  {
+    out << "\tComponent[" << comp << "]" << endl;
+    for (int i_pt = 0 ; i_pt < n_pts ; ++i_pt)
+    {
+      const Real *values = soa_table.get_component(comp,i_pt);
+      out << "\t\t";
+      for (int i_fn = 0 ; i_fn < soa_table.get_leading_dimension() ; ++i_fn)
+        out << values[i_fn] << " ";
+      out << endl;
+    }
+  }
+
+  out << "Testing the function view" << endl;
+  for (int i_fn = 0 ; i_fn < n_funcs ; ++i_fn)
+  {
+    const auto func_view = soa_table.get_function_view(i_fn);
+    out << "\tFunction["<< i_fn << "] = ";
+    for (int i_pt = 0 ; i_pt < func_view.get_num_entries() ; ++i_pt)
+      out << func_view[i_pt] << " ";
+    out << endl;
+  }
+
+  out << "Testing the point view" << endl;
+  for (int i_pt = 0 ; i_pt < n_pts ; ++i_pt)
+  {
+    const auto pt_view = soa_table.get_point_view(i_pt);
+    out << "\tPoint["<< i_pt << "] = ";
+    for (int i_fn = 0 ; i_fn < pt_view.get_num_entries() ; ++i_fn)
+      out << pt_view[i_fn] << " ";
+    out << endl;
+  }
+
+  ValueVector<Real> weights(n_pts);
+  for (int i_pt = 0 ; i_pt < n_pts ; ++i_pt)
+    weights[i_pt] = 2.0;
+  soa_table.scale_points(weights);
+
+  ValueTable<Value> table_copy(n_funcs,n_pts);
+  soa_table.copy_to(table_copy);
+
+  bool same = true;
+  auto it = table.cbegin();
+  for (const auto &v : table_copy)
+    same = same && ((v - 2.0 * (*it++)).norm() == 0.0);
+  out << "Scaled copy equal to the original table: " << (same ? "true" : "false") << endl;
+
+  OUTEND
+}
+
+
+
+int main()
+{
+  soa_value_table<1,1>(3,2);
+  soa_value_table<2,1>(9,2);
+  soa_value_table<3,1>(2,3);
+
+  return 0;
+}
@@ -50,24 +50,24 @@ shared_ptr<Domain<2>> quarter_annulus(TensorSize<2> nel)
   TensorIndex<2> deg = {1,2};
   IgCoefficients control_points;
   IgCoefficients weights;
-  control_points[ 0] = 1.0;
-  control_points[ 6] = 0.0;
-  control_points[ 1] = 2.0;
-  control_points[ 7] = 0.0;
-  control_points[ 2] = 1.0;
-  control_points[ 8] = 1.0;
-  control_points[ 3] = 2.0;
-  control_points[ 9] = 2.0;
-  control_points[ 4] = 0.0;
-  control_points[10] = 1.0;
-  control_points[ 5] = 0.0;
-  control_points[11] = 2.0;
-  weights[0] = 1.0;
-  weights[1] = 1.0;
-  weights[2] = sqrt(2.0)/2.0;
-  weights[3] = sqrt(2.0)/2.0;
-  weights[4] = 1.0;
-  weights[5] = 1.0;
+  control_points.insert(0, 1.0);
+  control_points.insert(6, 0.0);
+  control_points.insert(1, 2.0);
+  control_points.insert(7, 0.0);
+  control_points.insert(2, 1.0);
+  control_points.insert(8, 1.0);
+  control_points.insert(3, 2.0);
+  control_points.insert(9, 2.0);
+  control_points.insert(4, 0.0);
+  control_points.insert(10, 1.0);
+  control_points.insert(5, 0.0);
+  control_points.insert(11, 2.0);
+  weights.insert(0, 1.0);
+  weights.insert(1, 1.0);
+  weights.insert(2, sqrt(2.0)/2.0);
+  weights.insert(3, sqrt(2.0)/2.0);
+  weights.insert(4, 1.0);
+  weights.insert(5, 1.0);
 
   auto grid         = Grid<2>::create(2);
   // [annulus_init]